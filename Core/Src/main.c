@@ -98,6 +98,7 @@ int main(void)
     DebugInit();
     test_fluffer_basic();
     //test_flash_memory();
+    //bench_flash_memory();
     while (1)
     {
         /* USER CODE END WHILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * @file      backup_memory.c
+ * @brief
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <main.h>
+#include <utils.h>
+#include "backup_memory.h"
+
+
+/* ------------------------------------------------------------------------- */
+
+#define BACKUP_MEMORY_REGISTER(o)			((&BKP->DR1)[(o) / BACKUP_MEMORY_REGISTER_SIZE])
+#define BACKUP_MEMORY_BYTE_SHIFT(o)			(((o) % BACKUP_MEMORY_REGISTER_SIZE) << 3)
+
+/* ------------------------------------------------------------------------- */
+
+void BackupMemory_vidInit(void)
+{
+    /*	enable power & backup interface clocks	*/
+    RCC->APB1ENR |= (RCC_APB1ENR_PWREN | RCC_APB1ENR_BKPEN);
+
+    /*	enable write access to backup domain	*/
+    PWR->CR |= PWR_CR_DBP;
+}
+
+/* ------------------------------------------------------------------------- */
+
+BackupMemory_Error_t BackupMemory_enRead(uint16_t u16Offset, uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    if(IS_NULLPTR(pu8Buffer))
+    {
+        return BACKUP_MEMORY_ERROR_NULLPTR;
+    }
+
+    if(IS_ZERO(u16Len))
+    {
+        return BACKUP_MEMORY_ERROR_ZERO_LEN;
+    }
+
+    /*	check if offset is valid	*/
+    if(!IN_RANGE(((uint32_t)u16Offset + u16Len), BACKUP_MEMORY_OFFSET_START, (BACKUP_MEMORY_OFFSET_END + 1)))
+    {
+        return BACKUP_MEMORY_ERROR_MEM_BOUNDARY;
+    }
+
+    /*	copy register bytes to buffer	*/
+    while(u16Len--)
+    {
+        *pu8Buffer++ = (uint8_t)(BACKUP_MEMORY_REGISTER(u16Offset) >> BACKUP_MEMORY_BYTE_SHIFT(u16Offset));
+        u16Offset++;
+    }
+
+    return BACKUP_MEMORY_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
+
+BackupMemory_Error_t BackupMemory_enWrite(uint16_t u16Offset, const uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    uint32_t Local_u32Register;
+
+    if(IS_NULLPTR(pu8Buffer))
+    {
+        return BACKUP_MEMORY_ERROR_NULLPTR;
+    }
+
+    if(IS_ZERO(u16Len))
+    {
+        return BACKUP_MEMORY_ERROR_ZERO_LEN;
+    }
+
+    if(!IN_RANGE(((uint32_t)u16Offset + u16Len), BACKUP_MEMORY_OFFSET_START, (BACKUP_MEMORY_OFFSET_END + 1)))
+    {
+        return BACKUP_MEMORY_ERROR_MEM_BOUNDARY;
+    }
+
+    /*	read-modify-write each byte into its 16 bit register	*/
+    while(u16Len--)
+    {
+        Local_u32Register = BACKUP_MEMORY_REGISTER(u16Offset);
+        Local_u32Register &= ~(0xFFUL << BACKUP_MEMORY_BYTE_SHIFT(u16Offset));
+        Local_u32Register |= ((uint32_t)*pu8Buffer++ << BACKUP_MEMORY_BYTE_SHIFT(u16Offset));
+        BACKUP_MEMORY_REGISTER(u16Offset) = Local_u32Register;
+        u16Offset++;
+    }
+
+    return BACKUP_MEMORY_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * @file       backup_memory.h
+ * @version    1.0
+ * @date       Oct 16, 2026
+ * @addtogroup backup_memory_gp Backup Memory
+ * @brief      Byte access to the backup domain data registers, their content
+ *             is kept in standby mode (and on VBAT). Used to keep fluffer's
+ *             warm context between wake ups.
+ *****************************************************************************/
+#ifndef __BACKUP_MEMORY_H__
+#define __BACKUP_MEMORY_H__
+
+#include <backup_memory_config.h>
+
+/**
+ *
+ **/
+typedef enum backup_memory_error_t {
+    BACKUP_MEMORY_ERROR_NONE,			/**<  No error  */
+    BACKUP_MEMORY_ERROR_ZERO_LEN,       /**<  Unexpected zero length buffer  */
+    BACKUP_MEMORY_ERROR_NULLPTR,        /**<  Unexpected null pointer was given as a parameter  */
+    BACKUP_MEMORY_ERROR_MEM_BOUNDARY,   /**<  Read/Write will overflow outside of memory range  */
+}BackupMemory_Error_t;
+
+
+/**
+ * @brief Enable backup domain interface clocks, and backup domain write access
+ * @return void
+ **/
+void BackupMemory_vidInit(void);
+
+/**
+ * @brief Read data bytes from backup registers, into a given buffer
+ * @param u16Offset  Offset to start reading from
+ * @param pu8Buffer  Buffer to store read data into
+ * @param u16Len     Number of bytes to read
+ * @return BackupMemory_Error_t
+ **/
+BackupMemory_Error_t BackupMemory_enRead(uint16_t u16Offset, uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief Write data bytes to backup registers, from a given buffer
+ * @param u16Offset  Offset to start writing to
+ * @param pu8Buffer  Buffer to write data from
+ * @param u16Len     Number of bytes to write
+ * @return BackupMemory_Error_t
+ **/
+BackupMemory_Error_t BackupMemory_enWrite(uint16_t u16Offset, const uint8_t * pu8Buffer, uint16_t u16Len);
+
+
+#endif /* __BACKUP_MEMORY_H__ */
@@ -0,0 +1,32 @@
+/******************************************************************************
+ * @file      backup_memory_config.h
+ * @brief
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __BACKUP_MEMORY_CONFIG_H__
+#define __BACKUP_MEMORY_CONFIG_H__
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Microcontroller backup data registers (STM32F103xB: BKP_DR1 .. BKP_DR10),
+ * each register holds 16 bits of data
+ * */
+#define BACKUP_MEMORY_REGISTERS		10
+#define BACKUP_MEMORY_REGISTER_SIZE	2
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Backup memory size (bytes)
+ * */
+#define BACKUP_MEMORY_SIZE			(BACKUP_MEMORY_REGISTERS * BACKUP_MEMORY_REGISTER_SIZE)
+
+#define BACKUP_MEMORY_OFFSET_START	0
+#define BACKUP_MEMORY_OFFSET_END	(BACKUP_MEMORY_SIZE - 1)
+
+/* ------------------------------------------------------------------------- */
+
+#endif /* __BACKUP_MEMORY_CONFIG_H__ */
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * @file      crc_unit.c
+ * @brief     STM32F1 CRC calculation unit driver, see crc_unit.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <main.h>
+#include <utils.h>
+#include "crc_unit.h"
+
+
+/* ------------------------------------------------------------------------- */
+
+/*	reset the unit's data register to its initial value	*/
+#ifndef CRC_UNIT_RESET
+#define CRC_UNIT_RESET()			SET_BIT(CRC->CR, CRC_CR_RESET)
+#endif	/*	CRC_UNIT_RESET	*/
+
+/*	word store to the data register, it's fed to the CRC calculation	*/
+#ifndef CRC_UNIT_FEED
+#define CRC_UNIT_FEED(word)			(CRC->DR = (word))
+#endif	/*	CRC_UNIT_FEED	*/
+
+/* ------------------------------------------------------------------------- */
+
+void CrcUnit_vidInitialize(void)
+{
+    __HAL_RCC_CRC_CLK_ENABLE();
+}
+
+/* ------------------------------------------------------------------------- */
+
+uint32_t CrcUnit_u32Calculate(const uint8_t * pu8Data, uint16_t u16Len)
+{
+    uint32_t Local_u32Word;			/*	next word fed to the unit	*/
+    uint8_t Local_u8Index;			/*	byte index in the last word	*/
+
+    CRC_UNIT_RESET();
+
+    /*	whole words, buffer may be unaligned so words are put together from bytes	*/
+    for(; u16Len >= 4; u16Len -= 4, pu8Data += 4)
+    {
+        Local_u32Word = (uint32_t)pu8Data[0] | ((uint32_t)pu8Data[1] << 8) |
+                        ((uint32_t)pu8Data[2] << 16) | ((uint32_t)pu8Data[3] << 24);
+        CRC_UNIT_FEED(Local_u32Word);
+    }
+
+    /*	the unit takes words only, last bytes are padded with zeros	*/
+    if(u16Len > 0)
+    {
+        Local_u32Word = 0;
+
+        for(Local_u8Index = 0; Local_u8Index < u16Len; Local_u8Index++)
+        {
+            Local_u32Word |= (uint32_t)pu8Data[Local_u8Index] << (8 * Local_u8Index);
+        }
+
+        CRC_UNIT_FEED(Local_u32Word);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return CRC->DR;
+}
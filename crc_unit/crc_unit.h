@@ -0,0 +1,31 @@
+/******************************************************************************
+ * @file       crc_unit.h
+ * @version    1.0
+ * @date       Oct 16, 2026
+ * @copyright
+ * @addtogroup crc_unit_gp CRC Unit
+ * @brief      STM32F1 CRC calculation unit driver, CRC-32 (polynomial
+ *             0x04C11DB7, initial value 0xFFFFFFFF) of a buffer fed as little
+ *             endian 32-bit words, the last word padded with zeros. It matches
+ *             fluffer's software CRC, so it can be set as fluffer's CRC handle
+ *****************************************************************************/
+#ifndef __CRC_UNIT_H__
+#define __CRC_UNIT_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Enable the CRC unit's clock, must be called before the unit is used
+ * @return void
+ **/
+void CrcUnit_vidInitialize(void);
+
+/**
+ * @brief Calculate CRC-32 of the given buffer by the CRC unit, the unit is reset first
+ * @param pu8Data  buffer to calculate its CRC
+ * @param u16Len   number of bytes in the buffer, a partial last word is padded with zeros
+ * @return buffer's CRC
+ **/
+uint32_t CrcUnit_u32Calculate(const uint8_t * pu8Data, uint16_t u16Len);
+
+#endif /* __CRC_UNIT_H__ */
@@ -23,14 +23,210 @@
 
 #define FLASH_MEMORY_IS_16BIT_ALIGNED(a)	(((a) & 0x01) == 0)
 
+/*	FPEC status flags of a failed program	*/
+#define FLASH_MEMORY_FLAG_ERRORS			(FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR)
+
+/*	half word store, with FLASH_CR_PG set it's programmed by the FPEC	*/
+#ifndef FLASH_MEMORY_PROGRAM_HALFWORD
+#define FLASH_MEMORY_PROGRAM_HALFWORD(address, data)	(*(__IO uint16_t *)(address) = (data))
+#endif	/*	FLASH_MEMORY_PROGRAM_HALFWORD	*/
+
+#if FLASH_MEMORY_PROFILE == 1
+#define FLASH_MEMORY_PROFILE_START(start)		((start) = DWT->CYCCNT)
+#define FLASH_MEMORY_PROFILE_STOP(call, start)	FlashMemory_vidProfileCall(&FlashMemory_sProfile.call, (start))
+#define FLASH_MEMORY_PROFILE_UNLOCK()			(FlashMemory_sProfile.unlocks++)
+#else
+#define FLASH_MEMORY_PROFILE_START(start)		((void)(start))
+#define FLASH_MEMORY_PROFILE_STOP(call, start)	((void)(start))
+#define FLASH_MEMORY_PROFILE_UNLOCK()			((void)0)
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
+/* ------------------------------------------------------------------------- */
+
+/*	nested programming sessions, flash is kept unlocked while it's not 0	*/
+static uint8_t FlashMemory_u8SessionDepth = 0;
+
+#if FLASH_MEMORY_PROFILE == 1
+/*	write & erase profile since last reset	*/
+static FlashMemory_Profile_t FlashMemory_sProfile;
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Unlock the flash for a write or erase call, unless a session keeps it unlocked
+ * @return void
+ **/
+static void FlashMemory_vidUnlock(void);
+
+/**
+ * @brief Lock the flash after a write or erase call, unless a session keeps it unlocked
+ * @return void
+ **/
+static void FlashMemory_vidLock(void);
+
+/**
+ * @brief Program aligned half words, flash must be unlocked
+ * @param u32Address  16 bit aligned absolute address to start programming at
+ * @param pu8Data     data to program
+ * @param u16Len      number of bytes to program (even)
+ * @return FlashMemory_Error_t
+ **/
+static FlashMemory_Error_t FlashMemory_enProgramAligned(uint32_t u32Address, const uint8_t * pu8Data, uint16_t u16Len);
+
+#if FLASH_MEMORY_PROFILE == 1
+/**
+ * @brief Add a call's cycles (since its start count) to its profile
+ * @param psCall     pointer to call's profile
+ * @param u32Start   cycle count at call's start
+ * @return void
+ **/
+static void FlashMemory_vidProfileCall(FlashMemory_Call_Profile_t * psCall, uint32_t u32Start);
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Unlock the flash for a write or erase call, unless a session keeps it unlocked
+ * @return void
+ **/
+static void FlashMemory_vidUnlock(void)
+{
+    if(IS_ZERO(FlashMemory_u8SessionDepth))
+    {
+        HAL_FLASH_Unlock();
+        FLASH_MEMORY_PROFILE_UNLOCK();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 
+/**
+ * @brief Lock the flash after a write or erase call, unless a session keeps it unlocked
+ * @return void
+ **/
+static void FlashMemory_vidLock(void)
+{
+    if(IS_ZERO(FlashMemory_u8SessionDepth))
+    {
+        HAL_FLASH_Lock();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Program aligned half words, flash must be unlocked
+ * @param u32Address  16 bit aligned absolute address to start programming at
+ * @param pu8Data     data to program
+ * @param u16Len      number of bytes to program (even)
+ * @return FlashMemory_Error_t
+ **/
+static FlashMemory_Error_t FlashMemory_enProgramAligned(uint32_t u32Address, const uint8_t * pu8Data, uint16_t u16Len)
+{
+    FlashMemory_Error_t Local_enError = FLASH_MEMORY_ERROR_NONE;
+    uint16_t Local_u16DataIndex;
+    uint16_t Local_u16HalfWord;
+#if FLASH_MEMORY_FAST_PROGRAM == 1
+    uint32_t Local_u32Timeout;
+
+    /*	clear flags left by a previous operation, a set PGERR would fail the 1st half word	*/
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_MEMORY_FLAG_ERRORS);
+
+    SET_BIT(FLASH->CR, FLASH_CR_PG);
+
+    for(Local_u16DataIndex = 0; Local_u16DataIndex < u16Len; Local_u16DataIndex += 2)
+    {
+        Local_u16HalfWord = (uint16_t)pu8Data[Local_u16DataIndex] | ((uint16_t)pu8Data[Local_u16DataIndex + 1] << 8);
+
+        FLASH_MEMORY_PROGRAM_HALFWORD(u32Address + Local_u16DataIndex, Local_u16HalfWord);
+
+        /*	single busy-wait per half word	*/
+        for(Local_u32Timeout = FLASH_MEMORY_PROGRAM_TIMEOUT; __HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY) && !IS_ZERO(Local_u32Timeout); Local_u32Timeout--);
+
+        if(__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY))
+        {
+            Local_enError = FLASH_MEMORY_ERROR_FLASH_TIMEOUT;
+            break;
+        }
+        else if(__HAL_FLASH_GET_FLAG(FLASH_MEMORY_FLAG_ERRORS))
+        {
+            Local_enError = FLASH_MEMORY_ERROR_FLASH_ERROR;
+            break;
+        }
+        else
+        {
+            /*	half word programmed	*/
+        }
+    }
+
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PG);
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_MEMORY_FLAG_ERRORS);
+#else
+    HAL_StatusTypeDef Local_eFlashError;
+
+    for(Local_u16DataIndex = 0; Local_u16DataIndex < u16Len; Local_u16DataIndex += 2)
+    {
+        Local_u16HalfWord = (uint16_t)pu8Data[Local_u16DataIndex] | ((uint16_t)pu8Data[Local_u16DataIndex + 1] << 8);
+
+        Local_eFlashError = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, u32Address + Local_u16DataIndex, Local_u16HalfWord);
+
+        if(Local_eFlashError == HAL_ERROR)
+        {
+            Local_enError = FLASH_MEMORY_ERROR_FLASH_ERROR;
+            break;
+        }
+        else if(Local_eFlashError == HAL_TIMEOUT)
+        {
+            Local_enError = FLASH_MEMORY_ERROR_FLASH_TIMEOUT;
+            break;
+        }
+        else
+        {
+            /*	half word programmed	*/
+        }
+    }
+#endif	/*	FLASH_MEMORY_FAST_PROGRAM	*/
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+#if FLASH_MEMORY_PROFILE == 1
+/**
+ * @brief Add a call's cycles (since its start count) to its profile
+ * @param psCall     pointer to call's profile
+ * @param u32Start   cycle count at call's start
+ * @return void
+ **/
+static void FlashMemory_vidProfileCall(FlashMemory_Call_Profile_t * psCall, uint32_t u32Start)
+{
+    uint32_t Local_u32Cycles = DWT->CYCCNT - u32Start;		/*	wraps correctly	*/
+
+    psCall->calls++;
+    psCall->cycles += Local_u32Cycles;
+    psCall->max_cycles = MAX(psCall->max_cycles, Local_u32Cycles);
+}
+
+/* ------------------------------------------------------------------------- */
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
 FlashMemory_Error_t FlashMemory_enErase(uint8_t u8Block)
 {
     FlashMemory_Error_t Local_enError = FLASH_MEMORY_ERROR_NONE;
     uint32_t Local_u32PageError = 0;
     FLASH_EraseInitTypeDef Local_sFlashErase;
     HAL_StatusTypeDef Local_enEraseError;
+    uint32_t Local_u32Start = 0;
 
     /*	chec if block index is valid	*/
     if(!FLASH_MEMORY_IS_VALID_BLOCK(u8Block))
@@ -43,8 +239,10 @@ FlashMemory_Error_t FlashMemory_enErase(uint8_t u8Block)
     Local_sFlashErase.TypeErase = FLASH_TYPEERASE_PAGES;
     Local_sFlashErase.PageAddress = FLASH_MEMORY_BLOCK_ADDRESS(u8Block);
 
+    FLASH_MEMORY_PROFILE_START(Local_u32Start);
+
     /*	unlock the flash	*/
-    HAL_FLASH_Unlock();
+    FlashMemory_vidUnlock();
 
     /*	erase page	*/
     Local_enEraseError = HAL_FLASHEx_Erase(&Local_sFlashErase, &Local_u32PageError);
@@ -63,8 +261,10 @@ FlashMemory_Error_t FlashMemory_enErase(uint8_t u8Block)
         /*	local_enEraseError = HAL_OK	*/
     }
 
-    /*	unlock the flash	*/
-    HAL_FLASH_Lock();
+    /*	lock the flash	*/
+    FlashMemory_vidLock();
+
+    FLASH_MEMORY_PROFILE_STOP(erase, Local_u32Start);
 
     return Local_enError;
 }
@@ -105,7 +305,7 @@ FlashMemory_Error_t FlashMemory_enWrite(uint32_t u32Offset, const uint8_t * pu8B
     uint16_t Local_u16DataIndex = 0;
     HAL_StatusTypeDef Local_eFlashError;
     uint32_t Local_u32WriteAddress;
-    uint8_t Local_au8TempBuffer[2];
+    uint32_t Local_u32Start = 0;
     struct __alignment_t {
         uint8_t lead_bytes[2];
         uint8_t pad_bytes[2];
@@ -126,7 +326,9 @@ FlashMemory_Error_t FlashMemory_enWrite(uint32_t u32Offset, const uint8_t * pu8B
         return FLASH_MEMORY_ERROR_MEM_BOUNDARY;
     }
 
-    HAL_FLASH_Unlock();
+    FLASH_MEMORY_PROFILE_START(Local_u32Start);
+
+    FlashMemory_vidUnlock();
 
     /*	get write address	*/
     Local_u32WriteAddress = FLASH_MEMORY_OFFSET_TO_ADDRESS(u32Offset);
@@ -183,40 +385,83 @@ FlashMemory_Error_t FlashMemory_enWrite(uint32_t u32Offset, const uint8_t * pu8B
         {
             Local_u32WriteAddress++;
             Local_u16DataIndex++;
-            u16Len--;
         }
     }
 
-    while(Local_u16DataIndex < u16Len)
+    /*	edges are aligned, program the rest	*/
+    if(Local_u16DataIndex < u16Len)
     {
-        Local_au8TempBuffer[0] = pu8Buffer[Local_u16DataIndex++];
-        Local_au8TempBuffer[1] = pu8Buffer[Local_u16DataIndex++];
-
-        Local_eFlashError = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD,
-            Local_u32WriteAddress,
-            *((uint16_t*)Local_au8TempBuffer)
-        );
-
-        if(Local_eFlashError == HAL_ERROR)
-        {
-            Local_enError = FLASH_MEMORY_ERROR_FLASH_ERROR;
-            goto end;
-        }
-        else if(Local_eFlashError == HAL_TIMEOUT)
-        {
-            Local_enError = FLASH_MEMORY_ERROR_FLASH_TIMEOUT;
-            goto end;
-        }
-        else
-        {
-            Local_u32WriteAddress += 2;
-        }
+        Local_enError = FlashMemory_enProgramAligned(Local_u32WriteAddress, &pu8Buffer[Local_u16DataIndex], u16Len - Local_u16DataIndex);
+    }
+    else
+    {
+        /*	do nothing	*/
     }
 
     end:
-    HAL_FLASH_Lock();
+    FlashMemory_vidLock();
+
+    FLASH_MEMORY_PROFILE_STOP(write, Local_u32Start);
 
     return Local_enError;
 }
 
 /* ------------------------------------------------------------------------- */
+
+FlashMemory_Error_t FlashMemory_enBeginSession(void)
+{
+    /*	outermost session unlocks the flash	*/
+    FlashMemory_vidUnlock();
+    FlashMemory_u8SessionDepth++;
+
+    return FLASH_MEMORY_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
+
+FlashMemory_Error_t FlashMemory_enEndSession(void)
+{
+    if(IS_ZERO(FlashMemory_u8SessionDepth))
+    {
+        return FLASH_MEMORY_ERROR_SESSION;
+    }
+
+    FlashMemory_u8SessionDepth--;
+
+    /*	outermost session locks the flash	*/
+    FlashMemory_vidLock();
+
+    return FLASH_MEMORY_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
+
+const uint8_t * FlashMemory_pu8GetBase(void)
+{
+    return (const uint8_t *)FLASH_MEMORY_OFFSET_TO_ADDRESS(FLASH_MEMORY_OFFSET_START);
+}
+
+/* ------------------------------------------------------------------------- */
+
+#if FLASH_MEMORY_PROFILE == 1
+
+void FlashMemory_vidResetProfile(void)
+{
+    memset(&FlashMemory_sProfile, 0x00, sizeof(FlashMemory_sProfile));
+
+    /*	enable cycle counter	*/
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* ------------------------------------------------------------------------- */
+
+const FlashMemory_Profile_t * FlashMemory_psGetProfile(void)
+{
+    return &FlashMemory_sProfile;
+}
+
+/* ------------------------------------------------------------------------- */
+
+#endif	/*	FLASH_MEMORY_PROFILE	*/
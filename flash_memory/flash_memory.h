@@ -22,8 +22,31 @@ typedef enum flash_memory_error_t {
     FLASH_MEMORY_ERROR_FLASH_TIMEOUT,   /**<  Write/erase failed due to timeout	*/
     FLASH_MEMORY_ERROR_INVALID_ADDRESS,	/**<  Address is out of memory range  */
     FLASH_MEMORY_ERROR_MEM_BOUNDARY,    /**<  Read/Write will overflow outside of memory range  */
+    FLASH_MEMORY_ERROR_SESSION,         /**<  Session was ended without being begun  */
 }FlashMemory_Error_t;
 
+#if FLASH_MEMORY_PROFILE == 1
+
+/**
+ * @brief Profile of a flash memory call, in DWT cycles
+ **/
+typedef struct flash_memory_call_profile_t {
+    uint32_t calls;                     /**<  number of calls  */
+    uint64_t cycles;                    /**<  total cycles of all calls  */
+    uint32_t max_cycles;                /**<  cycles of the longest call  */
+}FlashMemory_Call_Profile_t;
+
+/**
+ * @brief Profile of flash memory write & erase calls since last reset
+ **/
+typedef struct flash_memory_profile_t {
+    FlashMemory_Call_Profile_t write;   /**<  FlashMemory_enWrite calls  */
+    FlashMemory_Call_Profile_t erase;   /**<  FlashMemory_enErase calls  */
+    uint32_t unlocks;                   /**<  flash unlocks, by write & erase calls outside a session, and by sessions  */
+}FlashMemory_Profile_t;
+
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
 
 /**
  * @brief Erase the given flash block
@@ -51,5 +74,42 @@ FlashMemory_Error_t FlashMemory_enRead(uint32_t u32Offset, uint8_t * pu8Buffer,
  **/
 FlashMemory_Error_t FlashMemory_enWrite(uint32_t u32Offset, const uint8_t * pu8Buffer, uint16_t u16Len);
 
+/**
+ * @brief Begin a programming session, flash is unlocked once & kept unlocked by write & erase calls
+ *        until the session ends. Sessions may be nested, flash is unlocked by the outermost one
+ * @return FlashMemory_Error_t
+ **/
+FlashMemory_Error_t FlashMemory_enBeginSession(void);
+
+/**
+ * @brief End a programming session, flash is locked by the end of the outermost session
+ * @return FlashMemory_Error_t
+ *         FLASH_MEMORY_ERROR_SESSION : if no session was begun
+ **/
+FlashMemory_Error_t FlashMemory_enEndSession(void);
+
+/**
+ * @brief Get a pointer to offset 0 of the allocated flash pages, flash is memory mapped
+ *        so data can be accessed directly (without copying it using FlashMemory_enRead)
+ * @return pointer to offset 0
+ **/
+const uint8_t * FlashMemory_pu8GetBase(void);
+
+#if FLASH_MEMORY_PROFILE == 1
+
+/**
+ * @brief Clear the write & erase profile, and enable DWT cycle counter
+ * @return void
+ **/
+void FlashMemory_vidResetProfile(void);
+
+/**
+ * @brief Get the write & erase profile since last reset
+ * @return pointer to profile
+ **/
+const FlashMemory_Profile_t * FlashMemory_psGetProfile(void);
+
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
 
 #endif /* __FLASH_H__ */
@@ -34,4 +34,28 @@
 
 /* ------------------------------------------------------------------------- */
 
+/**
+ * @brief Aligned half words programming, directly through FPEC registers (1), or by a HAL_FLASH_Program call per half word (0)
+ * */
+#ifndef FLASH_MEMORY_FAST_PROGRAM
+#define FLASH_MEMORY_FAST_PROGRAM		1
+#endif	/*	FLASH_MEMORY_FAST_PROGRAM	*/
+
+/**
+ * @brief Busy-wait loops before a half word program (direct FPEC programming) times out, a half word takes up to
+ *        70 us, ~1000 loops at 72 MHz
+ * */
+#ifndef FLASH_MEMORY_PROGRAM_TIMEOUT
+#define FLASH_MEMORY_PROGRAM_TIMEOUT	100000UL
+#endif	/*	FLASH_MEMORY_PROGRAM_TIMEOUT	*/
+
+/**
+ * @brief Write & erase calls profiling, by DWT cycle counter (1 : enabled, 0 : disabled)
+ * */
+#ifndef FLASH_MEMORY_PROFILE
+#define FLASH_MEMORY_PROFILE		0
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
+/* ------------------------------------------------------------------------- */
+
 #endif /* __FLASH_CONFIG_H__ */
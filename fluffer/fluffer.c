@@ -44,10 +44,45 @@
 #define FLUFFER_FIRST_BLOCK				0
 
 /**
- * @brief fluffer's main buffer brand
+ * @brief fluffer's main buffer brand, programmed over the copy brand once a clean up's copy is done (a word
+ *        programmed with zeros can be programmed again on memories that program a word only once)
  * */
 #define FLUFFER_MAIN_BUFFER_BRAND		0x00
 
+/**
+ * @brief fluffer's copy brand, a clean up is in progress: entries are being copied into the block
+ * */
+#define FLUFFER_COPY_BUFFER_BRAND		0xF0
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+/**
+ * @brief Blank block sequence number (erased header), sequence numbers wrap around before it
+ * */
+#define FLUFFER_SEQUENCE_BLANK			0xFFFF
+
+/**
+ * @brief Half of sequence numbers range, a sequence number is newer than the ones less than that behind it
+ * */
+#define FLUFFER_SEQUENCE_WINDOW			0x7FFF
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/**
+ * @brief Size of a block header's erase count & sequence number fields (32 bit each, a whole number of
+ *        memory words as word size is at most 4 bytes)
+ * */
+#define FLUFFER_WEAR_FIELD_SIZE			4
+
+/**
+ * @brief Blank erase count or sequence number (erased, or its program was cut by a reset)
+ * */
+#define FLUFFER_WEAR_FIELD_BLANK		0xFFFFFFFFUL
+
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
 /**
  * @brief fluffer's entry mark, marked entries are considered used and not read again
  * */
@@ -60,6 +95,11 @@
 
 /* ------------------------------------------------------------------------------------ */
 
+/**
+ * @brief Get size of an entry's record in memory, entry's data followed by its CRC (FLUFFER_CRC_ENTRY)
+ * */
+#define FLUFFER_RECORD_SIZE(psFluffer)											((psFluffer)->cfg.element_size + FLUFFER_CRC_SIZE)
+
 /**
  * @brief Get start memory address of the given fluffer instance
  * */
@@ -83,12 +123,79 @@
 /**
  * @brief Get absolute memory page index of a relative fluffer page index
  * */
-#define FLUFFER_PAGE_INDEX(psFluffer, u16PageIndex)								((psFluffer)->cfg.start_page + (u16PageIndex))
+#define FLUFFER_PAGE_INDEX(psFluffer, u32PageIndex)								((psFluffer)->cfg.start_page + (u32PageIndex))
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+/**
+ * @brief Get size of a block's header, the block's sequence number (2 bytes) rounded up to a memory word
+ * */
+#define FLUFFER_HEADER_SIZE(psFluffer)											((((psFluffer)->cfg.word_size + 1) / (psFluffer)->cfg.word_size) * (psFluffer)->cfg.word_size)
+
+#elif FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/**
+ * @brief Get size of a block's header: erase count, main buffer brand, then the sequence number of the
+ *        clean up that copied entries into the block
+ * */
+#define FLUFFER_HEADER_SIZE(psFluffer)											(FLUFFER_WEAR_FIELD_SIZE + (psFluffer)->cfg.word_size + FLUFFER_WEAR_FIELD_SIZE)
+
+#else
+
+/**
+ * @brief Get size of a block's header, the main buffer brand
+ * */
+#define FLUFFER_HEADER_SIZE(psFluffer)											((psFluffer)->cfg.word_size)
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+
+#if FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT
+
+/**
+ * @brief Get size of marks region for the given number of entries, a bit per entry rounded up to a memory word
+ * */
+#define FLUFFER_MARKS_SIZE(psFluffer, u32Entries)								((((((uint32_t)(u32Entries) + 7) >> 3) + (psFluffer)->cfg.word_size - 1) / (psFluffer)->cfg.word_size) * (psFluffer)->cfg.word_size)
+
+#else
+
+/**
+ * @brief Get size of marks region for the given number of entries, a memory word per entry
+ * */
+#define FLUFFER_MARKS_SIZE(psFluffer, u32Entries)								((uint32_t)(u32Entries) * (psFluffer)->cfg.word_size)
+
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+
+/**
+ * @brief Get offset of marks region in a block, right after the block's header
+ * */
+#define FLUFFER_MARKS_OFFSET(psFluffer)											FLUFFER_HEADER_SIZE(psFluffer)
+
+/**
+ * @brief Converts an entry ID to an offset, for the given fluffer instance. Entries' data starts after
+ * the marks region, requires the instance's size to be set
+ * */
+#define FLUFFER_ID_TO_OFFSET(psFluffer, u8Id)									(FLUFFER_MARKS_OFFSET(psFluffer) + FLUFFER_MARKS_SIZE(psFluffer, (psFluffer)->context.size) + ((u8Id) * FLUFFER_RECORD_SIZE(psFluffer)))
+
+/**
+ * @brief Get number of bytes in between 2 consecutive entries' data
+ * */
+#define FLUFFER_MARK_GAP(psFluffer)												0
+
+#else
 
 /**
  * @brief Converts an entry ID to an offset, for the given fluffer instance
  * */
-#define FLUFFER_ID_TO_OFFSET(psFluffer, u8Id)									(((u8Id) * ((psFluffer)->cfg.element_size + (psFluffer)->cfg.word_size)) + ((psFluffer)->cfg.word_size * 2))
+#define FLUFFER_ID_TO_OFFSET(psFluffer, u8Id)									(((u8Id) * (FLUFFER_RECORD_SIZE(psFluffer) + (psFluffer)->cfg.word_size)) + FLUFFER_HEADER_SIZE(psFluffer) + (psFluffer)->cfg.word_size)
+
+/**
+ * @brief Get number of bytes in between 2 consecutive entries' data (next entry's mark)
+ * */
+#define FLUFFER_MARK_GAP(psFluffer)												((psFluffer)->cfg.word_size)
+
+#endif	/*	FLUFFER_LAYOUT	*/
 
 /**
  * @brief Get fluffer's block address offset
@@ -110,32 +217,141 @@
  * */
 #define FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, u8Block, u8EntryIndex)		(FLUFFER_BLOCK_ADDRESS(psFluffer, (u8Block)) + FLUFFER_ID_TO_OFFSET(psFluffer, u8EntryIndex))
 
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+/**
+ * @brief Get index of the block that is u32Blocks blocks after the main buffer
+ * */
+#define FLUFFER_RING_BLOCK_ID(psFluffer, u32Blocks)								((uint8_t)(((psFluffer)->context.main_buffer + (u32Blocks)) % (psFluffer)->cfg.blocks))
+
+/**
+ * @brief Get index of the block holding the given entry, entry IDs count from the main buffer's first entry
+ * across the following blocks
+ * */
+#define FLUFFER_ENTRY_BLOCK_ID(psFluffer, u32EntryIndex)						FLUFFER_RING_BLOCK_ID(psFluffer, (u32EntryIndex) / (psFluffer)->context.size)
+
+/**
+ * @brief Get index of the given entry in the block holding it
+ * */
+#define FLUFFER_ENTRY_SLOT(psFluffer, u32EntryIndex)							((Fluffer_Index_t)((u32EntryIndex) % (psFluffer)->context.size))
+
+#else
+
+/**
+ * @brief Get index of the block holding the given entry
+ * */
+#define FLUFFER_ENTRY_BLOCK_ID(psFluffer, u32EntryIndex)						((psFluffer)->context.main_buffer)
+
 /**
- * @brief Get given block entry mark's address
+ * @brief Get index of the given entry in the block holding it
  * */
-#define FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psfluffer, u8block, u8EntryIndex) (FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, u8EntryIndex) - (psFluffer)->cfg.word_size)
+#define FLUFFER_ENTRY_SLOT(psFluffer, u32EntryIndex)							(u32EntryIndex)
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
 
 /**
  * @brief Get given fluffer entry's memory address
  * */
-#define FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, u8EntryIndex)					FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, (psFluffer)->context.main_buffer, u8EntryIndex)
+#define FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, u8EntryIndex)					FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, FLUFFER_ENTRY_BLOCK_ID(psFluffer, u8EntryIndex), FLUFFER_ENTRY_SLOT(psFluffer, u8EntryIndex))
+
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+
+/**
+ * @brief Get address of the given block's marks region
+ * */
+#define FLUFFER_BLOCK_MARKS_ADDRESS(psFluffer, u8BlockIndex)					(FLUFFER_BLOCK_ADDRESS(psFluffer, u8BlockIndex) + FLUFFER_MARKS_OFFSET(psFluffer))
+
+/**
+ * @brief Get address of main buffer's marks region
+ * */
+#define FLUFFER_MARKS_ADDRESS(psFluffer)										FLUFFER_BLOCK_MARKS_ADDRESS(psFluffer, (psFluffer)->context.main_buffer)
+
+#if FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT
+
+/**
+ * @brief gets address of the byte holding an entry's mark bit
+ * */
+#define FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psfluffer, u8EntryIndex)				(FLUFFER_BLOCK_MARKS_ADDRESS(psFluffer, FLUFFER_ENTRY_BLOCK_ID(psFluffer, u8EntryIndex)) + (FLUFFER_ENTRY_SLOT(psFluffer, u8EntryIndex) >> 3))
+
+/**
+ * @brief gets an entry's mark bit, entries are marked starting from the most significant bit
+ * of the block's marks region
+ * */
+#define FLUFFER_ENTRY_MARK_BIT(u8SlotIndex)										((uint8_t)(0x80 >> ((u8SlotIndex) & 0x07)))
+
+#else
+
+/**
+ * @brief gets address of the mark of given block's entry
+ * */
+#define FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u8Block, u32Slot)	(FLUFFER_BLOCK_MARKS_ADDRESS(psFluffer, (u8Block)) + ((u32Slot) * (psFluffer)->cfg.word_size))
+
+/**
+ * @brief gets address of an entry's mark
+ * */
+#define FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psfluffer, u8EntryIndex)				FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, FLUFFER_ENTRY_BLOCK_ID(psFluffer, u8EntryIndex), FLUFFER_ENTRY_SLOT(psFluffer, u8EntryIndex))
+
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+
+#else
+
+/**
+ * @brief gets address of the mark of given block's entry, in front of entry's data
+ * */
+#define FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u8Block, u32Slot)	(FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, (u8Block), (u32Slot)) - (psFluffer)->cfg.word_size)
 
 /**
  * @brief gets address of an entry's mark
  * */
 #define FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psfluffer, u8EntryIndex)				(FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, u8EntryIndex) - (psFluffer)->cfg.word_size)
 
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/**
+ * @brief Get block's erase count address, first in its header so the rest of its first page is blank
+ * once the block's brand is erased
+ * */
+#define FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, u8BlockIndex)					FLUFFER_BLOCK_ADDRESS(psFluffer, u8BlockIndex)
+
+/**
+ * @brief Get buffer's brand address, after the block's erase count
+ * */
+#define FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex)							(FLUFFER_BLOCK_ADDRESS(psFluffer, u8BlockIndex) + FLUFFER_WEAR_FIELD_SIZE)
+
+/**
+ * @brief Get block's sequence number address, after its brand
+ * */
+#define FLUFFER_SEQUENCE_ADDRESS(psFluffer, u8BlockIndex)						(FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex) + (psFluffer)->cfg.word_size)
+
+#else
+
 /**
- * @brief Get buffer's brand address
+ * @brief Get buffer's brand address (block's sequence number address with FLUFFER_BUFFER_RING)
  * */
 #define FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex)							FLUFFER_BLOCK_ADDRESS(psFluffer, u8BlockIndex)
 
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
 /* ------------------------------------------------------------------------------------ */
 
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+
+/**
+ * @brief Get max number of entries fluffer can hold, each entry takes its record & a bit,
+ * a memory word is reserved for rounding up the marks region
+ * */
+#define FLUFFER_MAX_ENTRIES(psFluffer)								((((uint32_t)FLUFFER_BLOCK_SIZE(psFluffer) - FLUFFER_HEADER_SIZE(psFluffer) - (psFluffer)->cfg.word_size) * 8) / ((8 * FLUFFER_RECORD_SIZE(psFluffer)) + 1))
+
+#else
+
 /**
  * @brief Get max number of entries fluffer can hold
  * */
-#define FLUFFER_MAX_ENTRIES(psFluffer)								((FLUFFER_BLOCK_SIZE(psFluffer) - (psFluffer)->cfg.word_size) / ((psFluffer)->cfg.element_size + psFluffer->cfg.word_size))
+#define FLUFFER_MAX_ENTRIES(psFluffer)								((FLUFFER_BLOCK_SIZE(psFluffer) - FLUFFER_HEADER_SIZE(psFluffer)) / (FLUFFER_RECORD_SIZE(psFluffer) + psFluffer->cfg.word_size))
+
+#endif	/*	FLUFFER_LAYOUT	*/
 
 /**
  * @brief check if given block is a main buffer block
@@ -148,10 +364,97 @@
  * */
 #define FLUFFER_IS_EMPTY(psFluffer)								    ((psFluffer)->context.tail == (psFluffer)->context.head)
 
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+/**
+ * @brief Get max number of entries in between head & tail, the block following the tail's block is kept
+ * free to be erased ahead
+ * */
+#define FLUFFER_CAPACITY(psFluffer)									((Fluffer_Index_t)(((psFluffer)->cfg.blocks - 1) * (psFluffer)->context.size))
+
+/**
+ * @brief Get number of entries that can be written before the tail's block is full
+ * */
+#define FLUFFER_BLOCK_ROOM(psFluffer)								((psFluffer)->context.size - FLUFFER_ENTRY_SLOT(psFluffer, (psFluffer)->context.tail))
+
+/**
+ * @brief check if the block holding the last written entry is full, the tail is moved to the next
+ * block by the next write
+ * */
+#define FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer)						(!IS_ZERO((psFluffer)->context.tail) && IS_ZERO(FLUFFER_ENTRY_SLOT(psFluffer, (psFluffer)->context.tail)))
+
+/**
+ * @brief Get position (relative to the main buffer) of the block holding the last written entry
+ * */
+#define FLUFFER_TAIL_BLOCK(psFluffer)								(IS_ZERO((psFluffer)->context.tail) ? 0 : (((psFluffer)->context.tail - 1) / (psFluffer)->context.size))
+
+/**
+ * @brief get index of the block following the block holding the last written entry
+ * */
+#define FLUFFER_NEXT_BLOCK_ID(psFluffer)							FLUFFER_RING_BLOCK_ID(psFluffer, FLUFFER_TAIL_BLOCK(psFluffer) + 1)
+
+/**
+ * @brief Get sequence number u16Count numbers after the given sequence number
+ * */
+#define FLUFFER_SEQUENCE_ADD(u16Sequence, u16Count)					((uint16_t)(((uint32_t)(u16Sequence) + (u16Count)) % FLUFFER_SEQUENCE_BLANK))
+
+/**
+ * @brief Get distance from sequence number u16From to sequence number u16To
+ * */
+#define FLUFFER_SEQUENCE_DISTANCE(u16To, u16From)					((uint16_t)(((uint32_t)(u16To) + FLUFFER_SEQUENCE_BLANK - (u16From)) % FLUFFER_SEQUENCE_BLANK))
+
+/**
+ * @brief check if sequence number u16Sequence is newer than sequence number u16Other
+ * */
+#define FLUFFER_SEQUENCE_IS_NEWER(u16Sequence, u16Other)			(!IS_ZERO(FLUFFER_SEQUENCE_DISTANCE(u16Sequence, u16Other)) && \
+                                                                    (FLUFFER_SEQUENCE_DISTANCE(u16Sequence, u16Other) <= FLUFFER_SEQUENCE_WINDOW))
+
+/**
+ * @brief check if fluffer instance is full, the next write drops the head's block unmarked entries
+ * */
+#define FLUFFER_IS_FULL(psFluffer)								    (((psFluffer)->context.tail == FLUFFER_CAPACITY(psFluffer)) && \
+                                                                    ((psFluffer)->context.head < (psFluffer)->context.size))
+
+#else
+
+/**
+ * @brief Get max number of entries in between head & tail
+ * */
+#define FLUFFER_CAPACITY(psFluffer)									((psFluffer)->context.size)
+
+/**
+ * @brief Get number of entries that can be written before the main buffer is full
+ * */
+#define FLUFFER_BLOCK_ROOM(psFluffer)								((psFluffer)->context.size - (psFluffer)->context.tail)
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/**
+ * @brief get next fluffer block index, the least worn block when it was picked
+ * */
+#define FLUFFER_NEXT_BLOCK_ID(psFluffer)							((psFluffer)->context.next_buffer)
+
+#else
+
+/**
+ * @brief get next fluffer block index
+ * */
+#define FLUFFER_NEXT_BLOCK_ID(psFluffer)							(((psFluffer)->context.main_buffer + 1) % (psFluffer)->cfg.blocks)
+
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+/**
+ * @brief check if the block holding the last written entry is full, never true as the main buffer
+ * is cleaned up by the write that fills it
+ * */
+#define FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer)						(0)
+
 /**
  * @brief check if fluffer instance is full
  * */
-#define FLUFFER_IS_FULL(psFluffer)								    ((psFluffer)->context.tail == (psFluffer)->context.size)
+#define FLUFFER_IS_FULL(psFluffer)								    ((psFluffer)->context.tail == FLUFFER_CAPACITY(psFluffer))
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
 
 /**
  * @brief Get count of entries in the main buffer
@@ -159,12 +462,94 @@
 #define FLUFFER_CURRENT_ENTRIES(psFluffer)						    ((psFluffer)->context.tail - (psFluffer)->context.head)
 
 /**
- * @brief get next fluffer block index
+ * @brief Get number of free entries in the main buffer that starts an incremental clean up
  * */
-#define FLUFFER_NEXT_BLOCK_ID(psFluffer)							(((psFluffer)->context.main_buffer + 1) % (psFluffer)->cfg.blocks)
+#define FLUFFER_CLEANUP_THRESHOLD(psFluffer)						MIN(FLUFFER_CLEANUP_HEADROOM, ((psFluffer)->context.size / 2))
+
+#if FLUFFER_EVICT_MODE == FLUFFER_EVICT_CHUNK
+
+/**
+ * @brief Get minimum number of oldest unmarked entries dropped by a clean up with no room left (migration)
+ * */
+#define FLUFFER_EVICT_ENTRIES(psFluffer)							MAX(((psFluffer)->context.size / FLUFFER_EVICT_CHUNK_DIVISOR), 1)
+
+#else
+
+/**
+ * @brief Get minimum number of oldest unmarked entries dropped by a clean up with no room left (migration)
+ * */
+#define FLUFFER_EVICT_ENTRIES(psFluffer)							(1)
+
+#endif	/*	FLUFFER_EVICT_MODE	*/
 
 /* ------------------------------------------------------------------------------------ */
 
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+
+/**
+ * @brief check if warm context handles are set for the given fluffer instance
+ * */
+#define FLUFFER_HAS_WARM_CONTEXT(psFluffer)							(! (IS_NULLPTR((psFluffer)->handles.load_handle) || \
+                                                                    IS_NULLPTR((psFluffer)->handles.save_handle)) )
+
+#else
+
+/**
+ * @brief warm contexts aren't kept, load & save handles are never called (they may hold garbage)
+ * */
+#define FLUFFER_HAS_WARM_CONTEXT(psFluffer)							(0)
+
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+#if FLUFFER_SESSION_MODE == FLUFFER_SESSION_HANDLES
+
+/**
+ * @brief check if given session handle (begin or end) is set
+ * */
+#define FLUFFER_HAS_SESSION_HANDLE(pfHandle)						(!IS_NULLPTR(pfHandle))
+
+#else
+
+/**
+ * @brief programming sessions aren't used, begin & end handles are never called (they may hold garbage)
+ * */
+#define FLUFFER_HAS_SESSION_HANDLE(pfHandle)						(0)
+
+#endif	/*	FLUFFER_SESSION_MODE	*/
+
+#if FLUFFER_ERASE_MODE == FLUFFER_ERASE_ASYNC
+
+/**
+ * @brief check if fluffer instance has a poll handle (asynchronous erase handle)
+ * */
+#define FLUFFER_HAS_POLL_HANDLE(psFluffer)							(!IS_NULLPTR((psFluffer)->handles.poll_handle))
+
+#else
+
+/**
+ * @brief erases are synchronous, poll handle is never called (it may hold garbage)
+ * */
+#define FLUFFER_HAS_POLL_HANDLE(psFluffer)							(0)
+
+#endif	/*	FLUFFER_ERASE_MODE	*/
+
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+
+/**
+ * @brief check if a write-back cache is set for the given fluffer instance
+ * */
+#define FLUFFER_HAS_CACHE(psFluffer)								(! (IS_NULLPTR((psFluffer)->cache.buffer) || \
+                                                                    IS_ZERO((psFluffer)->cache.capacity)) )
+
+/**
+ * @brief Get number of cached entries that triggers a write (max_dirty, capacity if it's 0 or larger)
+ * */
+#define FLUFFER_CACHE_LIMIT(psFluffer)								((IS_ZERO((psFluffer)->cache.max_dirty) || \
+                                                                    ((psFluffer)->cache.max_dirty > (psFluffer)->cache.capacity)) ? \
+                                                                    (psFluffer)->cache.capacity : (psFluffer)->cache.max_dirty)
+
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
 /**
  * @brief Checks for null pointer for a given fluffer instance
  * */
@@ -172,6 +557,47 @@
                                                                     IS_NULLPTR((psFluffer)->handles.write_handle) || \
                                                                     IS_NULLPTR((psFluffer)->handles.erase_handle)) )
 
+#if FLUFFER_WORKSPACE_MODE == FLUFFER_WORKSPACE_INSTANCE
+
+/**
+ * @brief Get size of the instance's entry buffer, at the workspace's start
+ * */
+#define FLUFFER_ENTRY_BUFFER_SIZE(psFluffer)						((uint16_t)(FLUFFER_RECORD_SIZE(psFluffer) + (psFluffer)->cfg.word_size))
+
+/**
+ * @brief Get instance's temporary buffer to read an entry (or a mark, brand, sequence) into
+ * */
+#define FLUFFER_ENTRY_BUFFER(psFluffer)								((psFluffer)->workspace.buffer)
+
+/**
+ * @brief Get instance's temporary buffer to lay out runs of entries & marks, after the entry buffer
+ * */
+#define FLUFFER_RUN_BUFFER(psFluffer)								(&(psFluffer)->workspace.buffer[FLUFFER_ENTRY_BUFFER_SIZE(psFluffer)])
+
+/**
+ * @brief Get size of the instance's run buffer, a multiple of the memory word size
+ * */
+#define FLUFFER_RUN_SIZE(psFluffer)									((uint16_t)((((psFluffer)->workspace.size - FLUFFER_ENTRY_BUFFER_SIZE(psFluffer)) / (psFluffer)->cfg.word_size) * (psFluffer)->cfg.word_size))
+
+#else
+
+/**
+ * @brief Get instance's temporary buffer to read an entry (or a mark, brand, sequence) into
+ * */
+#define FLUFFER_ENTRY_BUFFER(psFluffer)								(Fluffer_au8EntryBuffer)
+
+/**
+ * @brief Get instance's temporary buffer to lay out runs of entries & marks
+ * */
+#define FLUFFER_RUN_BUFFER(psFluffer)								(Fluffer_au8RunBuffer)
+
+/**
+ * @brief Get size of the instance's run buffer
+ * */
+#define FLUFFER_RUN_SIZE(psFluffer)									(FLUFFER_WRITE_RUN_SIZE)
+
+#endif	/*	FLUFFER_WORKSPACE_MODE	*/
+
 /** checks fluffer instance configurations
  * @brief
  * */
@@ -190,9 +616,9 @@
  * describes the entries to be transfered from one block to another.
  * */
 typedef struct fluffer_transfer_t {
-    uint16_t size;				/**<  transfer size  */
-    uint16_t src_id;            /**<  source block entry id (start from here)  */
-    uint16_t dst_id;            /**<  destination block entry id (write here)  */
+    Fluffer_Index_t size;		/**<  transfer size  */
+    Fluffer_Index_t src_id;     /**<  source block entry id (start from here)  */
+    Fluffer_Index_t dst_id;     /**<  destination block entry id (write here)  */
     uint8_t  src_block;      	/**<  source block id  */
     uint8_t  dst_block;         /**<  destination block id  */
 }Fluffer_Transfer_t;
@@ -211,61 +637,335 @@ typedef struct fluffer_transfer_t {
  * */
 static uint8_t Fluffer_u8IsFilled(const uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Preset);
 
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+
 /**
- * @brief  Brand fluffer instance's given block as a main buffer
+ * @brief  Calculate CRC-32 of an entry's data, by the instance's CRC handle if set. Otherwise by software,
+ *         matching the STM32 CRC unit: polynomial 0x04C11DB7, initial value 0xFFFFFFFF, data fed as
+ *         little endian 32-bit words, the last word padded with zeros
  * @param  psFluffer
- * @param  u8BlockIndex
- * @return void
+ * @param  pu8Data entry's data (element_size bytes)
+ * @return entry's CRC
  * */
-static void Fluffer_vidBrandBlock(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+static uint32_t Fluffer_u32Crc(const Fluffer_t * const psFluffer, const uint8_t * pu8Data);
 
 /**
- * @brief  Check if given entry is marked
+ * @brief  Put CRC of an entry's data right after it (little endian), making up the entry's record
  * @param  psFluffer
- * @param  u16entryId
- * @return 1 if entry is marked, 0 otherwise
+ * @param  pu8Record entry's record, data followed by room for its CRC
+ * @return void
  * */
-static uint8_t Fluffer_u8EntryIsMarked(const Fluffer_t * const psFluffer, uint16_t u16EntryId);
+static void Fluffer_vidPutCrc(const Fluffer_t * const psFluffer, uint8_t * const pu8Record);
 
 /**
- * @brief  Check if given entry is unmarked and is empty
+ * @brief  Check an entry's record, its data against the CRC following it
  * @param  psFluffer
- * @param  u16entryId
- * @return 1 if entry is unmarked & is empty, 0 otherwise
+ * @param  pu8Record entry's record, data followed by its CRC
+ * @return 1 if CRC matches entry's data, 0 otherwise
  * */
-static uint8_t Fluffer_u8EntryIsEmpty(const Fluffer_t * const psFluffer, uint16_t u16EntryId);
+static uint8_t Fluffer_u8RecordIsValid(const Fluffer_t * const psFluffer, const uint8_t * pu8Record);
 
 /**
- * @brief  Find the index of the first unmarked entry in the main buffer of the given
- *         fluffer instance
+ * @brief  Read given entry's record into the entry buffer, and check it
  * @param  psFluffer
- * @return index of fluffer's head
+ * @param  u32EntryId
+ * @return 1 if entry's CRC matches its data, 0 otherwise
  * */
-static uint16_t Fluffer_u16FindHead(const Fluffer_t * const psFluffer);
+static uint8_t Fluffer_u8EntryIsValid(const Fluffer_t * const psFluffer, uint32_t u32EntryId);
+
+#endif	/*	FLUFFER_CRC_MODE	*/
 
 /**
- * @brief  Find the first empty entry's index in the main buffer of the given fluffer instance
- * @param  psFluffer
- * @return Index of fluffer's tail
+ * @brief   Begin a programming session, if fluffer instance has a begin handle. Write & erase handle calls
+ *          up to Fluffer_vidEndSession share a single memory unlock
+ * @param   psFluffer
+ * @return  void
  * */
-static uint16_t Fluffer_u16FindTail(const Fluffer_t * const psFluffer);
+static void Fluffer_vidBeginSession(const Fluffer_t * const psFluffer);
 
 /**
- * @brief  Searches for blocks marked as main buffer, returns their count and
+ * @brief   End a programming session, if fluffer instance has an end handle
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidEndSession(const Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Check if an erase started by an asynchronous erase handle is still in progress
+ * @param   psFluffer
+ * @return  1 if the memory is busy, 0 if it's ready, fluffer instance has no poll handle or erases are
+ *          synchronous (FLUFFER_ERASE_SYNC)
+ * */
+static uint8_t Fluffer_u8IsBusy(const Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Wait for an erase started by an asynchronous erase handle to finish, if fluffer instance
+ *          has a poll handle
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidWaitReady(const Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Erase a memory page, and wait for the erase to finish
+ * @param   psFluffer
+ * @param   u32PageIndex absolute memory page index
+ * @return  void
+ * */
+static void Fluffer_vidErase(const Fluffer_t * const psFluffer, uint32_t u32PageIndex);
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/**
+ * @brief  Brand fluffer instance's given block as a main buffer, or as the block entries are copied into
+ *         (given the sequence number following the main buffer's with FLUFFER_WEAR_LEVEL)
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
+ * @return void
+ * */
+static void Fluffer_vidBrandBlock(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint8_t u8Brand);
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/**
+ * @brief  Check if given entry is marked
+ * @param  psFluffer
+ * @param  u32EntryId
+ * @return 1 if entry is marked, 0 otherwise
+ * */
+static uint8_t Fluffer_u8EntryIsMarked(const Fluffer_t * const psFluffer, uint32_t u32EntryId);
+
+/**
+ * @brief  Check if given entry is unmarked and is empty
+ * @param  psFluffer
+ * @param  u32EntryId
+ * @return 1 if entry is unmarked & is empty, 0 otherwise
+ * */
+static uint8_t Fluffer_u8EntryIsEmpty(const Fluffer_t * const psFluffer, uint32_t u32EntryId);
+
+/**
+ * @brief  Get given entry's state, from its mark
+ * @param  psFluffer
+ * @param  u32EntryId
+ * @return entry's state (FLUFFER_ENTRY_STATE_WRITTEN .. FLUFFER_ENTRY_STATE_MARKED)
+ * */
+static uint8_t Fluffer_u8ReadState(const Fluffer_t * const psFluffer, uint32_t u32EntryId);
+
+#if FLUFFER_MARK_STATES > 2
+
+/**
+ * @brief  Write an intermediate state to the mark at the given address, only bits cleared by the state
+ *         are programmed (mark's first byte), the rest of the mark is left erased
+ * @param  psFluffer
+ * @param  u32MarkAddress mark's address
+ * @param  u8State intermediate state (1 .. FLUFFER_MARK_STATES - 2)
+ * @return void
+ * */
+static void Fluffer_vidWriteState(const Fluffer_t * const psFluffer, uint32_t u32MarkAddress, uint8_t u8State);
+
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/**
+ * @brief  Find the index of the first unmarked entry in the main buffer of the given
+ *         fluffer instance
+ * @param  psFluffer
+ * @return index of fluffer's head
+ * */
+static uint32_t Fluffer_u32FindHead(const Fluffer_t * const psFluffer);
+
+/**
+ * @brief  Find the first empty entry's index in the main buffer of the given fluffer instance
+ * @param  psFluffer
+ * @return Index of fluffer's tail, or fluffer's size if main buffer is full
+ * */
+static uint32_t Fluffer_u32FindTail(const Fluffer_t * const psFluffer);
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if (FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT) || (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING)
+
+/**
+ * @brief  Binary search for the first empty entry's index in the main buffer of the given
+ *         fluffer instance, assuming written entries are a prefix of the main buffer
+ * @param  psFluffer
+ * @param  u32End index of the entry following the last entry searched
+ * @return Index of fluffer's tail, or u32End if no empty entry was found
+ * */
+static uint32_t Fluffer_u32BisectTail(const Fluffer_t * const psFluffer, uint32_t u32End);
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED) || (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING)
+
+/**
+ * @brief  Binary search for the index of the first unmarked entry in the main buffer of the given
+ *         fluffer instance, assuming marked entries are a prefix of the written entries
+ * @param  psFluffer
+ * @param  u32Tail index of fluffer's tail, upper limit of the search
+ * @return index of fluffer's head
+ * */
+static uint32_t Fluffer_u32BisectHead(const Fluffer_t * const psFluffer, uint32_t u32Tail);
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+#if FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT
+
+/**
+ * @brief  Spot check head & tail found by binary search against the main buffer
+ * @param  psFluffer
+ * @param  u32Head
+ * @param  u32Tail
+ * @return 1 if head & tail are consistent with the main buffer, 0 otherwise
+ * */
+static uint8_t Fluffer_u8BoundsAreValid(const Fluffer_t * const psFluffer, uint32_t u32Head, uint32_t u32Tail);
+
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+/**
+ * @brief  Searches for blocks with the given brand, returns their count and
  *         the index of the last block.
  * @param  psFluffer
  * @param  pu8BlockIndex
- * @return Index of main buffer's block
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
+ * @return Number of blocks with the given brand
+ * */
+static uint8_t Fluffer_u8GetBrandedBlocks(const Fluffer_t * const psFluffer, uint8_t * const pu8BlockIndex, uint8_t u8Brand);
+
+/**
+ * @brief  Check if given block is branded with the given brand
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
+ * @return 1 if the block has the given brand, 0 otherwise
+ * */
+static uint8_t Fluffer_u8IsBranded(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint8_t u8Brand);
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/**
+ * @brief  Read a 32 bit field of a block's header (erase count or sequence number)
+ * @param  psFluffer
+ * @param  u32Address field's address
+ * @return field's value, FLUFFER_WEAR_FIELD_BLANK if it's blank
+ * */
+static uint32_t Fluffer_u32ReadWearField(const Fluffer_t * const psFluffer, uint32_t u32Address);
+
+/**
+ * @brief  Write a 32 bit field of a block's header (erase count or sequence number), the field must be blank
+ * @param  psFluffer
+ * @param  u32Address field's address
+ * @param  u32Value
+ * @return void
+ * */
+static void Fluffer_vidWriteWearField(const Fluffer_t * const psFluffer, uint32_t u32Address, uint32_t u32Value);
+
+/**
+ * @brief  Get given block's erase count once its first page is erased: its erase count + 1, or the
+ *         highest erase count of all blocks if its erase count was lost (0 if all were lost)
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return block's new erase count
+ * */
+static uint32_t Fluffer_u32NextEraseCount(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+
+/**
+ * @brief  Erase given block's first page (holding its header), and wait for the erase to finish. The
+ *         block's erase count is read before the erase, and programmed back incremented after it
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return void
+ * */
+static void Fluffer_vidEraseHeaderPage(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+
+/**
+ * @brief  Prepare given block's first page to be erased ahead, the page is erased only if it's not
+ *         blank but for the block's erase count. With a poll handle, the erase is left running: the
+ *         erase count is kept by the clean up state until Fluffer_vidRestoreEraseCount. A lost erase
+ *         count is programmed again
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return void
+ * */
+static void Fluffer_vidPrepareHeaderPage(Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+
+/**
+ * @brief  Program back the erase count of the block whose first page was erased by the clean up, once
+ *         the erase is done (nothing is done if no erase count is pending)
+ * @param  psFluffer
+ * @return void
+ * */
+static void Fluffer_vidRestoreEraseCount(Fluffer_t * const psFluffer);
+
+/**
+ * @brief  Pick the block the next clean up copies entries into: a block left branded as copy (a clean up
+ *         cut by a reset), so it's erased ahead first, otherwise the least worn block. Blocks are checked
+ *         in order from the one following the main buffer, so blocks with equal erase counts are used in turn
+ * @param  psFluffer
+ * @return void
+ * */
+static void Fluffer_vidPickNextBlock(Fluffer_t * const psFluffer);
+
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+#else
+
+/**
+ * @brief  Read given block's sequence number
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  pu16Sequence pointer to a uint16_t variable, to store block's sequence number in it
+ * @return 1 if the block is in use (its sequence number is written), 0 otherwise
  * */
-static uint8_t Fluffer_u8GetMainBufferBlocks(const Fluffer_t * const psFluffer, uint8_t * const pu8BlockIndex);
+static uint8_t Fluffer_u8ReadSequence(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint16_t * const pu16Sequence);
 
 /**
- * @brief  Check if given block is branded as a main buffer
+ * @brief  Write given block's sequence number, the block must be erased
  * @param  psFluffer
  * @param  u8BlockIndex
- * @return 1 if the block is a main buffer, 0 otherwise
+ * @param  u16Sequence
+ * @return void
+ * */
+static void Fluffer_vidWriteSequence(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint16_t u16Sequence);
+
+/**
+ * @brief   Find main buffer, head & tail of a ring
+ * @details Blocks in use are chained by their sequence numbers, the chain is followed back from the
+ *          block with the newest sequence number (tail's block) for up to (blocks - 1) blocks, older
+ *          blocks are left to be erased ahead. Entries are written & marked in order across the
+ *          chain, so head & tail are found by binary search. The memory is prepared for first time
+ *          use if no block is in use.
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidMountRing(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Release main buffer blocks with all entries marked, the block following the main buffer
+ *          becomes the main buffer. Released blocks are erased ahead when the tail gets to them.
+ *          The block holding the last written entry is kept, even if all its entries are marked
+ * @param   psFluffer
+ * @return  void
  * */
-static uint8_t Fluffer_u8IsMainBuffer(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+static void Fluffer_vidReleaseBlocks(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Move the tail into the next block, called by the write that finds the block holding the
+ *          last written entry full
+ * @details Blocks with all entries marked are released first. If the block following the new tail's
+ *          block is the main buffer, the main buffer's entries are dropped (migration), so a block is
+ *          always free to be erased ahead. The new tail's block is then erased (pages that weren't
+ *          erased ahead) and given the next sequence number.
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidAdvanceBlock(Fluffer_t * const psFluffer);
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
 
 /**
  * @brief   Prepares fluffer instance's allocated memory blocks for first time use
@@ -276,6 +976,8 @@ static uint8_t Fluffer_u8IsMainBuffer(const Fluffer_t * const psFluffer, uint8_t
  * */
 static void Fluffer_vidPrepareFluffer(Fluffer_t * const psFluffer);
 
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
 /**
  * @brief  Copies unmarked entries from source block, into the destination block starting from the given entry ID
  * @param
@@ -286,24 +988,269 @@ static void Fluffer_vidPrepareFluffer(Fluffer_t * const psFluffer);
  * */
 static void Fluffer_vidCopyEntries(const Fluffer_t * const psFluffer, const Fluffer_Transfer_t * const psTransfer);
 
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/**
+ * @brief  Calculate warm context checksum (fletcher-16, sums start from 0xFF so erased/zeroed
+ *         memory doesn't pass)
+ * @param  psWarmContext
+ * @return checksum of warm context's bytes, except for the checksum itself
+ * */
+static uint16_t Fluffer_u16WarmContextChecksum(const Fluffer_Warm_Context_t * const psWarmContext);
+
+/**
+ * @brief  Write consecutive entries to the main buffer starting from tail, with a single write
+ *         handle call. Entries are laid out in the run buffer, each followed by its CRC (FLUFFER_CRC_ENTRY),
+ *         with unmarked marks between them (interleaved layout only).
+ * @param  psFluffer
+ * @param  pu8Data entries data, packed (element_size bytes each)
+ * @param  u16Count number of entries, must fit in main buffer & run buffer
+ * @return void
+ * */
+static void Fluffer_vidWriteRun(Fluffer_t * const psFluffer, const uint8_t * pu8Data, uint16_t u16Count);
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED) || (FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY)
+
+/**
+ * @brief   Pack consecutive entries read as a single run, in place
+ * @details A run holds entries' data with a mark word (interleaved layout) and the entry's CRC
+ * 			(FLUFFER_CRC_ENTRY) in between each 2 entries, data of each entry is moved back over
+ * 			the marks & CRCs before it, so entries are packed at the run's start
+ * @param   psFluffer
+ * @param   pu8Run pointer to run, its 1st byte is the 1st entry's data
+ * @param   u16Count number of entries in the run
+ * @return  void
+ * */
+static void Fluffer_vidPackRun(const Fluffer_t * const psFluffer, uint8_t * const pu8Run, uint16_t u16Count);
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+/**
+ * @brief  Mark consecutive entries of the main buffer, in order
+ * @details Interleaved layout: a write handle call per mark, as marks are separated by entries' data.
+ * 			Bitmap layout: marks are adjacent, so they're written with a single write handle call (per
+ * 			run buffer size)
+ * @param  psFluffer
+ * @param  u32First index of first entry to be marked, must be fluffer's head
+ * @param  u32Count number of entries to mark, all in the same block
+ * @return void
+ * */
+static void Fluffer_vidWriteMarks(const Fluffer_t * const psFluffer, uint32_t u32First, uint32_t u32Count);
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT) && (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY)
+
+/**
+ * @brief  Count leading zero bits of a byte (marked entries in a marks byte)
+ * @param  u8Byte
+ * @return number of leading zero bits (0 .. 8)
+ * */
+static uint8_t Fluffer_u8CountLeadingZeros(uint8_t u8Byte);
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+/**
+ * @brief  Load warm context using the instance's load handle and validate its checksum
+ * @param  psFluffer
+ * @param  psWarmContext
+ * @return 1 if a valid warm context was loaded, 0 otherwise
+ * */
+static uint8_t Fluffer_u8LoadWarmContext(const Fluffer_t * const psFluffer, Fluffer_Warm_Context_t * const psWarmContext);
+
+/**
+ * @brief   Restore fluffer instance's context from a saved warm context
+ * @details The saved context is trusted after a spot check of the main buffer's brand, the entries
+ *          around the head (last marked, first unmarked) and around the tail (last written, first empty)
+ * @param   psFluffer
+ * @return  1 if context was restored, 0 otherwise
+ * */
+static uint8_t Fluffer_u8RestoreContext(Fluffer_t * const psFluffer);
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
 /**
  * @brief   Clean up fluffer instance
- * @details Copy all unmarked entries from the current main buffer to the next secondary buffer
- * 			then erase the current main buffer, finally set secondary buffer as main buffer
+ * @details Brand the next secondary buffer as the block entries are copied into, copy all unmarked
+ * 			entries from the current main buffer to it, then erase the current main buffer's brand,
+ * 			finally brand secondary buffer as main buffer. A reset at any step leaves either the old main
+ * 			buffer, or the copy with all entries as the only branded main buffer.
+ * 			If marked entries are less than the required free entries, the oldest unmarked
+ * 			entries are dropped as well (migration), so at least FLUFFER_EVICT_ENTRIES are free
+ * @param   psFluffer
+ * @param   u32Reserve number of free entries required after clean up (1 .. main buffer size)
+ * @return  void
+ * */
+static void Fluffer_vidCleanUp(Fluffer_t * const psFluffer, uint32_t u32Reserve);
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/**
+ * @brief   Check if given memory page is blank (all bytes are clean)
+ * @param   psFluffer
+ * @param   u32PageIndex absolute memory page index
+ * @param   u16Offset bytes at the page's start left out of the check
+ * @return  1 if page is blank, 0 otherwise
+ * */
+static uint8_t Fluffer_u8PageIsBlank(const Fluffer_t * const psFluffer, uint32_t u32PageIndex, uint16_t u16Offset);
+
+/**
+ * @brief   Schedule preparation of the block following the main buffer (the block the tail moves to
+ *          next with FLUFFER_BUFFER_RING), entries are written into it next, so it must be erased
+ * @param   psFluffer
+ * @param   u8BlockIndex block to be prepared
+ * @return  void
+ * */
+static void Fluffer_vidScheduleErase(Fluffer_t * const psFluffer, uint8_t u8BlockIndex);
+
+/**
+ * @brief   Prepare the next page of the block following the main buffer, the page is erased
+ *          only if it's not blank
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidErasePage(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Prepare all remaining pages of the block following the main buffer
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidEraseNextBlock(Fluffer_t * const psFluffer);
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+
+/**
+ * @brief   Start an incremental clean up if free entries in the main buffer dropped to the clean up
+ *          threshold, and no clean up is in progress
+ * @details Entries are copied starting from head. If no entry is marked, the oldest FLUFFER_EVICT_ENTRIES
+ *          entries are dropped (migration), so the new main buffer is never full
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidStartCleanUp(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Do a single slice of fluffer instance's pending clean up: copy up to
+ *          FLUFFER_CLEANUP_COPY_ENTRIES entries (then switch main buffer if all entries
+ *          are copied), brand the new main buffer, or erase a page
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidCleanUpSlice(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Set the block entries were copied into as main buffer, once all entries are copied
+ * @details Entries marked during the copy are marked in the new main buffer, then the old main
+ *          buffer's first page (holding its brand) is erased. The new main buffer is branded by
+ *          the next slice, once the erase is done
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidSwitchMainBuffer(Fluffer_t * const psFluffer);
+
+/**
+ * @brief   Do all remaining slices of fluffer instance's pending clean up
  * @param   psFluffer
  * @return  void
  * */
-static void Fluffer_vidCleanUp(Fluffer_t * const psFluffer);
+static void Fluffer_vidFinishCleanUp(Fluffer_t * const psFluffer);
+
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
 
 /* ------------------------------------------------------------------------------------ */
 
+#if FLUFFER_WORKSPACE_MODE == FLUFFER_WORKSPACE_SHARED
+
 /**
  * @brief Temporary buffer to read entries into during tail search, clean up
  * and migrating entries
  *
  * @see FLUFFER_MAX_ELEMENT_SIZE
  * */
-static uint8_t Fluffer_au8EntryBuffer[FLUFFER_MAX_MEMORY_WORD_SIZE + FLUFFER_MAX_ELEMENT_SIZE];
+static uint8_t Fluffer_au8EntryBuffer[FLUFFER_MAX_MEMORY_WORD_SIZE + FLUFFER_MAX_ELEMENT_SIZE + FLUFFER_CRC_SIZE];
+
+/**
+ * @brief Temporary buffer to lay out consecutive entries (entries data & unmarked marks
+ * in between) written by a single write handle call
+ *
+ * @see FLUFFER_WRITE_RUN_SIZE
+ * */
+static uint8_t Fluffer_au8RunBuffer[FLUFFER_WRITE_RUN_SIZE];
+
+#endif	/*	FLUFFER_WORKSPACE_MODE	*/
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+
+/**
+ * @brief CRC-32 (polynomial 0x04C11DB7, MSB first) of each byte value, software CRC
+ * */
+static const uint32_t Fluffer_au32CrcTable[256] = {
+    0x00000000UL, 0x04C11DB7UL, 0x09823B6EUL, 0x0D4326D9UL,
+    0x130476DCUL, 0x17C56B6BUL, 0x1A864DB2UL, 0x1E475005UL,
+    0x2608EDB8UL, 0x22C9F00FUL, 0x2F8AD6D6UL, 0x2B4BCB61UL,
+    0x350C9B64UL, 0x31CD86D3UL, 0x3C8EA00AUL, 0x384FBDBDUL,
+    0x4C11DB70UL, 0x48D0C6C7UL, 0x4593E01EUL, 0x4152FDA9UL,
+    0x5F15ADACUL, 0x5BD4B01BUL, 0x569796C2UL, 0x52568B75UL,
+    0x6A1936C8UL, 0x6ED82B7FUL, 0x639B0DA6UL, 0x675A1011UL,
+    0x791D4014UL, 0x7DDC5DA3UL, 0x709F7B7AUL, 0x745E66CDUL,
+    0x9823B6E0UL, 0x9CE2AB57UL, 0x91A18D8EUL, 0x95609039UL,
+    0x8B27C03CUL, 0x8FE6DD8BUL, 0x82A5FB52UL, 0x8664E6E5UL,
+    0xBE2B5B58UL, 0xBAEA46EFUL, 0xB7A96036UL, 0xB3687D81UL,
+    0xAD2F2D84UL, 0xA9EE3033UL, 0xA4AD16EAUL, 0xA06C0B5DUL,
+    0xD4326D90UL, 0xD0F37027UL, 0xDDB056FEUL, 0xD9714B49UL,
+    0xC7361B4CUL, 0xC3F706FBUL, 0xCEB42022UL, 0xCA753D95UL,
+    0xF23A8028UL, 0xF6FB9D9FUL, 0xFBB8BB46UL, 0xFF79A6F1UL,
+    0xE13EF6F4UL, 0xE5FFEB43UL, 0xE8BCCD9AUL, 0xEC7DD02DUL,
+    0x34867077UL, 0x30476DC0UL, 0x3D044B19UL, 0x39C556AEUL,
+    0x278206ABUL, 0x23431B1CUL, 0x2E003DC5UL, 0x2AC12072UL,
+    0x128E9DCFUL, 0x164F8078UL, 0x1B0CA6A1UL, 0x1FCDBB16UL,
+    0x018AEB13UL, 0x054BF6A4UL, 0x0808D07DUL, 0x0CC9CDCAUL,
+    0x7897AB07UL, 0x7C56B6B0UL, 0x71159069UL, 0x75D48DDEUL,
+    0x6B93DDDBUL, 0x6F52C06CUL, 0x6211E6B5UL, 0x66D0FB02UL,
+    0x5E9F46BFUL, 0x5A5E5B08UL, 0x571D7DD1UL, 0x53DC6066UL,
+    0x4D9B3063UL, 0x495A2DD4UL, 0x44190B0DUL, 0x40D816BAUL,
+    0xACA5C697UL, 0xA864DB20UL, 0xA527FDF9UL, 0xA1E6E04EUL,
+    0xBFA1B04BUL, 0xBB60ADFCUL, 0xB6238B25UL, 0xB2E29692UL,
+    0x8AAD2B2FUL, 0x8E6C3698UL, 0x832F1041UL, 0x87EE0DF6UL,
+    0x99A95DF3UL, 0x9D684044UL, 0x902B669DUL, 0x94EA7B2AUL,
+    0xE0B41DE7UL, 0xE4750050UL, 0xE9362689UL, 0xEDF73B3EUL,
+    0xF3B06B3BUL, 0xF771768CUL, 0xFA325055UL, 0xFEF34DE2UL,
+    0xC6BCF05FUL, 0xC27DEDE8UL, 0xCF3ECB31UL, 0xCBFFD686UL,
+    0xD5B88683UL, 0xD1799B34UL, 0xDC3ABDEDUL, 0xD8FBA05AUL,
+    0x690CE0EEUL, 0x6DCDFD59UL, 0x608EDB80UL, 0x644FC637UL,
+    0x7A089632UL, 0x7EC98B85UL, 0x738AAD5CUL, 0x774BB0EBUL,
+    0x4F040D56UL, 0x4BC510E1UL, 0x46863638UL, 0x42472B8FUL,
+    0x5C007B8AUL, 0x58C1663DUL, 0x558240E4UL, 0x51435D53UL,
+    0x251D3B9EUL, 0x21DC2629UL, 0x2C9F00F0UL, 0x285E1D47UL,
+    0x36194D42UL, 0x32D850F5UL, 0x3F9B762CUL, 0x3B5A6B9BUL,
+    0x0315D626UL, 0x07D4CB91UL, 0x0A97ED48UL, 0x0E56F0FFUL,
+    0x1011A0FAUL, 0x14D0BD4DUL, 0x19939B94UL, 0x1D528623UL,
+    0xF12F560EUL, 0xF5EE4BB9UL, 0xF8AD6D60UL, 0xFC6C70D7UL,
+    0xE22B20D2UL, 0xE6EA3D65UL, 0xEBA91BBCUL, 0xEF68060BUL,
+    0xD727BBB6UL, 0xD3E6A601UL, 0xDEA580D8UL, 0xDA649D6FUL,
+    0xC423CD6AUL, 0xC0E2D0DDUL, 0xCDA1F604UL, 0xC960EBB3UL,
+    0xBD3E8D7EUL, 0xB9FF90C9UL, 0xB4BCB610UL, 0xB07DABA7UL,
+    0xAE3AFBA2UL, 0xAAFBE615UL, 0xA7B8C0CCUL, 0xA379DD7BUL,
+    0x9B3660C6UL, 0x9FF77D71UL, 0x92B45BA8UL, 0x9675461FUL,
+    0x8832161AUL, 0x8CF30BADUL, 0x81B02D74UL, 0x857130C3UL,
+    0x5D8A9099UL, 0x594B8D2EUL, 0x5408ABF7UL, 0x50C9B640UL,
+    0x4E8EE645UL, 0x4A4FFBF2UL, 0x470CDD2BUL, 0x43CDC09CUL,
+    0x7B827D21UL, 0x7F436096UL, 0x7200464FUL, 0x76C15BF8UL,
+    0x68860BFDUL, 0x6C47164AUL, 0x61043093UL, 0x65C52D24UL,
+    0x119B4BE9UL, 0x155A565EUL, 0x18197087UL, 0x1CD86D30UL,
+    0x029F3D35UL, 0x065E2082UL, 0x0B1D065BUL, 0x0FDC1BECUL,
+    0x3793A651UL, 0x3352BBE6UL, 0x3E119D3FUL, 0x3AD08088UL,
+    0x2497D08DUL, 0x2056CD3AUL, 0x2D15EBE3UL, 0x29D4F654UL,
+    0xC5A92679UL, 0xC1683BCEUL, 0xCC2B1D17UL, 0xC8EA00A0UL,
+    0xD6AD50A5UL, 0xD26C4D12UL, 0xDF2F6BCBUL, 0xDBEE767CUL,
+    0xE3A1CBC1UL, 0xE760D676UL, 0xEA23F0AFUL, 0xEEE2ED18UL,
+    0xF0A5BD1DUL, 0xF464A0AAUL, 0xF9278673UL, 0xFDE69BC4UL,
+    0x89B8FD09UL, 0x8D79E0BEUL, 0x803AC667UL, 0x84FBDBD0UL,
+    0x9ABC8BD5UL, 0x9E7D9662UL, 0x933EB0BBUL, 0x97FFAD0CUL,
+    0xAFB010B1UL, 0xAB710D06UL, 0xA6322BDFUL, 0xA2F33668UL,
+    0xBCB4666DUL, 0xB8757BDAUL, 0xB5365D03UL, 0xB1F740B4UL
+};
+
+#endif	/*	FLUFFER_CRC_MODE	*/
 
 /* ------------------------------------------------------------------------------------ */
 
@@ -333,55 +1280,235 @@ static uint8_t Fluffer_u8IsFilled(const uint8_t * pu8Buffer, uint16_t u16Len, ui
 
 /* ------------------------------------------------------------------------------------ */
 
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+
 /**
- * @brief  Check if given block is branded as a main buffer
+ * @brief  Calculate CRC-32 of an entry's data, by the instance's CRC handle if set. Otherwise by software,
+ *         matching the STM32 CRC unit: polynomial 0x04C11DB7, initial value 0xFFFFFFFF, data fed as
+ *         little endian 32-bit words, the last word padded with zeros
  * @param  psFluffer
- * @param  u8BlockIndex
- * @return 1 if the block is a main buffer, 0 otherwise
+ * @param  pu8Data entry's data (element_size bytes)
+ * @return entry's CRC
  * */
-static uint8_t Fluffer_u8IsMainBuffer(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+static uint32_t Fluffer_u32Crc(const Fluffer_t * const psFluffer, const uint8_t * pu8Data)
 {
-    uint32_t Local_u32BlockBrandAddress = FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex);	/*	address of the fluffer instance's block brand bytes	*/
+    uint32_t Local_u32Crc = 0xFFFFFFFFUL;												/*	CRC unit's initial value	*/
+    uint16_t Local_u16Len = (uint16_t)(((psFluffer->cfg.element_size + 3) / 4) * 4);	/*	data length, padded to words	*/
+    uint16_t Local_u16Index;															/*	index of byte fed next	*/
+    uint16_t Local_u16Byte;																/*	index of the byte in entry's data	*/
 
-    /*	read block's brand bytes into temp buffer	 */
-    psFluffer->handles.read_handle(Local_u32BlockBrandAddress, Fluffer_au8EntryBuffer, psFluffer->cfg.word_size);
+    if(!IS_NULLPTR(psFluffer->handles.crc_handle))
+    {
+        return psFluffer->handles.crc_handle(pu8Data, psFluffer->cfg.element_size);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
 
-    /*	check if read block's brand bytes == main buffer brand */
-    return Fluffer_u8IsFilled(Fluffer_au8EntryBuffer, psFluffer->cfg.word_size, FLUFFER_MAIN_BUFFER_BRAND);
+    for(Local_u16Index = 0; Local_u16Index < Local_u16Len; Local_u16Index++)
+    {
+        /*	a word is fed from its most significant byte, the last byte of its little endian bytes	*/
+        Local_u16Byte = (uint16_t)((Local_u16Index & ~3U) | (3U - (Local_u16Index & 3U)));
+
+        Local_u32Crc = (Local_u32Crc << 8) ^ Fluffer_au32CrcTable[(uint8_t)(Local_u32Crc >> 24) ^
+                       ((Local_u16Byte < psFluffer->cfg.element_size) ? pu8Data[Local_u16Byte] : 0)];
+    }
+
+    return Local_u32Crc;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
 /**
- * @brief  Searches for blocks marked as main buffer, returns their count and
- *         the index of the last block.
+ * @brief  Put CRC of an entry's data right after it (little endian), making up the entry's record
  * @param  psFluffer
- * @param  pu8BlockIndex
- * @return Index of main buffer's block
+ * @param  pu8Record entry's record, data followed by room for its CRC
+ * @return void
  * */
-static uint8_t Fluffer_u8GetMainBufferBlocks(const Fluffer_t * const psFluffer, uint8_t * const pu8BlockIndex)
+static void Fluffer_vidPutCrc(const Fluffer_t * const psFluffer, uint8_t * const pu8Record)
 {
-    uint8_t Local_u8BlockIndex;									/*	fluffer instance block index	*/
-    uint8_t Localu8MainBufferBlocks = 0;						/*	count found blocks branded as main buffers		*/
+    uint32_t Local_u32Crc = Fluffer_u32Crc(psFluffer, pu8Record);		/*	entry's CRC	*/
+    uint8_t * Local_pu8Crc = &pu8Record[psFluffer->cfg.element_size];	/*	CRC's bytes	*/
+
+    Local_pu8Crc[0] = (uint8_t)Local_u32Crc;
+    Local_pu8Crc[1] = (uint8_t)(Local_u32Crc >> 8);
+    Local_pu8Crc[2] = (uint8_t)(Local_u32Crc >> 16);
+    Local_pu8Crc[3] = (uint8_t)(Local_u32Crc >> 24);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Check an entry's record, its data against the CRC following it
+ * @param  psFluffer
+ * @param  pu8Record entry's record, data followed by its CRC
+ * @return 1 if CRC matches entry's data, 0 otherwise
+ * */
+static uint8_t Fluffer_u8RecordIsValid(const Fluffer_t * const psFluffer, const uint8_t * pu8Record)
+{
+    const uint8_t * Local_pu8Crc = &pu8Record[psFluffer->cfg.element_size];	/*	CRC's bytes	*/
+
+    return (Fluffer_u32Crc(psFluffer, pu8Record) == ((uint32_t)Local_pu8Crc[0] | ((uint32_t)Local_pu8Crc[1] << 8) |
+                                                     ((uint32_t)Local_pu8Crc[2] << 16) | ((uint32_t)Local_pu8Crc[3] << 24)));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Read given entry's record into the entry buffer, and check it
+ * @param  psFluffer
+ * @param  u32EntryId
+ * @return 1 if entry's CRC matches its data, 0 otherwise
+ * */
+static uint8_t Fluffer_u8EntryIsValid(const Fluffer_t * const psFluffer, uint32_t u32EntryId)
+{
+    psFluffer->handles.read_handle(FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, u32EntryId), FLUFFER_ENTRY_BUFFER(psFluffer), FLUFFER_RECORD_SIZE(psFluffer));
+
+    return Fluffer_u8RecordIsValid(psFluffer, FLUFFER_ENTRY_BUFFER(psFluffer));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+/**
+ * @brief   Begin a programming session, if fluffer instance has a begin handle. Write & erase handle calls
+ *          up to Fluffer_vidEndSession share a single memory unlock
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidBeginSession(const Fluffer_t * const psFluffer)
+{
+    if(FLUFFER_HAS_SESSION_HANDLE(psFluffer->handles.begin_handle))
+    {
+        psFluffer->handles.begin_handle();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   End a programming session, if fluffer instance has an end handle
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidEndSession(const Fluffer_t * const psFluffer)
+{
+    if(FLUFFER_HAS_SESSION_HANDLE(psFluffer->handles.end_handle))
+    {
+        psFluffer->handles.end_handle();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Check if an erase started by an asynchronous erase handle is still in progress
+ * @param   psFluffer
+ * @return  1 if the memory is busy, 0 if it's ready, fluffer instance has no poll handle or erases are
+ *          synchronous (FLUFFER_ERASE_SYNC)
+ * */
+static uint8_t Fluffer_u8IsBusy(const Fluffer_t * const psFluffer)
+{
+    return FLUFFER_HAS_POLL_HANDLE(psFluffer) && (psFluffer->handles.poll_handle() == FH_ERR_BUSY);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Wait for an erase started by an asynchronous erase handle to finish, if fluffer instance
+ *          has a poll handle
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidWaitReady(const Fluffer_t * const psFluffer)
+{
+    while(Fluffer_u8IsBusy(psFluffer))
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Erase a memory page, and wait for the erase to finish
+ * @param   psFluffer
+ * @param   u32PageIndex absolute memory page index
+ * @return  void
+ * */
+static void Fluffer_vidErase(const Fluffer_t * const psFluffer, uint32_t u32PageIndex)
+{
+    psFluffer->handles.erase_handle(u32PageIndex);
+    Fluffer_vidWaitReady(psFluffer);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/**
+ * @brief  Check if given block is branded with the given brand
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
+ * @return 1 if the block has the given brand, 0 otherwise
+ * */
+static uint8_t Fluffer_u8IsBranded(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint8_t u8Brand)
+{
+    uint32_t Local_u32BlockBrandAddress = FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex);	/*	address of the fluffer instance's block brand bytes	*/
+
+    /*	read block's brand bytes into temp buffer	 */
+    psFluffer->handles.read_handle(Local_u32BlockBrandAddress, FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size);
+
+    /*	check if read block's brand bytes == given brand */
+    return Fluffer_u8IsFilled(FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size, u8Brand);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Searches for blocks with the given brand, returns their count and
+ *         the index of the last block.
+ * @param  psFluffer
+ * @param  pu8BlockIndex
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
+ * @return Number of blocks with the given brand
+ * */
+static uint8_t Fluffer_u8GetBrandedBlocks(const Fluffer_t * const psFluffer, uint8_t * const pu8BlockIndex, uint8_t u8Brand)
+{
+    uint8_t Local_u8BlockIndex;									/*	fluffer instance block index	*/
+    uint8_t Localu8BrandedBlocks = 0;							/*	count found blocks with the given brand		*/
 
     /*	loop over fluffer instance blocks	*/
     for(Local_u8BlockIndex = 0; (Local_u8BlockIndex < psFluffer->cfg.blocks); Local_u8BlockIndex++)
     {
-        /*	check current block is a main buffer	*/
-        if(Fluffer_u8IsMainBuffer(psFluffer, Local_u8BlockIndex))
+        /*	check current block has the given brand	*/
+        if(Fluffer_u8IsBranded(psFluffer, Local_u8BlockIndex, u8Brand))
         {
-            /*	increment main buffer block count	*/
-            Localu8MainBufferBlocks++;
+            /*	increment branded block count	*/
+            Localu8BrandedBlocks++;
 
-            /*	set main buffer block index	*/
+            /*	set branded block index	*/
             (*pu8BlockIndex) = Local_u8BlockIndex;
         }
     }
 
-    /*	return if main buffer was found or not	*/
-    return Localu8MainBufferBlocks;
+    /*	return number of found blocks	*/
+    return Localu8BrandedBlocks;
 }
 
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
 /* ------------------------------------------------------------------------------------ */
 
 /**
@@ -393,18 +1520,45 @@ static uint8_t Fluffer_u8GetMainBufferBlocks(const Fluffer_t * const psFluffer,
  * */
 static void Fluffer_vidPrepareFluffer(Fluffer_t * const psFluffer)
 {
-    const uint16_t Local_u16TotalPagesNum = FLUFFER_ALLOCATED_PAGES(psFluffer);	/*	total number of allocated pages	*/
-    uint16_t Local_u16PageIndex = 0;											/*	memory page index	*/
+    const uint32_t Local_u32TotalPagesNum = FLUFFER_ALLOCATED_PAGES(psFluffer);	/*	total number of allocated pages	*/
+    uint32_t Local_u32PageIndex = 0;											/*	memory page index	*/
+
+    Fluffer_vidBeginSession(psFluffer);
 
     /*	loop over fluffer pages	*/
-    for(; Local_u16PageIndex < Local_u16TotalPagesNum; Local_u16PageIndex++)
+    for(; Local_u32PageIndex < Local_u32TotalPagesNum; Local_u32PageIndex++)
     {
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+        /*	blocks' first pages hold their erase counts, they're kept	*/
+        if(IS_ZERO(Local_u32PageIndex % psFluffer->cfg.pages_pre_block))
+        {
+            Fluffer_vidEraseHeaderPage(psFluffer, (uint8_t)(Local_u32PageIndex / psFluffer->cfg.pages_pre_block));
+        }
+        else
+        {
+            Fluffer_vidErase(psFluffer, FLUFFER_PAGE_INDEX(psFluffer, Local_u32PageIndex));
+        }
+#else
         /*	erase allocated fluffer pages	*/
-        psFluffer->handles.erase_handle(FLUFFER_PAGE_INDEX(psFluffer, Local_u16PageIndex));
+        Fluffer_vidErase(psFluffer, FLUFFER_PAGE_INDEX(psFluffer, Local_u32PageIndex));
+#endif	/*	FLUFFER_WEAR_MODE	*/
     }
 
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	first fluffer block starts the ring	*/
+    Fluffer_vidWriteSequence(psFluffer, FLUFFER_FIRST_BLOCK, 0);
+    psFluffer->context.sequence = 0;
+#else
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	first main buffer starts the clean ups' sequence	*/
+    Fluffer_vidWriteWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, FLUFFER_FIRST_BLOCK), 0);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
     /*	mark first fluffer block as main buffer	 */
-    Fluffer_vidBrandBlock(psFluffer, FLUFFER_FIRST_BLOCK);
+    Fluffer_vidBrandBlock(psFluffer, FLUFFER_FIRST_BLOCK, FLUFFER_MAIN_BUFFER_BRAND);
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    Fluffer_vidEndSession(psFluffer);
 
     /*	set first block as main buffer	*/
     psFluffer->context.main_buffer = FLUFFER_FIRST_BLOCK;
@@ -412,42 +1566,266 @@ static void Fluffer_vidPrepareFluffer(Fluffer_t * const psFluffer)
 
 /* ------------------------------------------------------------------------------------ */
 
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
 /**
- * @brief  Brand fluffer instance's given block as a main buffer
+ * @brief  Brand fluffer instance's given block as a main buffer, or as the block entries are copied into
+ *         (given the sequence number following the main buffer's with FLUFFER_WEAR_LEVEL)
  * @param  psFluffer
  * @param  u8BlockIndex
+ * @param  u8Brand FLUFFER_MAIN_BUFFER_BRAND or FLUFFER_COPY_BUFFER_BRAND
  * @return void
  * */
-static void Fluffer_vidBrandBlock(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+static void Fluffer_vidBrandBlock(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint8_t u8Brand)
 {
-    const uint8_t Local_au8MainBufferBrand [FLUFFER_DEFAULT_MAX_WORD_SIZE] = {				/*	main buffer brand */
-        FLUFFER_MAIN_BUFFER_BRAND, FLUFFER_MAIN_BUFFER_BRAND,
-        FLUFFER_MAIN_BUFFER_BRAND, FLUFFER_MAIN_BUFFER_BRAND,
+    const uint8_t Local_au8Brand [FLUFFER_DEFAULT_MAX_WORD_SIZE] = {						/*	block's brand word */
+        u8Brand, u8Brand, u8Brand, u8Brand,
     };
 
     uint32_t Local_u32BrandAddress = FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex);		/*	block's brand address	*/
 
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	a copy takes the sequence number following the main buffer's, it's programmed before the brand so
+     *	a branded copy always has it	*/
+    if(u8Brand == FLUFFER_COPY_BUFFER_BRAND)
+    {
+        Fluffer_vidWriteWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, u8BlockIndex),
+                                  Fluffer_u32ReadWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, psFluffer->context.main_buffer)) + 1);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
     /*	write brand to given block	*/
-    psFluffer->handles.write_handle(Local_u32BrandAddress, (uint8_t *)Local_au8MainBufferBrand, psFluffer->cfg.word_size);
+    psFluffer->handles.write_handle(Local_u32BrandAddress, (uint8_t *)Local_au8Brand, psFluffer->cfg.word_size);
+}
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Read a 32 bit field of a block's header (erase count or sequence number)
+ * @param  psFluffer
+ * @param  u32Address field's address
+ * @return field's value, FLUFFER_WEAR_FIELD_BLANK if it's blank
+ * */
+static uint32_t Fluffer_u32ReadWearField(const Fluffer_t * const psFluffer, uint32_t u32Address)
+{
+    uint8_t Local_au8Field[FLUFFER_WEAR_FIELD_SIZE];			/*	field's bytes	*/
+
+    psFluffer->handles.read_handle(u32Address, Local_au8Field, FLUFFER_WEAR_FIELD_SIZE);
+
+    /*	field is stored little endian	*/
+    return ((uint32_t)Local_au8Field[0] | ((uint32_t)Local_au8Field[1] << 8) |
+            ((uint32_t)Local_au8Field[2] << 16) | ((uint32_t)Local_au8Field[3] << 24));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Write a 32 bit field of a block's header (erase count or sequence number), the field must be blank
+ * @param  psFluffer
+ * @param  u32Address field's address
+ * @param  u32Value
+ * @return void
+ * */
+static void Fluffer_vidWriteWearField(const Fluffer_t * const psFluffer, uint32_t u32Address, uint32_t u32Value)
+{
+    uint8_t Local_au8Field[FLUFFER_WEAR_FIELD_SIZE] = {			/*	field's bytes, little endian	*/
+        (uint8_t)u32Value, (uint8_t)(u32Value >> 8),
+        (uint8_t)(u32Value >> 16), (uint8_t)(u32Value >> 24),
+    };
+
+    psFluffer->handles.write_handle(u32Address, Local_au8Field, FLUFFER_WEAR_FIELD_SIZE);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Get given block's erase count once its first page is erased: its erase count + 1, or the
+ *         highest erase count of all blocks if its erase count was lost (0 if all were lost)
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return block's new erase count
+ * */
+static uint32_t Fluffer_u32NextEraseCount(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+{
+    uint32_t Local_u32Count = Fluffer_u32ReadWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, u8BlockIndex));	/*	block's erase count	*/
+    uint32_t Local_u32Highest = 0;						/*	highest erase count found	*/
+    uint8_t Local_u8Block;								/*	block index	*/
+
+    if(Local_u32Count != FLUFFER_WEAR_FIELD_BLANK)
+    {
+        return Local_u32Count + 1;
+    }
+
+    /*	erase count was lost (a reset cut its program), it's taken for the most worn block's	*/
+    for(Local_u8Block = 0; Local_u8Block < psFluffer->cfg.blocks; Local_u8Block++)
+    {
+        Local_u32Count = Fluffer_u32ReadWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, Local_u8Block));
+
+        if((Local_u32Count != FLUFFER_WEAR_FIELD_BLANK) && (Local_u32Count > Local_u32Highest))
+        {
+            Local_u32Highest = Local_u32Count;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    return Local_u32Highest;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Erase given block's first page (holding its header), and wait for the erase to finish. The
+ *         block's erase count is read before the erase, and programmed back incremented after it
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return void
+ * */
+static void Fluffer_vidEraseHeaderPage(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+{
+    uint32_t Local_u32Count = Fluffer_u32NextEraseCount(psFluffer, u8BlockIndex);		/*	block's erase count after the erase	*/
+
+    Fluffer_vidErase(psFluffer, FLUFFER_BLOCK_START_PAGE(psFluffer, u8BlockIndex));
+    Fluffer_vidWriteWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, u8BlockIndex), Local_u32Count);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Prepare given block's first page to be erased ahead, the page is erased only if it's not
+ *         blank but for the block's erase count. With a poll handle, the erase is left running: the
+ *         erase count is kept by the clean up state until Fluffer_vidRestoreEraseCount. A lost erase
+ *         count is programmed again
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @return void
+ * */
+static void Fluffer_vidPrepareHeaderPage(Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+{
+    /*	block's brand was erased by the clean up it was the main buffer of, only its erase count is left.
+     *	Otherwise (ex: a copy cut by a reset), it's erased now: the erase count is programmed after	*/
+    if(!Fluffer_u8PageIsBlank(psFluffer, FLUFFER_BLOCK_START_PAGE(psFluffer, u8BlockIndex), FLUFFER_WEAR_FIELD_SIZE))
+    {
+        psFluffer->cleanup.erase_count = Fluffer_u32NextEraseCount(psFluffer, u8BlockIndex);
+        psFluffer->handles.erase_handle(FLUFFER_BLOCK_START_PAGE(psFluffer, u8BlockIndex));
+    }
+    else if(Fluffer_u32ReadWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, u8BlockIndex)) == FLUFFER_WEAR_FIELD_BLANK)
+    {
+        Fluffer_vidWriteWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, u8BlockIndex), Fluffer_u32NextEraseCount(psFluffer, u8BlockIndex));
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Program back the erase count of the block whose first page was erased by the clean up, once
+ *         the erase is done (nothing is done if no erase count is pending)
+ * @param  psFluffer
+ * @return void
+ * */
+static void Fluffer_vidRestoreEraseCount(Fluffer_t * const psFluffer)
+{
+    if(psFluffer->cleanup.erase_count != FLUFFER_WEAR_FIELD_BLANK)
+    {
+        Fluffer_vidWaitReady(psFluffer);
+        Fluffer_vidWriteWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, psFluffer->cleanup.block), psFluffer->cleanup.erase_count);
+        psFluffer->cleanup.erase_count = FLUFFER_WEAR_FIELD_BLANK;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Pick the block the next clean up copies entries into: a block left branded as copy (a clean up
+ *         cut by a reset), so it's erased ahead first, otherwise the least worn block. Blocks are checked
+ *         in order from the one following the main buffer, so blocks with equal erase counts are used in turn
+ * @param  psFluffer
+ * @return void
+ * */
+static void Fluffer_vidPickNextBlock(Fluffer_t * const psFluffer)
+{
+    uint32_t Local_u32Least = FLUFFER_WEAR_FIELD_BLANK;		/*	least erase count found, a lost one is taken for the highest	*/
+    uint32_t Local_u32Count;								/*	block's erase count	*/
+    uint8_t Local_u8Offset;									/*	block index, counted from the main buffer	*/
+    uint8_t Local_u8Block;									/*	block index	*/
+
+    psFluffer->context.next_buffer = (uint8_t)((psFluffer->context.main_buffer + 1) % psFluffer->cfg.blocks);
+
+    for(Local_u8Offset = 1; Local_u8Offset < psFluffer->cfg.blocks; Local_u8Offset++)
+    {
+        Local_u8Block = (uint8_t)((psFluffer->context.main_buffer + Local_u8Offset) % psFluffer->cfg.blocks);
+
+        /*	a single block is ever branded as copy	*/
+        if(Fluffer_u8IsBranded(psFluffer, Local_u8Block, FLUFFER_COPY_BUFFER_BRAND))
+        {
+            psFluffer->context.next_buffer = Local_u8Block;
+
+            return;
+        }
+
+        Local_u32Count = Fluffer_u32ReadWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, Local_u8Block));
+
+        if(Local_u32Count < Local_u32Least)
+        {
+            Local_u32Least = Local_u32Count;
+            psFluffer->context.next_buffer = Local_u8Block;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
 }
 
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
 /* ------------------------------------------------------------------------------------ */
 
 /**
  * @brief  Check if given entry is marked
  * @param  psFluffer
- * @param  u16entryId
+ * @param  u32EntryId
  * @return 1 if entry is marked, 0 otherwise
  * */
-static uint8_t Fluffer_u8EntryIsMarked(const Fluffer_t * const psFluffer, uint16_t u16EntryId)
+static uint8_t Fluffer_u8EntryIsMarked(const Fluffer_t * const psFluffer, uint32_t u32EntryId)
 {
-    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u16EntryId);	/*	entry address	*/
+    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u32EntryId);	/*	entry address	*/
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+
+    /*	read byte holding entry's mark bit into temp buffer	*/
+    psFluffer->handles.read_handle(Local_u32EntryAddress, FLUFFER_ENTRY_BUFFER(psFluffer), 1);
+
+    /*	check if entry's mark bit is cleared	*/
+    return ((FLUFFER_ENTRY_BUFFER(psFluffer)[0] & FLUFFER_ENTRY_MARK_BIT(FLUFFER_ENTRY_SLOT(psFluffer, u32EntryId))) == 0);
+
+#else
 
     /*	read entry mark	into temp buffer	*/
-    psFluffer->handles.read_handle(Local_u32EntryAddress, Fluffer_au8EntryBuffer, psFluffer->cfg.word_size);
+    psFluffer->handles.read_handle(Local_u32EntryAddress, FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size);
 
     /*	check if entry mark == entry mark	*/
-    return Fluffer_u8IsFilled(Fluffer_au8EntryBuffer, psFluffer->cfg.word_size, FLUFFER_ENTRY_MARKED);
+    return Fluffer_u8IsFilled(FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size, FLUFFER_ENTRY_MARKED);
+
+#endif	/*	FLUFFER_LAYOUT	*/
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -455,351 +1833,2332 @@ static uint8_t Fluffer_u8EntryIsMarked(const Fluffer_t * const psFluffer, uint16
 /**
  * @brief  Check if given entry is unmarked and is empty
  * @param  psFluffer
- * @param  u16entryId
+ * @param  u32EntryId
  * @return 1 if entry is unmarked & is empty, 0 otherwise
  * */
-static uint8_t Fluffer_u8EntryIsEmpty(const Fluffer_t * const psFluffer, uint16_t u16EntryId)
+static uint8_t Fluffer_u8EntryIsEmpty(const Fluffer_t * const psFluffer, uint32_t u32EntryId)
 {
-    uint32_t Local_u32ReadAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u16EntryId);		/*	entry's starting memory address	*/
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+
+    uint32_t Local_u32ReadAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, u32EntryId);			/*	entry's data memory address	*/
+
+    /*	an entry is marked only after it's written, so entry's data is enough	*/
+    psFluffer->handles.read_handle(Local_u32ReadAddress, FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.element_size);
+
+    /*	check if read bytes == erased bytes	*/
+    return Fluffer_u8IsFilled(FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.element_size, FLUFFER_CLEAN_BYTE_CONTENT);
+
+#else
+
+    uint32_t Local_u32ReadAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u32EntryId);		/*	entry's starting memory address	*/
 
-    psFluffer->handles.read_handle(Local_u32ReadAddress, Fluffer_au8EntryBuffer, psFluffer->cfg.element_size + 1);
+    psFluffer->handles.read_handle(Local_u32ReadAddress, FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.element_size + 1);
 
     /*	check if read bytes == erased bytes	*/
-    return Fluffer_u8IsFilled(Fluffer_au8EntryBuffer, psFluffer->cfg.element_size + 1, FLUFFER_CLEAN_BYTE_CONTENT);
+    return Fluffer_u8IsFilled(FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.element_size + 1, FLUFFER_CLEAN_BYTE_CONTENT);
+
+#endif	/*	FLUFFER_LAYOUT	*/
 }
 
-/* ------------------------------------------------------------------------------------ */
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Get given entry's state, from its mark
+ * @param  psFluffer
+ * @param  u32EntryId
+ * @return entry's state (FLUFFER_ENTRY_STATE_WRITTEN .. FLUFFER_ENTRY_STATE_MARKED)
+ * */
+static uint8_t Fluffer_u8ReadState(const Fluffer_t * const psFluffer, uint32_t u32EntryId)
+{
+    uint8_t Local_u8State = FLUFFER_ENTRY_STATE_WRITTEN;	/*	entry's state	*/
+
+    /*	entry's mark is read into the entry buffer	*/
+    if(Fluffer_u8EntryIsMarked(psFluffer, u32EntryId))
+    {
+        return FLUFFER_ENTRY_STATE_MARKED;
+    }
+
+#if FLUFFER_MARK_STATES > 2
+
+    /*	each intermediate state clears one more bit of mark's first byte, from the least significant bit	*/
+    while((Local_u8State < (FLUFFER_MARK_STATES - 2)) && IS_ZERO(FLUFFER_ENTRY_BUFFER(psFluffer)[0] & (0x01 << Local_u8State)))
+    {
+        Local_u8State++;
+    }
+
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+    return Local_u8State;
+}
+
+#if FLUFFER_MARK_STATES > 2
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Write an intermediate state to the mark at the given address, only bits cleared by the state
+ *         are programmed (mark's first byte), the rest of the mark is left erased
+ * @param  psFluffer
+ * @param  u32MarkAddress mark's address
+ * @param  u8State intermediate state (1 .. FLUFFER_MARK_STATES - 2)
+ * @return void
+ * */
+static void Fluffer_vidWriteState(const Fluffer_t * const psFluffer, uint32_t u32MarkAddress, uint8_t u8State)
+{
+    uint8_t Local_au8Mark[FLUFFER_DEFAULT_MAX_WORD_SIZE];	/*	entry's mark	*/
+
+    memset(Local_au8Mark, FLUFFER_ENTRY_UNMARKED, sizeof(Local_au8Mark));
+    Local_au8Mark[0] = (uint8_t)(FLUFFER_ENTRY_UNMARKED << u8State);
+
+    psFluffer->handles.write_handle(u32MarkAddress, Local_au8Mark, psFluffer->cfg.word_size);
+}
+
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+/* ------------------------------------------------------------------------------------ */
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/**
+ * @brief  Find the index of the first unmarked entry in the main buffer of the given
+ *         fluffer instance
+ * @param  psFluffer
+ * @return index of fluffer's head
+ * */
+static uint32_t Fluffer_u32FindHead(const Fluffer_t * const psFluffer)
+{
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+
+    uint32_t Local_u32ReadAddress = FLUFFER_MARKS_ADDRESS(psFluffer);						/*	next marks chunk address	*/
+    uint32_t Local_u32Left = FLUFFER_MARKS_SIZE(psFluffer, psFluffer->context.size);		/*	marks region bytes left to scan	*/
+    uint16_t Local_u16Chunk = 0;															/*	marks chunk size	*/
+    uint16_t Local_u16Index = 0;															/*	byte index in marks chunk	*/
+    uint32_t Local_u32Marked = 0;															/*	leading marked bytes	*/
+    uint32_t Local_u32Head;																	/*	index of first unmarked entry	*/
+    FlagStatus Local_enHeadFound = RESET;													/*	fluffer head found flag	*/
+
+    /*	bulk read marks region chunk by chunk, count leading marked bytes	*/
+    while((Local_u32Left > 0) && (Local_enHeadFound == RESET))
+    {
+        Local_u16Chunk = (uint16_t)MIN(Local_u32Left, FLUFFER_RUN_SIZE(psFluffer));
+        psFluffer->handles.read_handle(Local_u32ReadAddress, FLUFFER_RUN_BUFFER(psFluffer), Local_u16Chunk);
+
+        for(Local_u16Index = 0; (Local_u16Index < Local_u16Chunk) && (FLUFFER_RUN_BUFFER(psFluffer)[Local_u16Index] == FLUFFER_ENTRY_MARKED); Local_u16Index++);
+
+        Local_u32Marked += Local_u16Index;
+        Local_enHeadFound = (Local_u16Index < Local_u16Chunk) ? SET : RESET;
+
+        Local_u32ReadAddress += Local_u16Chunk;
+        Local_u32Left -= Local_u16Chunk;
+    }
+
+#if FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT
+
+    /*	8 entries per marked byte, then leading marked bits of the first byte that is not fully marked	*/
+    Local_u32Head = Local_u32Marked * 8;
+
+    if(Local_enHeadFound == SET)
+    {
+        Local_u32Head += Fluffer_u8CountLeadingZeros(FLUFFER_RUN_BUFFER(psFluffer)[Local_u16Index]);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+#else
+
+    /*	a partially marked word is not marked	*/
+    Local_u32Head = Local_u32Marked / psFluffer->cfg.word_size;
+
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+
+    /*	save head address offset	*/
+    return MIN(Local_u32Head, psFluffer->context.size);
+
+#else
+
+    uint32_t Local_u32EntryIndex = 0;								/*	entry index	*/
+    FlagStatus Local_enHeadFound = RESET;							/*	fluffer head found flag	*/
+
+    /*	loop over entries in fluffer instance's main buffer	*/
+    while((Local_u32EntryIndex < psFluffer->context.size) && (Local_enHeadFound == RESET))
+    {
+        /*	check if entry is not marked	*/
+        if(Fluffer_u8EntryIsMarked(psFluffer, Local_u32EntryIndex) == FALSE)
+        {
+            Local_enHeadFound = SET;
+        }
+        else
+        {
+            /*	increment entry index	*/
+            Local_u32EntryIndex++;
+        }
+    }
+
+    /*	save head address offset, all entries are marked if no unmarked entry was found	*/
+    return Local_u32EntryIndex;
+
+#endif	/*	FLUFFER_LAYOUT	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Find the first empty entry's index in the main buffer of the given fluffer instance
+ * @param  psFluffer
+ * @return Index of fluffer's tail, or fluffer's size if main buffer is full
+ * */
+static uint32_t Fluffer_u32FindTail(const Fluffer_t * const psFluffer)
+{
+    uint32_t Local_u32EntryIndex = 0;									/*	entry index	*/
+    FlagStatus Local_enTailFound = RESET;								/*	fluffer tail found flag	*/
+
+    /*	loop over entries in fluffer instance's main buffer	*/
+    while((Local_u32EntryIndex < psFluffer->context.size) && (Local_enTailFound == RESET))
+    {
+        /*	check if entry is empty	*/
+        if(Fluffer_u8EntryIsEmpty(psFluffer, Local_u32EntryIndex) == TRUE)
+        {
+            Local_enTailFound = SET;
+        }
+        else
+        {
+            Local_u32EntryIndex++;
+        }
+    }
+
+    /*	save head address offset	*/
+    return Local_u32EntryIndex;
+}
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/* ------------------------------------------------------------------------------------ */
+
+#if (FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT) || (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING)
+
+/**
+ * @brief  Binary search for the first empty entry's index in the main buffer of the given
+ *         fluffer instance, assuming written entries are a prefix of the main buffer
+ * @param  psFluffer
+ * @param  u32End index of the entry following the last entry searched
+ * @return Index of fluffer's tail, or u32End if no empty entry was found
+ * */
+static uint32_t Fluffer_u32BisectTail(const Fluffer_t * const psFluffer, uint32_t u32End)
+{
+    uint32_t Local_u32Low = 0;								/*	first entry that may be empty	*/
+    uint32_t Local_u32High = u32End;						/*	entries starting from here are empty	*/
+    uint32_t Local_u32Middle;								/*	probed entry index	*/
+
+    while(Local_u32Low < Local_u32High)
+    {
+        Local_u32Middle = Local_u32Low + ((Local_u32High - Local_u32Low) >> 1);
+
+        /*	check if entry is empty	*/
+        if(Fluffer_u8EntryIsEmpty(psFluffer, Local_u32Middle) == TRUE)
+        {
+            Local_u32High = Local_u32Middle;
+        }
+        else
+        {
+            Local_u32Low = Local_u32Middle + 1;
+        }
+    }
+
+    return Local_u32Low;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED) || (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING)
+
+/**
+ * @brief  Binary search for the index of the first unmarked entry in the main buffer of the given
+ *         fluffer instance, assuming marked entries are a prefix of the written entries
+ * @param  psFluffer
+ * @param  u32Tail index of fluffer's tail, upper limit of the search
+ * @return index of fluffer's head
+ * */
+static uint32_t Fluffer_u32BisectHead(const Fluffer_t * const psFluffer, uint32_t u32Tail)
+{
+    uint32_t Local_u32Low = 0;					/*	first entry that may be unmarked	*/
+    uint32_t Local_u32High = u32Tail;			/*	entries starting from here are unmarked	*/
+    uint32_t Local_u32Middle;					/*	probed entry index	*/
+
+    while(Local_u32Low < Local_u32High)
+    {
+        Local_u32Middle = Local_u32Low + ((Local_u32High - Local_u32Low) >> 1);
+
+        /*	check if entry is marked	*/
+        if(Fluffer_u8EntryIsMarked(psFluffer, Local_u32Middle) == TRUE)
+        {
+            Local_u32Low = Local_u32Middle + 1;
+        }
+        else
+        {
+            Local_u32High = Local_u32Middle;
+        }
+    }
+
+    return Local_u32Low;
+}
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+#if (FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT) && (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY)
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Spot check head & tail found by binary search against the main buffer
+ * @details The binary search already probed both sides of the head & tail boundaries, only the
+ *          first entry is checked here to catch a main buffer that is not a clean prefix. A full
+ *          main buffer is also rejected, to let the linear scan handle it the way it always did.
+ * @param  psFluffer
+ * @param  u32Head
+ * @param  u32Tail
+ * @return 1 if head & tail are consistent with the main buffer, 0 otherwise
+ * */
+static uint8_t Fluffer_u8BoundsAreValid(const Fluffer_t * const psFluffer, uint32_t u32Head, uint32_t u32Tail)
+{
+    /*	no empty entry was found	*/
+    if(u32Tail >= psFluffer->context.size)
+    {
+        return 0;
+    }
+
+    /*	first entry must be written if tail is not the first entry	*/
+    if((u32Tail > 0) && (Fluffer_u8EntryIsEmpty(psFluffer, 0) == TRUE))
+    {
+        return 0;
+    }
+
+    /*	first entry must be marked if head is not the first entry	*/
+    if((u32Head > 0) && (Fluffer_u8EntryIsMarked(psFluffer, 0) == FALSE))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+/* ------------------------------------------------------------------------------------ */
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/**
+ * @brief  Copies unmarked entries from source block, into the destination block starting from the given entry ID
+ * @param
+ * @param
+ * @param
+ * @param
+ * @return void
+ * */
+static void Fluffer_vidCopyEntries(const Fluffer_t * const psFluffer, const Fluffer_Transfer_t * const psTransfer)
+{
+    uint32_t Local_u32ReadAddress;		    				/*	source block entry's address		*/
+    uint32_t Local_u32WriteAddress;		    				/*	destination block entry's address	*/
+    uint32_t Local_u32ReadIndex = psTransfer->src_id;		/*	read index in source block	*/
+    uint32_t Local_u32WriteIndex = psTransfer->dst_id;	    /*	write index in destination block	*/
+
+    /*	loop over entries in the source block	*/
+    while(Local_u32ReadIndex < psTransfer->size)
+    {
+        /*	get source block entry's address	*/
+        Local_u32ReadAddress = FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, psTransfer->src_block, Local_u32ReadIndex);
+
+        /*	get destination block entry's address	*/
+        Local_u32WriteAddress = FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, psTransfer->dst_block, Local_u32WriteIndex);
+
+        /*	read entry from source buffer into temp buffer	*/
+        psFluffer->handles.read_handle(Local_u32ReadAddress, FLUFFER_ENTRY_BUFFER(psFluffer), FLUFFER_RECORD_SIZE(psFluffer));
+
+        /*	write entry (& its CRC) from temp buffer into destination block	*/
+        psFluffer->handles.write_handle(Local_u32WriteAddress, FLUFFER_ENTRY_BUFFER(psFluffer), FLUFFER_RECORD_SIZE(psFluffer));
+
+#if FLUFFER_MARK_STATES > 2
+        /*	entry's intermediate state is kept, erased marks aren't written	*/
+        psFluffer->handles.read_handle(FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, psTransfer->src_block, Local_u32ReadIndex),
+                                       FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size);
+
+        if(!Fluffer_u8IsFilled(FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size, FLUFFER_ENTRY_UNMARKED))
+        {
+            psFluffer->handles.write_handle(FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, psTransfer->dst_block, Local_u32WriteIndex),
+                                            FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.word_size);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+        /*	increment write index	*/
+        Local_u32WriteIndex++;
+
+        /*	increment read index	*/
+        Local_u32ReadIndex++;
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Clean up fluffer instance
+ * @details Brand the next secondary buffer as the block entries are copied into, copy all unmarked
+ * 			entries from the current main buffer to it, then erase the current main buffer's brand,
+ * 			finally brand secondary buffer as main buffer. A reset at any step leaves either the old main
+ * 			buffer, or the copy with all entries as the only branded main buffer.
+ * 			If marked entries are less than the required free entries, the oldest unmarked
+ * 			entries are dropped as well (migration), so at least FLUFFER_EVICT_ENTRIES are free
+ * @param   psFluffer
+ * @param   u32Reserve number of free entries required after clean up (1 .. main buffer size)
+ * @return  void
+ * */
+static void Fluffer_vidCleanUp(Fluffer_t * const psFluffer, uint32_t u32Reserve)
+{
+    uint8_t Local_u8NextBlock = FLUFFER_NEXT_BLOCK_ID(psFluffer);
+    uint8_t Local_u8OldBlock = psFluffer->context.main_buffer;
+
+    Fluffer_Transfer_t Local_sTransfer = {
+        .src_block = psFluffer->context.main_buffer,
+        .src_id = psFluffer->context.head,
+        .dst_block = Local_u8NextBlock,
+        .dst_id = 0,
+        .size = psFluffer->context.tail
+    };
+
+    /*	a migration leaves at least FLUFFER_EVICT_ENTRIES free, so following writes don't migrate again right away	*/
+    u32Reserve = MAX(u32Reserve, FLUFFER_EVICT_ENTRIES(psFluffer));
+
+    /*	check if unmarked entries leave less than the required free entries	*/
+    if((uint32_t)(psFluffer->context.tail - Local_sTransfer.src_id) > ((uint32_t)psFluffer->context.size - u32Reserve))
+    {
+        Local_sTransfer.src_id = psFluffer->context.tail - (psFluffer->context.size - u32Reserve);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    /*	copy, brand & erase share a single programming session	*/
+    Fluffer_vidBeginSession(psFluffer);
+
+    /*	next block's pages that weren't prepared by Fluffer_enIdleErase are erased here	*/
+    Fluffer_vidEraseNextBlock(psFluffer);
+
+    /*	clean up is in progress, a partial copy is never taken for a main buffer	*/
+    Fluffer_vidBrandBlock(psFluffer, Local_u8NextBlock, FLUFFER_COPY_BUFFER_BRAND);
+
+    /*	copy entries from current main buffer block to the next block	*/
+    Fluffer_vidCopyEntries(psFluffer, &Local_sTransfer);
+
+    /*	erase old buffer's brand once all entries are copied, so a single block is branded as main buffer.
+     *	Rest of its pages are erased before entries are copied into it again	*/
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    Fluffer_vidEraseHeaderPage(psFluffer, Local_u8OldBlock);
+#else
+    Fluffer_vidErase(psFluffer, FLUFFER_BLOCK_START_PAGE(psFluffer, Local_u8OldBlock));
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	set next block as main buffer, main buffer brand is programmed over the copy brand	*/
+    Fluffer_vidBrandBlock(psFluffer, Local_u8NextBlock, FLUFFER_MAIN_BUFFER_BRAND);
+
+    /*	set main buffer	*/
+    psFluffer->context.main_buffer = Local_u8NextBlock;
+
+    /*	set new head & tail	*/
+    psFluffer->context.tail = psFluffer->context.tail - Local_sTransfer.src_id;
+    psFluffer->context.head = 0;
+
+    Fluffer_vidEndSession(psFluffer);
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    Fluffer_vidPickNextBlock(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	erase ahead the block following the new main buffer	*/
+    Fluffer_vidScheduleErase(psFluffer, FLUFFER_NEXT_BLOCK_ID(psFluffer));
+}
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Check if given memory page is blank (all bytes are clean)
+ * @param   psFluffer
+ * @param   u32PageIndex absolute memory page index
+ * @param   u16Offset bytes at the page's start left out of the check
+ * @return  1 if page is blank, 0 otherwise
+ * */
+static uint8_t Fluffer_u8PageIsBlank(const Fluffer_t * const psFluffer, uint32_t u32PageIndex, uint16_t u16Offset)
+{
+    uint32_t Local_u32Address = (u32PageIndex * psFluffer->cfg.page_size) + u16Offset;		/*	address of next bytes to check	*/
+    uint16_t Local_u16Remaining = psFluffer->cfg.page_size - u16Offset;								/*	bytes left to check	*/
+    uint16_t Local_u16Chunk;															/*	bytes checked by a single read	*/
+
+    while(Local_u16Remaining > 0)
+    {
+        Local_u16Chunk = MIN(Local_u16Remaining, FLUFFER_RUN_SIZE(psFluffer));
+
+        psFluffer->handles.read_handle(Local_u32Address, FLUFFER_RUN_BUFFER(psFluffer), Local_u16Chunk);
+        if(!Fluffer_u8IsFilled(FLUFFER_RUN_BUFFER(psFluffer), Local_u16Chunk, FLUFFER_CLEAN_BYTE_CONTENT))
+        {
+            return 0;
+        }
+
+        Local_u32Address += Local_u16Chunk;
+        Local_u16Remaining -= Local_u16Chunk;
+    }
+
+    return 1;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Schedule preparation of the block following the main buffer (the block the tail moves to
+ *          next with FLUFFER_BUFFER_RING), entries are written into it next, so it must be erased
+ * @param   psFluffer
+ * @param   u8BlockIndex block to be prepared
+ * @return  void
+ * */
+static void Fluffer_vidScheduleErase(Fluffer_t * const psFluffer, uint8_t u8BlockIndex)
+{
+    psFluffer->cleanup.block = u8BlockIndex;
+    psFluffer->cleanup.page = 0;
+    psFluffer->cleanup.state = FLUFFER_CLEANUP_ERASE;
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    psFluffer->cleanup.erase_count = FLUFFER_WEAR_FIELD_BLANK;
+#endif	/*	FLUFFER_WEAR_MODE	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Prepare the next page of the block following the main buffer, the page is erased
+ *          only if it's not blank
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidErasePage(Fluffer_t * const psFluffer)
+{
+    Fluffer_Cleanup_t * const Local_psCleanUp = &psFluffer->cleanup;									/*	instance's clean up state	*/
+    uint32_t Local_u32PageIndex = FLUFFER_BLOCK_START_PAGE(psFluffer, Local_psCleanUp->block) + Local_psCleanUp->page;	/*	absolute page index	*/
+
+    /*	previous page's erase may still be in progress (asynchronous erase handle)	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    Fluffer_vidRestoreEraseCount(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	a blank check (read) is much cheaper than an erase, pages are mostly blank already. With a poll handle,
+     *	the erase is left running, it's polled before the next handle call	*/
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    if(IS_ZERO(Local_psCleanUp->page))
+    {
+        /*	block's first page holds its erase count, it's kept across the erase	*/
+        Fluffer_vidPrepareHeaderPage(psFluffer, Local_psCleanUp->block);
+    }
+    else if(!Fluffer_u8PageIsBlank(psFluffer, Local_u32PageIndex, 0))
+#else
+    if(!Fluffer_u8PageIsBlank(psFluffer, Local_u32PageIndex, 0))
+#endif	/*	FLUFFER_WEAR_MODE	*/
+    {
+        psFluffer->handles.erase_handle(Local_u32PageIndex);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    Local_psCleanUp->page++;
+
+    if(Local_psCleanUp->page >= psFluffer->cfg.pages_pre_block)
+    {
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+        /*	single page blocks: no next page's slice programs the erase count back	*/
+        Fluffer_vidRestoreEraseCount(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+        Local_psCleanUp->state = FLUFFER_CLEANUP_IDLE;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Prepare all remaining pages of the block following the main buffer
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidEraseNextBlock(Fluffer_t * const psFluffer)
+{
+    while(psFluffer->cleanup.state == FLUFFER_CLEANUP_ERASE)
+    {
+        Fluffer_vidErasePage(psFluffer);
+    }
+
+    /*	block is used right away	*/
+    Fluffer_vidWaitReady(psFluffer);
+}
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Read given block's sequence number
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  pu16Sequence pointer to a uint16_t variable, to store block's sequence number in it
+ * @return 1 if the block is in use (its sequence number is written), 0 otherwise
+ * */
+static uint8_t Fluffer_u8ReadSequence(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint16_t * const pu16Sequence)
+{
+    /*	read block's header into temp buffer	*/
+    psFluffer->handles.read_handle(FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex), FLUFFER_ENTRY_BUFFER(psFluffer), FLUFFER_HEADER_SIZE(psFluffer));
+
+    /*	sequence number is stored little endian	*/
+    (*pu16Sequence) = (uint16_t)(FLUFFER_ENTRY_BUFFER(psFluffer)[0] | (FLUFFER_ENTRY_BUFFER(psFluffer)[1] << 8));
+
+    return ((*pu16Sequence) != FLUFFER_SEQUENCE_BLANK);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Write given block's sequence number, the block must be erased
+ * @param  psFluffer
+ * @param  u8BlockIndex
+ * @param  u16Sequence
+ * @return void
+ * */
+static void Fluffer_vidWriteSequence(const Fluffer_t * const psFluffer, uint8_t u8BlockIndex, uint16_t u16Sequence)
+{
+    uint8_t Local_au8Header[FLUFFER_DEFAULT_MAX_WORD_SIZE] = {				/*	block's header, padding is left clean	*/
+        FLUFFER_CLEAN_BYTE_CONTENT, FLUFFER_CLEAN_BYTE_CONTENT,
+        FLUFFER_CLEAN_BYTE_CONTENT, FLUFFER_CLEAN_BYTE_CONTENT,
+    };
+
+    Local_au8Header[0] = (uint8_t)u16Sequence;
+    Local_au8Header[1] = (uint8_t)(u16Sequence >> 8);
+
+    /*	write header to given block	*/
+    psFluffer->handles.write_handle(FLUFFER_BRAND_ADDRESS(psFluffer, u8BlockIndex), Local_au8Header, FLUFFER_HEADER_SIZE(psFluffer));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Find main buffer, head & tail of a ring
+ * @details Blocks in use are chained by their sequence numbers, the chain is followed back from the
+ *          block with the newest sequence number (tail's block) for up to (blocks - 1) blocks, older
+ *          blocks are left to be erased ahead. Entries are written & marked in order across the
+ *          chain, so head & tail are found by binary search. The memory is prepared for first time
+ *          use if no block is in use.
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidMountRing(Fluffer_t * const psFluffer)
+{
+    uint16_t Local_u16Sequence;						/*	sequence number of a block	*/
+    uint8_t Local_u8Block;							/*	block index	*/
+    uint8_t Local_u8Chain = 0;						/*	blocks in use found, then blocks in the chain	*/
+
+    /*	find the block with the newest sequence number	*/
+    for(Local_u8Block = 0; Local_u8Block < psFluffer->cfg.blocks; Local_u8Block++)
+    {
+        if( Fluffer_u8ReadSequence(psFluffer, Local_u8Block, &Local_u16Sequence) &&
+            (IS_ZERO(Local_u8Chain) || FLUFFER_SEQUENCE_IS_NEWER(Local_u16Sequence, psFluffer->context.sequence)))
+        {
+            psFluffer->context.main_buffer = Local_u8Block;
+            psFluffer->context.sequence = Local_u16Sequence;
+            Local_u8Chain = 1;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    /*	no block is in use, format for 1st time use	*/
+    if(IS_ZERO(Local_u8Chain))
+    {
+        Fluffer_vidPrepareFluffer(psFluffer);
+        psFluffer->context.head = 0;
+        psFluffer->context.tail = 0;
+
+        return;
+    }
+
+    /*	follow the chain back, the block before the main buffer must have the previous sequence number	*/
+    while( (Local_u8Chain < (psFluffer->cfg.blocks - 1)) &&
+           Fluffer_u8ReadSequence(psFluffer, FLUFFER_RING_BLOCK_ID(psFluffer, psFluffer->cfg.blocks - 1), &Local_u16Sequence) &&
+           (Local_u16Sequence == FLUFFER_SEQUENCE_ADD(psFluffer->context.sequence, FLUFFER_SEQUENCE_BLANK - 1)))
+    {
+        psFluffer->context.main_buffer = FLUFFER_RING_BLOCK_ID(psFluffer, psFluffer->cfg.blocks - 1);
+        psFluffer->context.sequence = Local_u16Sequence;
+        Local_u8Chain++;
+    }
+
+    /*	written & marked entries are prefixes of the chain	*/
+    psFluffer->context.tail = Fluffer_u32BisectTail(psFluffer, Local_u8Chain * psFluffer->context.size);
+    psFluffer->context.head = Fluffer_u32BisectHead(psFluffer, psFluffer->context.tail);
+
+    Fluffer_vidReleaseBlocks(psFluffer);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Release main buffer blocks with all entries marked, the block following the main buffer
+ *          becomes the main buffer. Released blocks are erased ahead when the tail gets to them.
+ *          The block holding the last written entry is kept, even if all its entries are marked
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidReleaseBlocks(Fluffer_t * const psFluffer)
+{
+    while((psFluffer->context.head >= psFluffer->context.size) && (psFluffer->context.tail > psFluffer->context.size))
+    {
+        psFluffer->context.main_buffer = FLUFFER_RING_BLOCK_ID(psFluffer, 1);
+        psFluffer->context.sequence = FLUFFER_SEQUENCE_ADD(psFluffer->context.sequence, 1);
+        psFluffer->context.head -= psFluffer->context.size;
+        psFluffer->context.tail -= psFluffer->context.size;
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Move the tail into the next block, called by the write that finds the block holding the
+ *          last written entry full
+ * @details Blocks with all entries marked are released first. If the block following the new tail's
+ *          block is the main buffer, the main buffer's entries are dropped (migration), so a block is
+ *          always free to be erased ahead. The new tail's block is then erased (pages that weren't
+ *          erased ahead) and given the next sequence number.
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidAdvanceBlock(Fluffer_t * const psFluffer)
+{
+    uint16_t Local_u16Block;		/*	new tail's block, counted from main buffer	*/
+
+    Fluffer_vidReleaseBlocks(psFluffer);
+
+    /*	all blocks but the one to be erased ahead are in use, drop main buffer's unmarked entries	*/
+    if(psFluffer->context.tail >= FLUFFER_CAPACITY(psFluffer))
+    {
+        psFluffer->context.main_buffer = FLUFFER_RING_BLOCK_ID(psFluffer, 1);
+        psFluffer->context.sequence = FLUFFER_SEQUENCE_ADD(psFluffer->context.sequence, 1);
+        psFluffer->context.head = 0;
+        psFluffer->context.tail -= psFluffer->context.size;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    Local_u16Block = psFluffer->context.tail / psFluffer->context.size;
+
+    Fluffer_vidBeginSession(psFluffer);
+
+    /*	new tail's block pages that weren't erased ahead by Fluffer_enIdleErase are erased here	*/
+    Fluffer_vidEraseNextBlock(psFluffer);
+
+    /*	chain new tail's block to the main buffer	*/
+    Fluffer_vidWriteSequence(psFluffer, FLUFFER_RING_BLOCK_ID(psFluffer, Local_u16Block), FLUFFER_SEQUENCE_ADD(psFluffer->context.sequence, Local_u16Block));
+
+    Fluffer_vidEndSession(psFluffer);
+
+    /*	erase ahead the block following the new tail's block (no entry is written in it yet)	*/
+    Fluffer_vidScheduleErase(psFluffer, FLUFFER_RING_BLOCK_ID(psFluffer, Local_u16Block + 1));
+}
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Start an incremental clean up if free entries in the main buffer dropped to the clean up
+ *          threshold, at least as many entries are marked, and no clean up is in progress
+ * @details Entries are copied starting from head, no unmarked entry is dropped. With fewer marked entries,
+ *          the clean up is deferred until more entries are marked, or the main buffer is full, where the
+ *          oldest entries are dropped (migration) by a blocking clean up
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidStartCleanUp(Fluffer_t * const psFluffer)
+{
+    /*	check if a clean up is in progress, or main buffer still has enough free entries	*/
+    if( (psFluffer->cleanup.state != FLUFFER_CLEANUP_IDLE) ||
+        ((psFluffer->context.size - psFluffer->context.tail) > FLUFFER_CLEANUP_THRESHOLD(psFluffer)) )
+    {
+        return;
+    }
+
+    /*	check if clean up would free enough entries, otherwise it would be restarted right after	*/
+    if(psFluffer->context.head < FLUFFER_CLEANUP_THRESHOLD(psFluffer))
+    {
+        return;
+    }
+
+    /*	entries written until the copy is done are copied too, they fit as marked entries are dropped	*/
+    psFluffer->cleanup.first_id = psFluffer->context.head;
+    psFluffer->cleanup.next_id = psFluffer->cleanup.first_id;
+    psFluffer->cleanup.block = FLUFFER_NEXT_BLOCK_ID(psFluffer);
+    psFluffer->cleanup.state = FLUFFER_CLEANUP_COPY;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Do a single slice of fluffer instance's pending clean up: copy up to
+ *          FLUFFER_CLEANUP_COPY_ENTRIES entries (then switch main buffer if all entries
+ *          are copied), brand the new main buffer, or erase a page
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidCleanUpSlice(Fluffer_t * const psFluffer)
+{
+    Fluffer_Cleanup_t * const Local_psCleanUp = &psFluffer->cleanup;	/*	instance's clean up state	*/
+    Fluffer_Transfer_t Local_sTransfer;									/*	entries copied by this slice	*/
+
+    /*	previous slice's erase may still be in progress (asynchronous erase handle)	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    if(Local_psCleanUp->state == FLUFFER_CLEANUP_COPY)
+    {
+        /*	clean up is in progress, a partial copy is never taken for a main buffer	*/
+        if(Local_psCleanUp->next_id == Local_psCleanUp->first_id)
+        {
+            Fluffer_vidBrandBlock(psFluffer, Local_psCleanUp->block, FLUFFER_COPY_BUFFER_BRAND);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        Local_sTransfer.src_block = psFluffer->context.main_buffer;
+        Local_sTransfer.src_id = Local_psCleanUp->next_id;
+        Local_sTransfer.dst_block = Local_psCleanUp->block;
+        Local_sTransfer.dst_id = Local_psCleanUp->next_id - Local_psCleanUp->first_id;
+        Local_sTransfer.size = MIN(psFluffer->context.tail, Local_psCleanUp->next_id + FLUFFER_CLEANUP_COPY_ENTRIES);
+
+        Fluffer_vidCopyEntries(psFluffer, &Local_sTransfer);
+        Local_psCleanUp->next_id = Local_sTransfer.size;
+
+        /*	switch in the same slice once copy catches up with the tail, as entries may be written before the next slice	*/
+        if(Local_psCleanUp->next_id == psFluffer->context.tail)
+        {
+            Fluffer_vidSwitchMainBuffer(psFluffer);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+    else if(Local_psCleanUp->state == FLUFFER_CLEANUP_BRAND)
+    {
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+        /*	old main buffer's first page is erased, its erase count is programmed back	*/
+        Fluffer_vidRestoreEraseCount(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+        /*	old main buffer's brand is erased, main buffer brand is programmed over the copy brand	*/
+        Fluffer_vidBrandBlock(psFluffer, psFluffer->context.main_buffer, FLUFFER_MAIN_BUFFER_BRAND);
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+        Fluffer_vidPickNextBlock(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+        /*	block following the new main buffer is erased ahead by the next slices	*/
+        Fluffer_vidScheduleErase(psFluffer, FLUFFER_NEXT_BLOCK_ID(psFluffer));
+    }
+    else if(Local_psCleanUp->state == FLUFFER_CLEANUP_ERASE)
+    {
+        Fluffer_vidErasePage(psFluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Set the block entries were copied into as main buffer, once all entries are copied
+ * @details Entries marked during the copy are marked in the new main buffer, then the old main
+ *          buffer's first page (holding its brand) is erased. The new main buffer is branded by
+ *          the next slice, once the erase is done
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidSwitchMainBuffer(Fluffer_t * const psFluffer)
+{
+    Fluffer_Cleanup_t * const Local_psCleanUp = &psFluffer->cleanup;		/*	instance's clean up state	*/
+    uint8_t Local_u8OldBlock = psFluffer->context.main_buffer;				/*	old main buffer block index	*/
+    uint32_t Local_u32Marked = 0;											/*	copied entries marked during the copy	*/
+
+    if(psFluffer->context.head > Local_psCleanUp->first_id)
+    {
+        Local_u32Marked = psFluffer->context.head - Local_psCleanUp->first_id;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    /*	copied entries start at the new main buffer's first entry	*/
+    psFluffer->context.main_buffer = Local_psCleanUp->block;
+    psFluffer->context.tail = psFluffer->context.tail - Local_psCleanUp->first_id;
+    psFluffer->context.head = Local_u32Marked;
+
+    if(!IS_ZERO(Local_u32Marked))
+    {
+        Fluffer_vidWriteMarks(psFluffer, 0, Local_u32Marked);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	old main buffer's erase count is read before the erase, it's programmed back by the next slice	*/
+    Local_psCleanUp->erase_count = Fluffer_u32NextEraseCount(psFluffer, Local_u8OldBlock);
+    Local_psCleanUp->block = Local_u8OldBlock;
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	erase old main buffer's brand once all entries are copied, so a single block is branded as main buffer.
+     *	With a poll handle, the erase is left running until the next slice	*/
+    psFluffer->handles.erase_handle(FLUFFER_BLOCK_START_PAGE(psFluffer, Local_u8OldBlock));
+
+    /*	new main buffer is branded by the next slice, entries are written to it meanwhile	*/
+    Local_psCleanUp->state = FLUFFER_CLEANUP_BRAND;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Do all remaining slices of fluffer instance's pending clean up
+ * @param   psFluffer
+ * @return  void
+ * */
+static void Fluffer_vidFinishCleanUp(Fluffer_t * const psFluffer)
+{
+    Fluffer_vidBeginSession(psFluffer);
+
+    while(psFluffer->cleanup.state != FLUFFER_CLEANUP_IDLE)
+    {
+        Fluffer_vidCleanUpSlice(psFluffer);
+    }
+
+    /*	entries are written right after	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    Fluffer_vidEndSession(psFluffer);
+}
+
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+/**
+ * @brief  Calculate warm context checksum (fletcher-16, sums start from 0xFF so erased/zeroed
+ *         memory doesn't pass)
+ * @param  psWarmContext
+ * @return checksum of warm context's bytes, except for the checksum itself
+ * */
+static uint16_t Fluffer_u16WarmContextChecksum(const Fluffer_Warm_Context_t * const psWarmContext)
+{
+    const uint8_t * Local_pu8Byte = (const uint8_t *)psWarmContext;							/*	warm context bytes	*/
+    uint16_t Local_u16Len = (uint16_t)offsetof(Fluffer_Warm_Context_t, checksum);			/*	bytes covered by checksum	*/
+    uint16_t Local_u16Sum1 = 0xFF;
+    uint16_t Local_u16Sum2 = 0xFF;
+
+    while(Local_u16Len--)
+    {
+        Local_u16Sum1 = (Local_u16Sum1 + *Local_pu8Byte++) % 0xFF;
+        Local_u16Sum2 = (Local_u16Sum2 + Local_u16Sum1) % 0xFF;
+    }
+
+    return (uint16_t)((Local_u16Sum2 << 8) | Local_u16Sum1);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Load warm context using the instance's load handle and validate its checksum
+ * @param  psFluffer
+ * @param  psWarmContext
+ * @return 1 if a valid warm context was loaded, 0 otherwise
+ * */
+static uint8_t Fluffer_u8LoadWarmContext(const Fluffer_t * const psFluffer, Fluffer_Warm_Context_t * const psWarmContext)
+{
+    /*	read saved warm context	*/
+    if(psFluffer->handles.load_handle((uint8_t *)psWarmContext, sizeof(Fluffer_Warm_Context_t)) != FH_ERR_NONE)
+    {
+        return 0;
+    }
+
+    /*	check saved context wasn't corrupted	*/
+    return (psWarmContext->checksum == Fluffer_u16WarmContextChecksum(psWarmContext));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Restore fluffer instance's context from a saved warm context
+ * @details The saved context is trusted after a spot check of the main buffer's brand, the entries
+ *          around the head (last marked, first unmarked) and around the tail (last written, first empty)
+ * @param   psFluffer
+ * @return  1 if context was restored, 0 otherwise
+ * */
+static uint8_t Fluffer_u8RestoreContext(Fluffer_t * const psFluffer)
+{
+    Fluffer_Warm_Context_t Local_sWarmContext;											/*	saved warm context	*/
+    const Fluffer_Context_t * const Local_psContext = &Local_sWarmContext.context;		/*	saved fluffer context	*/
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    uint16_t Local_u16Sequence;															/*	block's sequence number	*/
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    if(!FLUFFER_HAS_WARM_CONTEXT(psFluffer) || !Fluffer_u8LoadWarmContext(psFluffer, &Local_sWarmContext))
+    {
+        return 0;
+    }
+
+    /*	saved context must match instance configurations	*/
+    if( (Local_psContext->size != FLUFFER_MAX_ENTRIES(psFluffer)) ||
+        (Local_psContext->main_buffer >= psFluffer->cfg.blocks) ||
+        (Local_psContext->head > Local_psContext->tail))
+    {
+        return 0;
+    }
+
+    /*	entries are checked against the saved main buffer	*/
+    psFluffer->context = *Local_psContext;
+
+    /*	a full tail's block is left as is until the next write (FLUFFER_BUFFER_RING only)	*/
+    if( (psFluffer->context.tail > FLUFFER_CAPACITY(psFluffer)) ||
+        ((psFluffer->context.tail == FLUFFER_CAPACITY(psFluffer)) && !FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer)))
+    {
+        return 0;
+    }
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	saved main buffer & tail's block must still be chained with the saved sequence numbers	*/
+    if( !Fluffer_u8ReadSequence(psFluffer, psFluffer->context.main_buffer, &Local_u16Sequence) ||
+        (Local_u16Sequence != psFluffer->context.sequence) ||
+        !Fluffer_u8ReadSequence(psFluffer, FLUFFER_RING_BLOCK_ID(psFluffer, FLUFFER_TAIL_BLOCK(psFluffer)), &Local_u16Sequence) ||
+        (Local_u16Sequence != FLUFFER_SEQUENCE_ADD(psFluffer->context.sequence, FLUFFER_TAIL_BLOCK(psFluffer))))
+    {
+        return 0;
+    }
+#else
+    /*	saved main buffer must still be branded	*/
+    if(!Fluffer_u8IsBranded(psFluffer, psFluffer->context.main_buffer, FLUFFER_MAIN_BUFFER_BRAND))
+    {
+        return 0;
+    }
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	context must have been saved since the main buffer's last clean up	*/
+    if((uint16_t)Fluffer_u32ReadWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, psFluffer->context.main_buffer)) != Local_sWarmContext.generation)
+    {
+        return 0;
+    }
+#endif	/*	FLUFFER_WEAR_MODE	*/
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	entry before head must be marked, head entry must be unmarked (if it's in a written block)	*/
+    if( ((Local_psContext->head > 0) && (Fluffer_u8EntryIsMarked(psFluffer, Local_psContext->head - 1) == FALSE)) ||
+        (((Local_psContext->head < Local_psContext->tail) || !FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer)) &&
+         (Fluffer_u8EntryIsMarked(psFluffer, Local_psContext->head) == TRUE)))
+    {
+        return 0;
+    }
+
+    /*	entry before tail must be written, tail entry must be empty (if it's in a written block)	*/
+    if( ((Local_psContext->tail > 0) && (Fluffer_u8EntryIsEmpty(psFluffer, Local_psContext->tail - 1) == TRUE)) ||
+        (!FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer) && (Fluffer_u8EntryIsEmpty(psFluffer, Local_psContext->tail) == FALSE)))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief  Write consecutive entries to the main buffer starting from tail, with a single write
+ *         handle call. Entries are laid out in the run buffer, each followed by its CRC (FLUFFER_CRC_ENTRY),
+ *         with unmarked marks between them (interleaved layout only).
+ * @param  psFluffer
+ * @param  pu8Data entries data, packed (element_size bytes each)
+ * @param  u16Count number of entries, must fit in main buffer & run buffer
+ * @return void
+ * */
+static void Fluffer_vidWriteRun(Fluffer_t * const psFluffer, const uint8_t * pu8Data, uint16_t u16Count)
+{
+    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psFluffer->context.tail);	/*	1st entry's address	*/
+    uint8_t * Local_pu8Run = FLUFFER_RUN_BUFFER(psFluffer);														/*	run buffer write pointer	*/
+    uint16_t Local_u16Index;																			/*	entry index in run	*/
+
+    for(Local_u16Index = 0; Local_u16Index < u16Count; Local_u16Index++)
+    {
+        /*	copy entry data	*/
+        memcpy(Local_pu8Run, pu8Data, psFluffer->cfg.element_size);
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+        /*	entry's CRC follows its data	*/
+        Fluffer_vidPutCrc(psFluffer, Local_pu8Run);
+#endif	/*	FLUFFER_CRC_MODE	*/
+        Local_pu8Run += FLUFFER_RECORD_SIZE(psFluffer);
+        pu8Data += psFluffer->cfg.element_size;
+
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED
+        /*	next entry's mark is left unmarked	*/
+        if(Local_u16Index < (u16Count - 1))
+        {
+            memset(Local_pu8Run, FLUFFER_ENTRY_UNMARKED, psFluffer->cfg.word_size);
+            Local_pu8Run += psFluffer->cfg.word_size;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+#endif	/*	FLUFFER_LAYOUT	*/
+    }
+
+    /*	write all entries at once	*/
+    psFluffer->handles.write_handle(Local_u32EntryAddress, FLUFFER_RUN_BUFFER(psFluffer), (uint16_t)(Local_pu8Run - FLUFFER_RUN_BUFFER(psFluffer)));
+
+    /*	move tail past written entries	*/
+    psFluffer->context.tail += u16Count;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED) || (FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY)
+
+/**
+ * @brief   Pack consecutive entries read as a single run, in place
+ * @details A run holds entries' data with a mark word (interleaved layout) and the entry's CRC
+ * 			(FLUFFER_CRC_ENTRY) in between each 2 entries, data of each entry is moved back over
+ * 			the marks & CRCs before it, so entries are packed at the run's start
+ * @param   psFluffer
+ * @param   pu8Run pointer to run, its 1st byte is the 1st entry's data
+ * @param   u16Count number of entries in the run
+ * @return  void
+ * */
+static void Fluffer_vidPackRun(const Fluffer_t * const psFluffer, uint8_t * const pu8Run, uint16_t u16Count)
+{
+    uint16_t Local_u16Index;		/*	entry index in run	*/
+
+    /*	1st entry is already in place, destination never passes source so entries are moved in order	*/
+    for(Local_u16Index = 1; Local_u16Index < u16Count; Local_u16Index++)
+    {
+        memmove(&pu8Run[Local_u16Index * psFluffer->cfg.element_size],
+                &pu8Run[Local_u16Index * (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer))],
+                psFluffer->cfg.element_size);
+    }
+}
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Mark consecutive entries of the main buffer, in order
+ * @details Interleaved layout: a write handle call per mark, as marks are separated by entries' data.
+ * 			Bitmap layout: marks are adjacent, so they're written with a single write handle call (per
+ * 			run buffer size)
+ * @param  psFluffer
+ * @param  u32First index of first entry to be marked, must be fluffer's head
+ * @param  u32Count number of entries to mark, all in the same block
+ * @return void
+ * */
+static void Fluffer_vidWriteMarks(const Fluffer_t * const psFluffer, uint32_t u32First, uint32_t u32Count)
+{
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+
+#if FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT
+
+    uint32_t Local_u32Marks = FLUFFER_BLOCK_MARKS_ADDRESS(psFluffer, FLUFFER_ENTRY_BLOCK_ID(psFluffer, u32First));	/*	marks region of entries' block	*/
+    uint32_t Local_u32Slot = FLUFFER_ENTRY_SLOT(psFluffer, u32First);								/*	1st entry's index in its block	*/
+    uint32_t Local_u32Head = Local_u32Slot + u32Count;												/*	head's index in the block after marking	*/
+    uint32_t Local_u32Byte = (Local_u32Slot >> 3) - ((Local_u32Slot >> 3) % psFluffer->cfg.word_size);	/*	1st written marks byte, word aligned	*/
+    uint32_t Local_u32End = (((Local_u32Head - 1) >> 3) / psFluffer->cfg.word_size + 1) * psFluffer->cfg.word_size;	/*	last written marks byte + 1	*/
+    uint16_t Local_u16Chunk;																		/*	marks bytes written per write handle call	*/
+    uint16_t Local_u16Index;																		/*	byte index in chunk	*/
+    uint32_t Local_u32Cleared;																		/*	cleared bits in marks byte	*/
+
+    while(Local_u32Byte < Local_u32End)
+    {
+        Local_u16Chunk = (uint16_t)MIN((Local_u32End - Local_u32Byte), FLUFFER_RUN_SIZE(psFluffer));
+
+        /*	each byte holds all marks up to the new head, already marked bits are written again as 0	*/
+        for(Local_u16Index = 0; Local_u16Index < Local_u16Chunk; Local_u16Index++)
+        {
+            Local_u32Cleared = ((Local_u32Byte + Local_u16Index) << 3);
+            Local_u32Cleared = (Local_u32Head > Local_u32Cleared) ? MIN((Local_u32Head - Local_u32Cleared), 8) : 0;
+
+            FLUFFER_RUN_BUFFER(psFluffer)[Local_u16Index] = (uint8_t)(FLUFFER_ENTRY_UNMARKED >> Local_u32Cleared);
+        }
+
+        psFluffer->handles.write_handle(Local_u32Marks + Local_u32Byte, FLUFFER_RUN_BUFFER(psFluffer), Local_u16Chunk);
+
+        Local_u32Byte += Local_u16Chunk;
+    }
+
+#else
+
+    uint16_t Local_u16RunLimit = FLUFFER_RUN_SIZE(psFluffer) / psFluffer->cfg.word_size;					/*	marks per write handle call	*/
+    uint16_t Local_u16Run;																			/*	marks in current run	*/
+
+    memset(FLUFFER_RUN_BUFFER(psFluffer), FLUFFER_ENTRY_MARKED, MIN(u32Count, Local_u16RunLimit) * psFluffer->cfg.word_size);
+
+    while(u32Count > 0)
+    {
+        Local_u16Run = (uint16_t)MIN(u32Count, Local_u16RunLimit);
+
+        /*	adjacent marks are written at once	*/
+        psFluffer->handles.write_handle(FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u32First), FLUFFER_RUN_BUFFER(psFluffer), Local_u16Run * psFluffer->cfg.word_size);
+
+        u32First += Local_u16Run;
+        u32Count -= Local_u16Run;
+    }
+
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+
+#else
+
+    uint32_t Local_u32EntryMarkAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, u32First);	/*	mark address of entry to be marked	*/
+    const uint8_t Local_au8TempBuffer[FLUFFER_DEFAULT_MAX_WORD_SIZE] = {						/*	entry's mark	*/
+        FLUFFER_ENTRY_MARKED, FLUFFER_ENTRY_MARKED,
+        FLUFFER_ENTRY_MARKED, FLUFFER_ENTRY_MARKED,
+    };
+
+    /*	marks are interleaved with entries' data, so each mark is a separate write	*/
+    while(u32Count--)
+    {
+        psFluffer->handles.write_handle(Local_u32EntryMarkAddress, (uint8_t *)Local_au8TempBuffer, psFluffer->cfg.word_size);
+        Local_u32EntryMarkAddress += FLUFFER_RECORD_SIZE(psFluffer) + psFluffer->cfg.word_size;
+    }
+
+#endif	/*	FLUFFER_LAYOUT	*/
+}
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT) && (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY)
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Count leading zero bits of a byte (marked entries in a marks byte)
+ * @param  u8Byte
+ * @return number of leading zero bits (0 .. 8)
+ * */
+static uint8_t Fluffer_u8CountLeadingZeros(uint8_t u8Byte)
+{
+    uint8_t Local_u8Count = 0;
+
+    while((Local_u8Count < 8) && ((u8Byte & (0x80 >> Local_u8Count)) == 0))
+    {
+        Local_u8Count++;
+    }
+
+    return Local_u8Count;
+}
+
+#endif	/*	FLUFFER_LAYOUT	*/
+
+/* ------------------------------------------------------------------------------------ */
+/* -------------------------------- Public APIs --------------------------------------- */
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enInitHandles(Fluffer_Handles_t * const psHandles, Fluffer_Read_Handle_t pfRead, Fluffer_Write_Handle_t pfWrite, Fluffer_Erase_Handle_t pfErase)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psHandles) || IS_NULLPTR(pfRead) || IS_NULLPTR(pfWrite) || IS_NULLPTR(pfErase))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	optional handles are called whenever they're set	*/
+    memset(psHandles, 0x00, sizeof(Fluffer_Handles_t));
+
+    psHandles->read_handle = pfRead;
+    psHandles->write_handle = pfWrite;
+    psHandles->erase_handle = pfErase;
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enInitialize(Fluffer_t * psFluffer)
+{
+    //uint8_t Local_u8MainBuffer;
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+    uint8_t Local_u8MainBuffers;		/*	count of blocks branded as main buffers	*/
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || !FLUFFER_VALIDATE_HANDLES(psFluffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	validate fluffer memory configurations	*/
+    if(!FLUFFER_VALIDATE_CFG(psFluffer))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+
+#if FLUFFER_WORKSPACE_MODE == FLUFFER_WORKSPACE_INSTANCE
+    /*	workspace must hold an entry, and a run buffer of at least an entry & a mark	*/
+    if(IS_NULLPTR(psFluffer->workspace.buffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    if(psFluffer->workspace.size < FLUFFER_WORKSPACE_SIZE(psFluffer->cfg.element_size, psFluffer->cfg.word_size, FLUFFER_ENTRY_BUFFER_SIZE(psFluffer)))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+#endif	/*	FLUFFER_WORKSPACE_MODE	*/
+
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+    /*	entries cached before are dropped	*/
+    psFluffer->cache.dirty = 0;
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	a block is kept free to be erased ahead, and a migration drops a whole block, so at least 2 other
+     *	blocks are needed. Entries of all other blocks must be indexed by head & tail	*/
+    if((psFluffer->cfg.blocks < 3) || (((uint64_t)(psFluffer->cfg.blocks - 1) * FLUFFER_MAX_ENTRIES(psFluffer)) > FLUFFER_INDEX_MAX))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+#else
+    /*	entries of the main buffer must be indexed by head & tail	*/
+    if(FLUFFER_MAX_ENTRIES(psFluffer) > FLUFFER_INDEX_MAX)
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    /*	use saved warm context if it still matches the main buffer	*/
+    if(Fluffer_u8RestoreContext(psFluffer))
+    {
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+        /*	erase counts may have changed since the context was saved	*/
+        Fluffer_vidPickNextBlock(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+        /*	next block may have been left unerased (power loss), it's checked before it's used	*/
+        Fluffer_vidScheduleErase(psFluffer, FLUFFER_NEXT_BLOCK_ID(psFluffer));
+
+        return FLUFFER_ERROR_NONE;
+    }
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+    /*	set fluffer size (number of entries per block)	*/
+    psFluffer->context.size = FLUFFER_MAX_ENTRIES(psFluffer);
+
+    /*	find main buffer, head & tail	*/
+    Fluffer_vidMountRing(psFluffer);
+
+#else
+
+    /*	check blocks for main buffer	*/
+    //if(Fluffer_u8GetMainBufferBlocks(psFluffer, &Local_u8MainBuffer) != 1)
+    Local_u8MainBuffers = Fluffer_u8GetBrandedBlocks(psFluffer, &psFluffer->context.main_buffer, FLUFFER_MAIN_BUFFER_BRAND);
+
+    /*	clean up was interrupted after the old main buffer's brand was erased, all entries were copied already
+     *	so the copy is branded as main buffer, finishing the clean up	*/
+    if(IS_ZERO(Local_u8MainBuffers) && (Fluffer_u8GetBrandedBlocks(psFluffer, &psFluffer->context.main_buffer, FLUFFER_COPY_BUFFER_BRAND) == 1))
+    {
+        Fluffer_vidBeginSession(psFluffer);
+        Fluffer_vidBrandBlock(psFluffer, psFluffer->context.main_buffer, FLUFFER_MAIN_BUFFER_BRAND);
+        Fluffer_vidEndSession(psFluffer);
+    }
+    else if(Local_u8MainBuffers != 1)
+    {
+        /* if main blocks == 0: format for 1st time use
+         * if main blocks >  1: memory is corrupt
+         * in both cases, the memory is reformatted. In case of memory corruption,
+         * old data is lost
+         * */
+        Fluffer_vidPrepareFluffer(psFluffer);
+    }
+    else
+    {
+        //psFluffer->context.main_buffer = Local_u8MainBuffer;
+    }
+
+    /*	set fluffer size (number of entries)	*/
+    psFluffer->context.size = FLUFFER_MAX_ENTRIES(psFluffer);
+
+#if FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT
+
+    /*	binary search for tail, then for head in the written entries	*/
+    psFluffer->context.tail = Fluffer_u32BisectTail(psFluffer, psFluffer->context.size);
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+    /*	marks are packed, a bulk scan of the marks region is cheaper than probing marks one by one	*/
+    psFluffer->context.head = Fluffer_u32FindHead(psFluffer);
+#else
+    psFluffer->context.head = Fluffer_u32BisectHead(psFluffer, psFluffer->context.tail);
+#endif	/*	FLUFFER_LAYOUT	*/
+
+    /*	main buffer is not a clean prefix, fall back to linear scan	*/
+    if(!Fluffer_u8BoundsAreValid(psFluffer, psFluffer->context.head, psFluffer->context.tail))
+    {
+        psFluffer->context.head = Fluffer_u32FindHead(psFluffer);
+        psFluffer->context.tail = Fluffer_u32FindTail(psFluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+#else
+
+    /*	find head	*/
+    psFluffer->context.head = Fluffer_u32FindHead(psFluffer);
+
+    /*	find tail	*/
+    psFluffer->context.tail = Fluffer_u32FindTail(psFluffer);
+
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	a copy cut by a reset is picked, so it's erased ahead	*/
+    Fluffer_vidPickNextBlock(psFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	next block may have been left unerased (power loss), it's checked before it's used	*/
+    Fluffer_vidScheduleErase(psFluffer, FLUFFER_NEXT_BLOCK_ID(psFluffer));
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+    /*	clean up was interrupted while entries were copied (partial copy is left with the copy brand), it's
+     *	done again into the next block, as the write that filled the main buffer would have	*/
+    if(FLUFFER_IS_FULL(psFluffer))
+    {
+        Fluffer_vidCleanUp(psFluffer, 1);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	save found context, so the next initialization can skip the search	*/
+    if(FLUFFER_HAS_WARM_CONTEXT(psFluffer))
+    {
+        Fluffer_enSaveContext(psFluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enSaveContext(const Fluffer_t * const psFluffer)
+{
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+    Fluffer_Warm_Context_t Local_sWarmContext;		/*	warm context to be saved	*/
+    uint16_t Local_u16Generation = 0;				/*	warm context generation	*/
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+
+    if(!FLUFFER_HAS_WARM_CONTEXT(psFluffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    /*	generation is the main buffer's clean up sequence number, so a context saved before later clean ups
+     *	into the same block is rejected	*/
+    Fluffer_vidWaitReady(psFluffer);
+    Local_u16Generation = (uint16_t)Fluffer_u32ReadWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, psFluffer->context.main_buffer));
+#else
+    /*	continue generation count of the last saved context	*/
+    if(Fluffer_u8LoadWarmContext(psFluffer, &Local_sWarmContext))
+    {
+        Local_u16Generation = Local_sWarmContext.generation + 1;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	clear padding bytes, they're covered by the checksum	*/
+    memset(&Local_sWarmContext, 0x00, sizeof(Fluffer_Warm_Context_t));
+
+    Local_sWarmContext.context = psFluffer->context;
+    Local_sWarmContext.generation = Local_u16Generation;
+    Local_sWarmContext.checksum = Fluffer_u16WarmContextChecksum(&Local_sWarmContext);
+
+    /*	save warm context	*/
+    if(psFluffer->handles.save_handle((uint8_t *)&Local_sWarmContext, sizeof(Fluffer_Warm_Context_t)) != FH_ERR_NONE)
+    {
+        return FLUFFER_ERROR_MEMORY;
+    }
+
+    return FLUFFER_ERROR_NONE;
+
+#else
+
+    /*	warm contexts aren't kept	*/
+    return FLUFFER_ERROR_PARAM;
+
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enInitReader(const Fluffer_t * const psFluffer, Fluffer_Reader_t * psReader)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	set reader entry id to fluffer's instance head	*/
+    psReader->id = psFluffer->context.head;
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enIsEmpty(const Fluffer_t * const psFluffer, uint8_t * pu8Result)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Result))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    (*pu8Result) = FLUFFER_IS_EMPTY(psFluffer);
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enIsFull(const Fluffer_t * const psFluffer, uint8_t * pu8Result)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Result))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    (*pu8Result) = FLUFFER_IS_FULL(psFluffer);
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enIsBusy(const Fluffer_t * const psFluffer, uint8_t * pu8Result)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Result))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    (*pu8Result) = Fluffer_u8IsBusy(psFluffer);
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enReadEntry(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t * const pu8Buffer)
+{
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    uint8_t Local_u8Valid;																	/*	entry's CRC matches its data	*/
+#else
+    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psReader->id);	/*	entry's memory address	*/
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader) || IS_NULLPTR(pu8Buffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check if fluffer is empty or reader head == tail	*/
+    if(FLUFFER_IS_EMPTY(psFluffer) || (psReader->id == psFluffer->context.tail))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+
+    /*	read entry's record into temp buffer, and check it	*/
+    Local_u8Valid = Fluffer_u8EntryIsValid(psFluffer, psReader->id);
+
+    /*	copy entry's data into given buffer	*/
+    memcpy(pu8Buffer, FLUFFER_ENTRY_BUFFER(psFluffer), psFluffer->cfg.element_size);
+
+    /*	increment reader's id	*/
+    psReader->id++;
+
+    return Local_u8Valid ? FLUFFER_ERROR_NONE : FLUFFER_ERROR_CRC;
+
+#else
+
+    /*	read entry into given buffer */
+    psFluffer->handles.read_handle(Local_u32EntryAddress, (uint8_t *)pu8Buffer, psFluffer->cfg.element_size);
+
+    /*	increment reader's id	*/
+    psReader->id++;
+
+    return FLUFFER_ERROR_NONE;
+
+#endif	/*	FLUFFER_CRC_MODE	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enReadEntries(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t * const pu8Buffer, uint16_t u16Max, uint16_t * const pu16Count)
+{
+    uint16_t Local_u16Count;		/*	entries to read	*/
+    uint32_t Local_u32RunLimit;		/*	maximum entries of a run that fits in the given buffer	*/
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    Fluffer_Error_t Local_enError = FLUFFER_ERROR_NONE;	/*	set if run's first entry fails its CRC	*/
+    uint16_t Local_u16Index;							/*	valid entries at run's start	*/
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader) || IS_NULLPTR(pu8Buffer) || IS_NULLPTR(pu16Count))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    (*pu16Count) = 0;
+
+    if(IS_ZERO(u16Max))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+
+    /*	check if fluffer is empty or reader head == tail	*/
+    if(FLUFFER_IS_EMPTY(psFluffer) || (psReader->id >= psFluffer->context.tail))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	run is read into the given buffer as is (marks & CRCs included), then packed	*/
+    Local_u32RunLimit = (((uint32_t)u16Max * psFluffer->cfg.element_size) + FLUFFER_MARK_GAP(psFluffer)) / (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer));
+
+    /*	read handle's length is 16 bit, a run is at most UINT16_MAX bytes	*/
+    Local_u32RunLimit = MIN(Local_u32RunLimit, ((uint32_t)UINT16_MAX + FLUFFER_MARK_GAP(psFluffer)) / (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer)));
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    /*	an entry's record doesn't fit in the given buffer, it's read through the entry buffer	*/
+    if(IS_ZERO(Local_u32RunLimit))
+    {
+        Local_enError = Fluffer_enReadEntry(psFluffer, psReader, pu8Buffer);
+        (*pu16Count) = 1;
+
+        return Local_enError;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+    Local_u16Count = (uint16_t)MIN(Local_u32RunLimit, (uint32_t)(psFluffer->context.tail - psReader->id));
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	blocks are not contiguous, a run ends at the end of its block	*/
+    Local_u16Count = (uint16_t)MIN((uint32_t)Local_u16Count, ((uint32_t)psFluffer->context.size - FLUFFER_ENTRY_SLOT(psFluffer, psReader->id)));
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    /*	read all entries at once */
+    psFluffer->handles.read_handle(FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psReader->id), pu8Buffer,
+                                   (uint16_t)((Local_u16Count * (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer))) - FLUFFER_MARK_GAP(psFluffer)));
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    /*	entries are checked before their CRCs are packed over	*/
+    Local_u16Index = 0;
+    while((Local_u16Index < Local_u16Count) &&
+          Fluffer_u8RecordIsValid(psFluffer, &pu8Buffer[Local_u16Index * (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer))]))
+    {
+        Local_u16Index++;
+    }
+
+    /*	run stops before the first corrupt entry, which is then returned alone (as Fluffer_enReadEntry does)	*/
+    if(IS_ZERO(Local_u16Index))
+    {
+        Local_u16Count = 1;
+        Local_enError = FLUFFER_ERROR_CRC;
+    }
+    else
+    {
+        Local_u16Count = Local_u16Index;
+    }
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_INTERLEAVED) || (FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY)
+    Fluffer_vidPackRun(psFluffer, pu8Buffer, Local_u16Count);
+#endif	/*	FLUFFER_LAYOUT	*/
+
+    /*	move reader past read entries	*/
+    psReader->id += Local_u16Count;
+    (*pu16Count) = Local_u16Count;
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    return Local_enError;
+#else
+    return FLUFFER_ERROR_NONE;
+#endif	/*	FLUFFER_CRC_MODE	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enPeekEntry(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, const uint8_t ** const ppu8Entry, uint16_t * const pu16Len)
+{
+    const uint8_t * Local_pu8Base;		/*	pointer to memory offset 0	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader) || IS_NULLPTR(ppu8Entry) || IS_NULLPTR(pu16Len) || IS_NULLPTR(psFluffer->handles.map_handle))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check if fluffer is empty or reader head == tail	*/
+    if(FLUFFER_IS_EMPTY(psFluffer) || (psReader->id >= psFluffer->context.tail))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    Local_pu8Base = psFluffer->handles.map_handle();
+
+    if(IS_NULLPTR(Local_pu8Base))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	point to entry in memory	*/
+    (*ppu8Entry) = Local_pu8Base + FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psReader->id);
+    (*pu16Len) = psFluffer->cfg.element_size;
+
+    /*	increment reader's id	*/
+    psReader->id++;
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    /*	entry's CRC follows its data in memory	*/
+    return Fluffer_u8RecordIsValid(psFluffer, *ppu8Entry) ? FLUFFER_ERROR_NONE : FLUFFER_ERROR_CRC;
+#else
+    return FLUFFER_ERROR_NONE;
+#endif	/*	FLUFFER_CRC_MODE	*/
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enMarkEntry(Fluffer_t * const psFluffer)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check if fluffer is empty	*/
+    if(FLUFFER_IS_EMPTY(psFluffer))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    /*	write to head's mark	*/
+    Fluffer_vidWriteMarks(psFluffer, psFluffer->context.head, 1);
+
+    /*	increment fluffer instance's head	*/
+    psFluffer->context.head++;
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enMarkEntries(Fluffer_t * const psFluffer, uint16_t u16Count)
+{
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    uint16_t Local_u16Marks;		/*	entries marked in head's block	*/
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check if fluffer is empty	*/
+    if(FLUFFER_IS_EMPTY(psFluffer))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	can't mark more entries than the main buffer holds	*/
+    if(IS_ZERO(u16Count) || (u16Count > FLUFFER_CURRENT_ENTRIES(psFluffer)))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    Fluffer_vidBeginSession(psFluffer);
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+
+    /*	marks of different blocks are not adjacent, they're written block by block	*/
+    while(u16Count > 0)
+    {
+        Local_u16Marks = (uint16_t)MIN((uint32_t)u16Count, ((uint32_t)psFluffer->context.size - FLUFFER_ENTRY_SLOT(psFluffer, psFluffer->context.head)));
+
+        Fluffer_vidWriteMarks(psFluffer, psFluffer->context.head, Local_u16Marks);
+
+        psFluffer->context.head += Local_u16Marks;
+        u16Count -= Local_u16Marks;
+    }
+
+#else
+
+    /*	marks are written in order, so marked entries remain a prefix of the main buffer if power is lost midway	*/
+    Fluffer_vidWriteMarks(psFluffer, psFluffer->context.head, u16Count);
+
+    /*	move fluffer instance's head past marked entries	*/
+    psFluffer->context.head += u16Count;
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    Fluffer_vidEndSession(psFluffer);
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enGetEntryState(const Fluffer_t * const psFluffer, const Fluffer_Reader_t * const psReader, uint8_t * const pu8State)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader) || IS_NULLPTR(pu8State))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check if reader points to an unmarked entry	*/
+    if((psReader->id < psFluffer->context.head) || (psReader->id >= psFluffer->context.tail))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
+
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
+
+    (*pu8State) = Fluffer_u8ReadState(psFluffer, psReader->id);
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enAdvanceEntry(Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t u8State)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+#if FLUFFER_MARK_STATES > 2
+
+    /*	entries are marked (last state) by Fluffer_enMarkEntry, in order	*/
+    if(IS_ZERO(u8State) || (u8State > (FLUFFER_MARK_STATES - 2)))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+
+    /*	check if reader points to an unmarked entry	*/
+    if((psReader->id < psFluffer->context.head) || (psReader->id >= psFluffer->context.tail))
+    {
+        return FLUFFER_ERROR_EMPTY;
+    }
 
-/**
- * @brief  Find the index of the first unmarked entry in the main buffer of the given
- *         fluffer instance
- * @param  psFluffer
- * @return index of fluffer's head
- * */
-static uint16_t Fluffer_u16FindHead(const Fluffer_t * const psFluffer)
-{
-    uint16_t Local_u16EntryIndex = 0;								/*	entry index	*/
-    FlagStatus Local_enHeadFound = RESET;							/*	fluffer head found flag	*/
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
 
-    /*	loop over entries in fluffer instance's main buffer	*/
-    while((Local_u16EntryIndex < psFluffer->context.size) && (Local_enHeadFound == RESET))
+    /*	a state is never cleared back, an entry already at the given state isn't written again	*/
+    if(Fluffer_u8ReadState(psFluffer, psReader->id) < u8State)
     {
-        /*	check if entry is not marked	*/
-        if(Fluffer_u8EntryIsMarked(psFluffer, Local_u16EntryIndex) == FALSE)
+        Fluffer_vidWriteState(psFluffer, FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, psReader->id), u8State);
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+        /*	entry's copy is advanced too, so its state isn't lost when the main buffer is switched	*/
+        if( (psFluffer->cleanup.state == FLUFFER_CLEANUP_COPY) &&
+            (psReader->id >= psFluffer->cleanup.first_id) && (psReader->id < psFluffer->cleanup.next_id) )
         {
-            Local_enHeadFound = SET;
+            Fluffer_vidWriteState(psFluffer, FLUFFER_BLOCK_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, psFluffer->cleanup.block,
+                                  psReader->id - psFluffer->cleanup.first_id), u8State);
         }
         else
         {
-            /*	increment entry index	*/
-            Local_u16EntryIndex++;
+            /*	do nothing	*/
         }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+    }
+    else
+    {
+        /*	do nothing	*/
     }
 
-    /*	save head address offset	*/
-    return (Local_enHeadFound == SET) ? Local_u16EntryIndex : 0;
+    /*	increment reader's id	*/
+    psReader->id++;
+
+    return FLUFFER_ERROR_NONE;
+
+#else
+
+    /*	no intermediate states	*/
+    (void)u8State;
+
+    return FLUFFER_ERROR_PARAM;
+
+#endif	/*	FLUFFER_MARK_STATES	*/
 }
 
 /* ------------------------------------------------------------------------------------ */
 
-/**
- * @brief  Find the first empty entry's index in the main buffer of the given fluffer instance
- * @param  psFluffer
- * @return Index of fluffer's tail
- * */
-static uint16_t Fluffer_u16FindTail(const Fluffer_t * const psFluffer)
+Fluffer_Error_t Fluffer_enWriteEntry(Fluffer_t * const psFluffer, uint8_t * const pu8Data)
 {
-    uint16_t Local_u16EntryIndex = 0;									/*	entry index	*/
-    FlagStatus Local_enTailFound = RESET;								/*	fluffer tail found flag	*/
+#if FLUFFER_CRC_MODE != FLUFFER_CRC_ENTRY
+    uint32_t Local_u32EntryAddress;		/*	entry's address	*/
+#endif	/*	FLUFFER_CRC_MODE	*/
 
-    /*	loop over entries in fluffer instance's main buffer	*/
-    while((Local_u16EntryIndex < psFluffer->context.size) && (Local_enTailFound == RESET))
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+    /*	coalesce entry with the cached ones, they're written by a single run once max dirty is reached	*/
+    if(FLUFFER_HAS_CACHE(psFluffer))
     {
-        /*	check if entry is empty	*/
-        if(Fluffer_u8EntryIsEmpty(psFluffer, Local_u16EntryIndex) == TRUE)
+        memcpy(&psFluffer->cache.buffer[psFluffer->cache.dirty * psFluffer->cfg.element_size], pu8Data, psFluffer->cfg.element_size);
+        psFluffer->cache.dirty++;
+
+        /*	while an erase is in progress (poll handle), entries are kept cached up to capacity	*/
+        if((psFluffer->cache.dirty >= FLUFFER_CACHE_LIMIT(psFluffer)) &&
+           ((psFluffer->cache.dirty >= psFluffer->cache.capacity) || !Fluffer_u8IsBusy(psFluffer)))
         {
-            Local_enTailFound = SET;
+            return Fluffer_enFlush(psFluffer);
         }
         else
         {
-            Local_u16EntryIndex++;
+            return FLUFFER_ERROR_NONE;
         }
     }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_CACHE_MODE	*/
 
-    /*	save head address offset	*/
-    return (Local_enTailFound == SET) ? Local_u16EntryIndex : 0;
-}
-
-/* ------------------------------------------------------------------------------------ */
-
-/**
- * @brief  Copies unmarked entries from source block, into the destination block starting from the given entry ID
- * @param
- * @param
- * @param
- * @param
- * @return void
- * */
-static void Fluffer_vidCopyEntries(const Fluffer_t * const psFluffer, const Fluffer_Transfer_t * const psTransfer)
-{
-    uint32_t Local_u32ReadAddress;		    				/*	source block entry's address		*/
-    uint32_t Local_u32WriteAddress;		    				/*	destination block entry's address	*/
-    uint16_t Local_u16ReadIndex = psTransfer->src_id;		/*	read index in source block	*/
-    uint16_t Local_u16WriteIndex = psTransfer->dst_id;	    /*	write index in destination block	*/
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
 
-    /*	loop over entries in the source block	*/
-    while(Local_u16ReadIndex < psTransfer->size)
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	check if last written entry's block is full	*/
+    if(FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer))
     {
-        /*	get source block entry's address	*/
-        Local_u32ReadAddress = FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, psTransfer->src_block, Local_u16ReadIndex);
+        Fluffer_vidAdvanceBlock(psFluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_BUFFER_MODE	*/
 
-        /*	get destination block entry's address	*/
-        Local_u32WriteAddress = FLUFFER_BLOCK_ENTRY_ADDRESS_BY_ID(psFluffer, psTransfer->dst_block, Local_u16WriteIndex);
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
 
-        /*	read entry from source buffer into temp buffer	*/
-        psFluffer->handles.read_handle(Local_u32ReadAddress, Fluffer_au8EntryBuffer, psFluffer->cfg.element_size);
+    /*	entry's record (data & CRC) is laid out in the run buffer, written by a single write handle call	*/
+    Fluffer_vidWriteRun(psFluffer, pu8Data, 1);
 
-        /*	write entry from temp buffer into destination block	*/
-        psFluffer->handles.write_handle(Local_u32WriteAddress, Fluffer_au8EntryBuffer, psFluffer->cfg.element_size);
+#else
 
-        /*	increment write index	*/
-        Local_u16WriteIndex++;
+    Local_u32EntryAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psFluffer->context.tail);
 
-        /*	increment read index	*/
-        Local_u16ReadIndex++;
-    }
-}
+    /*	write entry to main buffer	*/
+    psFluffer->handles.write_handle(Local_u32EntryAddress, pu8Data, psFluffer->cfg.element_size);
 
-/* ------------------------------------------------------------------------------------ */
+    /*	increment tail	*/
+    psFluffer->context.tail++;
 
-/**
- * @brief   Clean up fluffer instance
- * @details Copy all unmarked entries from the current main buffer to the next secondary buffer
- * 			then erase the current main buffer, finally set secondary buffer as main buffer
- * @param   psFluffer
- * @return  void
- * */
-static void Fluffer_vidCleanUp(Fluffer_t * const psFluffer)
-{
-    uint8_t Local_u8NextBlock = FLUFFER_NEXT_BLOCK_ID(psFluffer);
-    uint8_t Local_u8PageIndex = 0;
+#endif	/*	FLUFFER_CRC_MODE	*/
 
-    Fluffer_Transfer_t Local_sTransfer = {
-        .src_block = psFluffer->context.main_buffer,
-        .src_id = psFluffer->context.head,
-        .dst_block = Local_u8NextBlock,
-        .dst_id = 0,
-        .size = psFluffer->context.tail
-    };
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
 
-    /*	check if current entries == buffer size	*/
-    if(FLUFFER_CURRENT_ENTRIES(psFluffer) == psFluffer->context.size)
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+    /*	pending clean up wasn't done by Fluffer_enService in time, finish it now	*/
+    if(FLUFFER_IS_FULL(psFluffer))
     {
-        Local_sTransfer.src_id++;
+        Fluffer_vidFinishCleanUp(psFluffer);
     }
     else
     {
         /*	do nothing	*/
     }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
 
-    /*	copy entries from current main buffer block to the next block	*/
-    Fluffer_vidCopyEntries(psFluffer, &Local_sTransfer);
-
-    /*	set next block as main buffer	*/
-    Fluffer_vidBrandBlock(psFluffer, Local_u8NextBlock);
-
-    /*	erase old buffer pages	*/
-    for(;Local_u8PageIndex < psFluffer->cfg.pages_pre_block; Local_u8PageIndex++)
+    /*	check if main buffer is full	*/
+    if(FLUFFER_IS_FULL(psFluffer))
+    {
+        Fluffer_vidCleanUp(psFluffer, 1);
+    }
+    else
     {
-        psFluffer->handles.erase_handle(FLUFFER_BLOCK_START_PAGE(psFluffer, psFluffer->context.main_buffer) + Local_u8PageIndex);
+        /*	do nothing	*/
     }
 
-    /*	set main buffer	*/
-    psFluffer->context.main_buffer = Local_u8NextBlock;
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+    /*	start clean up before the main buffer is full	*/
+    Fluffer_vidStartCleanUp(psFluffer);
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
 
-    /*	set new head & tail	*/
-    psFluffer->context.tail = psFluffer->context.tail - Local_sTransfer.src_id;
-    psFluffer->context.head = 0;
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+    return FLUFFER_ERROR_NONE;
 }
 
-/* ------------------------------------------------------------------------------------ */
-/* -------------------------------- Public APIs --------------------------------------- */
 /* ------------------------------------------------------------------------------------ */
 
-Fluffer_Error_t Fluffer_enInitialize(Fluffer_t * psFluffer)
+Fluffer_Error_t Fluffer_enWriteEntries(Fluffer_t * const psFluffer, uint8_t * const pu8Data, uint16_t u16Count, uint16_t * const pu16Written)
 {
-    //uint8_t Local_u8MainBuffer;
+    uint16_t Local_u16Index = 0;		/*	index of next entry to be written	*/
+    uint16_t Local_u16RunLimit;			/*	maximum entries in a single run	*/
+    uint16_t Local_u16Run;				/*	entries in current run	*/
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+    uint16_t Local_u16Remaining;		/*	entries left after main buffer is full	*/
+    uint32_t Local_u32Left;				/*	free entries left after the rest of the batch is written	*/
+#endif	/*	FLUFFER_BUFFER_MODE	*/
 
     /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer) || !FLUFFER_VALIDATE_HANDLES(psFluffer))
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Data) || IS_NULLPTR(pu16Written))
     {
         return FLUFFER_ERROR_NULLPTR;
     }
 
-    /*	validate fluffer memory configurations	*/
-    if(!FLUFFER_VALIDATE_CFG(psFluffer))
-    {
-        return FLUFFER_ERROR_PARAM;
-    }
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
 
-    /*	check blocks for main buffer	*/
-    //if(Fluffer_u8GetMainBufferBlocks(psFluffer, &Local_u8MainBuffer) != 1)
-    if(Fluffer_u8GetMainBufferBlocks(psFluffer, &psFluffer->context.main_buffer) != 1)
-    {
-        /* if main blocks == 0: format for 1st time use
-         * if main blocks >  1: memory is corrupt
-         * in both cases, the memory is reformatted. In case of memory corruption,
-         * old data is lost
-         * */
-        Fluffer_vidPrepareFluffer(psFluffer);
-    }
-    else
+    /*	runs, clean up & cached entries share a single programming session	*/
+    Fluffer_vidBeginSession(psFluffer);
+
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+    /*	cached entries are older, they're written first	*/
+    Fluffer_enFlush(psFluffer);
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+    /*	entries that fit in the run buffer: record, then (mark, record) for each following entry	*/
+    Local_u16RunLimit = (FLUFFER_RUN_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer)) / (FLUFFER_RECORD_SIZE(psFluffer) + FLUFFER_MARK_GAP(psFluffer));
+
+    while(Local_u16Index < u16Count)
     {
-        //psFluffer->context.main_buffer = Local_u8MainBuffer;
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+        /*	check if last written entry's block is full	*/
+        if(FLUFFER_TAIL_BLOCK_IS_FULL(psFluffer))
+        {
+            Fluffer_vidAdvanceBlock(psFluffer);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+        /*	split run at main buffer's end (tail's block end with FLUFFER_BUFFER_RING)	*/
+        Local_u16Run = (uint16_t)MIN((uint32_t)(u16Count - Local_u16Index), (uint32_t)FLUFFER_BLOCK_ROOM(psFluffer));
+        Local_u16Run = MIN(Local_u16Run, Local_u16RunLimit);
+
+        Fluffer_vidWriteRun(psFluffer, &pu8Data[Local_u16Index * psFluffer->cfg.element_size], Local_u16Run);
+        Local_u16Index += Local_u16Run;
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+        /*	pending clean up wasn't done by Fluffer_enService in time, finish it now	*/
+        if(FLUFFER_IS_FULL(psFluffer))
+        {
+            Fluffer_vidFinishCleanUp(psFluffer);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+        /*	check if main buffer is full	*/
+        if(FLUFFER_IS_FULL(psFluffer))
+        {
+            Local_u16Remaining = u16Count - Local_u16Index;
+
+            /*	free entries single entry writes would leave: the 1st clean up frees the marked entries, or
+             *	FLUFFER_EVICT_ENTRIES, each following one (no entries marked) frees FLUFFER_EVICT_ENTRIES	*/
+            Local_u32Left = MAX(psFluffer->context.head, FLUFFER_EVICT_ENTRIES(psFluffer));
+            if(Local_u16Remaining < Local_u32Left)
+            {
+                Local_u32Left = Local_u32Left - Local_u16Remaining;
+            }
+            else
+            {
+                Local_u32Left = FLUFFER_EVICT_ENTRIES(psFluffer) - ((Local_u16Remaining - Local_u32Left) % FLUFFER_EVICT_ENTRIES(psFluffer));
+            }
+
+            /*	entries that would be dropped by the migration anyway are skipped	*/
+            if(((uint32_t)Local_u16Remaining + Local_u32Left) > psFluffer->context.size)
+            {
+                Local_u16Index += (uint16_t)(Local_u16Remaining - (psFluffer->context.size - Local_u32Left));
+                Local_u16Remaining = (uint16_t)(psFluffer->context.size - Local_u32Left);
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+
+            /*	single clean up, leaves enough space for the rest of the batch & keeps main buffer not full	*/
+            Fluffer_vidCleanUp(psFluffer, Local_u16Remaining + Local_u32Left);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
     }
 
-    /*	set fluffer size (number of entries)	*/
-    psFluffer->context.size = FLUFFER_MAX_ENTRIES(psFluffer);
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+    /*	start clean up before the main buffer is full	*/
+    Fluffer_vidStartCleanUp(psFluffer);
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
 
-    /*	find head	*/
-    psFluffer->context.head = Fluffer_u16FindHead(psFluffer);
+    Fluffer_vidEndSession(psFluffer);
 
-    /*	find tail	*/
-    psFluffer->context.tail = Fluffer_u16FindTail(psFluffer);
+    (*pu16Written) = Local_u16Index;
 
     return FLUFFER_ERROR_NONE;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
-Fluffer_Error_t Fluffer_enInitReader(const Fluffer_t * const psFluffer, Fluffer_Reader_t * psReader)
+Fluffer_Error_t Fluffer_enFlush(Fluffer_t * const psFluffer)
 {
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+    uint16_t Local_u16Count;			/*	cached entries	*/
+    uint16_t Local_u16Written;
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
     /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader))
+    if(IS_NULLPTR(psFluffer))
     {
         return FLUFFER_ERROR_NULLPTR;
     }
 
-    /*	set reader entry id to fluffer's instance head	*/
-    psReader->id = psFluffer->context.head;
+#if FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+    if(FLUFFER_HAS_CACHE(psFluffer) && !IS_ZERO(psFluffer->cache.dirty))
+    {
+        /*	cache is emptied first, so the write doesn't flush it again	*/
+        Local_u16Count = psFluffer->cache.dirty;
+        psFluffer->cache.dirty = 0;
+
+        return Fluffer_enWriteEntries(psFluffer, psFluffer->cache.buffer, Local_u16Count, &Local_u16Written);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_CACHE_MODE	*/
 
     return FLUFFER_ERROR_NONE;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
-Fluffer_Error_t Fluffer_enIsEmpty(const Fluffer_t * const psFluffer, uint8_t * pu8Result)
+Fluffer_Error_t Fluffer_enService(Fluffer_t * const psFluffer, uint16_t u16Budget)
 {
     /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Result))
+    if(IS_NULLPTR(psFluffer))
     {
         return FLUFFER_ERROR_NULLPTR;
     }
 
-    (*pu8Result) = FLUFFER_IS_EMPTY(psFluffer);
+    /*	at least a single slice must be done	*/
+    if(IS_ZERO(u16Budget))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
 
-    return FLUFFER_ERROR_NONE;
-}
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+    /*	free entries may have dropped to threshold while the previous clean up was in progress	*/
+    Fluffer_vidStartCleanUp(psFluffer);
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
 
-/* ------------------------------------------------------------------------------------ */
+    Fluffer_vidBeginSession(psFluffer);
 
-Fluffer_Error_t Fluffer_enIsFull(const Fluffer_t * const psFluffer, uint8_t * pu8Result)
-{
-    /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(pu8Result))
+    /*	no slice waits for an erase started by the previous one (asynchronous erase handle), the caller
+     *	calls again once it's done	*/
+    while((psFluffer->cleanup.state != FLUFFER_CLEANUP_IDLE) && !IS_ZERO(u16Budget) && !Fluffer_u8IsBusy(psFluffer))
     {
-        return FLUFFER_ERROR_NULLPTR;
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+        Fluffer_vidCleanUpSlice(psFluffer);
+#else
+        /*	clean up is done by the write that fills the main buffer, only the next block's erase is pending	*/
+        Fluffer_vidErasePage(psFluffer);
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+        u16Budget--;
     }
 
-    (*pu8Result) = FLUFFER_IS_FULL(psFluffer);
+    Fluffer_vidEndSession(psFluffer);
 
-    return FLUFFER_ERROR_NONE;
+    return ((psFluffer->cleanup.state == FLUFFER_CLEANUP_IDLE) && !Fluffer_u8IsBusy(psFluffer)) ? FLUFFER_ERROR_NONE : FLUFFER_ERROR_BUSY;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
-Fluffer_Error_t Fluffer_enReadEntry(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t * const pu8Buffer)
+Fluffer_Error_t Fluffer_enIdleErase(Fluffer_t * const psFluffer)
 {
-    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psReader->id);	/*	entry's memory address	*/
-
     /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psReader) || IS_NULLPTR(pu8Buffer))
+    if(IS_NULLPTR(psFluffer))
     {
         return FLUFFER_ERROR_NULLPTR;
     }
 
-    /*	check if fluffer is empty or reader head == tail	*/
-    if(FLUFFER_IS_EMPTY(psFluffer) || (psReader->id == psFluffer->context.tail))
+    /*	entries are being copied into the next block, it's done by Fluffer_enService	*/
+    if(psFluffer->cleanup.state == FLUFFER_CLEANUP_COPY)
     {
-        return FLUFFER_ERROR_EMPTY;
+        return FLUFFER_ERROR_BUSY;
     }
 
-    /*	read entry into given buffer */
-    psFluffer->handles.read_handle(Local_u32EntryAddress, (uint8_t *)pu8Buffer, psFluffer->cfg.element_size);
+    Fluffer_vidBeginSession(psFluffer);
 
-    /*	increment reader's id	*/
-    psReader->id++;
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+    /*	new main buffer is branded first, the block following it is erased ahead then	*/
+    if(psFluffer->cleanup.state == FLUFFER_CLEANUP_BRAND)
+    {
+        Fluffer_vidCleanUpSlice(psFluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+    Fluffer_vidEraseNextBlock(psFluffer);
+    Fluffer_vidEndSession(psFluffer);
 
     return FLUFFER_ERROR_NONE;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
-Fluffer_Error_t Fluffer_enMarkEntry(Fluffer_t * const psFluffer)
+Fluffer_Error_t Fluffer_enGetWearStats(const Fluffer_t * const psFluffer, Fluffer_Wear_Stats_t * const psStats)
 {
-    uint32_t Local_u32EntryMarkAddress = FLUFFER_ENTRY_MARK_ADDRESS_BY_ID(psFluffer, psFluffer->context.head);	/*	fluffer instance head's mark memory address	*/
-    const uint8_t Local_au8TempBuffer[FLUFFER_DEFAULT_MAX_WORD_SIZE] = {										/*	entry's mark	*/
-        FLUFFER_ENTRY_MARKED, FLUFFER_ENTRY_MARKED,
-        FLUFFER_ENTRY_MARKED, FLUFFER_ENTRY_MARKED,
-    };
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    uint64_t Local_u64Sum = 0;							/*	sum of erase counts	*/
+    uint32_t Local_u32Count;							/*	block's erase count	*/
+    uint8_t Local_u8Known = 0;							/*	blocks whose erase count is kept	*/
+    uint8_t Local_u8Block;								/*	block index	*/
+#endif	/*	FLUFFER_WEAR_MODE	*/
 
     /*	check for null pointers	*/
-    if(IS_NULLPTR(psFluffer))
+    if(IS_NULLPTR(psFluffer) || IS_NULLPTR(psStats))
     {
         return FLUFFER_ERROR_NULLPTR;
     }
 
-    /*	check if fluffer is empty	*/
-    if(FLUFFER_IS_EMPTY(psFluffer))
-    {
-        return FLUFFER_ERROR_EMPTY;
-    }
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
 
-    /*	write to head's mark	*/
-    psFluffer->handles.write_handle(Local_u32EntryMarkAddress, (uint8_t *)Local_au8TempBuffer, psFluffer->cfg.word_size);
+    /*	erase ahead may still be in progress	*/
+    Fluffer_vidWaitReady(psFluffer);
 
-    /*	increment fluffer instance's head	*/
-    psFluffer->context.head++;
+    psStats->min = 0;
+    psStats->max = 0;
 
-    return FLUFFER_ERROR_NONE;
-}
+    for(Local_u8Block = 0; Local_u8Block < psFluffer->cfg.blocks; Local_u8Block++)
+    {
+        Local_u32Count = Fluffer_u32ReadWearField(psFluffer, FLUFFER_ERASE_COUNT_ADDRESS(psFluffer, Local_u8Block));
 
-/* ------------------------------------------------------------------------------------ */
+        /*	a lost erase count is left out until it's programmed again	*/
+        if(Local_u32Count != FLUFFER_WEAR_FIELD_BLANK)
+        {
+            psStats->min = IS_ZERO(Local_u8Known) ? Local_u32Count : MIN(psStats->min, Local_u32Count);
+            psStats->max = MAX(psStats->max, Local_u32Count);
+            Local_u64Sum += Local_u32Count;
+            Local_u8Known++;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
 
-Fluffer_Error_t Fluffer_enWriteEntry(Fluffer_t * const psFluffer, uint8_t * const pu8Data)
-{
-    uint32_t Local_u32EntryAddress = FLUFFER_ENTRY_ADDRESS_BY_ID(psFluffer, psFluffer->context.tail);	/*	entry's address	*/
+    psStats->mean = IS_ZERO(Local_u8Known) ? 0 : (uint32_t)(Local_u64Sum / Local_u8Known);
+    psStats->sequence = Fluffer_u32ReadWearField(psFluffer, FLUFFER_SEQUENCE_ADDRESS(psFluffer, psFluffer->context.main_buffer));
 
-    /*	write entry to main buffer	*/
-    psFluffer->handles.write_handle(Local_u32EntryAddress, pu8Data, psFluffer->cfg.element_size);
+    return FLUFFER_ERROR_NONE;
 
-    /*	increment tail	*/
-    psFluffer->context.tail++;
+#else
 
-    /*	check if main buffer is full	*/
-    if(FLUFFER_IS_FULL(psFluffer))
-    {
-        Fluffer_vidCleanUp(psFluffer);
-    }
-    else
-    {
-        /*	do nothing	*/
-    }
+    /*	blocks' headers hold their brands only	*/
+    return FLUFFER_ERROR_PARAM;
 
-    return FLUFFER_ERROR_NONE;
+#endif	/*	FLUFFER_WEAR_MODE	*/
 }
 
 /* ------------------------------------------------------------------------------------ */
 
 /**@}*/
-
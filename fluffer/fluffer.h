@@ -10,6 +10,44 @@
 #ifndef __FLUFFER_H__
 #define __FLUFFER_H__
 
+#include <fluffer_config.h>
+
+#if FLUFFER_ADDRESSING == FLUFFER_ADDRESSING_32
+
+/**
+ * @brief Memory page index or count (FLUFFER_ADDRESSING_32)
+ * */
+typedef uint32_t Fluffer_Page_t;
+
+/**
+ * @brief Entry index or count (FLUFFER_ADDRESSING_32)
+ * */
+typedef uint32_t Fluffer_Index_t;
+
+/**
+ * @brief Maximum entry index
+ * */
+#define FLUFFER_INDEX_MAX				UINT32_MAX
+
+#else
+
+/**
+ * @brief Memory page index or count
+ * */
+typedef uint8_t Fluffer_Page_t;
+
+/**
+ * @brief Entry index or count
+ * */
+typedef uint16_t Fluffer_Index_t;
+
+/**
+ * @brief Maximum entry index
+ * */
+#define FLUFFER_INDEX_MAX				UINT16_MAX
+
+#endif	/*	FLUFFER_ADDRESSING	*/
+
 /**
  * @brief Error codes returned by flash memory IO handles to indicate success or failure of the operation
  **/
@@ -19,6 +57,7 @@ typedef enum fluffer_handle_error_t {
     FH_ERR_INVALID_ADDRESS,     /**<  invalid address for read, write  */
     FH_ERR_INVALID_PAGE,        /**<  invalid page index  */
     FH_ERR_CORRUPTED_BLOCK,     /**<  corrupted page (byte read after a write operation were not the same as the bytes written)  */
+    FH_ERR_BUSY,                /**<  an erase started by an asynchronous erase handle is still in progress (poll handle only)  */
 }Fluffer_Handle_Error_t;
 
 /**
@@ -32,9 +71,50 @@ typedef Fluffer_Handle_Error_t (*Fluffer_Read_Handle_t)(uint32_t, uint8_t *, uin
 typedef Fluffer_Handle_Error_t (*Fluffer_Write_Handle_t)(uint32_t, uint8_t *, uint16_t);
 
 /**
- * @brief Fluffer erase handle, erases a memory page
+ * @brief Fluffer erase handle, erases a memory page (page index is 32 bit with FLUFFER_ADDRESSING_32)
+ * */
+typedef Fluffer_Handle_Error_t (*Fluffer_Erase_Handle_t)(Fluffer_Page_t);
+
+/**
+ * @brief Fluffer context load handle, reads a saved warm context from a memory that keeps
+ *        its content in low power mode (ex: backup registers)
  * */
-typedef Fluffer_Handle_Error_t (*Fluffer_Erase_Handle_t)(uint8_t);
+typedef Fluffer_Handle_Error_t (*Fluffer_Load_Handle_t)(uint8_t *, uint16_t);
+
+/**
+ * @brief Fluffer context save handle, saves a warm context into a memory that keeps
+ *        its content in low power mode (ex: backup registers)
+ * */
+typedef Fluffer_Handle_Error_t (*Fluffer_Save_Handle_t)(uint8_t *, uint16_t);
+
+/**
+ * @brief Fluffer direct map handle, returns a pointer to memory offset 0 if the memory is memory
+ *        mapped (ex: on chip flash), entries are then accessed directly without a read handle call
+ * */
+typedef const uint8_t * (*Fluffer_Map_Handle_t)(void);
+
+/**
+ * @brief Fluffer session handle, begins or ends a programming session (ex: unlocks or locks the flash
+ *        controller once for all write & erase handle calls in between). Sessions may be nested, the
+ *        memory is locked again by the outermost end
+ * */
+typedef Fluffer_Handle_Error_t (*Fluffer_Session_Handle_t)(void);
+
+/**
+ * @brief Fluffer poll handle, returns FH_ERR_BUSY while an erase started by the erase handle is in progress,
+ *        FH_ERR_NONE once the memory is ready. With a poll handle, the erase handle may start the erase and
+ *        return right away (ex: a SPI NOR erase command, or an erase started by DMA or interrupt), fluffer
+ *        polls for its completion before its next handle call
+ * */
+typedef Fluffer_Handle_Error_t (*Fluffer_Poll_Handle_t)(void);
+
+/**
+ * @brief Fluffer CRC handle, returns the CRC-32 of the given bytes as the STM32F1 CRC unit computes it (polynomial
+ *        0x04C11DB7, initial value 0xFFFFFFFF, 32 bit little endian words fed most significant bit first, the last
+ *        word zero padded), used to offload entries' CRCs (FLUFFER_CRC_ENTRY) to the hardware. Without it, the
+ *        same CRC is computed in software (table driven)
+ * */
+typedef uint32_t (*Fluffer_Crc_Handle_t)(const uint8_t *, uint16_t);
 
 /**
  * @brief Fluffer handles structure, holds read, write & erase handles for the fluffer instance
@@ -43,30 +123,100 @@ typedef struct fluffer_handles_t {
     Fluffer_Read_Handle_t  read_handle;		/**<  read handle  */
     Fluffer_Write_Handle_t write_handle;    /**<  write handle  */
     Fluffer_Erase_Handle_t erase_handle;    /**<  erase handle  */
+    Fluffer_Load_Handle_t  load_handle;     /**<  warm context load handle (optional, NULL if not used, FLUFFER_CONTEXT_WARM only)  */
+    Fluffer_Save_Handle_t  save_handle;     /**<  warm context save handle (optional, NULL if not used, FLUFFER_CONTEXT_WARM only)  */
+    Fluffer_Map_Handle_t   map_handle;      /**<  direct map handle (optional, NULL if memory is not memory mapped)  */
+    Fluffer_Session_Handle_t begin_handle;  /**<  programming session begin handle (optional, NULL if not used, FLUFFER_SESSION_HANDLES only)  */
+    Fluffer_Session_Handle_t end_handle;    /**<  programming session end handle (optional, NULL if not used, FLUFFER_SESSION_HANDLES only)  */
+    Fluffer_Poll_Handle_t  poll_handle;     /**<  asynchronous erase poll handle (optional, NULL if erases are done when the erase handle returns, FLUFFER_ERASE_ASYNC only)  */
+    Fluffer_Crc_Handle_t   crc_handle;      /**<  entries' CRC handle (optional, NULL for the software CRC, FLUFFER_CRC_ENTRY only)  */
 }Fluffer_Handles_t;
 
 /**
  * @brief fluffer context, holds fluffer instance variables
  * */
 typedef struct fluffer_context_t {
-    uint16_t head;			/**<  head index  */
-    uint16_t tail;          /**<  tail index  */
-    uint16_t size;          /**<  fluffer size, maximum number of entries that can written to fluffer  */
-    uint8_t  main_buffer;   /**<  main buffer block index  */
+    Fluffer_Index_t head;	/**<  head index  */
+    Fluffer_Index_t tail;   /**<  tail index  */
+    Fluffer_Index_t size;   /**<  fluffer size, maximum number of entries that can written to fluffer (per block with FLUFFER_BUFFER_RING)  */
+    uint16_t sequence;      /**<  main buffer block's sequence number (FLUFFER_BUFFER_RING only)  */
+    uint8_t  main_buffer;   /**<  main buffer block index (block holding head with FLUFFER_BUFFER_RING)  */
+    uint8_t  next_buffer;   /**<  block the next clean up copies entries into, the least worn one (FLUFFER_WEAR_LEVEL only)  */
 }Fluffer_Context_t;
 
+/**
+ * @brief fluffer warm context, a copy of fluffer context kept by the load & save handles, used to
+ *        skip main buffer search when the instance is initialized
+ * */
+typedef struct fluffer_warm_context_t {
+    Fluffer_Context_t context;	/**<  saved fluffer context  */
+    uint16_t generation;        /**<  incremented each time the context is saved (main buffer's clean up sequence number with FLUFFER_WEAR_LEVEL, checked on load)  */
+    uint16_t checksum;          /**<  checksum of saved context & generation  */
+}Fluffer_Warm_Context_t;
+
 /**
  * @brief fluffer configurations, describes memory and allocation pages for fluffer instance
  * */
 typedef struct fluffer_config_t {
     uint16_t page_size;			/**<  memory page size  */
     uint8_t  word_size;	        /**<  memory word size (byte aligned = 1, half word aligned = 2, word aligned = 4)  */
-    uint8_t  start_page;        /**<  allocated memory starting page index  */
-    uint8_t  pages_pre_block;   /**<  allocated pages per block  */
+    Fluffer_Page_t start_page;  /**<  allocated memory starting page index  */
+    Fluffer_Page_t pages_pre_block;	/**<  allocated pages per block  */
     uint8_t  blocks;            /**<  total number of block for fluffer instance */
     uint8_t  element_size;  	/**<  fluffer element size (bytes)  */
 }Fluffer_Config_t;
 
+/**
+ * @brief fluffer clean up states, copy and brand states are used by the incremental clean up (FLUFFER_CLEANUP_INCREMENTAL) only
+ * */
+typedef enum fluffer_cleanup_state_t {
+    FLUFFER_CLEANUP_IDLE,		/**<  no clean up in progress  */
+    FLUFFER_CLEANUP_COPY,       /**<  copying entries to the next block, then erasing the old main buffer's brand  */
+    FLUFFER_CLEANUP_BRAND,      /**<  branding the block entries were copied into as main buffer, once the old brand's erase is done  */
+    FLUFFER_CLEANUP_ERASE,      /**<  erasing ahead the block following the main buffer (pages that aren't blank)  */
+}Fluffer_Cleanup_State_t;
+
+/**
+ * @brief fluffer clean up, holds the state of an incremental clean up between Fluffer_enService calls
+ * */
+typedef struct fluffer_cleanup_t {
+    Fluffer_Cleanup_State_t state;	/**<  clean up state  */
+    Fluffer_Index_t first_id;       /**<  first main buffer entry copied, entries before it are dropped  */
+    Fluffer_Index_t next_id;        /**<  next main buffer entry to be copied  */
+    uint8_t  block;                 /**<  block being copied into (copy state), old main buffer (brand state, FLUFFER_WEAR_LEVEL), or erased ahead (erase state)  */
+    Fluffer_Page_t page;            /**<  next page to blank check & erase, relative to block's first page  */
+    uint32_t erase_count;           /**<  block's erase count, programmed back once its first page is erased (brand & erase states, FLUFFER_WEAR_LEVEL only)  */
+}Fluffer_Cleanup_t;
+
+/**
+ * @brief fluffer workspace, RAM used by a single fluffer instance for entry copies, and runs of entries &
+ *        marks written or read by a single handle call (FLUFFER_WORKSPACE_INSTANCE only). The first
+ *        (element_size + word_size + FLUFFER_CRC_SIZE) bytes hold an entry, the rest (rounded down to a multiple of word_size)
+ *        is the run buffer, larger run buffers mean fewer handle calls per entry
+ * */
+typedef struct fluffer_workspace_t {
+    uint8_t * buffer;			/**<  workspace buffer, must not be used by anything else while the instance is in use  */
+    uint16_t size;              /**<  workspace size (bytes), at least FLUFFER_WORKSPACE_SIZE(element_size, word_size, element_size + word_size + FLUFFER_CRC_SIZE)  */
+}Fluffer_Workspace_t;
+
+/**
+ * @brief Get workspace size (bytes) for a fluffer instance with the given element size, word size & run
+ *        buffer size (at least element size + word size, and an entry's CRC with FLUFFER_CRC_ENTRY)
+ * */
+#define FLUFFER_WORKSPACE_SIZE(u8ElementSize, u8WordSize, u16RunSize)		((u8ElementSize) + (u8WordSize) + FLUFFER_CRC_SIZE + (u16RunSize))
+
+/**
+ * @brief fluffer write-back cache, RAM holding entries written by Fluffer_enWriteEntry until they're written
+ *        to memory by a single Fluffer_enWriteEntries call (FLUFFER_CACHE_WRITE_BACK only). An instance with
+ *        a null buffer or 0 capacity writes entries directly
+ * */
+typedef struct fluffer_cache_t {
+    uint8_t * buffer;			/**<  cache buffer, its size must be capacity * @ref element_size bytes  */
+    uint16_t capacity;          /**<  number of entries the cache buffer holds  */
+    uint16_t max_dirty;         /**<  cached entries that trigger a write (at most capacity, 0 for capacity), bounds entries lost on a power cut  */
+    uint16_t dirty;             /**<  number of cached entries, not written to memory yet (owned by the instance)  */
+}Fluffer_Cache_t;
+
 /**
  * @brief fluffer structure
  * */
@@ -74,15 +224,36 @@ typedef struct fluffer_t {
     Fluffer_Handles_t handles;	/**<  fluffer instance handles  */
     Fluffer_Context_t context;  /**<  fluffer instance context  */
     Fluffer_Config_t cfg;  		/**<  fluffer instance memory configurations  */
+    Fluffer_Cleanup_t cleanup;  /**<  fluffer instance clean up state  */
+    Fluffer_Workspace_t workspace;	/**<  fluffer instance workspace (FLUFFER_WORKSPACE_INSTANCE only)  */
+    Fluffer_Cache_t cache;			/**<  fluffer instance write-back cache (FLUFFER_CACHE_WRITE_BACK only)  */
 }Fluffer_t;
 
+/**
+ * @brief Fluffer wear statistics, erase counts of the allocated blocks (FLUFFER_WEAR_LEVEL only). Blocks whose
+ *        erase count was lost (a reset cut its program) are left out until it's programmed again
+ * */
+typedef struct fluffer_wear_stats_t {
+    uint32_t min;				/**<  lowest erase count  */
+    uint32_t max;               /**<  highest erase count  */
+    uint32_t mean;              /**<  mean erase count, rounded down  */
+    uint32_t sequence;          /**<  main buffer's sequence number, clean ups done since the memory was prepared  */
+}Fluffer_Wear_Stats_t;
+
 /**
  * @brief Fluffer reader structure, holds the index of entry to be read
  * */
 typedef struct {
-    uint16_t id;	/**<	index of entry to be read	*/
+    Fluffer_Index_t id;	/**<	index of entry to be read	*/
 }Fluffer_Reader_t;
 
+/**
+ * @brief Entry states, intermediate states (1 .. FLUFFER_MARK_STATES - 2) are defined by the application
+ * (ex: 1 sent, 2 acknowledged)
+ * */
+#define FLUFFER_ENTRY_STATE_WRITTEN		0							/**<  entry is written, its mark is erased  */
+#define FLUFFER_ENTRY_STATE_MARKED		(FLUFFER_MARK_STATES - 1)	/**<  entry is marked, pending for removal  */
+
 /**
  * @brief Fluffer error codes, returned by fluffer functions to indicate an error
  * */
@@ -94,22 +265,63 @@ typedef enum {
     FLUFFER_ERROR_EMPTY,        /**<  fluffer instance is empty  */
     FLUFFER_ERROR_FULL,         /**<  fluffer instance is full  */
     FLUFFER_ERROR_MEMORY,       /**<  memory access error (read, write, erase)  */
+    FLUFFER_ERROR_BUSY,         /**<  clean up is in progress  */
+    FLUFFER_ERROR_CRC,          /**<  an entry's CRC doesn't match its data, ex: a write cut by a power loss (FLUFFER_CRC_ENTRY only)  */
 } Fluffer_Error_t;
 
 
+/**
+ * @brief   Set fluffer instance's memory handles, and clear all its optional handles (load, save, map,
+ * 			session, poll & CRC handles). Optional handles are only called in the modes using them (ex: load
+ * 			& save handles with FLUFFER_CONTEXT_WARM), then whenever they're not null, so it should be called
+ * 			before optional handles are set & before Fluffer_enInitialize by builds enabling them, so handles
+ * 			of an instance that isn't zero initialized (ex: on the stack) are never garbage
+ * @param   psHandles pointer to fluffer instance's handles
+ * @param   pfRead memory read handle
+ * @param   pfWrite memory write handle
+ * @param   pfErase memory page erase handle
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if handles pointer, or one (or more) of the memory handles is null
+ * */
+Fluffer_Error_t Fluffer_enInitHandles(Fluffer_Handles_t * const psHandles, Fluffer_Read_Handle_t pfRead, Fluffer_Write_Handle_t pfWrite, Fluffer_Erase_Handle_t pfErase);
+
 /**
  * @brief   Initialize fluffer instance state and prepare fluffer instance for usage, depending on values in
  * 			fluffer instance configurations (cfg)
- * @details Check fluffer allocated blocks. If no blocks were found, prepares the memory for 1st time use.
- *          Otherwise, validate found blocks, and If they were corrupt, purge allocated blocks.
+ * @details If a warm context was saved (FLUFFER_CONTEXT_WARM, load & save handles are set), and it matches the main buffer's
+ *          head & tail, it's used as is. Otherwise, check fluffer allocated blocks. If no blocks were found,
+ *          prepares the memory for 1st time use. A clean up interrupted by a reset is finished: if no block is
+ *          branded as main buffer, the block entries were being copied into has all of them (the old main
+ *          buffer's brand is erased after the copy), it's branded as main buffer. If the main buffer is full
+ *          (the copy didn't finish), it's cleaned up again. Otherwise, if blocks were corrupt, purge allocated blocks.
+ *          The found context is saved as a warm context. The write-back cache
+ *          (FLUFFER_CACHE_WRITE_BACK) is emptied, entries cached before are dropped.
  * @param   psFluffer pointer to fluffer instance
  * @return  Fluffer_Error_t
  * 			FLUFFER_ERROR_NONE : if no errors occurred
- * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, or one (or more) its handles is null
- * 			FLUFFER_ERROR_PARAM : if fluffer instance configurations are invalid
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, or one (or more) its handles is null, or its workspace
+ * 			buffer is null (FLUFFER_WORKSPACE_INSTANCE)
+ * 			FLUFFER_ERROR_PARAM : if fluffer instance configurations are invalid (with FLUFFER_BUFFER_RING: less
+ * 			than 3 blocks, or more than FLUFFER_INDEX_MAX entries in all blocks but one; otherwise more than
+ * 			FLUFFER_INDEX_MAX entries per block), or its workspace is smaller than
+ * 			FLUFFER_WORKSPACE_SIZE(element_size, word_size, element_size + word_size + FLUFFER_CRC_SIZE) (FLUFFER_WORKSPACE_INSTANCE)
  * */
 Fluffer_Error_t Fluffer_enInitialize(Fluffer_t * psFluffer);
 
+/**
+ * @brief   Save fluffer instance context as a warm context using the instance's save handle, to be used
+ *          by the next Fluffer_enInitialize call. Should be called before entering low power mode.
+ *          Cached entries (FLUFFER_CACHE_WRITE_BACK) aren't part of the context, call Fluffer_enFlush first.
+ * @param   psFluffer pointer to fluffer instance
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, its load or save handle is null
+ * 			FLUFFER_ERROR_PARAM : if warm contexts aren't kept (FLUFFER_CONTEXT_MODE isn't FLUFFER_CONTEXT_WARM)
+ * 			FLUFFER_ERROR_MEMORY : if save handle failed
+ * */
+Fluffer_Error_t Fluffer_enSaveContext(const Fluffer_t * const psFluffer);
+
 /**
  * @brief   Initialize given reader instance
  * @param   psFluffer pointer to fluffer instance
@@ -140,17 +352,80 @@ Fluffer_Error_t Fluffer_enIsEmpty(const Fluffer_t * const psFluffer, uint8_t * p
  * */
 Fluffer_Error_t Fluffer_enIsFull(const Fluffer_t * const psFluffer, uint8_t * pu8Result);
 
+/**
+ * @brief	Check if an erase started by fluffer instance's asynchronous erase handle is still in progress,
+ * 			so a read, mark or write of entries would wait for it (a cached write doesn't)
+ * @param   psFluffer pointer to fluffer instance
+ * @param   pu8Result pointer to a unit8_t variable, to store result in it. 1 if busy, 0 if ready, the
+ * 			instance has no poll handle or erases are synchronous (FLUFFER_ERASE_SYNC)
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance or result pointer is null
+ * */
+Fluffer_Error_t Fluffer_enIsBusy(const Fluffer_t * const psFluffer, uint8_t * pu8Result);
+
 /**
  * @brief   Read entry from main buffer, pointed to by the reader instance, and copy it into given buffer
+ * @details With FLUFFER_CRC_ENTRY the entry is read with its CRC, and checked against it. An entry that
+ * 			fails its CRC is still copied and the reader is moved past it, so it can be skipped (marked).
  * @param   psFluffer pointer to fluffer instance
  * @param  	psReader pointer to reader instance
  * @param	pu8Buffer pointer to buffer to copy entry into, its size must be at least @ref element_size bytes
  * @return  Fluffer_Error_t
  * 			FLUFFER_ERROR_NONE : if no errors occurred
  * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, the reader instance, or buffer pointer is null
+ * 			FLUFFER_ERROR_CRC : if entry's CRC doesn't match its data (FLUFFER_CRC_ENTRY)
  * */
 Fluffer_Error_t Fluffer_enReadEntry(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t * const pu8Buffer);
 
+/**
+ * @brief   Read consecutive entries from main buffer, starting at the entry pointed to by the reader
+ * 			instance, and copy them packed (without mark words) into given buffer
+ * @details Entries are read with a single read handle call directly into the given buffer. In the
+ * 			interleaved layout mark words are then stripped in place, and as the read includes a mark
+ * 			word in between each 2 entries, up to (u16Max * @ref element_size + @ref word_size) /
+ * 			(@ref element_size + @ref word_size) entries are read per call, call again to read the rest.
+ * 			In the bitmap layout (@ref FLUFFER_LAYOUT_BITMAP) entries' data is contiguous and up to
+ * 			u16Max entries are read per call. A run is at most UINT16_MAX bytes (the read handle's length),
+ * 			so large buffers may take more calls. With FLUFFER_CRC_ENTRY each entry's CRC is read along (and
+ * 			stripped in place), so fewer entries fit in the buffer, at least one is read per call. A run
+ * 			stops before the first entry that fails its CRC, the next call returns that entry alone with
+ * 			FLUFFER_ERROR_CRC (as Fluffer_enReadEntry does), so the caller can drop it and go on.
+ * @param   psFluffer pointer to fluffer instance
+ * @param  	psReader pointer to reader instance
+ * @param	pu8Buffer pointer to buffer to copy entries into, its size must be at least u16Max * @ref element_size bytes
+ * @param	u16Max maximum number of entries to read, must be > 0
+ * @param	pu16Count pointer to a uint16_t variable, to store number of read entries in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, the reader instance, buffer pointer or count pointer is null
+ * 			FLUFFER_ERROR_PARAM : if u16Max is 0
+ * 			FLUFFER_ERROR_EMPTY : if there are no entries left to read
+ * 			FLUFFER_ERROR_CRC : if the single read entry's CRC doesn't match its data (FLUFFER_CRC_ENTRY)
+ * */
+Fluffer_Error_t Fluffer_enReadEntries(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t * const pu8Buffer, uint16_t u16Max, uint16_t * const pu16Count);
+
+/**
+ * @brief   Get a pointer to the entry pointed to by the reader instance, directly in memory (zero copy
+ * 			counterpart of Fluffer_enReadEntry), then move reader to the next entry
+ * @details Requires the map handle. The pointer is valid until the next clean up of the main buffer
+ * 			(a write that fills the main buffer), it should not be used after that. With the ring buffer
+ * 			(FLUFFER_BUFFER_RING) the pointer is valid until the next write that moves the tail into another block.
+ * 			With FLUFFER_CRC_ENTRY the entry is checked against its CRC in place, an entry that fails it is
+ * 			still returned.
+ * @param   psFluffer pointer to fluffer instance
+ * @param  	psReader pointer to reader instance
+ * @param	ppu8Entry pointer to a const pointer, to store entry's address in it
+ * @param	pu16Len pointer to a uint16_t variable, to store entry's length (@ref element_size) in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, the reader instance, one of the output pointers,
+ * 			the map handle, or the pointer returned by it is null
+ * 			FLUFFER_ERROR_EMPTY : if there are no entries left to read
+ * 			FLUFFER_ERROR_CRC : if entry's CRC doesn't match its data (FLUFFER_CRC_ENTRY)
+ * */
+Fluffer_Error_t Fluffer_enPeekEntry(const Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, const uint8_t ** const ppu8Entry, uint16_t * const pu16Len);
+
 /**
  * @brief 	Mark main buffer's head entry as pending for removal
  * @param   psFluffer pointer to fluffer instance
@@ -160,8 +435,71 @@ Fluffer_Error_t Fluffer_enReadEntry(const Fluffer_t * const psFluffer, Fluffer_R
  * */
 Fluffer_Error_t Fluffer_enMarkEntry(Fluffer_t * const psFluffer);
 
+/**
+ * @brief 	Mark multiple entries, starting from main buffer's head, as pending for removal
+ * @details Same as calling Fluffer_enMarkEntry u16Count times, without per call overhead (address
+ * 			calculation, checks). In the interleaved layout marks are written in order, one write
+ * 			handle call per mark, as marks are separated by entries' data in the main buffer. In the
+ * 			bitmap layout (@ref FLUFFER_LAYOUT_BITMAP) adjacent marks are written together, with a
+ * 			single write handle call per run buffer of marks (@ref FLUFFER_WRITE_RUN_SIZE, or the instance's
+ * 			workspace with FLUFFER_WORKSPACE_INSTANCE).
+ * @param   psFluffer pointer to fluffer instance
+ * @param	u16Count number of entries to mark (1 .. number of unmarked entries)
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance is null
+ * 			FLUFFER_ERROR_EMPTY : if fluffer instance is empty
+ * 			FLUFFER_ERROR_PARAM : if u16Count is 0, or more than the number of unmarked entries
+ * */
+Fluffer_Error_t Fluffer_enMarkEntries(Fluffer_t * const psFluffer, uint16_t u16Count);
+
+/**
+ * @brief 	Get state of the entry pointed to by the reader instance, reader isn't moved
+ * @details An entry's state is kept in its mark (see @ref FLUFFER_MARK_STATES), so it survives resets and
+ * 			is kept when the entry is copied by a clean up. Entries from head to tail are never marked.
+ * @param   psFluffer pointer to fluffer instance
+ * @param  	psReader pointer to reader instance
+ * @param	pu8State pointer to a uint8_t variable, to store entry's state in it (@ref FLUFFER_ENTRY_STATE_WRITTEN ..
+ * 			FLUFFER_MARK_STATES - 2)
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, the reader instance or state pointer is null
+ * 			FLUFFER_ERROR_EMPTY : if reader doesn't point to an unmarked entry
+ * */
+Fluffer_Error_t Fluffer_enGetEntryState(const Fluffer_t * const psFluffer, const Fluffer_Reader_t * const psReader, uint8_t * const pu8State);
+
+/**
+ * @brief 	Advance the entry pointed to by the reader instance to the given intermediate state, then move
+ * 			reader to the next entry
+ * @details Only the bits cleared by the new state are programmed over the entry's mark, with a single write
+ * 			handle call (two while an incremental clean up is copying the entry). An entry already at (or past)
+ * 			the given state isn't written again. Entries are marked (removed) by Fluffer_enMarkEntry, in order.
+ * 			Typical use is tracking entries that were sent but not acknowledged yet: copy the reader, read
+ * 			the entry, send it, then advance the copy to the sent state.
+ * @param   psFluffer pointer to fluffer instance
+ * @param  	psReader pointer to reader instance
+ * @param	u8State new entry state (1 .. FLUFFER_MARK_STATES - 2)
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance or the reader instance is null
+ * 			FLUFFER_ERROR_PARAM : if u8State isn't an intermediate state
+ * 			FLUFFER_ERROR_EMPTY : if reader doesn't point to an unmarked entry
+ * */
+Fluffer_Error_t Fluffer_enAdvanceEntry(Fluffer_t * const psFluffer, Fluffer_Reader_t * const psReader, uint8_t u8State);
+
 /**
  * @brief	Write given data buffer as an entry into given fluffer instance's main buffer
+ * @details If the main buffer becomes full, it's cleaned up before returning. With the incremental
+ * 			clean up (FLUFFER_CLEANUP_INCREMENTAL), the clean up is only started once free entries drop
+ * 			to @ref FLUFFER_CLEANUP_HEADROOM and as many entries are marked, and is done by Fluffer_enService. A pending clean up is
+ * 			finished by the write only if the main buffer becomes full before Fluffer_enService does it.
+ * 			With the ring buffer (FLUFFER_BUFFER_RING) nothing is copied: the write that finds the tail's
+ * 			block full moves the tail into the next block (erased ahead), releasing blocks with all entries
+ * 			marked. If all blocks but the one erased ahead are in use, the head block's unmarked entries are
+ * 			dropped. With a write-back cache (FLUFFER_CACHE_WRITE_BACK), the entry is copied into the cache,
+ * 			and cached entries are written by a single Fluffer_enWriteEntries call once there are max_dirty
+ * 			of them. While an erase started by an asynchronous erase handle is in progress (poll handle),
+ * 			entries are kept cached up to the cache's capacity instead of waiting for the erase.
  * @param   psFluffer pointer to fluffer instance
  * @param	pu8Data pointer to data to be written as an entry, its size must be @ref element_size bytes
  * @return  Fluffer_Error_t
@@ -170,6 +508,89 @@ Fluffer_Error_t Fluffer_enMarkEntry(Fluffer_t * const psFluffer);
  * */
 Fluffer_Error_t Fluffer_enWriteEntry(Fluffer_t * const psFluffer, uint8_t * const pu8Data);
 
+/**
+ * @brief	Write multiple entries into given fluffer instance's main buffer
+ * @details Consecutive entries are written with a single write handle call (a run), a run is split
+ * 			at the main buffer's end (tail's block end with FLUFFER_BUFFER_RING) or when the run buffer is
+ * 			full (@ref FLUFFER_WRITE_RUN_SIZE, or the instance's workspace with FLUFFER_WORKSPACE_INSTANCE).
+ * 			Clean up is done at most once per call, freeing enough space for the rest of the
+ * 			entries. Unmarked entries left in the main buffer are the same as calling Fluffer_enWriteEntry
+ * 			for each entry, entries that would be dropped by a clean up are skipped (counted as written).
+ * 			Cached entries (FLUFFER_CACHE_WRITE_BACK) are written first, so entries stay in order.
+ * @param   psFluffer pointer to fluffer instance
+ * @param	pu8Data pointer to entries to be written, packed, its size must be u16Count * @ref element_size bytes
+ * @param	u16Count number of entries to write
+ * @param	pu16Written pointer to a uint16_t variable, to store number of written entries in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance, the data pointer or written pointer is null
+ * */
+Fluffer_Error_t Fluffer_enWriteEntries(Fluffer_t * const psFluffer, uint8_t * const pu8Data, uint16_t u16Count, uint16_t * const pu16Written);
+
+/**
+ * @brief	Write entries cached by Fluffer_enWriteEntry (FLUFFER_CACHE_WRITE_BACK) to given fluffer instance's
+ * 			main buffer, by a single Fluffer_enWriteEntries call. Cached entries can't be read, marked or
+ * 			saved in a warm context until they're written. Should be called before reading entries and
+ * 			before entering low power mode. Does nothing without a cache, or with FLUFFER_CACHE_NONE.
+ * @param   psFluffer pointer to fluffer instance
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance is null
+ * */
+Fluffer_Error_t Fluffer_enFlush(Fluffer_t * const psFluffer);
+
+/**
+ * @brief	Do up to u16Budget slices of the given fluffer instance's pending clean up
+ * @details A slice is one of: copy up to @ref FLUFFER_CLEANUP_COPY_ENTRIES entries to the next block
+ * 			(then erase the old main buffer's first page if all entries are copied), brand the next block as
+ * 			main buffer once that erase is done, or blank check one page of the block following the main
+ * 			buffer, and erase it if it's not blank (erase ahead). Entries can be written, read and marked
+ * 			in between calls. Should be called in idle time. Copy & brand slices are done with the incremental
+ * 			clean up (FLUFFER_CLEANUP_INCREMENTAL) only, otherwise only the erase ahead is pending.
+ * 			With a poll handle, erases of a slice are started and left running: no slice is done while the
+ * 			memory is busy, the call returns right away instead, so it never waits for an erase. Call it
+ * 			again once the memory is ready (ex: from the erase completion callback's event, or periodically).
+ * @param   psFluffer pointer to fluffer instance
+ * @param	u16Budget maximum number of slices to do, must be > 0
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no clean up is pending
+ * 			FLUFFER_ERROR_BUSY : if clean up is still in progress, or an erase it started isn't done yet, call again
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance is null
+ * 			FLUFFER_ERROR_PARAM : if u16Budget is 0
+ * */
+Fluffer_Error_t Fluffer_enService(Fluffer_t * const psFluffer, uint16_t u16Budget);
+
+/**
+ * @brief	Erase ahead the block following the main buffer, so the next clean up only copies entries
+ * 			and brands it
+ * @details After each clean up (and after Fluffer_enInitialize), the block following the main buffer
+ * 			(the least worn block with FLUFFER_WEAR_LEVEL) must be erased before the next clean up copies entries into it. Each of its pages is blank
+ * 			checked (read), and erased only if it's not blank. Should be called in idle time, pages that
+ * 			aren't prepared when the main buffer is full are erased by the write that fills it. With the ring
+ * 			buffer (FLUFFER_BUFFER_RING) the block the tail moves into next is erased ahead instead.
+ * @param   psFluffer pointer to fluffer instance
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance is null
+ * 			FLUFFER_ERROR_BUSY : if an incremental clean up is copying entries, call Fluffer_enService instead
+ * */
+Fluffer_Error_t Fluffer_enIdleErase(Fluffer_t * const psFluffer);
+
+/**
+ * @brief	Get erase counts statistics of fluffer instance's allocated blocks
+ * @details Each block's header holds its erase count, incremented each time the block's first page is
+ * 			erased (once per clean up the block is the main buffer of), and the sequence number of the clean
+ * 			up that copied entries into it. Clean ups copy entries into the least worn block, so erase counts
+ * 			stay within 1 of each other once they caught up. Erase counts are read from the memory.
+ * @param   psFluffer pointer to fluffer instance
+ * @param   psStats pointer to wear statistics, to store erase counts statistics in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psFluffer instance or statistics pointer is null
+ * 			FLUFFER_ERROR_PARAM : if erase counts aren't kept (FLUFFER_WEAR_MODE isn't FLUFFER_WEAR_LEVEL)
+ * */
+Fluffer_Error_t Fluffer_enGetWearStats(const Fluffer_t * const psFluffer, Fluffer_Wear_Stats_t * const psStats);
+
 #endif /* __FLUFFER_H__ */
 
 /**@}*/
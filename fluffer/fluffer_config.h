@@ -22,11 +22,330 @@
  * */
 #define FLUFFER_MAX_ELEMENT_SIZE		100
 
+/**
+ * @brief Size of buffer used to lay out consecutive entries written by Fluffer_enWriteEntries
+ * with a single write handle call, must be at least FLUFFER_MAX_ELEMENT_SIZE (and an entry's CRC)
+ * */
+#define FLUFFER_WRITE_RUN_SIZE			256
+
 /**
  * @brief Clean byte content, shared between all fluffer instances
  * */
 #define FLUFFER_CLEAN_BYTE_CONTENT		0xFF
 
+/**
+ * @brief Head & tail recovery strategies, used by Fluffer_enInitialize to
+ * locate the main buffer's head & tail
+ * */
+#define FLUFFER_RECOVERY_LINEAR			0	/**<  scan main buffer entries one by one  */
+#define FLUFFER_RECOVERY_BISECT			1	/**<  binary search, falls back to linear scan if main buffer is inconsistent  */
+
+/**
+ * @brief Head & tail recovery strategy for all fluffer instances, the ring buffer mode always uses
+ * binary search (entries are written & marked in order across blocks)
+ * */
+#ifndef FLUFFER_RECOVERY_MODE
+#define FLUFFER_RECOVERY_MODE			FLUFFER_RECOVERY_BISECT
+#endif	/*	FLUFFER_RECOVERY_MODE	*/
+
+/**
+ * @brief Context modes, define whether Fluffer_enInitialize may restore a context saved by the load & save
+ * handles instead of recovering head & tail from memory
+ * */
+#define FLUFFER_CONTEXT_COLD			0	/**<  context is always recovered from memory, load & save handles are never called  */
+#define FLUFFER_CONTEXT_WARM			1	/**<  instances with load & save handles (both non null) restore a saved warm context, if it passes its checks  */
+
+/**
+ * @brief Context mode for all fluffer instances
+ * */
+#ifndef FLUFFER_CONTEXT_MODE
+#define FLUFFER_CONTEXT_MODE			FLUFFER_CONTEXT_COLD
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+/**
+ * @brief Block layouts, define where entries' marks are stored in a block
+ * */
+#define FLUFFER_LAYOUT_INTERLEAVED		0	/**<  a mark word in front of each entry's data  */
+#define FLUFFER_LAYOUT_BITMAP			1	/**<  packed marks region after the block's brand, entries' data is contiguous after it  */
+
+/**
+ * @brief Block layout for all fluffer instances
+ * */
+#ifndef FLUFFER_LAYOUT
+#define FLUFFER_LAYOUT					FLUFFER_LAYOUT_INTERLEAVED
+#endif	/*	FLUFFER_LAYOUT	*/
+
+/**
+ * @brief Mark granularity of the bitmap layout
+ * */
+#define FLUFFER_MARK_WORD				0	/**<  a memory word per entry, for memories that can program a word only once (ex: STM32F1 flash)  */
+#define FLUFFER_MARK_BIT				1	/**<  a bit per entry, for memories that can clear more bits of a programmed word (ex: NOR flash)  */
+
+/**
+ * @brief Mark granularity for all fluffer instances, used by bitmap layout only
+ * */
+#ifndef FLUFFER_BITMAP_MARK
+#define FLUFFER_BITMAP_MARK				FLUFFER_MARK_WORD
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+
+/**
+ * @brief Clean up modes, define when the main buffer is cleaned up
+ * */
+#define FLUFFER_CLEANUP_BLOCKING		0	/**<  clean up is done by the write that fills the main buffer  */
+#define FLUFFER_CLEANUP_INCREMENTAL		1	/**<  clean up is started before the main buffer is full, and done in slices by Fluffer_enService  */
+
+/**
+ * @brief Clean up mode for all fluffer instances
+ * */
+#ifndef FLUFFER_CLEANUP_MODE
+#define FLUFFER_CLEANUP_MODE			FLUFFER_CLEANUP_BLOCKING
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+/**
+ * @brief Buffer modes, define how entries are laid out over the allocated blocks
+ * */
+#define FLUFFER_BUFFER_COPY				0	/**<  entries are kept in a single block (main buffer), unmarked entries are copied to the next block when it's full  */
+#define FLUFFER_BUFFER_RING				1	/**<  entries span all blocks in order, a block is reused once all its entries are marked (no copies)  */
+
+/**
+ * @brief Buffer mode for all fluffer instances
+ * */
+#ifndef FLUFFER_BUFFER_MODE
+#define FLUFFER_BUFFER_MODE				FLUFFER_BUFFER_COPY
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/**
+ * @brief Free entries left in the main buffer when an incremental clean up is started (at most half
+ * of the main buffer is used), entries written while the clean up is in progress are written there
+ * */
+#ifndef FLUFFER_CLEANUP_HEADROOM
+#define FLUFFER_CLEANUP_HEADROOM		32
+#endif	/*	FLUFFER_CLEANUP_HEADROOM	*/
+
+/**
+ * @brief Maximum number of entries copied by a single Fluffer_enService slice
+ * */
+#ifndef FLUFFER_CLEANUP_COPY_ENTRIES
+#define FLUFFER_CLEANUP_COPY_ENTRIES	8
+#endif	/*	FLUFFER_CLEANUP_COPY_ENTRIES	*/
+
+/**
+ * @brief Workspace modes, define where fluffer instances' temporary buffers (entry copies, runs of entries
+ * & marks) are kept
+ * */
+#define FLUFFER_WORKSPACE_SHARED		0	/**<  file static buffers shared by all instances (sized by FLUFFER_MAX_ELEMENT_SIZE & FLUFFER_WRITE_RUN_SIZE), instances must not be used concurrently  */
+#define FLUFFER_WORKSPACE_INSTANCE		1	/**<  each instance has its own workspace (Fluffer_t workspace), instances can be used concurrently from different tasks  */
+
+/**
+ * @brief Workspace mode for all fluffer instances
+ * */
+#ifndef FLUFFER_WORKSPACE_MODE
+#define FLUFFER_WORKSPACE_MODE			FLUFFER_WORKSPACE_SHARED
+#endif	/*	FLUFFER_WORKSPACE_MODE	*/
+
+/**
+ * @brief Eviction modes, define how many of the oldest unmarked entries are dropped when the main buffer
+ * is cleaned up with no room left (FLUFFER_BUFFER_COPY only, FLUFFER_BUFFER_RING drops the oldest block)
+ * */
+#define FLUFFER_EVICT_ENTRY				0	/**<  only as many entries as needed are dropped, a saturated buffer is copied on every write  */
+#define FLUFFER_EVICT_CHUNK				1	/**<  at least 1 / FLUFFER_EVICT_CHUNK_DIVISOR of the main buffer is dropped, a saturated buffer is copied once per chunk  */
+
+/**
+ * @brief Eviction mode for all fluffer instances
+ * */
+#ifndef FLUFFER_EVICT_MODE
+#define FLUFFER_EVICT_MODE				FLUFFER_EVICT_ENTRY
+#endif	/*	FLUFFER_EVICT_MODE	*/
+
+/**
+ * @brief Share of the main buffer dropped at once with FLUFFER_EVICT_CHUNK (1 / divisor of its entries),
+ * writes into a saturated buffer copy (divisor - 1) entries each on average
+ * */
+#ifndef FLUFFER_EVICT_CHUNK_DIVISOR
+#define FLUFFER_EVICT_CHUNK_DIVISOR		4
+#endif	/*	FLUFFER_EVICT_CHUNK_DIVISOR	*/
+
+/**
+ * @brief Cache modes, define whether entries written by Fluffer_enWriteEntry are coalesced in RAM before
+ * they're written to memory
+ * */
+#define FLUFFER_CACHE_NONE				0	/**<  each entry is written by its own write handle call  */
+#define FLUFFER_CACHE_WRITE_BACK		1	/**<  instances with a cache (Fluffer_t cache) keep up to max_dirty entries in RAM, then write them by a single run, entries in RAM are lost on a power cut  */
+
+/**
+ * @brief Cache mode for all fluffer instances
+ * */
+#ifndef FLUFFER_CACHE_MODE
+#define FLUFFER_CACHE_MODE				FLUFFER_CACHE_NONE
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+/**
+ * @brief Session modes, define whether groups of write & erase handle calls are wrapped in programming sessions
+ * */
+#define FLUFFER_SESSION_NONE			0	/**<  begin & end handles are never called  */
+#define FLUFFER_SESSION_HANDLES			1	/**<  instances with begin & end handles (non null) call them around each group of write & erase handle calls  */
+
+/**
+ * @brief Session mode for all fluffer instances
+ * */
+#ifndef FLUFFER_SESSION_MODE
+#define FLUFFER_SESSION_MODE			FLUFFER_SESSION_NONE
+#endif	/*	FLUFFER_SESSION_MODE	*/
+
+/**
+ * @brief Erase modes, define whether an erase may still be in progress when the erase handle returns
+ * */
+#define FLUFFER_ERASE_SYNC				0	/**<  erases are done when the erase handle returns, poll handle is never called  */
+#define FLUFFER_ERASE_ASYNC				1	/**<  instances with a poll handle (non null) poll it before reading or programming memory  */
+
+/**
+ * @brief Erase mode for all fluffer instances
+ * */
+#ifndef FLUFFER_ERASE_MODE
+#define FLUFFER_ERASE_MODE				FLUFFER_ERASE_SYNC
+#endif	/*	FLUFFER_ERASE_MODE	*/
+
+/**
+ * @brief Number of states an entry's mark goes through, from written (0) to marked (FLUFFER_MARK_STATES - 1).
+ * Each intermediate state (ex: sent, then acknowledged) clears one more bit of the mark's first byte, so it's
+ * programmed over the previous state without an erase. Memories that program a word only once (ex: STM32F1
+ * flash, a half word can only be cleared to 0 after it's programmed) support a single intermediate state (3),
+ * memories that can clear more bits of a programmed word (ex: NOR flash) support up to 8 states
+ * */
+#ifndef FLUFFER_MARK_STATES
+#define FLUFFER_MARK_STATES				2
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+/**
+ * @brief Addressing modes, define the width of page indices (start page, pages per block, erase handle's page)
+ * and entry indices (head, tail, entries per block)
+ * */
+#define FLUFFER_ADDRESSING_16			0	/**<  8 bit page indices & 16 bit entry indices: up to 256 pages & 65535 entries per instance  */
+#define FLUFFER_ADDRESSING_32			1	/**<  32 bit page & entry indices, for large memories (ex: multi-megabyte external NOR flash), the warm context grows from 14 to 20 bytes  */
+
+/**
+ * @brief Addressing mode for all fluffer instances
+ * */
+#ifndef FLUFFER_ADDRESSING
+#define FLUFFER_ADDRESSING				FLUFFER_ADDRESSING_16
+#endif	/*	FLUFFER_ADDRESSING	*/
+
+/**
+ * @brief CRC modes, define whether each entry is stored with a CRC of its data
+ * */
+#define FLUFFER_CRC_NONE				0	/**<  entries' data is stored as is  */
+#define FLUFFER_CRC_ENTRY				1	/**<  a CRC-32 (same as the STM32F1 CRC unit's) is stored after each entry's data, it's checked when entries are read  */
+
+/**
+ * @brief CRC mode for all fluffer instances
+ * */
+#ifndef FLUFFER_CRC_MODE
+#define FLUFFER_CRC_MODE				FLUFFER_CRC_NONE
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+/**
+ * @brief Bytes stored after each entry's data for its CRC
+ * */
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+#define FLUFFER_CRC_SIZE				4
+#else
+#define FLUFFER_CRC_SIZE				0
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+/**
+ * @brief Wear modes, define which block a clean up copies entries into
+ * */
+#define FLUFFER_WEAR_NONE				0	/**<  entries are copied into the block following the main buffer, a block's header is its brand  */
+#define FLUFFER_WEAR_LEVEL				1	/**<  a block's header holds its erase count & a clean up sequence number too, entries are copied into the least worn block  */
+
+/**
+ * @brief Wear mode for all fluffer instances, FLUFFER_WEAR_LEVEL changes the block layout (memory
+ * prepared without it is prepared again)
+ * */
+#ifndef FLUFFER_WEAR_MODE
+#define FLUFFER_WEAR_MODE				FLUFFER_WEAR_NONE
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+#if FLUFFER_WRITE_RUN_SIZE < (FLUFFER_MAX_ELEMENT_SIZE + FLUFFER_CRC_SIZE)
+#error "FLUFFER_WRITE_RUN_SIZE must be at least FLUFFER_MAX_ELEMENT_SIZE (and an entry's CRC with FLUFFER_CRC_ENTRY)"
+#endif	/*	FLUFFER_WRITE_RUN_SIZE	*/
+
+#if (FLUFFER_CONTEXT_MODE != FLUFFER_CONTEXT_COLD) && (FLUFFER_CONTEXT_MODE != FLUFFER_CONTEXT_WARM)
+#error "FLUFFER_CONTEXT_MODE must be FLUFFER_CONTEXT_COLD or FLUFFER_CONTEXT_WARM"
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+#if (FLUFFER_LAYOUT != FLUFFER_LAYOUT_INTERLEAVED) && (FLUFFER_LAYOUT != FLUFFER_LAYOUT_BITMAP)
+#error "FLUFFER_LAYOUT must be FLUFFER_LAYOUT_INTERLEAVED or FLUFFER_LAYOUT_BITMAP"
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#if (FLUFFER_WRITE_RUN_SIZE < FLUFFER_MAX_MEMORY_WORD_SIZE) || ((FLUFFER_WRITE_RUN_SIZE % FLUFFER_MAX_MEMORY_WORD_SIZE) != 0)
+#error "FLUFFER_WRITE_RUN_SIZE must be a multiple of FLUFFER_MAX_MEMORY_WORD_SIZE"
+#endif	/*	FLUFFER_WRITE_RUN_SIZE	*/
+
+#if (FLUFFER_CLEANUP_MODE != FLUFFER_CLEANUP_BLOCKING) && (FLUFFER_CLEANUP_MODE != FLUFFER_CLEANUP_INCREMENTAL)
+#error "FLUFFER_CLEANUP_MODE must be FLUFFER_CLEANUP_BLOCKING or FLUFFER_CLEANUP_INCREMENTAL"
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+#if (FLUFFER_BUFFER_MODE != FLUFFER_BUFFER_COPY) && (FLUFFER_BUFFER_MODE != FLUFFER_BUFFER_RING)
+#error "FLUFFER_BUFFER_MODE must be FLUFFER_BUFFER_COPY or FLUFFER_BUFFER_RING"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING) && (FLUFFER_CLEANUP_MODE != FLUFFER_CLEANUP_BLOCKING)
+#error "FLUFFER_BUFFER_RING doesn't copy entries, FLUFFER_CLEANUP_MODE must be FLUFFER_CLEANUP_BLOCKING"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if (FLUFFER_EVICT_MODE != FLUFFER_EVICT_ENTRY) && (FLUFFER_EVICT_MODE != FLUFFER_EVICT_CHUNK)
+#error "FLUFFER_EVICT_MODE must be FLUFFER_EVICT_ENTRY or FLUFFER_EVICT_CHUNK"
+#endif	/*	FLUFFER_EVICT_MODE	*/
+
+#if (FLUFFER_WORKSPACE_MODE != FLUFFER_WORKSPACE_SHARED) && (FLUFFER_WORKSPACE_MODE != FLUFFER_WORKSPACE_INSTANCE)
+#error "FLUFFER_WORKSPACE_MODE must be FLUFFER_WORKSPACE_SHARED or FLUFFER_WORKSPACE_INSTANCE"
+#endif	/*	FLUFFER_WORKSPACE_MODE	*/
+
+#if (FLUFFER_CACHE_MODE != FLUFFER_CACHE_NONE) && (FLUFFER_CACHE_MODE != FLUFFER_CACHE_WRITE_BACK)
+#error "FLUFFER_CACHE_MODE must be FLUFFER_CACHE_NONE or FLUFFER_CACHE_WRITE_BACK"
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+#if (FLUFFER_SESSION_MODE != FLUFFER_SESSION_NONE) && (FLUFFER_SESSION_MODE != FLUFFER_SESSION_HANDLES)
+#error "FLUFFER_SESSION_MODE must be FLUFFER_SESSION_NONE or FLUFFER_SESSION_HANDLES"
+#endif	/*	FLUFFER_SESSION_MODE	*/
+
+#if (FLUFFER_ERASE_MODE != FLUFFER_ERASE_SYNC) && (FLUFFER_ERASE_MODE != FLUFFER_ERASE_ASYNC)
+#error "FLUFFER_ERASE_MODE must be FLUFFER_ERASE_SYNC or FLUFFER_ERASE_ASYNC"
+#endif	/*	FLUFFER_ERASE_MODE	*/
+
+#if (FLUFFER_ADDRESSING != FLUFFER_ADDRESSING_16) && (FLUFFER_ADDRESSING != FLUFFER_ADDRESSING_32)
+#error "FLUFFER_ADDRESSING must be FLUFFER_ADDRESSING_16 or FLUFFER_ADDRESSING_32"
+#endif	/*	FLUFFER_ADDRESSING	*/
+
+#if (FLUFFER_CRC_MODE != FLUFFER_CRC_NONE) && (FLUFFER_CRC_MODE != FLUFFER_CRC_ENTRY)
+#error "FLUFFER_CRC_MODE must be FLUFFER_CRC_NONE or FLUFFER_CRC_ENTRY"
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+#if (FLUFFER_WEAR_MODE != FLUFFER_WEAR_NONE) && (FLUFFER_WEAR_MODE != FLUFFER_WEAR_LEVEL)
+#error "FLUFFER_WEAR_MODE must be FLUFFER_WEAR_NONE or FLUFFER_WEAR_LEVEL"
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+#if (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING) && (FLUFFER_WEAR_MODE != FLUFFER_WEAR_NONE)
+#error "FLUFFER_BUFFER_RING erases blocks in turn (even wear), FLUFFER_WEAR_MODE must be FLUFFER_WEAR_NONE"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_EVICT_CHUNK_DIVISOR < 2
+#error "FLUFFER_EVICT_CHUNK_DIVISOR must be at least 2"
+#endif	/*	FLUFFER_EVICT_CHUNK_DIVISOR	*/
+
+#if FLUFFER_CLEANUP_COPY_ENTRIES < 1
+#error "FLUFFER_CLEANUP_COPY_ENTRIES must be at least 1"
+#endif	/*	FLUFFER_CLEANUP_COPY_ENTRIES	*/
+
+#if (FLUFFER_MARK_STATES < 2) || (FLUFFER_MARK_STATES > 8)
+#error "FLUFFER_MARK_STATES must be 2 .. 8"
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+#if (FLUFFER_MARK_STATES > 2) && (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+#error "FLUFFER_MARK_BIT marks are a single bit, FLUFFER_MARK_STATES must be 2"
+#endif	/*	FLUFFER_MARK_STATES	*/
+
 #endif /* __FLUFFER_CONFIG_H__ */
 
 /**@}*/
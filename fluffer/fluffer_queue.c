@@ -0,0 +1,290 @@
+/******************************************************************************
+ * @file       fluffer_queue.c
+ * @brief      Fluffer queue, see fluffer_queue.h
+ * @version    1.0
+ * @date       Oct 16, 2026
+ * @copyright
+ * @addtogroup fluffer_gp FLuffer
+ * @{
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <main.h>
+#include <utils.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <fluffer_queue.h>
+
+
+/* ------------------------------------------------------------------------------------ */
+
+/*
+ * Indices are free running, a slot's index is masked by (capacity - 1) and the number of queued
+ * entries is (tail - head), so a full queue is told apart from an empty one without a spare slot.
+ * tail is written by the producer only (release, after the entry's copy), head is claimed with a
+ * compare & swap by the consumer, and by the producer when it drops the oldest entry. dropped is
+ * counted by both, the consumer counts a claimed batch its write failed to write. Atomics are
+ * GCC builtins (LDREX/STREX on Cortex-M3), as the project is C99.
+ */
+
+/**
+ * @brief Maximum queue capacity, so (tail - head) of a full queue fits in uint16_t
+ * */
+#define FLUFFER_QUEUE_MAX_CAPACITY		32768
+
+/**
+ * @brief Load a queue index, entries written before it was stored are visible
+ * */
+#define FLUFFER_QUEUE_LOAD(pu16Index)						__atomic_load_n((pu16Index), __ATOMIC_ACQUIRE)
+
+/**
+ * @brief Store a queue index, entries written before it are visible to the other side's load
+ * */
+#define FLUFFER_QUEUE_STORE(pu16Index, u16Value)			__atomic_store_n((pu16Index), (u16Value), __ATOMIC_RELEASE)
+
+/**
+ * @brief Claim queue's head, moving it from an expected index to a new one, fails if the other side moved it first
+ * */
+#define FLUFFER_QUEUE_CLAIM(pu16Index, pu16Expected, u16New)	\
+    __atomic_compare_exchange_n((pu16Index), (pu16Expected), (u16New), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/**
+ * @brief Add to queue's dropped counter, both sides count dropped entries
+ * */
+#define FLUFFER_QUEUE_DROP(pu32Dropped, u32Count)			__atomic_fetch_add((pu32Dropped), (u32Count), __ATOMIC_RELAXED)
+
+/**
+ * @brief Get a slot's address by its (free running) index
+ */
+#define FLUFFER_QUEUE_SLOT(psQueue, u16Index)	\
+    (&(psQueue)->slots[(uint32_t)((u16Index) & ((psQueue)->capacity - 1)) * (psQueue)->fluffer->cfg.element_size])
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Copy entries from queue's slots into its batch buffer, copy is split at the slots' end
+ * @param   psQueue pointer to fluffer queue
+ * @param	u16Head index of 1st entry to copy
+ * @param	u16Count number of entries to copy
+ * @return  void
+ * */
+static void Fluffer_vidQueueCopyBatch(Fluffer_Queue_t * const psQueue, uint16_t u16Head, uint16_t u16Count);
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief   Copy entries from queue's slots into its batch buffer, copy is split at the slots' end
+ * @param   psQueue pointer to fluffer queue
+ * @param	u16Head index of 1st entry to copy
+ * @param	u16Count number of entries to copy
+ * @return  void
+ * */
+static void Fluffer_vidQueueCopyBatch(Fluffer_Queue_t * const psQueue, uint16_t u16Head, uint16_t u16Count)
+{
+    uint16_t Local_u16First;		/*	entries before the slots' end	*/
+    uint16_t Local_u16ElementSize = psQueue->fluffer->cfg.element_size;
+
+    Local_u16First = MIN(u16Count, psQueue->capacity - (u16Head & (psQueue->capacity - 1)));
+
+    memcpy(psQueue->batch, FLUFFER_QUEUE_SLOT(psQueue, u16Head), (uint32_t)Local_u16First * Local_u16ElementSize);
+
+    if(u16Count > Local_u16First)
+    {
+        memcpy(&psQueue->batch[(uint32_t)Local_u16First * Local_u16ElementSize], psQueue->slots,
+               (uint32_t)(u16Count - Local_u16First) * Local_u16ElementSize);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enQueueInitialize(Fluffer_Queue_t * const psQueue)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psQueue) || IS_NULLPTR(psQueue->fluffer) || IS_NULLPTR(psQueue->slots) || IS_NULLPTR(psQueue->batch))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    /*	check for parameters	*/
+    if( IS_ZERO(psQueue->capacity) || (psQueue->capacity > FLUFFER_QUEUE_MAX_CAPACITY) ||
+        !IS_ZERO(psQueue->capacity & (psQueue->capacity - 1)) || IS_ZERO(psQueue->batch_size) ||
+        ((psQueue->policy != FLUFFER_QUEUE_DROP_NEWEST) && (psQueue->policy != FLUFFER_QUEUE_DROP_OLDEST)))
+    {
+        return FLUFFER_ERROR_PARAM;
+    }
+
+    psQueue->head = 0;
+    psQueue->tail = 0;
+    psQueue->dropped = 0;
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enQueuePush(Fluffer_Queue_t * const psQueue, const uint8_t * const pu8Data)
+{
+    uint16_t Local_u16Tail;			/*	producer's own index	*/
+    uint16_t Local_u16Head;			/*	consumer's index	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psQueue) || IS_NULLPTR(pu8Data))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    Local_u16Tail = psQueue->tail;
+    Local_u16Head = FLUFFER_QUEUE_LOAD(&psQueue->head);
+
+    /*	queue is full	*/
+    if((uint16_t)(Local_u16Tail - Local_u16Head) >= psQueue->capacity)
+    {
+        if(psQueue->policy == FLUFFER_QUEUE_DROP_NEWEST)
+        {
+            FLUFFER_QUEUE_DROP(&psQueue->dropped, 1);
+            return FLUFFER_ERROR_FULL;
+        }
+        /*	a failed claim means the consumer already took the oldest entry, so there's room anyway	*/
+        else if(FLUFFER_QUEUE_CLAIM(&psQueue->head, &Local_u16Head, (uint16_t)(Local_u16Head + 1)))
+        {
+            FLUFFER_QUEUE_DROP(&psQueue->dropped, 1);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    memcpy(FLUFFER_QUEUE_SLOT(psQueue, Local_u16Tail), pu8Data, psQueue->fluffer->cfg.element_size);
+
+    /*	publish the entry	*/
+    FLUFFER_QUEUE_STORE(&psQueue->tail, (uint16_t)(Local_u16Tail + 1));
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enQueueDrain(Fluffer_Queue_t * const psQueue, uint16_t u16Max, uint16_t * const pu16Drained)
+{
+    Fluffer_Error_t Local_enError;
+    uint16_t Local_u16Head;			/*	consumer's index	*/
+    uint16_t Local_u16Count;		/*	entries in current batch	*/
+    uint16_t Local_u16Written;		/*	entries written by current batch	*/
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psQueue) || IS_NULLPTR(pu16Drained))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    *pu16Drained = 0;
+
+    while(*pu16Drained < u16Max)
+    {
+        /*	copy a batch out of the queue, the producer may drop the oldest entry while it's copied	*/
+        do
+        {
+            Local_u16Head = FLUFFER_QUEUE_LOAD(&psQueue->head);
+            Local_u16Count = (uint16_t)(FLUFFER_QUEUE_LOAD(&psQueue->tail) - Local_u16Head);
+            Local_u16Count = MIN(Local_u16Count, MIN(psQueue->batch_size, u16Max - *pu16Drained));
+
+            if(IS_ZERO(Local_u16Count))
+            {
+                return FLUFFER_ERROR_NONE;
+            }
+
+            Fluffer_vidQueueCopyBatch(psQueue, Local_u16Head, Local_u16Count);
+        }while(!FLUFFER_QUEUE_CLAIM(&psQueue->head, &Local_u16Head, (uint16_t)(Local_u16Head + Local_u16Count)));
+
+        /*	slots are free again, the batch is written from its own buffer	*/
+        Local_u16Written = 0;
+        Local_enError = Fluffer_enWriteEntries(psQueue->fluffer, psQueue->batch, Local_u16Count, &Local_u16Written);
+
+        if(Local_enError != FLUFFER_ERROR_NONE)
+        {
+            /*	batch's slots may already hold new entries, its entries that weren't written are lost	*/
+            FLUFFER_QUEUE_DROP(&psQueue->dropped, (uint32_t)(Local_u16Count - Local_u16Written));
+            *pu16Drained += Local_u16Written;
+
+            return Local_enError;
+        }
+
+        *pu16Drained += Local_u16Count;
+    }
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enQueueFlush(Fluffer_Queue_t * const psQueue)
+{
+    Fluffer_Error_t Local_enError;
+    uint16_t Local_u16Drained;
+
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psQueue))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    do
+    {
+        Local_enError = Fluffer_enQueueDrain(psQueue, UINT16_MAX, &Local_u16Drained);
+
+        if(Local_enError != FLUFFER_ERROR_NONE)
+        {
+            return Local_enError;
+        }
+    }while(!IS_ZERO(Local_u16Drained));
+
+    /*	write entries left in the instance's write-back cache	*/
+    Local_enError = Fluffer_enFlush(psQueue->fluffer);
+
+    if(Local_enError != FLUFFER_ERROR_NONE)
+    {
+        return Local_enError;
+    }
+
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+    /*	save warm context, so the next boot doesn't scan the memory	*/
+    if(!IS_NULLPTR(psQueue->fluffer->handles.load_handle) && !IS_NULLPTR(psQueue->fluffer->handles.save_handle))
+    {
+        return Fluffer_enSaveContext(psQueue->fluffer);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Error_t Fluffer_enQueueCount(const Fluffer_Queue_t * const psQueue, uint16_t * const pu16Count)
+{
+    /*	check for null pointers	*/
+    if(IS_NULLPTR(psQueue) || IS_NULLPTR(pu16Count))
+    {
+        return FLUFFER_ERROR_NULLPTR;
+    }
+
+    *pu16Count = (uint16_t)(FLUFFER_QUEUE_LOAD(&psQueue->tail) - FLUFFER_QUEUE_LOAD(&psQueue->head));
+
+    return FLUFFER_ERROR_NONE;
+}
+
+/**@}*/
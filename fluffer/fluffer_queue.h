@@ -0,0 +1,106 @@
+/******************************************************************************
+ * @file       fluffer_queue.h
+ * @version    1.0
+ * @date       Oct 16, 2026
+ * @copyright
+ * @addtogroup fluffer_gp FLuffer
+ * @brief	   Fluffer queue, a lock-free single producer / single consumer RAM ring staged in front of a
+ * 			   fluffer instance. The producer (ex: an ISR) pushes entries in O(1) without any memory
+ * 			   handle call, the consumer (ex: a background task) drains them into the fluffer instance
+ * 			   with Fluffer_enWriteEntries.
+ * @{
+ *****************************************************************************/
+#ifndef __FLUFFER_QUEUE_H__
+#define __FLUFFER_QUEUE_H__
+
+/**
+ * @brief Fluffer queue overflow policies, define what a push does when the queue is full
+ * */
+typedef enum fluffer_queue_policy_t {
+    FLUFFER_QUEUE_DROP_NEWEST,		/**<  the pushed entry is dropped, push returns FLUFFER_ERROR_FULL  */
+    FLUFFER_QUEUE_DROP_OLDEST,      /**<  the oldest queued entry is dropped to make room for the pushed entry  */
+}Fluffer_Queue_Policy_t;
+
+/**
+ * @brief Fluffer queue structure, buffers, capacity, batch size & policy are set by the application before
+ *        Fluffer_enQueueInitialize, indices & counters are owned by the queue
+ * */
+typedef struct fluffer_queue_t {
+    Fluffer_t * fluffer;				/**<  fluffer instance entries are drained into (initialized)  */
+    uint8_t * slots;                    /**<  queue slots, its size must be capacity * @ref element_size bytes  */
+    uint8_t * batch;                    /**<  entries copied out of the queue & written by a single Fluffer_enWriteEntries call,
+                                              its size must be batch_size * @ref element_size bytes  */
+    uint16_t capacity;                  /**<  number of slots, a power of 2 (at most 32768)  */
+    uint16_t batch_size;                /**<  number of entries in the batch buffer  */
+    Fluffer_Queue_Policy_t policy;      /**<  overflow policy  */
+    volatile uint16_t head;             /**<  index of the oldest queued entry (free running)  */
+    volatile uint16_t tail;             /**<  index of the next pushed entry (free running), written by the producer only  */
+    volatile uint32_t dropped;          /**<  entries dropped by the overflow policy, or claimed by a drain that failed to write them  */
+}Fluffer_Queue_t;
+
+/**
+ * @brief   Initialize fluffer queue, the queue is emptied & its dropped counter is cleared
+ * @param   psQueue pointer to fluffer queue
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psQueue, its fluffer instance, slots or batch buffer is null
+ * 			FLUFFER_ERROR_PARAM : if capacity isn't a power of 2 (or more than 32768), batch size is 0,
+ * 			or policy is invalid
+ * */
+Fluffer_Error_t Fluffer_enQueueInitialize(Fluffer_Queue_t * const psQueue);
+
+/**
+ * @brief   Push an entry into fluffer queue, O(1) with no memory handle calls. Can be called from an ISR,
+ *          by a single producer
+ * @details With FLUFFER_QUEUE_DROP_OLDEST, a full queue drops its oldest entry, a drain copying it at the
+ *          same time notices it (its claim fails) and copies again
+ * @param   psQueue pointer to fluffer queue
+ * @param	pu8Data pointer to entry's data, its size must be @ref element_size bytes
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred (an entry may be dropped with FLUFFER_QUEUE_DROP_OLDEST)
+ * 			FLUFFER_ERROR_NULLPTR : if psQueue, or the data pointer is null
+ * 			FLUFFER_ERROR_FULL : if queue is full with FLUFFER_QUEUE_DROP_NEWEST, the entry is dropped
+ * */
+Fluffer_Error_t Fluffer_enQueuePush(Fluffer_Queue_t * const psQueue, const uint8_t * const pu8Data);
+
+/**
+ * @brief   Drain queued entries into the fluffer instance, in batches of up to batch_size entries (a single
+ *          Fluffer_enWriteEntries call each). Must be called by a single consumer, the only user of the
+ *          fluffer instance
+ * @details A batch is claimed (its slots are freed for the producer) before it's written, so if its write
+ *          fails, its entries that weren't written are lost and counted in dropped
+ * @param   psQueue pointer to fluffer queue
+ * @param	u16Max maximum number of entries to drain
+ * @param	pu16Drained pointer to a uint16_t variable, to store number of drained entries in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psQueue, or the drained pointer is null
+ * 			Fluffer_enWriteEntries's error : if a batch's write failed, draining is stopped
+ * */
+Fluffer_Error_t Fluffer_enQueueDrain(Fluffer_Queue_t * const psQueue, uint16_t u16Max, uint16_t * const pu16Drained);
+
+/**
+ * @brief   Drain all queued entries into the fluffer instance, write its cached entries (Fluffer_enFlush), then
+ *          save its warm context (FLUFFER_CONTEXT_WARM, if the load & save handles are set). Should be called before entering low
+ *          power mode, once producers are stopped
+ * @param   psQueue pointer to fluffer queue
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psQueue is null
+ * 			FLUFFER_ERROR_MEMORY : if save handle failed
+ * */
+Fluffer_Error_t Fluffer_enQueueFlush(Fluffer_Queue_t * const psQueue);
+
+/**
+ * @brief   Get number of entries in fluffer queue
+ * @param   psQueue pointer to fluffer queue
+ * @param	pu16Count pointer to a uint16_t variable, to store number of queued entries in it
+ * @return  Fluffer_Error_t
+ * 			FLUFFER_ERROR_NONE : if no errors occurred
+ * 			FLUFFER_ERROR_NULLPTR : if psQueue, or the count pointer is null
+ * */
+Fluffer_Error_t Fluffer_enQueueCount(const Fluffer_Queue_t * const psQueue, uint16_t * const pu16Count);
+
+#endif /* __FLUFFER_QUEUE_H__ */
+
+/**@}*/
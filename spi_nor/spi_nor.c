@@ -0,0 +1,789 @@
+/******************************************************************************
+ * @file      spi_nor.c
+ * @brief     JEDEC SPI NOR flash driver, see spi_nor.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <utils.h>
+#include "spi_nor.h"
+
+
+/* ------------------------------------------------------------------------- */
+
+#define SPI_NOR_REGION_ADDRESS				(SPI_NOR_START_SECTOR * SPI_NOR_SECTOR_SIZE)
+#define SPI_NOR_OFFSET_TO_ADDRESS(o)		((o) + SPI_NOR_REGION_ADDRESS)
+#define SPI_NOR_IS_VALID_SECTOR(s)			((s) < SPI_NOR_ALLOCATED_SECTORS)
+#define SPI_NOR_PAGE_ROOM(a)				(SPI_NOR_PAGE_SIZE - ((a) % SPI_NOR_PAGE_SIZE))
+
+/*	command & address bytes	*/
+#define SPI_NOR_HEADER_SIZE					(1 + SPI_NOR_ADDRESS_BYTES)
+
+/*	no block is known to be erased	*/
+#define SPI_NOR_NO_BLOCK					UINT32_MAX
+
+#if SPI_NOR_ADDRESS_BYTES == 4
+#define SPI_NOR_READ_COMMAND				SPI_NOR_CMD_READ_4B
+#define SPI_NOR_PROGRAM_COMMAND				SPI_NOR_CMD_PAGE_PROGRAM_4B
+#define SPI_NOR_SECTOR_ERASE_COMMAND		SPI_NOR_CMD_SECTOR_ERASE_4B
+#define SPI_NOR_BLOCK_ERASE_COMMAND			SPI_NOR_CMD_BLOCK_ERASE_4B
+#else
+#define SPI_NOR_READ_COMMAND				SPI_NOR_CMD_READ
+#define SPI_NOR_PROGRAM_COMMAND				SPI_NOR_CMD_PAGE_PROGRAM
+#define SPI_NOR_SECTOR_ERASE_COMMAND		SPI_NOR_CMD_SECTOR_ERASE
+#define SPI_NOR_BLOCK_ERASE_COMMAND			SPI_NOR_CMD_BLOCK_ERASE
+#endif	/*	SPI_NOR_ADDRESS_BYTES	*/
+
+/* ------------------------------------------------------------------------- */
+
+/*	SPI bus handles, set by SpiNor_enInitialize	*/
+static const SpiNor_Bus_t * SpiNor_psBus = NULL;
+
+/*	64 KB block erased by SpiNor_enErase or SpiNor_enEraseBlock, with no program since	*/
+static uint32_t SpiNor_u32ErasedBlock = SPI_NOR_NO_BLOCK;
+
+/*	an erase started by SpiNor_enStartErase may still be in progress	*/
+static uint8_t SpiNor_u8Erasing = 0;
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Run a command: select the memory, send the command (and address), then send or receive its data
+ *        bytes, and deselect the memory (on errors too)
+ * @param u8Command  command
+ * @param u32Address absolute address, sent if u8Address isn't 0
+ * @param u8Address  1 if the command takes an address, 0 otherwise
+ * @param pu8Tx      data bytes sent after the address, NULL if none
+ * @param pu8Rx      buffer for data bytes received after the address, NULL if none
+ * @param u16Len     number of data bytes
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enCommand(uint8_t u8Command, uint32_t u32Address, uint8_t u8Address, const uint8_t * pu8Tx, uint8_t * pu8Rx, uint16_t u16Len);
+
+/**
+ * @brief Set the write enable latch, needed by each program & erase
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_WRITE_DISABLED : if the latch wasn't set (write protected memory)
+ **/
+static SpiNor_Error_t SpiNor_enWriteEnable(void);
+
+/**
+ * @brief Wait for a program or erase to finish, status register is read continuously in a single transfer
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_TIMEOUT : if the memory is still busy after SPI_NOR_BUSY_TIMEOUT status reads
+ **/
+static SpiNor_Error_t SpiNor_enWaitReady(void);
+
+/**
+ * @brief Wait for an erase started by SpiNor_enStartErase to finish, if any
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enFinishErase(void);
+
+/**
+ * @brief Erase a sector or a block: write enable, erase command, wait
+ * @param u8Command  erase command
+ * @param u32Address absolute address of the erased sector or block
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseAt(uint8_t u8Command, uint32_t u32Address, uint8_t u8Wait);
+
+/**
+ * @brief Erase a sector of the allocated region, see SpiNor_enEraseSector
+ * @param u32Sector  sector index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseSectorAt(uint32_t u32Sector, uint8_t u8Wait);
+
+/**
+ * @brief Erase a 64 KB block of the allocated region, see SpiNor_enEraseBlock
+ * @param u32Block   block index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseBlockAt(uint32_t u32Block, uint8_t u8Wait);
+
+/**
+ * @brief Erase a sector of the allocated region for the region's user, see SpiNor_enErase
+ * @param u32Sector  sector index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseUnit(uint32_t u32Sector, uint8_t u8Wait);
+
+/**
+ * @brief Convert a driver error to a fluffer handle error
+ * @param enError    driver error
+ * @param enBoundary handle error of an out of region access
+ * @return Fluffer_Handle_Error_t
+ **/
+static Fluffer_Handle_Error_t SpiNor_enHandleError(SpiNor_Error_t enError, Fluffer_Handle_Error_t enBoundary);
+
+/**
+ * @brief Fluffer read handle, see SpiNor_enRead
+ **/
+static Fluffer_Handle_Error_t SpiNor_enReadHandle(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief Fluffer write handle, see SpiNor_enWrite
+ **/
+static Fluffer_Handle_Error_t SpiNor_enWriteHandle(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len);
+
+/**
+ * @brief Fluffer erase handle, see SpiNor_enErase
+ **/
+static Fluffer_Handle_Error_t SpiNor_enEraseHandle(Fluffer_Page_t Page);
+
+/**
+ * @brief Fluffer asynchronous erase handle, see SpiNor_enStartErase
+ **/
+static Fluffer_Handle_Error_t SpiNor_enStartEraseHandle(Fluffer_Page_t Page);
+
+/**
+ * @brief Fluffer poll handle, see SpiNor_enIsBusy
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_BUSY : if an erase started by the asynchronous erase handle is still in progress
+ **/
+static Fluffer_Handle_Error_t SpiNor_enPollHandle(void);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Run a command: select the memory, send the command (and address), then send or receive its data
+ *        bytes, and deselect the memory (on errors too)
+ * @param u8Command  command
+ * @param u32Address absolute address, sent if u8Address isn't 0
+ * @param u8Address  1 if the command takes an address, 0 otherwise
+ * @param pu8Tx      data bytes sent after the address, NULL if none
+ * @param pu8Rx      buffer for data bytes received after the address, NULL if none
+ * @param u16Len     number of data bytes
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enCommand(uint8_t u8Command, uint32_t u32Address, uint8_t u8Address, const uint8_t * pu8Tx, uint8_t * pu8Rx, uint16_t u16Len)
+{
+    SpiNor_Error_t Local_enError;
+    uint8_t Local_au8Header[SPI_NOR_HEADER_SIZE];
+    uint8_t Local_u8HeaderLen = 1;
+    uint8_t Local_u8Byte;
+
+    Local_au8Header[0] = u8Command;
+
+    /*	address is sent most significant byte first	*/
+    if(u8Address)
+    {
+        for(Local_u8Byte = SPI_NOR_ADDRESS_BYTES; Local_u8Byte > 0; Local_u8Byte--)
+        {
+            Local_au8Header[Local_u8HeaderLen++] = (uint8_t)(u32Address >> ((Local_u8Byte - 1) * 8));
+        }
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    Local_enError = SpiNor_psBus->select_handle(1);
+
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_psBus->transmit_handle(Local_au8Header, Local_u8HeaderLen);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    if((Local_enError == SPI_NOR_ERROR_NONE) && !IS_NULLPTR(pu8Tx))
+    {
+        Local_enError = SpiNor_psBus->transmit_handle(pu8Tx, u16Len);
+    }
+    else if((Local_enError == SPI_NOR_ERROR_NONE) && !IS_NULLPTR(pu8Rx))
+    {
+        Local_enError = SpiNor_psBus->receive_handle(pu8Rx, u16Len);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    /*	a command is only executed once the memory is deselected	*/
+    if(SpiNor_psBus->select_handle(0) != SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SPI_NOR_ERROR_BUS;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Set the write enable latch, needed by each program & erase
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_WRITE_DISABLED : if the latch wasn't set (write protected memory)
+ **/
+static SpiNor_Error_t SpiNor_enWriteEnable(void)
+{
+    SpiNor_Error_t Local_enError;
+    uint8_t Local_u8Status = 0;
+
+    Local_enError = SpiNor_enCommand(SPI_NOR_CMD_WRITE_ENABLE, 0, 0, NULL, NULL, 0);
+
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_enCommand(SPI_NOR_CMD_READ_STATUS, 0, 0, NULL, &Local_u8Status, 1);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    if((Local_enError == SPI_NOR_ERROR_NONE) && !(Local_u8Status & SPI_NOR_STATUS_WEL))
+    {
+        Local_enError = SPI_NOR_ERROR_WRITE_DISABLED;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Wait for a program or erase to finish, status register is read continuously in a single transfer
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_TIMEOUT : if the memory is still busy after SPI_NOR_BUSY_TIMEOUT status reads
+ **/
+static SpiNor_Error_t SpiNor_enWaitReady(void)
+{
+    const uint8_t Local_u8Command = SPI_NOR_CMD_READ_STATUS;
+    SpiNor_Error_t Local_enError;
+    uint8_t Local_u8Status = SPI_NOR_STATUS_BUSY;
+    uint32_t Local_u32Timeout = SPI_NOR_BUSY_TIMEOUT;
+
+    Local_enError = SpiNor_psBus->select_handle(1);
+
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_psBus->transmit_handle(&Local_u8Command, 1);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    /*	status register is output again & again while the memory is selected	*/
+    while((Local_enError == SPI_NOR_ERROR_NONE) && (Local_u8Status & SPI_NOR_STATUS_BUSY) && !IS_ZERO(Local_u32Timeout))
+    {
+        Local_enError = SpiNor_psBus->receive_handle(&Local_u8Status, 1);
+        Local_u32Timeout--;
+    }
+
+    if(SpiNor_psBus->select_handle(0) != SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SPI_NOR_ERROR_BUS;
+    }
+    else if((Local_enError == SPI_NOR_ERROR_NONE) && (Local_u8Status & SPI_NOR_STATUS_BUSY))
+    {
+        Local_enError = SPI_NOR_ERROR_TIMEOUT;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Wait for an erase started by SpiNor_enStartErase to finish, if any
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enFinishErase(void)
+{
+    SpiNor_Error_t Local_enError = SPI_NOR_ERROR_NONE;
+
+    if(SpiNor_u8Erasing)
+    {
+        Local_enError = SpiNor_enWaitReady();
+        SpiNor_u8Erasing = (Local_enError != SPI_NOR_ERROR_NONE);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Erase a sector or a block: write enable, erase command, wait
+ * @param u8Command  erase command
+ * @param u32Address absolute address of the erased sector or block
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseAt(uint8_t u8Command, uint32_t u32Address, uint8_t u8Wait)
+{
+    SpiNor_Error_t Local_enError;
+
+    Local_enError = SpiNor_enFinishErase();
+
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_enWriteEnable();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_enCommand(u8Command, u32Address, 1, NULL, NULL, 0);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    if((Local_enError == SPI_NOR_ERROR_NONE) && u8Wait)
+    {
+        Local_enError = SpiNor_enWaitReady();
+    }
+    else if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        /*	next command waits for it, unless SpiNor_enIsBusy sees it done first	*/
+        SpiNor_u8Erasing = 1;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Erase a sector of the allocated region, see SpiNor_enEraseSector
+ * @param u32Sector  sector index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseSectorAt(uint32_t u32Sector, uint8_t u8Wait)
+{
+    if(!SPI_NOR_IS_VALID_SECTOR(u32Sector))
+    {
+        return SPI_NOR_ERROR_MEM_BOUNDARY;
+    }
+
+    if(IS_NULLPTR(SpiNor_psBus))
+    {
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    return SpiNor_enEraseAt(SPI_NOR_SECTOR_ERASE_COMMAND, SPI_NOR_OFFSET_TO_ADDRESS(u32Sector * SPI_NOR_SECTOR_SIZE), u8Wait);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Erase a 64 KB block of the allocated region, see SpiNor_enEraseBlock
+ * @param u32Block   block index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseBlockAt(uint32_t u32Block, uint8_t u8Wait)
+{
+    SpiNor_Error_t Local_enError;
+
+    /*	block's sectors must all be in the region	*/
+    if(((SPI_NOR_START_SECTOR % SPI_NOR_BLOCK_SECTORS) != 0) ||
+       (((uint64_t)u32Block + 1) * SPI_NOR_BLOCK_SECTORS > SPI_NOR_ALLOCATED_SECTORS))
+    {
+        return SPI_NOR_ERROR_MEM_BOUNDARY;
+    }
+
+    if(IS_NULLPTR(SpiNor_psBus))
+    {
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    Local_enError = SpiNor_enEraseAt(SPI_NOR_BLOCK_ERASE_COMMAND, SPI_NOR_OFFSET_TO_ADDRESS(u32Block * SPI_NOR_BLOCK_SIZE), u8Wait);
+
+    SpiNor_u32ErasedBlock = (Local_enError == SPI_NOR_ERROR_NONE) ? u32Block : SPI_NOR_NO_BLOCK;
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Erase a sector of the allocated region for the region's user, see SpiNor_enErase
+ * @param u32Sector  sector index
+ * @param u8Wait     1 to wait for the erase to finish, 0 to return once it's started
+ * @return SpiNor_Error_t
+ **/
+static SpiNor_Error_t SpiNor_enEraseUnit(uint32_t u32Sector, uint8_t u8Wait)
+{
+#if SPI_NOR_BLOCK_ERASE == 1
+    if(!SPI_NOR_IS_VALID_SECTOR(u32Sector))
+    {
+        return SPI_NOR_ERROR_MEM_BOUNDARY;
+    }
+
+    /*	sector's block is still erased	*/
+    if((u32Sector / SPI_NOR_BLOCK_SECTORS) == SpiNor_u32ErasedBlock)
+    {
+        return SPI_NOR_ERROR_NONE;
+    }
+
+    /*	sector's block belongs to a single erase unit, all of it is erased by the region's user anyway	*/
+    return SpiNor_enEraseBlockAt(u32Sector / SPI_NOR_BLOCK_SECTORS, u8Wait);
+#else
+    return SpiNor_enEraseSectorAt(u32Sector, u8Wait);
+#endif	/*	SPI_NOR_BLOCK_ERASE	*/
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Convert a driver error to a fluffer handle error
+ * @param enError    driver error
+ * @param enBoundary handle error of an out of region access
+ * @return Fluffer_Handle_Error_t
+ **/
+static Fluffer_Handle_Error_t SpiNor_enHandleError(SpiNor_Error_t enError, Fluffer_Handle_Error_t enBoundary)
+{
+    Fluffer_Handle_Error_t Local_enError;
+
+    switch(enError)
+    {
+        case SPI_NOR_ERROR_NONE:
+        case SPI_NOR_ERROR_ZERO_LEN:
+            Local_enError = FH_ERR_NONE;
+            break;
+
+        case SPI_NOR_ERROR_NULLPTR:
+            Local_enError = FH_ERR_NULLPTR;
+            break;
+
+        case SPI_NOR_ERROR_MEM_BOUNDARY:
+            Local_enError = enBoundary;
+            break;
+
+        default:
+            /*	bus error, timeout or write protected memory, memory content is unknown	*/
+            Local_enError = FH_ERR_CORRUPTED_BLOCK;
+            break;
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fluffer read handle, see SpiNor_enRead
+ **/
+static Fluffer_Handle_Error_t SpiNor_enReadHandle(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    return SpiNor_enHandleError(SpiNor_enRead(u32Offset, pu8Buffer, u16Len), FH_ERR_INVALID_ADDRESS);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fluffer write handle, see SpiNor_enWrite
+ **/
+static Fluffer_Handle_Error_t SpiNor_enWriteHandle(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len)
+{
+    return SpiNor_enHandleError(SpiNor_enWrite(u32Offset, pu8Data, u16Len), FH_ERR_INVALID_ADDRESS);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fluffer erase handle, see SpiNor_enErase
+ **/
+static Fluffer_Handle_Error_t SpiNor_enEraseHandle(Fluffer_Page_t Page)
+{
+    return SpiNor_enHandleError(SpiNor_enErase(Page), FH_ERR_INVALID_PAGE);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fluffer asynchronous erase handle, see SpiNor_enStartErase
+ **/
+static Fluffer_Handle_Error_t SpiNor_enStartEraseHandle(Fluffer_Page_t Page)
+{
+    return SpiNor_enHandleError(SpiNor_enStartErase(Page), FH_ERR_INVALID_PAGE);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fluffer poll handle, see SpiNor_enIsBusy
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_BUSY : if an erase started by the asynchronous erase handle is still in progress
+ **/
+static Fluffer_Handle_Error_t SpiNor_enPollHandle(void)
+{
+    SpiNor_Error_t Local_enError;
+    uint8_t Local_u8Busy = 0;
+
+    Local_enError = SpiNor_enIsBusy(&Local_u8Busy);
+
+    return Local_u8Busy ? FH_ERR_BUSY : SpiNor_enHandleError(Local_enError, FH_ERR_INVALID_PAGE);
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enInitialize(const SpiNor_Bus_t * const psBus, uint32_t * const pu32Id)
+{
+    SpiNor_Error_t Local_enError;
+    uint8_t Local_au8Id[3];
+    uint32_t Local_u32Id;
+
+    if( IS_NULLPTR(psBus) || IS_NULLPTR(psBus->select_handle) ||
+        IS_NULLPTR(psBus->transmit_handle) || IS_NULLPTR(psBus->receive_handle))
+    {
+        return SPI_NOR_ERROR_NULLPTR;
+    }
+
+    SpiNor_psBus = psBus;
+    SpiNor_u32ErasedBlock = SPI_NOR_NO_BLOCK;
+    SpiNor_u8Erasing = 0;
+
+    Local_enError = SpiNor_enCommand(SPI_NOR_CMD_READ_JEDEC_ID, 0, 0, NULL, Local_au8Id, sizeof(Local_au8Id));
+    if(Local_enError != SPI_NOR_ERROR_NONE)
+    {
+        return Local_enError;
+    }
+
+    Local_u32Id = ((uint32_t)Local_au8Id[0] << 16) | ((uint32_t)Local_au8Id[1] << 8) | Local_au8Id[2];
+
+    /*	floating or shorted MISO	*/
+    if(IS_ZERO(Local_u32Id) || (Local_u32Id == 0xFFFFFFUL))
+    {
+        return SPI_NOR_ERROR_NOT_FOUND;
+    }
+
+    if(!IS_NULLPTR(pu32Id))
+    {
+        (*pu32Id) = Local_u32Id;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return SPI_NOR_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enRead(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    SpiNor_Error_t Local_enError;
+
+    if(IS_NULLPTR(pu8Buffer))
+    {
+        return SPI_NOR_ERROR_NULLPTR;
+    }
+
+    if(IS_ZERO(u16Len))
+    {
+        return SPI_NOR_ERROR_ZERO_LEN;
+    }
+
+    if((u32Offset + u16Len) > (SPI_NOR_OFFSET_END + 1))
+    {
+        return SPI_NOR_ERROR_MEM_BOUNDARY;
+    }
+
+    if(IS_NULLPTR(SpiNor_psBus))
+    {
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    Local_enError = SpiNor_enFinishErase();
+
+    /*	a read isn't limited to a page	*/
+    if(Local_enError == SPI_NOR_ERROR_NONE)
+    {
+        Local_enError = SpiNor_enCommand(SPI_NOR_READ_COMMAND, SPI_NOR_OFFSET_TO_ADDRESS(u32Offset), 1, NULL, pu8Buffer, u16Len);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enWrite(uint32_t u32Offset, const uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    SpiNor_Error_t Local_enError;
+    uint32_t Local_u32Address;
+    uint16_t Local_u16Chunk;
+
+    if(IS_NULLPTR(pu8Buffer))
+    {
+        return SPI_NOR_ERROR_NULLPTR;
+    }
+
+    if(IS_ZERO(u16Len))
+    {
+        return SPI_NOR_ERROR_ZERO_LEN;
+    }
+
+    if((u32Offset + u16Len) > (SPI_NOR_OFFSET_END + 1))
+    {
+        return SPI_NOR_ERROR_MEM_BOUNDARY;
+    }
+
+    if(IS_NULLPTR(SpiNor_psBus))
+    {
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    Local_enError = SpiNor_enFinishErase();
+    Local_u32Address = SPI_NOR_OFFSET_TO_ADDRESS(u32Offset);
+
+    while((u16Len > 0) && (Local_enError == SPI_NOR_ERROR_NONE))
+    {
+        /*	a page program wraps around at the page's end, split at page boundaries	*/
+        Local_u16Chunk = (uint16_t)MIN(u16Len, SPI_NOR_PAGE_ROOM(Local_u32Address));
+
+        /*	erased block is being programmed	*/
+        if(((u32Offset / SPI_NOR_BLOCK_SIZE) == SpiNor_u32ErasedBlock) ||
+           (((u32Offset + Local_u16Chunk - 1) / SPI_NOR_BLOCK_SIZE) == SpiNor_u32ErasedBlock))
+        {
+            SpiNor_u32ErasedBlock = SPI_NOR_NO_BLOCK;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        Local_enError = SpiNor_enWriteEnable();
+
+        if(Local_enError == SPI_NOR_ERROR_NONE)
+        {
+            Local_enError = SpiNor_enCommand(SPI_NOR_PROGRAM_COMMAND, Local_u32Address, 1, pu8Buffer, NULL, Local_u16Chunk);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        if(Local_enError == SPI_NOR_ERROR_NONE)
+        {
+            Local_enError = SpiNor_enWaitReady();
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        Local_u32Address += Local_u16Chunk;
+        u32Offset += Local_u16Chunk;
+        pu8Buffer += Local_u16Chunk;
+        u16Len -= Local_u16Chunk;
+    }
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enEraseSector(uint32_t u32Sector)
+{
+    return SpiNor_enEraseSectorAt(u32Sector, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enEraseBlock(uint32_t u32Block)
+{
+    return SpiNor_enEraseBlockAt(u32Block, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enErase(uint32_t u32Sector)
+{
+    return SpiNor_enEraseUnit(u32Sector, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enStartErase(uint32_t u32Sector)
+{
+    return SpiNor_enEraseUnit(u32Sector, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+SpiNor_Error_t SpiNor_enIsBusy(uint8_t * const pu8Busy)
+{
+    SpiNor_Error_t Local_enError = SPI_NOR_ERROR_NONE;
+    uint8_t Local_u8Status = 0;
+
+    if(IS_NULLPTR(pu8Busy))
+    {
+        return SPI_NOR_ERROR_NULLPTR;
+    }
+
+    /*	no bus traffic unless an erase was started	*/
+    if(SpiNor_u8Erasing)
+    {
+        Local_enError = SpiNor_enCommand(SPI_NOR_CMD_READ_STATUS, 0, 0, NULL, &Local_u8Status, 1);
+        SpiNor_u8Erasing = (Local_enError != SPI_NOR_ERROR_NONE) || (Local_u8Status & SPI_NOR_STATUS_BUSY);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    (*pu8Busy) = (Local_enError == SPI_NOR_ERROR_NONE) && SpiNor_u8Erasing;
+
+    return Local_enError;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void SpiNor_vidSetHandles(Fluffer_Handles_t * const psHandles)
+{
+    Fluffer_enInitHandles(psHandles, SpiNor_enReadHandle, SpiNor_enWriteHandle, SpiNor_enEraseHandle);
+}
+
+/* ------------------------------------------------------------------------- */
+
+void SpiNor_vidSetAsyncHandles(Fluffer_Handles_t * const psHandles)
+{
+    SpiNor_vidSetHandles(psHandles);
+    psHandles->erase_handle = SpiNor_enStartEraseHandle;
+    psHandles->poll_handle = SpiNor_enPollHandle;
+}
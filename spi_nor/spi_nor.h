@@ -0,0 +1,169 @@
+/******************************************************************************
+ * @file       spi_nor.h
+ * @version    1.0
+ * @date       Oct 16, 2026
+ * @copyright
+ * @addtogroup spi_nor_gp SPI NOR Flash
+ * @brief      JEDEC SPI NOR flash driver (external memory), page programs split
+ *             at 256 B page boundaries, 4 KB sector & 64 KB block erases. The
+ *             SPI bus is reached through select, transmit & receive handles
+ *             (ex: HAL_SPI_Transmit & a chip select GPIO), so the driver
+ *             doesn't depend on a SPI peripheral, and runs on a host with a
+ *             bus stand-in
+ *****************************************************************************/
+#ifndef __SPI_NOR_H__
+#define __SPI_NOR_H__
+
+#include <stdint.h>
+#include <spi_nor_config.h>
+#include <fluffer.h>
+
+/**
+ * @brief JEDEC SPI NOR commands
+ **/
+#define SPI_NOR_CMD_WRITE_ENABLE		0x06
+#define SPI_NOR_CMD_READ_STATUS			0x05
+#define SPI_NOR_CMD_READ_JEDEC_ID		0x9F
+#define SPI_NOR_CMD_READ				0x03
+#define SPI_NOR_CMD_PAGE_PROGRAM		0x02
+#define SPI_NOR_CMD_SECTOR_ERASE		0x20
+#define SPI_NOR_CMD_BLOCK_ERASE			0xD8
+#define SPI_NOR_CMD_READ_4B				0x13
+#define SPI_NOR_CMD_PAGE_PROGRAM_4B		0x12
+#define SPI_NOR_CMD_SECTOR_ERASE_4B		0x21
+#define SPI_NOR_CMD_BLOCK_ERASE_4B		0xDC
+
+/**
+ * @brief Status register bits
+ **/
+#define SPI_NOR_STATUS_BUSY				0x01		/**<  write in progress  */
+#define SPI_NOR_STATUS_WEL				0x02		/**<  write enable latch  */
+
+/**
+ *
+ **/
+typedef enum spi_nor_error_t {
+    SPI_NOR_ERROR_NONE,					/**<  No error  */
+    SPI_NOR_ERROR_ZERO_LEN,             /**<  Unexpected zero length buffer  */
+    SPI_NOR_ERROR_NULLPTR,              /**<  Unexpected null pointer was given as a parameter  */
+    SPI_NOR_ERROR_BUS,                  /**<  SPI bus transfer failed, or no bus was given  */
+    SPI_NOR_ERROR_TIMEOUT,              /**<  Program/erase didn't finish in SPI_NOR_BUSY_TIMEOUT status reads  */
+    SPI_NOR_ERROR_WRITE_DISABLED,       /**<  Write enable latch wasn't set by a write enable (write protected memory)  */
+    SPI_NOR_ERROR_MEM_BOUNDARY,         /**<  Read/Write/Erase will overflow outside of the allocated region  */
+    SPI_NOR_ERROR_NOT_FOUND,            /**<  No memory answered the JEDEC ID read  */
+}SpiNor_Error_t;
+
+/**
+ * @brief Chip select handle, selects (1: CS low) or deselects (0: CS high) the memory
+ **/
+typedef SpiNor_Error_t (*SpiNor_Select_Handle_t)(uint8_t);
+
+/**
+ * @brief Transmit handle, clocks bytes out to the selected memory
+ **/
+typedef SpiNor_Error_t (*SpiNor_Transmit_Handle_t)(const uint8_t *, uint16_t);
+
+/**
+ * @brief Receive handle, clocks bytes in from the selected memory
+ **/
+typedef SpiNor_Error_t (*SpiNor_Receive_Handle_t)(uint8_t *, uint16_t);
+
+/**
+ * @brief SPI bus handles
+ **/
+typedef struct spi_nor_bus_t {
+    SpiNor_Select_Handle_t   select_handle;		/**<  chip select handle  */
+    SpiNor_Transmit_Handle_t transmit_handle;   /**<  transmit handle  */
+    SpiNor_Receive_Handle_t  receive_handle;    /**<  receive handle  */
+}SpiNor_Bus_t;
+
+
+/**
+ * @brief Set the SPI bus & check a memory answers its JEDEC ID read
+ * @param psBus      SPI bus handles, kept by the driver (must stay valid)
+ * @param pu32Id     pointer to a uint32_t variable, to store the JEDEC ID in it (manufacturer, type, capacity),
+ *                   may be NULL
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_NOT_FOUND : if the ID reads as all 0s or all 1s (no memory on the bus)
+ **/
+SpiNor_Error_t SpiNor_enInitialize(const SpiNor_Bus_t * const psBus, uint32_t * const pu32Id);
+
+/**
+ * @brief Read data bytes from the allocated region, into a given buffer, by a single read command
+ * @param u32Offset  Offset to start reading from
+ * @param pu8Buffer  Buffer to store read data into
+ * @param u16Len     Number of bytes to read
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enRead(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief Program data bytes into the allocated region, from a given buffer. Will not erase before the write.
+ *        The write is split at page boundaries, a page program (write enable, program, wait) per page
+ * @param u32Offset  Offset to start writing to
+ * @param pu8Buffer  Buffer to write data from
+ * @param u16Len     Number of bytes to write
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enWrite(uint32_t u32Offset, const uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief Erase a 4 KB sector of the allocated region
+ * @param u32Sector  sector index
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enEraseSector(uint32_t u32Sector);
+
+/**
+ * @brief Erase a 64 KB block of the allocated region, the region must be 64 KB aligned
+ * @param u32Block   block index (SPI_NOR_BLOCK_SECTORS sectors each)
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_MEM_BOUNDARY : if the block isn't in the region, or the region isn't 64 KB aligned
+ **/
+SpiNor_Error_t SpiNor_enEraseBlock(uint32_t u32Block);
+
+/**
+ * @brief Erase a sector of the allocated region for the region's user. With SPI_NOR_BLOCK_ERASE, the sector's
+ *        whole 64 KB block is erased (the user erases all of its sectors anyway), and following erases of
+ *        its sectors do nothing until one of them is programmed
+ * @param u32Sector  sector index
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enErase(uint32_t u32Sector);
+
+/**
+ * @brief Start erasing a sector of the allocated region for the region's user (see SpiNor_enErase), and return
+ *        once the erase command is sent. The next read, write or erase waits for it, SpiNor_enIsBusy tells
+ *        if it's done without waiting
+ * @param u32Sector  sector index
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enStartErase(uint32_t u32Sector);
+
+/**
+ * @brief Check if an erase started by SpiNor_enStartErase is still in progress, by a single status read (no bus
+ *        traffic if no erase was started)
+ * @param pu8Busy    pointer to a uint8_t variable, to store 1 in it if the erase is in progress, 0 otherwise
+ * @return SpiNor_Error_t
+ **/
+SpiNor_Error_t SpiNor_enIsBusy(uint8_t * const pu8Busy);
+
+/**
+ * @brief Set fluffer handles to the driver's read, write & erase (a fluffer page is a 4 KB sector, start_page
+ *        is relative to SPI_NOR_START_SECTOR), map, load, save & session handles are cleared
+ * @param psHandles  pointer to fluffer instance's handles
+ * @return void
+ **/
+void SpiNor_vidSetHandles(Fluffer_Handles_t * const psHandles);
+
+/**
+ * @brief Set fluffer handles as SpiNor_vidSetHandles does, with an erase handle that only starts the erase
+ *        (SpiNor_enStartErase) and a poll handle (SpiNor_enIsBusy), so fluffer's clean up doesn't wait for erases
+ *        (FLUFFER_ERASE_ASYNC, otherwise the driver waits for a started erase before its next command)
+ * @param psHandles  pointer to fluffer instance's handles
+ * @return void
+ **/
+void SpiNor_vidSetAsyncHandles(Fluffer_Handles_t * const psHandles);
+
+
+#endif /* __SPI_NOR_H__ */
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * @file      spi_nor_config.h
+ * @brief     JEDEC SPI NOR flash geometry, allocated region & driver options
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __SPI_NOR_CONFIG_H__
+#define __SPI_NOR_CONFIG_H__
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief JEDEC SPI NOR geometry (W25Q, MX25L, IS25LP, ... classes)
+ * */
+#define SPI_NOR_PAGE_SIZE				256UL		/**<  program page, a page program wraps around at its end  */
+#define SPI_NOR_SECTOR_SIZE				4096UL		/**<  smallest erase unit (sector erase, 0x20)  */
+#define SPI_NOR_BLOCK_SIZE				65536UL		/**<  large erase unit (block erase, 0xD8)  */
+#define SPI_NOR_BLOCK_SECTORS			(SPI_NOR_BLOCK_SIZE / SPI_NOR_SECTOR_SIZE)
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Allocated region, offsets & sector indices given to the driver are relative to its 1st sector
+ * */
+#ifndef SPI_NOR_START_SECTOR
+#define SPI_NOR_START_SECTOR			0UL
+#endif	/*	SPI_NOR_START_SECTOR	*/
+
+#ifndef SPI_NOR_ALLOCATED_SECTORS
+#define SPI_NOR_ALLOCATED_SECTORS		256UL		/**<  1 MB  */
+#endif	/*	SPI_NOR_ALLOCATED_SECTORS	*/
+
+#define SPI_NOR_OFFSET_START			0UL
+#define SPI_NOR_OFFSET_END				((SPI_NOR_ALLOCATED_SECTORS * SPI_NOR_SECTOR_SIZE) - 1)
+
+/**
+ * @brief Address bytes sent with read, program & erase commands: 3 (up to 16 MB), or 4 (4 byte address
+ *        commands 0x13, 0x12, 0x21 & 0xDC, for larger memories)
+ * */
+#ifndef SPI_NOR_ADDRESS_BYTES
+#define SPI_NOR_ADDRESS_BYTES			3
+#endif	/*	SPI_NOR_ADDRESS_BYTES	*/
+
+/**
+ * @brief Sectors always erased together by the region's user (ex: a fluffer block, pages_pre_block with a 4 KB
+ *        page size). If it's a multiple of SPI_NOR_BLOCK_SECTORS & the region is 64 KB aligned, SpiNor_enErase
+ *        erases a sector's whole 64 KB block at once (~150 ms instead of 16 sector erases of ~45 ms)
+ * */
+#ifndef SPI_NOR_ERASE_UNIT_SECTORS
+#define SPI_NOR_ERASE_UNIT_SECTORS		1UL
+#endif	/*	SPI_NOR_ERASE_UNIT_SECTORS	*/
+
+/**
+ * @brief Status register reads before a program or erase times out, a 64 KB block erase takes up to
+ *        2 s, a status read takes 8 clocks (~5M reads at 20 MHz)
+ * */
+#ifndef SPI_NOR_BUSY_TIMEOUT
+#define SPI_NOR_BUSY_TIMEOUT			10000000UL
+#endif	/*	SPI_NOR_BUSY_TIMEOUT	*/
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief 64 KB block erases are used by SpiNor_enErase (1), or sector erases only (0)
+ * */
+#if ((SPI_NOR_ERASE_UNIT_SECTORS % SPI_NOR_BLOCK_SECTORS) == 0) && ((SPI_NOR_START_SECTOR % SPI_NOR_BLOCK_SECTORS) == 0)
+#define SPI_NOR_BLOCK_ERASE				1
+#else
+#define SPI_NOR_BLOCK_ERASE				0
+#endif	/*	SPI_NOR_ERASE_UNIT_SECTORS	*/
+
+#if (SPI_NOR_ADDRESS_BYTES != 3) && (SPI_NOR_ADDRESS_BYTES != 4)
+#error "SPI_NOR_ADDRESS_BYTES must be 3 or 4"
+#endif	/*	SPI_NOR_ADDRESS_BYTES	*/
+
+#if (SPI_NOR_ADDRESS_BYTES == 3) && (((SPI_NOR_START_SECTOR + SPI_NOR_ALLOCATED_SECTORS) * SPI_NOR_SECTOR_SIZE) > (1UL << 24))
+#error "Regions beyond 16 MB need SPI_NOR_ADDRESS_BYTES of 4"
+#endif	/*	SPI_NOR_ADDRESS_BYTES	*/
+
+#if (SPI_NOR_ALLOCATED_SECTORS == 0) || (SPI_NOR_ERASE_UNIT_SECTORS == 0)
+#error "SPI_NOR_ALLOCATED_SECTORS & SPI_NOR_ERASE_UNIT_SECTORS must be at least 1"
+#endif	/*	SPI_NOR_ALLOCATED_SECTORS	*/
+
+/* ------------------------------------------------------------------------- */
+
+#endif /* __SPI_NOR_CONFIG_H__ */
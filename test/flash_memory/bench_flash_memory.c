@@ -0,0 +1,166 @@
+/******************************************************************************
+ * @file      bench_flash_memory.c
+ * @brief     Micro-benchmark of FlashMemory_enWrite, DWT cycles per byte
+ *            for aligned & unaligned buffers, and unlocks & cycles saved by
+ *            a programming session. Built with FLASH_MEMORY_PROFILE = 1, on
+ *            target, or on the host with the FPEC mock (cycles are modeled)
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_memory.h>
+#include <test_flash_memory.h>
+
+
+#define BENCH_MAX_LEN				512
+#define BENCH_SESSION_WRITES		16
+#define BENCH_SESSION_LEN			32
+
+
+#if FLASH_MEMORY_PROFILE == 1
+static const uint16_t BENCH_LENGTHS[] = {2, 8, 32, 128, 512};
+
+static void fill_buffer(uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Seed)
+{
+    uint16_t Local_u16Index;
+
+    for(Local_u16Index = 0; Local_u16Index < u16Len; Local_u16Index++)
+    {
+        pu8Buffer[Local_u16Index] = (uint8_t)((Local_u16Index * 7) + u8Seed);
+    }
+}
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+
+static void bench_flash_memory_cycles(void);
+static void bench_flash_memory_session(void);
+
+/**
+ * Micro-benchmark, for each length, at offset 0 (aligned) & 1 (unaligned):
+ * 01. erase block 0, reset profile
+ * 02. write the buffer, check it's read back
+ * 03. report cycles, cycles per byte (x100)
+ * */
+static void bench_flash_memory_cycles(void)
+{
+#if FLASH_MEMORY_PROFILE == 1
+    uint8_t Local_au8Data[BENCH_MAX_LEN];
+    uint8_t Local_au8Read[BENCH_MAX_LEN];
+    const FlashMemory_Profile_t * Local_psProfile = FlashMemory_psGetProfile();
+    uint8_t Local_u8Index;
+    uint8_t Local_u8Offset;
+    uint16_t Local_u16Len;
+
+    printf("\nfast program: %u\n", (unsigned int)FLASH_MEMORY_FAST_PROGRAM);
+    printf("%8s %8s %12s %14s\n", "offset", "bytes", "cycles", "cycles/byte");
+
+    for(Local_u8Index = 0; Local_u8Index < (sizeof(BENCH_LENGTHS) / sizeof(BENCH_LENGTHS[0])); Local_u8Index++)
+    {
+        Local_u16Len = BENCH_LENGTHS[Local_u8Index];
+
+        for(Local_u8Offset = 0; Local_u8Offset < 2; Local_u8Offset++)
+        {
+            /*	01. erase	*/
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enErase(0));
+            FlashMemory_vidResetProfile();
+
+            /*	02. write & check	*/
+            fill_buffer(Local_au8Data, Local_u16Len, Local_u8Index);
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enWrite(Local_u8Offset, Local_au8Data, Local_u16Len));
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enRead(Local_u8Offset, Local_au8Read, Local_u16Len));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Data, Local_au8Read, Local_u16Len);
+            TEST_ASSERT_EQUAL_UINT32(1, Local_psProfile->write.calls);
+
+            /*	03. report	*/
+            printf("%8u %8u %12lu %11lu.%02lu\n", (unsigned int)Local_u8Offset, (unsigned int)Local_u16Len,
+                (unsigned long)Local_psProfile->write.cycles,
+                (unsigned long)(Local_psProfile->write.cycles / Local_u16Len),
+                (unsigned long)(((Local_psProfile->write.cycles * 100) / Local_u16Len) % 100));
+        }
+    }
+#else
+    TEST_IGNORE_MESSAGE("FLASH_MEMORY_PROFILE only");
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+}
+
+/**
+ * Session scenario, without & with a programming session:
+ * 01. erase block 0, reset profile
+ * 02. write BENCH_SESSION_WRITES buffers of BENCH_SESSION_LEN bytes back to back
+ * 03. report unlocks & cycles, check a session unlocks once
+ * */
+static void bench_flash_memory_session(void)
+{
+#if FLASH_MEMORY_PROFILE == 1
+    uint8_t Local_au8Data[BENCH_SESSION_LEN];
+    const FlashMemory_Profile_t * Local_psProfile = FlashMemory_psGetProfile();
+    uint8_t Local_u8Session;
+    uint8_t Local_u8Write;
+
+    printf("\n%8s %8s %12s\n", "session", "unlocks", "cycles");
+
+    for(Local_u8Session = 0; Local_u8Session < 2; Local_u8Session++)
+    {
+        /*	01. erase	*/
+        TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enErase(0));
+        FlashMemory_vidResetProfile();
+
+        /*	02. write	*/
+        if(Local_u8Session)
+        {
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enBeginSession());
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        for(Local_u8Write = 0; Local_u8Write < BENCH_SESSION_WRITES; Local_u8Write++)
+        {
+            fill_buffer(Local_au8Data, sizeof(Local_au8Data), Local_u8Write);
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enWrite((uint32_t)Local_u8Write * BENCH_SESSION_LEN, Local_au8Data, sizeof(Local_au8Data)));
+        }
+
+        if(Local_u8Session)
+        {
+            TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_NONE, FlashMemory_enEndSession());
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        /*	03. report	*/
+        printf("%8u %8lu %12lu\n", (unsigned int)Local_u8Session, (unsigned long)Local_psProfile->unlocks,
+            (unsigned long)Local_psProfile->write.cycles);
+        TEST_ASSERT_EQUAL_UINT32((Local_u8Session) ? 1 : BENCH_SESSION_WRITES, Local_psProfile->unlocks);
+    }
+
+    TEST_ASSERT_EQUAL(FLASH_MEMORY_ERROR_SESSION, FlashMemory_enEndSession());
+#else
+    TEST_IGNORE_MESSAGE("FLASH_MEMORY_PROFILE only");
+#endif	/*	FLASH_MEMORY_PROFILE	*/
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_flash_memory(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_flash_memory_cycles);
+    RUN_TEST(bench_flash_memory_session);
+    UNITY_END();
+}
@@ -9,5 +9,6 @@
 #define __FLASH_TEST_FLASH_H__
 
 void test_flash_memory(void);
+void bench_flash_memory(void);
 
 #endif /* __FLASH_TEST_FLASH_H__ */
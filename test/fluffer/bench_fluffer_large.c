@@ -0,0 +1,261 @@
+/******************************************************************************
+ * @file      bench_fluffer_large.c
+ * @brief     Host benchmark, runs a fluffer instance on multi-megabyte
+ *            external NOR flash (flash memory simulator, SPI NOR timing).
+ *            Checks head & tail are recovered by a cold mount past 65535
+ *            entries, then reports entries per block, capacity & cold mount
+ *            time (simulated) and read handle calls of an empty, half full
+ *            & full fluffer, for 1, 4 & 16 MB memories. Memories the build
+ *            can't address are reported as skipped: build with
+ *            FLUFFER_ADDRESSING_32 & FLASH_SIM_MAX_SIZE of 16 MB.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fluffer.h>
+
+
+#define BENCH_BLOCKS				4
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_WORD_SIZE				1
+#define BENCH_BATCH					256			/*	entries per Fluffer_enWriteEntries call	*/
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+#define BENCH_MODE_NAME				"ring"
+#else
+#define BENCH_MODE_NAME				"copy"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_ADDRESSING == FLUFFER_ADDRESSING_32
+#define BENCH_ADDRESSING_NAME		"32"
+#else
+#define BENCH_ADDRESSING_NAME		"16"
+#endif	/*	FLUFFER_ADDRESSING	*/
+
+/*	simulated memory sizes (MB)	*/
+static const uint8_t BenchMemorySizes[] = {1, 4, 16};
+
+static uint8_t BenchBatch[BENCH_BATCH * BENCH_ELEMENT_SIZE];
+
+/*	simulated memory is a SPI NOR flash of u8Megabytes MB, split in BENCH_BLOCKS blocks,
+ *	returns 0 if the simulator or the build can't hold it	*/
+static uint8_t init_instance(Fluffer_t * psFluffer, uint8_t u8Megabytes)
+{
+    FlashSim_Config_t Local_sMemory = FlashSim_sPresetSpiNor;
+    uint32_t Local_u32Pages = ((uint32_t)u8Megabytes << 20) / Local_sMemory.page_size;
+
+    if((Local_u32Pages > FLASH_SIM_MAX_PAGES) || ((Local_u32Pages * Local_sMemory.page_size) > FLASH_SIM_MAX_SIZE))
+    {
+        return 0;
+    }
+
+    Local_sMemory.pages = (uint16_t)Local_u32Pages;
+    TEST_ASSERT_TRUE_MESSAGE(FlashSim_u8Init(&Local_sMemory), "Memory config error\n");
+
+    memset(psFluffer, 0x00, sizeof(Fluffer_t));
+    psFluffer->cfg.page_size = Local_sMemory.page_size;
+    psFluffer->cfg.blocks = BENCH_BLOCKS;
+    psFluffer->cfg.start_page = 0;
+    psFluffer->cfg.word_size = BENCH_WORD_SIZE;
+    psFluffer->cfg.element_size = BENCH_ELEMENT_SIZE;
+    FlashSim_vidSetHandles(&psFluffer->handles);
+
+    /*	pages per block don't fit the build's page index (FLUFFER_ADDRESSING_16)	*/
+    if((Fluffer_Page_t)(Local_u32Pages / BENCH_BLOCKS) != (Local_u32Pages / BENCH_BLOCKS))
+    {
+        return 0;
+    }
+
+    psFluffer->cfg.pages_pre_block = (Fluffer_Page_t)(Local_u32Pages / BENCH_BLOCKS);
+
+    /*	entries don't fit the build's entry index (FLUFFER_ADDRESSING_16)	*/
+    return Fluffer_enInitialize(psFluffer) == FLUFFER_ERROR_NONE;
+}
+
+/*	entries that can be written without dropping any	*/
+static uint32_t get_capacity(const Fluffer_t * psFluffer)
+{
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    /*	a block is kept free to be erased ahead	*/
+    return ((uint32_t)(psFluffer->cfg.blocks - 1) * psFluffer->context.size) - 1;
+#else
+    /*	main buffer is cleaned up once it's full	*/
+    return (uint32_t)psFluffer->context.size - 1;
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+}
+
+/*	write u32Count entries, each holds its sequence number	*/
+static void write_entries(Fluffer_t * psFluffer, uint32_t u32Count)
+{
+    uint32_t Local_u32Sequence = 0;
+    uint16_t Local_u16Batch;
+    uint16_t Local_u16Index;
+    uint16_t Local_u16Written;
+
+    while(Local_u32Sequence < u32Count)
+    {
+        Local_u16Batch = (uint16_t)MIN(u32Count - Local_u32Sequence, BENCH_BATCH);
+
+        for(Local_u16Index = 0; Local_u16Index < Local_u16Batch; Local_u16Index++)
+        {
+            memset(&BenchBatch[Local_u16Index * BENCH_ELEMENT_SIZE], 0x5A, BENCH_ELEMENT_SIZE);
+            memcpy(&BenchBatch[Local_u16Index * BENCH_ELEMENT_SIZE], &Local_u32Sequence, sizeof(Local_u32Sequence));
+            Local_u32Sequence++;
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntries(psFluffer, BenchBatch, Local_u16Batch, &Local_u16Written), "WriteEntries error\n");
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_u16Batch, Local_u16Written, "WriteEntries Failed @count\n");
+    }
+}
+
+/*	mark u32Count entries	*/
+static void mark_entries(Fluffer_t * psFluffer, uint32_t u32Count)
+{
+    uint16_t Local_u16Batch;
+
+    while(u32Count > 0)
+    {
+        Local_u16Batch = (uint16_t)MIN(u32Count, UINT16_MAX);
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(psFluffer, Local_u16Batch), "MarkEntries error\n");
+        u32Count -= Local_u16Batch;
+    }
+}
+
+/*	drop the context & mount again from the memory (no warm context)	*/
+static void remount(Fluffer_t * psFluffer)
+{
+    memset(&psFluffer->context, 0x00, sizeof(psFluffer->context));
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enInitialize(psFluffer), "Initialize error\n");
+}
+
+static void bench_fluffer_large_recovery(void);
+static void bench_fluffer_large_mount(void);
+
+/**
+ * For each memory size the build can address:
+ * 01. fill fluffer to its capacity, mark half of the entries
+ * 02. mount again, check unmarked entries count & that the oldest unmarked entry is the 1st one that wasn't marked
+ * 03. read the rest of the entries in order
+ * */
+static void bench_fluffer_large_recovery(void)
+{
+    Fluffer_t Local_sFluffer;
+    Fluffer_Reader_t Local_sReader;
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    uint32_t Local_u32Capacity;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected;
+    uint8_t Local_u8Size;
+
+    printf("\nLarge memory recovery, %s buffer, %s bit addressing\n", BENCH_MODE_NAME, BENCH_ADDRESSING_NAME);
+    printf("%-8s %-18s %-12s %-12s\n", "memory", "entries per block", "capacity", "recovered");
+
+    for(Local_u8Size = 0; Local_u8Size < sizeof(BenchMemorySizes); Local_u8Size++)
+    {
+        if(!init_instance(&Local_sFluffer, BenchMemorySizes[Local_u8Size]))
+        {
+            printf("%2u MB    skipped\n", (unsigned int)BenchMemorySizes[Local_u8Size]);
+            continue;
+        }
+
+        /*	01. fill & mark half	*/
+        Local_u32Capacity = get_capacity(&Local_sFluffer);
+        write_entries(&Local_sFluffer, Local_u32Capacity);
+        mark_entries(&Local_sFluffer, Local_u32Capacity / 2);
+
+        /*	02. mount	*/
+        remount(&Local_sFluffer);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Capacity - (Local_u32Capacity / 2),
+                                         (uint32_t)(Local_sFluffer.context.tail - Local_sFluffer.context.head),
+                                         "Initialize Failed @bounds\n");
+
+        /*	03. read in order	*/
+        Fluffer_enInitReader(&Local_sFluffer, &Local_sReader);
+        for(Local_u32Expected = Local_u32Capacity / 2; Local_u32Expected < Local_u32Capacity; Local_u32Expected++)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry), "ReadEntry error\n");
+            memcpy(&Local_u32Sequence, Local_au8Entry, sizeof(Local_u32Sequence));
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Expected, Local_u32Sequence, "ReadEntry Failed @order\n");
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_EMPTY, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry), "ReadEntry Failed @end\n");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "Illegal program\n");
+
+        printf("%2u MB    %-18lu %-12lu %-12s\n", (unsigned int)BenchMemorySizes[Local_u8Size],
+               (unsigned long)Local_sFluffer.context.size, (unsigned long)Local_u32Capacity, "ok");
+    }
+}
+
+/**
+ * For each memory size the build can address & each fill level (empty, half full, full):
+ * 01. fill fluffer, no entry is marked
+ * 02. mount again (cold mount), report simulated time & read handle calls
+ * */
+static void bench_fluffer_large_mount(void)
+{
+    static const uint8_t Local_au8Fill[] = {0, 50, 100};
+    Fluffer_t Local_sFluffer;
+    const FlashSim_Stats_t * Local_psStats;
+    uint32_t Local_u32Entries;
+    uint8_t Local_u8Size;
+    uint8_t Local_u8Fill;
+
+    printf("\nLarge memory cold mount, %s buffer, %s bit addressing, %s recovery\n", BENCH_MODE_NAME, BENCH_ADDRESSING_NAME,
+           (FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT) ? "bisect" : "linear");
+    printf("%-8s %-6s %-12s %-14s %-12s\n", "memory", "fill", "entries", "mount (ms)", "read calls");
+
+    for(Local_u8Size = 0; Local_u8Size < sizeof(BenchMemorySizes); Local_u8Size++)
+    {
+        for(Local_u8Fill = 0; Local_u8Fill < sizeof(Local_au8Fill); Local_u8Fill++)
+        {
+            if(!init_instance(&Local_sFluffer, BenchMemorySizes[Local_u8Size]))
+            {
+                printf("%2u MB    skipped\n", (unsigned int)BenchMemorySizes[Local_u8Size]);
+                break;
+            }
+
+            /*	01. fill	*/
+            Local_u32Entries = (get_capacity(&Local_sFluffer) * Local_au8Fill[Local_u8Fill]) / 100;
+            write_entries(&Local_sFluffer, Local_u32Entries);
+
+            /*	02. mount	*/
+            FlashSim_vidResetStats();
+            remount(&Local_sFluffer);
+            Local_psStats = FlashSim_psGetStats();
+
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Entries, (uint32_t)(Local_sFluffer.context.tail - Local_sFluffer.context.head),
+                                             "Initialize Failed @bounds\n");
+
+            printf("%2u MB    %3u%%   %-12lu %-14.3f %-12lu\n", (unsigned int)BenchMemorySizes[Local_u8Size],
+                   (unsigned int)Local_au8Fill[Local_u8Fill], (unsigned long)Local_u32Entries,
+                   Local_psStats->time_ns / 1e6, (unsigned long)Local_psStats->read_calls);
+        }
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_large(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_large_recovery);
+    RUN_TEST(bench_fluffer_large_mount);
+    UNITY_END();
+}
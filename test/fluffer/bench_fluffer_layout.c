@@ -0,0 +1,235 @@
+/******************************************************************************
+ * @file      bench_fluffer_layout.c
+ * @brief     Host benchmark, reports capacity & scan cost of the block layout
+ *            selected by FLUFFER_LAYOUT (& FLUFFER_BITMAP_MARK). Build once
+ *            per layout to compare interleaved marks to the marks bitmap:
+ *            entries per block, head search (mount) read calls & bytes,
+ *            drain read calls and ack write calls. Runs on the host flash
+ *            memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_MAX_PAGES_PER_BLOCK	64
+#define MEMORY_BLOCKS				2
+#define MEMORY_PAGES				(MEMORY_MAX_PAGES_PER_BLOCK * MEMORY_BLOCKS)
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_DRAIN_SIZE			64
+#define BENCH_ACK_SIZE				50
+#define BENCH_RECOVERY_SIZE			(2 * 1024)		/*	both blocks of the recovery scenario	*/
+
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+#if FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT
+#define BENCH_LAYOUT_NAME			"bitmap (bit marks)"
+#else
+#define BENCH_LAYOUT_NAME			"bitmap (word marks)"
+#endif	/*	FLUFFER_BITMAP_MARK	*/
+#else
+#define BENCH_LAYOUT_NAME			"interleaved"
+#endif	/*	FLUFFER_LAYOUT	*/
+
+
+/*
+ * STM32F1 flash, not memory mapped so scans call the read handle. Bit marks program
+ * a word more than once, so any bit can be cleared with FLUFFER_MARK_BIT
+ * */
+static void setup_layout(uint8_t u8PagesPerBlock, uint16_t u16ElementSize)
+{
+    FlashSim_Config_t Local_sMemory = FlashSim_sPresetStm32f1;
+
+    Local_sMemory.pages = MEMORY_PAGES;
+    Local_sMemory.mapped = 0;
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+    Local_sMemory.rule = FLASH_SIM_RULE_CLEAR_BITS;
+#endif	/*	FLUFFER_LAYOUT	*/
+    setup_fluffer(&Local_sMemory, MEMORY_BLOCKS, u8PagesPerBlock, u16ElementSize);
+}
+
+static void bench_fluffer_layout_recovery(void);
+static void bench_fluffer_layout_capacity(void);
+static void bench_fluffer_layout_scan(void);
+
+/**
+ * Recovery scenario (1 KB blocks), for each number of marked entries (0 .. written entries):
+ * 01. initialize instance, write 3/4 of the main buffer, mark entries one by one, or all at once
+ * 02. check memory written by single marks == memory written by a batch mark
+ * 03. initialize a new instance, check head & tail are found
+ * 04. read entries after head, check they're the expected entries
+ * */
+static void bench_fluffer_layout_recovery(void)
+{
+    static uint8_t Local_au8Expected[BENCH_RECOVERY_SIZE];
+    static uint8_t Local_au8Memory[BENCH_RECOVERY_SIZE];
+    uint8_t Local_au8Buffer[BENCH_DRAIN_SIZE * BENCH_ELEMENT_SIZE];
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    Fluffer_t Local_sNewFluffer;
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Written;
+    uint16_t Local_u16Marks;
+    uint16_t Local_u16Index;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Read;
+
+    setup_layout(1, BENCH_ELEMENT_SIZE);
+    Local_u16Written = (FLUFFER.context.size * 3) / 4;
+
+    for(Local_u16Marks = 0; Local_u16Marks <= Local_u16Written; Local_u16Marks++)
+    {
+        /*	01. mark one by one	*/
+        setup_layout(1, BENCH_ELEMENT_SIZE);
+        write_entries(0, Local_u16Written);
+        for(Local_u16Index = 0; Local_u16Index < Local_u16Marks; Local_u16Index++)
+        {
+            Fluffer_enMarkEntry(&FLUFFER);
+        }
+        FlashSim_enRead(0, Local_au8Expected, sizeof(Local_au8Expected));
+
+        /*	01. mark all at once	*/
+        setup_layout(1, BENCH_ELEMENT_SIZE);
+        write_entries(0, Local_u16Written);
+        if(Local_u16Marks > 0)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, Local_u16Marks), "MarkEntries error\n");
+        }
+
+        /*	02. compare marks	*/
+        FlashSim_enRead(0, Local_au8Memory, sizeof(Local_au8Memory));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Expected, Local_au8Memory, sizeof(Local_au8Expected), "MarkEntries Failed @memory\n");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "MarkEntries Failed @violations\n");
+
+        /*	03. recover head & tail	*/
+        mount_copy(&Local_sNewFluffer);
+
+        /*	04. read remaining entries	*/
+        Fluffer_enInitReader(&Local_sNewFluffer, &Local_sReader);
+        Local_u16Read = Local_u16Marks;
+        while(Fluffer_enReadEntries(&Local_sNewFluffer, &Local_sReader, Local_au8Buffer, BENCH_DRAIN_SIZE, &Local_u16Count) == FLUFFER_ERROR_NONE)
+        {
+            for(Local_u16Index = 0; Local_u16Index < Local_u16Count; Local_u16Index++, Local_u16Read++)
+            {
+                make_entry(Local_au8Entry, Local_u16Read);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Entry, &Local_au8Buffer[Local_u16Index * BENCH_ELEMENT_SIZE], BENCH_ELEMENT_SIZE, "ReadEntries Failed @entry\n");
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_u16Written, Local_u16Read, "ReadEntries Failed @count\n");
+    }
+}
+
+/**
+ * Capacity scenario, for element sizes 4, 16, 64 & block sizes 1, 4, 64 KB:
+ * 01. initialize instance
+ * 02. report entries per block & overhead bytes per entry (block size / entries - element size)
+ * */
+static void bench_fluffer_layout_capacity(void)
+{
+    const uint16_t Local_au16ElementSizes[] = {4, 16, 64};
+    const uint8_t Local_au8PagesPerBlock[] = {1, 4, 64};
+    uint8_t Local_u8Element;
+    uint8_t Local_u8Block;
+
+    printf("\nlayout: %s, word size: %u\n", BENCH_LAYOUT_NAME, FlashSim_sPresetStm32f1.program_unit);
+    printf("%8s %10s %10s %14s\n", "element", "block", "entries", "overhead/entry");
+
+    for(Local_u8Element = 0; Local_u8Element < (sizeof(Local_au16ElementSizes) / sizeof(Local_au16ElementSizes[0])); Local_u8Element++)
+    {
+        for(Local_u8Block = 0; Local_u8Block < sizeof(Local_au8PagesPerBlock); Local_u8Block++)
+        {
+            /*	01. initialize instance	*/
+            setup_layout(Local_au8PagesPerBlock[Local_u8Block], Local_au16ElementSizes[Local_u8Element]);
+
+            /*	02. report	*/
+            printf("%8u %10lu %10u %14.3f\n",
+                (unsigned int)Local_au16ElementSizes[Local_u8Element],
+                (unsigned long)Local_au8PagesPerBlock[Local_u8Block] * FlashSim_sPresetStm32f1.page_size,
+                (unsigned int)FLUFFER.context.size,
+                ((double)Local_au8PagesPerBlock[Local_u8Block] * FlashSim_sPresetStm32f1.page_size / FLUFFER.context.size) - Local_au16ElementSizes[Local_u8Element]);
+        }
+    }
+}
+
+/**
+ * Scan scenario, for block sizes 1, 2, 4, ... 64 KB:
+ * 01. initialize instance, fill main buffer except for the last entry, mark half of the entries
+ * 02. initialize a new instance, report read handle calls & bytes read (head & tail search)
+ * 03. drain all unmarked entries using Fluffer_enReadEntries (BENCH_DRAIN_SIZE entries per call), report read handle calls
+ * 04. ack BENCH_ACK_SIZE entries (or all unmarked entries if less) using Fluffer_enMarkEntries, report write handle calls
+ * */
+static void bench_fluffer_layout_scan(void)
+{
+    uint8_t Local_au8Buffer[BENCH_DRAIN_SIZE * BENCH_ELEMENT_SIZE];
+    Fluffer_t Local_sNewFluffer;
+    Fluffer_Reader_t Local_sReader;
+    uint8_t Local_u8PagesPerBlock;
+    uint16_t Local_u16Count;
+    uint32_t Local_u32MountCalls;
+    uint32_t Local_u32MountBytes;
+    uint32_t Local_u32DrainCalls;
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+
+    printf("\nlayout: %s, element size: %u, word size: %u, recovery mode: %u\n", BENCH_LAYOUT_NAME, BENCH_ELEMENT_SIZE, FlashSim_sPresetStm32f1.program_unit, FLUFFER_RECOVERY_MODE);
+    printf("%10s %10s %12s %12s %12s %12s\n", "block", "entries", "mount calls", "mount bytes", "drain calls", "ack writes");
+
+    for(Local_u8PagesPerBlock = 1; Local_u8PagesPerBlock <= MEMORY_MAX_PAGES_PER_BLOCK; Local_u8PagesPerBlock <<= 1)
+    {
+        /*	01. fill & mark half	*/
+        setup_layout(Local_u8PagesPerBlock, BENCH_ELEMENT_SIZE);
+        write_entries(0, FLUFFER.context.size - 1);
+        Fluffer_enMarkEntries(&FLUFFER, FLUFFER.context.tail / 2);
+
+        /*	02. mount	*/
+        FlashSim_vidResetStats();
+        mount_copy(&Local_sNewFluffer);
+        Local_u32MountCalls = Local_psStats->read_calls;
+        Local_u32MountBytes = Local_psStats->read_bytes;
+
+        /*	03. drain	*/
+        Fluffer_enInitReader(&Local_sNewFluffer, &Local_sReader);
+        FlashSim_vidResetStats();
+        while(Fluffer_enReadEntries(&Local_sNewFluffer, &Local_sReader, Local_au8Buffer, BENCH_DRAIN_SIZE, &Local_u16Count) == FLUFFER_ERROR_NONE);
+        Local_u32DrainCalls = Local_psStats->read_calls;
+
+        /*	04. ack	*/
+        FlashSim_vidResetStats();
+        Fluffer_enMarkEntries(&Local_sNewFluffer, MIN(BENCH_ACK_SIZE, Local_sNewFluffer.context.tail - Local_sNewFluffer.context.head));
+
+        printf("%10lu %10u %12lu %12lu %12lu %12lu\n",
+            (unsigned long)Local_u8PagesPerBlock * FlashSim_sPresetStm32f1.page_size,
+            (unsigned int)FLUFFER.context.size,
+            (unsigned long)Local_u32MountCalls,
+            (unsigned long)Local_u32MountBytes,
+            (unsigned long)Local_u32DrainCalls,
+            (unsigned long)Local_psStats->write_calls);
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_layout(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_layout_recovery);
+    RUN_TEST(bench_fluffer_layout_capacity);
+    RUN_TEST(bench_fluffer_layout_scan);
+    UNITY_END();
+}
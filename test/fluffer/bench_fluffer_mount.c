@@ -0,0 +1,377 @@
+/******************************************************************************
+ * @file      bench_fluffer_mount.c
+ * @brief     Host benchmark, counts read handle calls & bytes read by
+ *            Fluffer_enInitialize to recover head & tail, for block sizes
+ *            from 1 KB to 64 KB. Build once per FLUFFER_RECOVERY_MODE to
+ *            compare linear & binary search recovery. Cold mount (search)
+ *            is compared to warm mount (context restored from a RAM stand-in
+ *            for the backup registers, FLUFFER_CONTEXT_WARM only). Runs on
+ *            the host flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_MAX_PAGES_PER_BLOCK	64
+#define MEMORY_BLOCKS				2
+#define MEMORY_PAGES				(MEMORY_MAX_PAGES_PER_BLOCK * MEMORY_BLOCKS)
+#define BENCH_ELEMENT_SIZE			16
+#define BACKUP_MEMORY_SIZE			20
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+#define BENCH_WARM_CALLS			(5 + 1 + MEMORY_BLOCKS)	/*	spot check, main buffer's sequence number & blocks' erase counts	*/
+#else
+#define BENCH_WARM_CALLS			5						/*	spot check	*/
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+
+/*	emulated backup registers	*/
+static uint8_t BACKUP[BACKUP_MEMORY_SIZE];
+
+static Fluffer_Handle_Error_t FlfrLoadHandle(uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    if(u16Len > BACKUP_MEMORY_SIZE)
+    {
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    memcpy(pu8Buffer, BACKUP, u16Len);
+    return FH_ERR_NONE;
+}
+
+static Fluffer_Handle_Error_t FlfrSaveHandle(uint8_t * pu8Data, uint16_t u16Len)
+{
+    if(u16Len > BACKUP_MEMORY_SIZE)
+    {
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    memcpy(BACKUP, pu8Data, u16Len);
+    return FH_ERR_NONE;
+}
+
+/*
+ * STM32F1 flash, not memory mapped so head & tail searches call the read handle. The warm context is
+ * kept in the emulated backup registers if u8Warm is set
+ * */
+static void setup_mount(uint8_t u8PagesPerBlock, uint8_t u8Warm)
+{
+    FlashSim_Config_t Local_sMemory = FlashSim_sPresetStm32f1;
+
+    Local_sMemory.pages = MEMORY_PAGES;
+    Local_sMemory.mapped = 0;
+    TEST_ASSERT_TRUE_MESSAGE(FlashSim_u8Init(&Local_sMemory), "Memory config error\n");
+
+    memset(BACKUP, 0x00, sizeof(BACKUP));
+    config_fluffer(&Local_sMemory, MEMORY_BLOCKS, u8PagesPerBlock, BENCH_ELEMENT_SIZE);
+    if(u8Warm)
+    {
+        FLUFFER.handles.load_handle = FlfrLoadHandle;
+        FLUFFER.handles.save_handle = FlfrSaveHandle;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER), "Init error\n");
+}
+
+static void bench_fluffer_mount_sizes(void);
+static void bench_fluffer_mount_fallback(void);
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+static void bench_fluffer_mount_stale(void);
+static void bench_fluffer_mount_generation(void);
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+/**
+ * Benchmark scenario, for each block size (1, 2, 4, ... 64 KB):
+ * 01. erase memory & initialize fluffer instance
+ * 02. write entries until 3/4 of the main buffer is used
+ * 03. mark half of the written entries
+ * 04. initialize a new instance with the same configurations, counting read handle calls. Saved warm
+ *     context is stale (saved by 1st initialization), so the main buffer is searched (cold mount)
+ * 05. initialize a new instance again, using warm context saved by last initialization (warm mount)
+ * 06. check new instances context == old instance context
+ * */
+static void bench_fluffer_mount_sizes(void)
+{
+    uint8_t Local_au8DataBuffer[BENCH_ELEMENT_SIZE];
+    Fluffer_t Local_sNewFluffer;
+    Fluffer_Error_t Local_enError;
+    uint8_t Local_u8PagesPerBlock;
+    uint16_t Local_u16Entries;
+    uint16_t Local_u16Index;
+    uint32_t Local_u32ColdCalls;
+    uint32_t Local_u32ColdBytes;
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+
+    printf("\nrecovery mode: %s\n", (FLUFFER_RECOVERY_MODE == FLUFFER_RECOVERY_BISECT) ? "bisect" : "linear");
+    printf("%10s %8s %8s %8s %12s %12s %12s %12s\n", "block (B)", "size", "head", "tail",
+        "cold calls", "cold bytes", "warm calls", "warm bytes");
+
+    for(Local_u8PagesPerBlock = 1; Local_u8PagesPerBlock <= MEMORY_MAX_PAGES_PER_BLOCK; Local_u8PagesPerBlock <<= 1)
+    {
+        /*	01. erase memory & initialize instance	*/
+        setup_mount(Local_u8PagesPerBlock, TRUE);
+
+        /*	02. fill 3/4 of the main buffer	*/
+        Local_u16Entries = (FLUFFER.context.size * 3) / 4;
+        for(Local_u16Index = 0; Local_u16Index < Local_u16Entries; Local_u16Index++)
+        {
+            memset(Local_au8DataBuffer, (uint8_t)(Local_u16Index % FLUFFER_CLEAN_BYTE_CONTENT), sizeof(Local_au8DataBuffer));
+            Local_enError = Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer);
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "WriteEntry error\n");
+        }
+
+        /*	03. mark half of the written entries	*/
+        for(Local_u16Index = 0; Local_u16Index < (Local_u16Entries / 2); Local_u16Index++)
+        {
+            Local_enError = Fluffer_enMarkEntry(&FLUFFER);
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "MarkEntry error\n");
+        }
+
+        /*	04. cold mount a new instance, counting reads	*/
+        FlashSim_vidResetStats();
+        mount_copy(&Local_sNewFluffer);
+        Local_u32ColdCalls = Local_psStats->read_calls;
+        Local_u32ColdBytes = Local_psStats->read_bytes;
+
+        /*	05. warm mount a new instance, counting reads	*/
+        FlashSim_vidResetStats();
+        mount_copy(&Local_sNewFluffer);
+
+        printf("%10u %8u %8u %8u %12lu %12lu %12lu %12lu\n",
+            (unsigned int)(FlashSim_sPresetStm32f1.page_size * Local_u8PagesPerBlock),
+            (unsigned int)Local_sNewFluffer.context.size,
+            (unsigned int)Local_sNewFluffer.context.head,
+            (unsigned int)Local_sNewFluffer.context.tail,
+            (unsigned long)Local_u32ColdCalls,
+            (unsigned long)Local_u32ColdBytes,
+            (unsigned long)Local_psStats->read_calls,
+            (unsigned long)Local_psStats->read_bytes);
+    }
+}
+
+/**
+ * Fallback scenario:
+ * 01. erase memory & initialize fluffer instance with the largest block
+ * 02. write entries until half of the main buffer is used, mark none
+ * 03. corrupt the mark of an entry in the middle of the written entries
+ * 04. initialize a new instance, head must be found by the linear scan (1st entry)
+ * */
+static void bench_fluffer_mount_fallback(void)
+{
+    uint8_t Local_au8DataBuffer[BENCH_ELEMENT_SIZE];
+    Fluffer_t Local_sNewFluffer;
+    Fluffer_Error_t Local_enError;
+    uint16_t Local_u16Entries;
+    uint16_t Local_u16Index;
+    uint32_t Local_u32MarkOffset;
+    uint8_t Local_au8Mark[FLASH_SIM_MAX_PROGRAM_UNIT] = {0};
+
+    /*	01. erase memory & initialize instance	*/
+    setup_mount(MEMORY_MAX_PAGES_PER_BLOCK, FALSE);
+
+    /*	02. fill half of the main buffer	*/
+    Local_u16Entries = FLUFFER.context.size / 2;
+    for(Local_u16Index = 0; Local_u16Index < Local_u16Entries; Local_u16Index++)
+    {
+        memset(Local_au8DataBuffer, (uint8_t)(Local_u16Index % FLUFFER_CLEAN_BYTE_CONTENT), sizeof(Local_au8DataBuffer));
+        Local_enError = Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer);
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "WriteEntry error\n");
+    }
+
+    /*	03. mark the entry the 1st bisection step probes, leaving the 1st entry unmarked	*/
+    Local_u32MarkOffset = (FLUFFER.cfg.word_size + ((Local_u16Entries / 2) * (BENCH_ELEMENT_SIZE + FLUFFER.cfg.word_size)));
+    TEST_ASSERT_EQUAL_MESSAGE(FH_ERR_NONE, FlashSim_enWrite(Local_u32MarkOffset, Local_au8Mark, FLUFFER.cfg.word_size), "Mark error\n");
+
+    /*	04. mount a new instance	*/
+    memcpy(&Local_sNewFluffer, &FLUFFER, sizeof(Fluffer_t));
+    memset(&Local_sNewFluffer.context, 0x00, sizeof(Fluffer_Context_t));
+
+    Local_enError = Fluffer_enInitialize(&Local_sNewFluffer);
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "Init error\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, Local_sNewFluffer.context.head, "Fallback Failed @head\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_u16Entries, Local_sNewFluffer.context.tail, "Fallback Failed @tail\n");
+}
+
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+
+/**
+ * Stale warm context scenario:
+ * 01. erase memory & initialize fluffer instance, save warm context
+ * 02. write & mark entries without saving warm context
+ * 03. initialize a new instance, warm context must be rejected
+ * 04. save warm context, then corrupt it
+ * 05. initialize a new instance, warm context must be rejected
+ * 06. save warm context, initialize a new instance, warm context must be used
+ * */
+static void bench_fluffer_mount_stale(void)
+{
+    uint8_t Local_au8DataBuffer[BENCH_ELEMENT_SIZE];
+    Fluffer_t Local_sNewFluffer;
+    Fluffer_Error_t Local_enError;
+    uint32_t Local_u32WarmCalls;
+
+    /*	01. erase memory & initialize instance	*/
+    setup_mount(1, TRUE);
+
+    /*	02. write 2 entries, mark 1	*/
+    memset(Local_au8DataBuffer, 0x01, sizeof(Local_au8DataBuffer));
+    Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer);
+    Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer);
+    Fluffer_enMarkEntry(&FLUFFER);
+
+    /*	03. stale warm context	*/
+    mount_copy(&Local_sNewFluffer);
+
+    /*	04. corrupted warm context	*/
+    Local_enError = Fluffer_enSaveContext(&FLUFFER);
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "SaveContext error\n");
+    Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer);
+    BACKUP[offsetof(Fluffer_Context_t, tail)]++;
+
+    /*	05. initialize, corrupted warm context fails its checksum	*/
+    mount_copy(&Local_sNewFluffer);
+
+    /*	06. warm context, only the spot check is read	*/
+    Local_enError = Fluffer_enSaveContext(&FLUFFER);
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "SaveContext error\n");
+    FlashSim_vidResetStats();
+    mount_copy(&Local_sNewFluffer);
+    Local_u32WarmCalls = FlashSim_psGetStats()->read_calls;
+    TEST_ASSERT_MESSAGE(Local_u32WarmCalls <= BENCH_WARM_CALLS, "Warm context was not used\n");
+}
+
+/**
+ * Warm context generation scenario:
+ * 01. erase memory & initialize fluffer instance, write 4 entries & mark 3, save warm context twice
+ * 02. check generation counts saves, or is the main buffer's sequence number (0) with FLUFFER_WEAR_LEVEL
+ * 03. write & mark entries one by one until 2 clean ups bring the main buffer back, then write 4 entries
+ *     & mark 3: head, tail & main buffer are the saved context's (FLUFFER_WEAR_LEVEL only)
+ * 04. initialize a new instance, saved context's generation is older than the main buffer's sequence
+ *     number, so the main buffer is searched & the found context is saved with generation 2 (FLUFFER_WEAR_LEVEL only)
+ * */
+static void bench_fluffer_mount_generation(void)
+{
+    uint8_t Local_au8DataBuffer[BENCH_ELEMENT_SIZE];
+    Fluffer_Warm_Context_t Local_sSaved;
+    Fluffer_t Local_sNewFluffer;
+    uint16_t Local_u16Generation;
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    uint8_t Local_u8MainBuffer;
+    uint8_t Local_u8CleanUps = 0;
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+    /*	01. erase memory & initialize instance, save twice	*/
+    setup_mount(1, TRUE);
+    memset(Local_au8DataBuffer, 0x01, sizeof(Local_au8DataBuffer));
+    while(FLUFFER.context.tail < 4)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer), "WriteEntry error\n");
+    }
+
+    while(FLUFFER.context.head < 3)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER), "MarkEntry error\n");
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enSaveContext(&FLUFFER), "SaveContext error\n");
+    memcpy(&Local_sSaved, BACKUP, sizeof(Local_sSaved));
+    Local_u16Generation = Local_sSaved.generation;
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enSaveContext(&FLUFFER), "SaveContext error\n");
+    memcpy(&Local_sSaved, BACKUP, sizeof(Local_sSaved));
+
+    /*	02. check generation	*/
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, Local_u16Generation, "SaveContext Failed @generation\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, Local_sSaved.generation, "SaveContext Failed @generation\n");
+
+    /*	03. 2 clean ups, main buffer is back, move head & tail to the saved ones	*/
+    Local_u8MainBuffer = FLUFFER.context.main_buffer;
+    while(1)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer), "WriteEntry error\n");
+        if(FLUFFER.context.main_buffer != Local_u8MainBuffer)
+        {
+            Local_u8MainBuffer = FLUFFER.context.main_buffer;
+            Local_u8CleanUps++;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        if(Local_u8CleanUps == 2)
+        {
+            break;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER), "MarkEntry error\n");
+        }
+    }
+
+    while(FLUFFER.context.tail < Local_sSaved.context.tail)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8DataBuffer), "WriteEntry error\n");
+    }
+
+    while(FLUFFER.context.head < Local_sSaved.context.head)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER), "MarkEntry error\n");
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(Local_sSaved.context.main_buffer, FLUFFER.context.main_buffer);
+    TEST_ASSERT_EQUAL_UINT32(Local_sSaved.context.head, FLUFFER.context.head);
+    TEST_ASSERT_EQUAL_UINT32(Local_sSaved.context.tail, FLUFFER.context.tail);
+
+    /*	04. stale generation, main buffer is searched	*/
+    mount_copy(&Local_sNewFluffer);
+    memcpy(&Local_sSaved, BACKUP, sizeof(Local_sSaved));
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(2, Local_sSaved.generation, "Stale warm context was used\n");
+#else
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_u16Generation + 1, Local_sSaved.generation, "SaveContext Failed @generation\n");
+
+    /*	saved context is used	*/
+    mount_copy(&Local_sNewFluffer);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+}
+
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_mount(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_mount_sizes);
+    RUN_TEST(bench_fluffer_mount_fallback);
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+    RUN_TEST(bench_fluffer_mount_stale);
+    RUN_TEST(bench_fluffer_mount_generation);
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+    UNITY_END();
+}
@@ -0,0 +1,326 @@
+/******************************************************************************
+ * @file      bench_fluffer_read.c
+ * @brief     Host benchmark, compares Fluffer_enReadEntries (bulk drain) to
+ *            Fluffer_enReadEntry (single entry) in read handle calls & bytes
+ *            read per entry, and checks both paths read the same entries.
+ *            Compares Fluffer_enMarkEntries (batch ack) to Fluffer_enMarkEntry,
+ *            and Fluffer_enPeekEntry (zero copy) to Fluffer_enReadEntry.
+ *            Checks runs of more than 64 KB are split into read handle calls.
+ *            Runs on the host flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_PAGES				4
+#define MEMORY_SIZE					(MEMORY_PAGES * 1024)		/*	STM32F1 preset pages are 1 KB	*/
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_MAX_DRAIN				64
+#define BENCH_LARGE_ENTRIES			5000		/*	over 64 KB of entries, marks & CRCs	*/
+#define BENCH_LARGE_MAX				8192		/*	a 128 KB block's worth of entries	*/
+
+/*	unmarked entries in main buffer	*/
+#define CURRENT_ENTRIES(psFluffer)	(uint16_t)((psFluffer)->context.tail - (psFluffer)->context.head)
+
+
+/**
+ * @brief initialize FLUFFER on an erased memory, write entries until main buffer is full, then mark u16Marks entries
+ * */
+static void fill_instance(uint16_t u16Marks)
+{
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    uint16_t Local_u16Index;
+
+    setup_fluffer(&FlashSim_sPresetStm32f1, 2, MEMORY_PAGES / 2, BENCH_ELEMENT_SIZE);
+
+    /*	entries are read by the read handle, the peek scenario sets the map handle	*/
+    FLUFFER.handles.map_handle = NULL;
+
+    for(Local_u16Index = 0; Local_u16Index < (FLUFFER.context.size - 1); Local_u16Index++)
+    {
+        memset(Local_au8Entry, (uint8_t)(Local_u16Index % FLUFFER_CLEAN_BYTE_CONTENT), BENCH_ELEMENT_SIZE);
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8Entry), "WriteEntry error\n");
+    }
+
+    for(Local_u16Index = 0; Local_u16Index < u16Marks; Local_u16Index++)
+    {
+        Fluffer_enMarkEntry(&FLUFFER);
+    }
+}
+
+static void bench_fluffer_read_equivalence(void);
+static void bench_fluffer_read_drain(void);
+static void bench_fluffer_read_ack(void);
+static void bench_fluffer_read_peek(void);
+static void bench_fluffer_read_large(void);
+
+/**
+ * Equivalence scenario, for drain sizes 1 .. BENCH_MAX_DRAIN:
+ * 01. fill instance, mark a few entries so head != 0
+ * 02. read all entries one by one using Fluffer_enReadEntry
+ * 03. read all entries using Fluffer_enReadEntries, check each call reads at least 1 entry
+ *     & at most the drain size, & buffer beyond read entries is untouched
+ * 04. check both reads are identical, & reading an empty reader returns error empty
+ * */
+static void bench_fluffer_read_equivalence(void)
+{
+    static uint8_t Local_au8Single[MEMORY_SIZE];
+    static uint8_t Local_au8Drained[MEMORY_SIZE];
+    uint8_t Local_au8Guard[BENCH_MAX_DRAIN * BENCH_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Max;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Read;
+    uint16_t Local_u16Index;
+
+    for(Local_u16Max = 1; Local_u16Max <= BENCH_MAX_DRAIN; Local_u16Max++)
+    {
+        /*	01. fill instance	*/
+        fill_instance(3);
+
+        /*	02. read one by one	*/
+        Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+        for(Local_u16Index = 0; Local_u16Index < CURRENT_ENTRIES(&FLUFFER); Local_u16Index++)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, &Local_au8Single[Local_u16Index * BENCH_ELEMENT_SIZE]), "ReadEntry error\n");
+        }
+
+        /*	03. drain	*/
+        Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+        Local_u16Read = 0;
+        while(Local_u16Read < CURRENT_ENTRIES(&FLUFFER))
+        {
+            memset(Local_au8Guard, 0xA5, sizeof(Local_au8Guard));
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Guard, Local_u16Max, &Local_u16Count), "ReadEntries error\n");
+            TEST_ASSERT_TRUE_MESSAGE((Local_u16Count > 0) && (Local_u16Count <= Local_u16Max), "ReadEntries Failed @count\n");
+
+            for(Local_u16Index = Local_u16Max * BENCH_ELEMENT_SIZE; Local_u16Index < sizeof(Local_au8Guard); Local_u16Index++)
+            {
+                TEST_ASSERT_EQUAL_HEX8_MESSAGE(0xA5, Local_au8Guard[Local_u16Index], "ReadEntries Failed @buffer overrun\n");
+            }
+
+            memcpy(&Local_au8Drained[Local_u16Read * BENCH_ELEMENT_SIZE], Local_au8Guard, Local_u16Count * BENCH_ELEMENT_SIZE);
+            Local_u16Read += Local_u16Count;
+        }
+
+        /*	04. compare	*/
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(CURRENT_ENTRIES(&FLUFFER), Local_u16Read, "ReadEntries Failed @total\n");
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Single, Local_au8Drained, Local_u16Read * BENCH_ELEMENT_SIZE, "ReadEntries Failed @entries\n");
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_EMPTY, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Guard, Local_u16Max, &Local_u16Count), "ReadEntries Failed @empty\n");
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, Local_u16Count, "ReadEntries Failed @empty count\n");
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_PARAM, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Guard, 0, &Local_u16Count), "ReadEntries Failed @max 0\n");
+}
+
+/**
+ * Drain scenario, for drain sizes 1, 4, 16, 64:
+ * 01. fill instance
+ * 02. drain all entries using Fluffer_enReadEntry (drain size 1) or Fluffer_enReadEntries
+ * 03. report read handle calls per entry & bytes read per entry
+ * */
+static void bench_fluffer_read_drain(void)
+{
+    uint8_t Local_au8Buffer[BENCH_MAX_DRAIN * BENCH_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Max;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Entries;
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+
+    printf("\nelement size: %u, word size: %u\n", BENCH_ELEMENT_SIZE, FlashSim_sPresetStm32f1.program_unit);
+    printf("%8s %8s %14s %14s\n", "path", "drain", "reads/entry", "bytes/entry");
+
+    /*	single entry path	*/
+    fill_instance(0);
+    Local_u16Entries = CURRENT_ENTRIES(&FLUFFER);
+    Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+    FlashSim_vidResetStats();
+    while(Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Buffer) == FLUFFER_ERROR_NONE);
+    printf("%8s %8u %14.3f %14.2f\n", "single", 1U, (double)Local_psStats->read_calls / Local_u16Entries, (double)Local_psStats->read_bytes / Local_u16Entries);
+
+    /*	bulk drain path	*/
+    for(Local_u16Max = 1; Local_u16Max <= BENCH_MAX_DRAIN; Local_u16Max <<= 2)
+    {
+        fill_instance(0);
+        Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+        FlashSim_vidResetStats();
+        while(Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Buffer, Local_u16Max, &Local_u16Count) == FLUFFER_ERROR_NONE);
+        printf("%8s %8u %14.3f %14.2f\n", "drain", (unsigned int)Local_u16Max, (double)Local_psStats->read_calls / Local_u16Entries, (double)Local_psStats->read_bytes / Local_u16Entries);
+    }
+}
+
+/**
+ * Ack scenario, for ack sizes 1 .. BENCH_MAX_DRAIN:
+ * 01. fill instance, ack all entries in batches using Fluffer_enMarkEntry, keep a copy of memory
+ * 02. fill instance, ack all entries in batches using Fluffer_enMarkEntries
+ * 03. check memories & heads are identical, instance is empty
+ * 04. check error codes: ack more than stored, ack 0, ack when empty
+ * 05. report write handle calls per acked entry for a 50 entries batch
+ * */
+static void bench_fluffer_read_ack(void)
+{
+    static uint8_t Local_au8Expected[MEMORY_SIZE];
+    uint16_t Local_u16Ack;
+    uint16_t Local_u16Batch;
+    uint16_t Local_u16Index;
+    uint16_t Local_u16Head;
+
+    for(Local_u16Ack = 1; Local_u16Ack <= BENCH_MAX_DRAIN; Local_u16Ack++)
+    {
+        /*	01. single mark path	*/
+        fill_instance(0);
+        while(CURRENT_ENTRIES(&FLUFFER))
+        {
+            Local_u16Batch = MIN(Local_u16Ack, CURRENT_ENTRIES(&FLUFFER));
+            for(Local_u16Index = 0; Local_u16Index < Local_u16Batch; Local_u16Index++)
+            {
+                TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER), "MarkEntry error\n");
+            }
+        }
+        memcpy(Local_au8Expected, FlashSim_pu8Map(), MEMORY_SIZE);
+        Local_u16Head = FLUFFER.context.head;
+
+        /*	02. batch mark path	*/
+        fill_instance(0);
+        while(CURRENT_ENTRIES(&FLUFFER))
+        {
+            Local_u16Batch = MIN(Local_u16Ack, CURRENT_ENTRIES(&FLUFFER));
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, Local_u16Batch), "MarkEntries error\n");
+        }
+
+        /*	03. compare	*/
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_u16Head, FLUFFER.context.head, "MarkEntries Failed @head\n");
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Expected, FlashSim_pu8Map(), MEMORY_SIZE, "MarkEntries Failed @memory\n");
+    }
+
+    /*	04. error codes	*/
+    fill_instance(0);
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_PARAM, Fluffer_enMarkEntries(&FLUFFER, CURRENT_ENTRIES(&FLUFFER) + 1), "MarkEntries Failed @count > entries\n");
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_PARAM, Fluffer_enMarkEntries(&FLUFFER, 0), "MarkEntries Failed @count 0\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, FLUFFER.context.head, "MarkEntries Failed @head moved on error\n");
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, CURRENT_ENTRIES(&FLUFFER)), "MarkEntries Failed @all\n");
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_EMPTY, Fluffer_enMarkEntries(&FLUFFER, 1), "MarkEntries Failed @empty\n");
+
+    /*	05. report	*/
+    fill_instance(0);
+    FlashSim_vidResetStats();
+    Fluffer_enMarkEntries(&FLUFFER, 50);
+    printf("\nack 50 entries: %.3f write handle calls per entry\n", (double)FlashSim_psGetStats()->write_calls / 50);
+}
+
+/**
+ * Peek scenario:
+ * 01. fill instance, mark a few entries so head != 0
+ * 02. peek without a map handle == error null pointer, reader doesn't move
+ * 03. set map handle, peek all entries, each entry == entry read using Fluffer_enReadEntry, pointer
+ *     points into memory & no read handle calls were made
+ * 04. peek when all entries were peeked == error empty
+ * */
+static void bench_fluffer_read_peek(void)
+{
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    Fluffer_Reader_t Local_sPeeker;
+    const uint8_t * Local_pu8Entry = NULL;
+    uint16_t Local_u16Len = 0;
+    uint16_t Local_u16Index;
+    uint32_t Local_u32ReadCalls;
+
+    /*	01. fill instance	*/
+    fill_instance(3);
+    Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+    Fluffer_enInitReader(&FLUFFER, &Local_sPeeker);
+
+    /*	02. no map handle	*/
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NULLPTR, Fluffer_enPeekEntry(&FLUFFER, &Local_sPeeker, &Local_pu8Entry, &Local_u16Len), "PeekEntry Failed @no map handle\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(Local_sReader.id, Local_sPeeker.id, "PeekEntry Failed @reader moved on error\n");
+
+    /*	03. peek all entries	*/
+    FLUFFER.handles.map_handle = FlashSim_pu8Map;
+    for(Local_u16Index = 0; Local_u16Index < CURRENT_ENTRIES(&FLUFFER); Local_u16Index++)
+    {
+        Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Entry);
+
+        Local_u32ReadCalls = FlashSim_psGetStats()->read_calls;
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enPeekEntry(&FLUFFER, &Local_sPeeker, &Local_pu8Entry, &Local_u16Len), "PeekEntry error\n");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32ReadCalls, FlashSim_psGetStats()->read_calls, "PeekEntry Failed @read handle called\n");
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(BENCH_ELEMENT_SIZE, Local_u16Len, "PeekEntry Failed @length\n");
+        TEST_ASSERT_TRUE_MESSAGE((Local_pu8Entry >= FlashSim_pu8Map()) && (Local_pu8Entry < (FlashSim_pu8Map() + MEMORY_SIZE)), "PeekEntry Failed @pointer\n");
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Entry, Local_pu8Entry, BENCH_ELEMENT_SIZE, "PeekEntry Failed @entry\n");
+    }
+
+    /*	04. empty	*/
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_EMPTY, Fluffer_enPeekEntry(&FLUFFER, &Local_sPeeker, &Local_pu8Entry, &Local_u16Len), "PeekEntry Failed @empty\n");
+}
+
+/**
+ * Large run scenario, SPI NOR preset with 128 KB blocks, a buffer of a block's worth of entries:
+ * 01. initialize instance, write BENCH_LARGE_ENTRIES entries (a run of more than 64 KB)
+ * 02. read all entries using Fluffer_enReadEntries, check no read handle call reads more than UINT16_MAX
+ *     bytes & the read entries are the written ones, in order
+ * */
+static void bench_fluffer_read_large(void)
+{
+    static uint8_t Local_au8Buffer[BENCH_LARGE_MAX * BENCH_ELEMENT_SIZE];
+    uint8_t Local_au8Expected[BENCH_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Read = 0;
+    uint16_t Local_u16Index;
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+
+    /*	01. fill	*/
+    setup_fluffer(&FlashSim_sPresetSpiNor, 2, FlashSim_sPresetSpiNor.pages / 2, BENCH_ELEMENT_SIZE);
+    write_entries(0, BENCH_LARGE_ENTRIES);
+
+    /*	02. drain	*/
+    Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+    FlashSim_vidResetStats();
+    while(Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Buffer, BENCH_LARGE_MAX, &Local_u16Count) == FLUFFER_ERROR_NONE)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(Local_psStats->read_bytes <= UINT16_MAX, "ReadEntries Failed @run size\n");
+        FlashSim_vidResetStats();
+
+        for(Local_u16Index = 0; Local_u16Index < Local_u16Count; Local_u16Index++, Local_u16Read++)
+        {
+            make_entry(Local_au8Expected, Local_u16Read);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Expected, &Local_au8Buffer[Local_u16Index * BENCH_ELEMENT_SIZE], BENCH_ELEMENT_SIZE, "ReadEntries Failed @entry\n");
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(BENCH_LARGE_ENTRIES, Local_u16Read, "ReadEntries Failed @total\n");
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_read(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_read_equivalence);
+    RUN_TEST(bench_fluffer_read_drain);
+    RUN_TEST(bench_fluffer_read_ack);
+    RUN_TEST(bench_fluffer_read_peek);
+    RUN_TEST(bench_fluffer_read_large);
+    UNITY_END();
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * @file      bench_fluffer_ring.c
+ * @brief     Host benchmark, checks the buffer mode selected by
+ *            FLUFFER_BUFFER_MODE keeps entries in order across resets, then
+ *            reports write amplification (bytes programmed per entry byte),
+ *            erases per 1k entries, erases spread over pages & dropped
+ *            entries, for a consumer lagging behind by a steady backlog.
+ *            Runs on the host flash memory simulator. Build once per buffer
+ *            mode to compare copy & ring buffers.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_PAGES_PER_BLOCK		4
+#define MEMORY_BLOCKS				4
+#define MEMORY_PAGES				(MEMORY_PAGES_PER_BLOCK * MEMORY_BLOCKS)
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_ENTRIES				50000UL
+#define BENCH_ACK_SIZE				16
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+#define BENCH_MODE_NAME				"ring"
+#else
+#define BENCH_MODE_NAME				"copy"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+
+/*	blocks with all entries marked may be released by the new instance only, so entries are compared, not head & tail	*/
+static void mount(Fluffer_t * psNewFluffer)
+{
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    uint8_t Local_au8NewEntry[BENCH_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    Fluffer_Reader_t Local_sNewReader;
+
+    memcpy(psNewFluffer, &FLUFFER, sizeof(Fluffer_t));
+    memset(&psNewFluffer->context, 0x00, sizeof(Fluffer_Context_t));
+
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enInitialize(psNewFluffer), "Init error\n");
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(FLUFFER.context.tail - FLUFFER.context.head,
+        psNewFluffer->context.tail - psNewFluffer->context.head, "Init Failed @count\n");
+
+    Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+    Fluffer_enInitReader(psNewFluffer, &Local_sNewReader);
+    if(Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Entry) == FLUFFER_ERROR_NONE)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(psNewFluffer, &Local_sNewReader, Local_au8NewEntry), "ReadEntry error\n");
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Entry, Local_au8NewEntry, BENCH_ELEMENT_SIZE, "Init Failed @head\n");
+    }
+}
+
+static void bench_fluffer_ring_remount(void);
+static void bench_fluffer_ring_wear(void);
+
+/**
+ * Remount scenario, the instance is replaced by a newly initialized one every 97 writes (a reset):
+ * 01. initialize instance, write BENCH_ENTRIES entries, every BENCH_ACK_SIZE writes read & mark
+ *     BENCH_ACK_SIZE entries, once a block's worth of entries is left unmarked
+ * 02. every 97 writes, initialize a new instance, check it holds the same entries, continue with the new instance
+ * 03. check entries are in order & none are dropped
+ * */
+static void bench_fluffer_ring_remount(void)
+{
+    Fluffer_t Local_sNewFluffer;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Dropped = 0;
+    uint16_t Local_u16Backlog;
+
+    /*	01. write & ack	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    Local_u16Backlog = FLUFFER.context.size / 2;
+
+    for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+    {
+        write_sequence(Local_u32Sequence);
+
+        if(((Local_u32Sequence % BENCH_ACK_SIZE) == 0) && ((FLUFFER.context.tail - FLUFFER.context.head) > Local_u16Backlog))
+        {
+            Local_u32Dropped += ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected);
+        }
+
+        /*	02. remount	*/
+        if((Local_u32Sequence % 97) == 0)
+        {
+            mount(&Local_sNewFluffer);
+            memcpy(&FLUFFER, &Local_sNewFluffer, sizeof(Fluffer_t));
+        }
+    }
+
+    /*	03. drain & check	*/
+    Local_u32Dropped += ack_sequences(UINT16_MAX, &Local_u32Expected);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, Local_u32Dropped, "ReadEntry Failed @dropped\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(BENCH_ENTRIES, Local_u32Expected, "ReadEntry Failed @last\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "WriteEntry Failed @violations\n");
+}
+
+/**
+ * Wear scenario, for a backlog of 0, 1/4, 1/2, 3/4, 1 & 2 blocks' worth of entries:
+ * 01. initialize instance, write BENCH_ENTRIES entries, every BENCH_ACK_SIZE writes read & mark
+ *     BENCH_ACK_SIZE entries, once the backlog is left unmarked
+ * 02. report bytes programmed per entry byte (write amplification), erases per 1k entries, least &
+ *     most erased pages, and dropped entries
+ * */
+static void bench_fluffer_ring_wear(void)
+{
+    const uint8_t Local_au8BacklogQuarters[] = {0, 1, 2, 3, 4, 8};
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected;
+    uint32_t Local_u32Dropped;
+    uint32_t Local_u32MinErases;
+    uint32_t Local_u32MaxErases;
+    uint16_t Local_u16Backlog;
+    uint8_t Local_u8Index;
+    uint8_t Local_u8Page;
+
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    printf("\nbuffer mode: %s, blocks: %u x %u KB, entries per block: %u, element size: %u\n",
+        BENCH_MODE_NAME, (unsigned int)MEMORY_BLOCKS, (unsigned int)(MEMORY_PAGES_PER_BLOCK * FlashSim_sPresetStm32f1.page_size / 1024),
+        (unsigned int)FLUFFER.context.size, (unsigned int)BENCH_ELEMENT_SIZE);
+    printf("%10s %12s %12s %12s %12s %12s\n", "backlog", "write amp", "erases/1k", "min erases", "max erases", "dropped");
+
+    for(Local_u8Index = 0; Local_u8Index < sizeof(Local_au8BacklogQuarters); Local_u8Index++)
+    {
+        /*	01. write & ack	*/
+        setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+        Local_u16Backlog = (FLUFFER.context.size * Local_au8BacklogQuarters[Local_u8Index]) / 4;
+        Local_u32Expected = 0;
+        Local_u32Dropped = 0;
+        FlashSim_vidResetStats();
+
+        for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+        {
+            write_sequence(Local_u32Sequence);
+
+            if(((Local_u32Sequence % BENCH_ACK_SIZE) == 0) && ((FLUFFER.context.tail - FLUFFER.context.head) > Local_u16Backlog))
+            {
+                Local_u32Dropped += ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected);
+            }
+        }
+
+        /*	02. report, marks written by acks are counted too, page erases are counted since FlashSim_u8Init	*/
+        Local_u32MinErases = UINT32_MAX;
+        Local_u32MaxErases = 0;
+        for(Local_u8Page = 0; Local_u8Page < MEMORY_PAGES; Local_u8Page++)
+        {
+            Local_u32MinErases = MIN(Local_u32MinErases, FlashSim_u32GetEraseCount(Local_u8Page));
+            Local_u32MaxErases = MAX(Local_u32MaxErases, FlashSim_u32GetEraseCount(Local_u8Page));
+        }
+
+        printf("%10u %12.3f %12.2f %12lu %12lu %12lu\n",
+            (unsigned int)Local_u16Backlog,
+            (double)Local_psStats->program_bytes / ((double)BENCH_ENTRIES * BENCH_ELEMENT_SIZE),
+            (Local_psStats->erases * 1000.0) / BENCH_ENTRIES,
+            (unsigned long)Local_u32MinErases,
+            (unsigned long)Local_u32MaxErases,
+            (unsigned long)Local_u32Dropped);
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_ring(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_ring_remount);
+    RUN_TEST(bench_fluffer_ring_wear);
+    UNITY_END();
+}
@@ -0,0 +1,348 @@
+/******************************************************************************
+ * @file      bench_fluffer_service.c
+ * @brief     Host benchmark, checks the clean up selected by FLUFFER_CLEANUP_MODE
+ *            keeps entries in order while entries are written, read & marked,
+ *            then reports worst case write call & Fluffer_enService slice cost,
+ *            as handle calls & simulated STM32F1 flash time, with & without
+ *            erasing ahead using Fluffer_enIdleErase. Runs on the host flash
+ *            memory simulator. Build once per clean up mode to compare
+ *            blocking & incremental clean up.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_PAGES_PER_BLOCK		4
+#define MEMORY_BLOCKS				2
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_ENTRIES				20000
+#define BENCH_ACK_SIZE				16
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+#define BENCH_MODE_NAME				"incremental"
+#else
+#define BENCH_MODE_NAME				"blocking"
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+
+/*	simulated time spent in handles since the last FlashSim_vidResetStats call	*/
+static uint32_t model_us(void)
+{
+    return (uint32_t)(FlashSim_psGetStats()->time_ns / 1000UL);
+}
+
+static void bench_fluffer_service_consistency(void);
+static void bench_fluffer_service_overrun(void);
+static void bench_fluffer_service_unmarked(void);
+static void bench_fluffer_service_latency(void);
+static void bench_fluffer_service_erase_ahead(void);
+static void bench_fluffer_service_remount(void);
+
+/**
+ * Consistency scenario:
+ * 01. initialize instance, write BENCH_ENTRIES entries, do a single Fluffer_enService slice after each write
+ * 02. every BENCH_ACK_SIZE / 2 writes, read & mark BENCH_ACK_SIZE entries, check entries are in order & none are dropped
+ * 03. whenever no clean up is pending, initialize a new instance, check head & tail are found
+ * 04. check clean ups were done
+ * */
+static void bench_fluffer_service_consistency(void)
+{
+    Fluffer_t Local_sNewFluffer;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Dropped = 0;
+    uint8_t Local_u8MainBuffer;
+    uint16_t Local_u16Switches = 0;
+    Fluffer_Error_t Local_enError;
+
+    /*	01. write & service	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    Local_u8MainBuffer = FLUFFER.context.main_buffer;
+
+    /*	consumer is slower than producer for the 1st half, so main buffer fills up	*/
+    for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+    {
+        write_sequence(Local_u32Sequence);
+        Local_enError = Fluffer_enService(&FLUFFER, 1);
+        TEST_ASSERT_TRUE_MESSAGE((Local_enError == FLUFFER_ERROR_NONE) || (Local_enError == FLUFFER_ERROR_BUSY), "Service error\n");
+
+        /*	02. read & mark	*/
+        if((Local_u32Sequence % ((Local_u32Sequence < (BENCH_ENTRIES / 2)) ? BENCH_ACK_SIZE : (BENCH_ACK_SIZE / 2))) == 0)
+        {
+            Local_u32Dropped += ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected);
+        }
+
+        /*	03. remount	*/
+        if(Local_enError == FLUFFER_ERROR_NONE)
+        {
+            mount_copy(&Local_sNewFluffer);
+        }
+
+        if(Local_u8MainBuffer != FLUFFER.context.main_buffer)
+        {
+            Local_u8MainBuffer = FLUFFER.context.main_buffer;
+            Local_u16Switches++;
+        }
+    }
+
+    /*	drain the rest	*/
+    Local_u32Dropped += ack_sequences(UINT16_MAX, &Local_u32Expected);
+
+    /*	04. report	*/
+    printf("\nclean up mode: %s, entries: %u, clean ups: %u, dropped (migration): %lu\n",
+        BENCH_MODE_NAME, (unsigned int)BENCH_ENTRIES, (unsigned int)Local_u16Switches, (unsigned long)Local_u32Dropped);
+    TEST_ASSERT_TRUE_MESSAGE(Local_u16Switches > 1, "CleanUp Failed @count\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "WriteEntry Failed @violations\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(BENCH_ENTRIES, Local_u32Expected, "ReadEntry Failed @last\n");
+}
+
+/**
+ * Overrun scenario, Fluffer_enService is never called & nothing is marked:
+ * 01. initialize instance, write 4 main buffers of entries
+ * 02. check no write failed, and entries left are the newest entries, in order
+ * */
+static void bench_fluffer_service_overrun(void)
+{
+    Fluffer_t Local_sNewFluffer;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Written;
+
+    /*	01. write	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    Local_u32Written = FLUFFER.context.size * 4UL;
+    for(Local_u32Sequence = 0; Local_u32Sequence < Local_u32Written; Local_u32Sequence++)
+    {
+        write_sequence(Local_u32Sequence);
+    }
+
+    /*	02. check	*/
+    TEST_ASSERT_FALSE_MESSAGE(FLUFFER.context.tail == FLUFFER.context.size, "WriteEntry Failed @full\n");
+    Fluffer_enService(&FLUFFER, UINT16_MAX);
+    mount_copy(&Local_sNewFluffer);
+    ack_sequences(UINT16_MAX, &Local_u32Expected);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Written, Local_u32Expected, "ReadEntry Failed @last\n");
+}
+
+/**
+ * Unmarked scenario, nothing is marked & the main buffer is never full:
+ * 01. initialize instance, write a main buffer of entries but one
+ * 02. do Fluffer_enService slices, check no clean up switched main buffer, as it would only free entries
+ *     by dropping them
+ * 03. check all entries are kept, in order
+ * */
+static void bench_fluffer_service_unmarked(void)
+{
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Written;
+    uint8_t Local_u8MainBuffer;
+    uint16_t Local_u16Slice;
+
+    /*	01. write	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    Local_u8MainBuffer = FLUFFER.context.main_buffer;
+    Local_u32Written = FLUFFER.context.size - 1UL;
+    for(Local_u32Sequence = 0; Local_u32Sequence < Local_u32Written; Local_u32Sequence++)
+    {
+        write_sequence(Local_u32Sequence);
+    }
+
+    /*	02. service	*/
+    for(Local_u16Slice = 0; Local_u16Slice < 200; Local_u16Slice++)
+    {
+        Fluffer_enService(&FLUFFER, 1);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(Local_u8MainBuffer, FLUFFER.context.main_buffer, "Service Failed @main_buffer\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Written, FLUFFER.context.tail - FLUFFER.context.head, "Service Failed @entries\n");
+
+    /*	03. check	*/
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ack_sequences(UINT16_MAX, &Local_u32Expected), "ReadEntry Failed @dropped\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(Local_u32Written, Local_u32Expected, "ReadEntry Failed @last\n");
+}
+
+/**
+ * Latency scenario:
+ * 01. initialize instance, write BENCH_ENTRIES entries, do a single Fluffer_enService slice after each write,
+ *     read & mark BENCH_ACK_SIZE entries every BENCH_ACK_SIZE writes
+ * 02. report worst case write call & service slice (handle calls, modeled time), erases per 1k entries
+ * */
+static void bench_fluffer_service_latency(void)
+{
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Erases = 0;
+    uint32_t Local_au32MaxWrite[3] = {0};	/*	write calls, erase calls, modeled time	*/
+    uint32_t Local_au32MaxSlice[3] = {0};	/*	write calls, erase calls, modeled time	*/
+
+    /*	01. write & service	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+    {
+        FlashSim_vidResetStats();
+        write_sequence(Local_u32Sequence);
+        Local_au32MaxWrite[0] = MAX(Local_au32MaxWrite[0], Local_psStats->write_calls);
+        Local_au32MaxWrite[1] = MAX(Local_au32MaxWrite[1], Local_psStats->erases);
+        Local_au32MaxWrite[2] = MAX(Local_au32MaxWrite[2], model_us());
+        Local_u32Erases += Local_psStats->erases;
+
+        FlashSim_vidResetStats();
+        Fluffer_enService(&FLUFFER, 1);
+        Local_au32MaxSlice[0] = MAX(Local_au32MaxSlice[0], Local_psStats->write_calls);
+        Local_au32MaxSlice[1] = MAX(Local_au32MaxSlice[1], Local_psStats->erases);
+        Local_au32MaxSlice[2] = MAX(Local_au32MaxSlice[2], model_us());
+        Local_u32Erases += Local_psStats->erases;
+
+        if((Local_u32Sequence % BENCH_ACK_SIZE) == 0)
+        {
+            ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected);
+        }
+    }
+
+    /*	02. report	*/
+    printf("\nclean up mode: %s, block: %u KB, entries per block: %u, copy entries per slice: %u, headroom: %u\n",
+        BENCH_MODE_NAME, (unsigned int)(MEMORY_PAGES_PER_BLOCK * FlashSim_sPresetStm32f1.page_size / 1024), (unsigned int)FLUFFER.context.size,
+        (unsigned int)FLUFFER_CLEANUP_COPY_ENTRIES, (unsigned int)FLUFFER_CLEANUP_HEADROOM);
+    printf("%14s %12s %12s %14s\n", "", "max writes", "max erases", "max time (us)");
+    printf("%14s %12lu %12lu %14lu\n", "write call", (unsigned long)Local_au32MaxWrite[0], (unsigned long)Local_au32MaxWrite[1], (unsigned long)Local_au32MaxWrite[2]);
+    printf("%14s %12lu %12lu %14lu\n", "service slice", (unsigned long)Local_au32MaxSlice[0], (unsigned long)Local_au32MaxSlice[1], (unsigned long)Local_au32MaxSlice[2]);
+    printf("erases per 1k entries: %.2f\n", (Local_u32Erases * 1000.0) / BENCH_ENTRIES);
+}
+
+/**
+ * Erase ahead scenario, Fluffer_enService is not called, for both with & without Fluffer_enIdleErase:
+ * 01. initialize instance, write BENCH_ENTRIES entries, call Fluffer_enIdleErase after each write (or not),
+ *     read & mark BENCH_ACK_SIZE entries every BENCH_ACK_SIZE writes
+ * 02. report worst case write call (handle calls, modeled time), worst Fluffer_enIdleErase call, erases per 1k entries
+ * */
+static void bench_fluffer_service_erase_ahead(void)
+{
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected;
+    uint32_t Local_u32Erases;
+    uint32_t Local_au32MaxWrite[3];		/*	write calls, erase calls, modeled time	*/
+    uint32_t Local_u32MaxIdle;			/*	modeled time	*/
+    uint8_t Local_u8Idle;
+
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    printf("\nclean up mode: %s, block: %u KB, entries per block: %u\n",
+        BENCH_MODE_NAME, (unsigned int)(MEMORY_PAGES_PER_BLOCK * FlashSim_sPresetStm32f1.page_size / 1024), (unsigned int)FLUFFER.context.size);
+    printf("%12s %12s %12s %16s %16s %14s\n", "idle erase", "max writes", "max erases", "max write (us)", "max idle (us)", "erases/1k");
+
+    for(Local_u8Idle = 0; Local_u8Idle < 2; Local_u8Idle++)
+    {
+        /*	01. write & erase ahead	*/
+        setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+        Local_u32Expected = 0;
+        Local_u32Erases = 0;
+        Local_u32MaxIdle = 0;
+        memset(Local_au32MaxWrite, 0x00, sizeof(Local_au32MaxWrite));
+
+        for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+        {
+            FlashSim_vidResetStats();
+            write_sequence(Local_u32Sequence);
+            Local_au32MaxWrite[0] = MAX(Local_au32MaxWrite[0], Local_psStats->write_calls);
+            Local_au32MaxWrite[1] = MAX(Local_au32MaxWrite[1], Local_psStats->erases);
+            Local_au32MaxWrite[2] = MAX(Local_au32MaxWrite[2], model_us());
+            Local_u32Erases += Local_psStats->erases;
+
+            if(Local_u8Idle)
+            {
+                FlashSim_vidResetStats();
+                Fluffer_enIdleErase(&FLUFFER);
+                Local_u32MaxIdle = MAX(Local_u32MaxIdle, model_us());
+                Local_u32Erases += Local_psStats->erases;
+            }
+
+            if((Local_u32Sequence % BENCH_ACK_SIZE) == 0)
+            {
+                TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected), "ReadEntry Failed @dropped\n");
+            }
+        }
+
+        /*	02. report	*/
+        printf("%12s %12lu %12lu %16lu %16lu %14.2f\n", Local_u8Idle ? "yes" : "no",
+            (unsigned long)Local_au32MaxWrite[0], (unsigned long)Local_au32MaxWrite[1], (unsigned long)Local_au32MaxWrite[2],
+            (unsigned long)Local_u32MaxIdle, (Local_u32Erases * 1000.0) / BENCH_ENTRIES);
+    }
+}
+
+/**
+ * Remount scenario, the instance is replaced by a newly initialized one every 97 writes (a reset, clean up
+ * state is lost, a block may be left partially copied or erased):
+ * 01. initialize instance, write BENCH_ENTRIES entries, do a single Fluffer_enService slice after each write,
+ *     read & mark BENCH_ACK_SIZE entries every BENCH_ACK_SIZE writes
+ * 02. every 97 writes, initialize a new instance, check head & tail are found, continue with the new instance
+ * 03. check entries are in order & none are dropped
+ * */
+static void bench_fluffer_service_remount(void)
+{
+    Fluffer_t Local_sNewFluffer;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint32_t Local_u32Dropped = 0;
+
+    /*	01. write & service	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, MEMORY_BLOCKS, MEMORY_PAGES_PER_BLOCK, BENCH_ELEMENT_SIZE);
+    for(Local_u32Sequence = 0; Local_u32Sequence < BENCH_ENTRIES; Local_u32Sequence++)
+    {
+        write_sequence(Local_u32Sequence);
+        Fluffer_enService(&FLUFFER, 1);
+
+        if((Local_u32Sequence % BENCH_ACK_SIZE) == 0)
+        {
+            Local_u32Dropped += ack_sequences(BENCH_ACK_SIZE, &Local_u32Expected);
+        }
+
+        /*	02. remount	*/
+        if((Local_u32Sequence % 97) == 0)
+        {
+            mount_copy(&Local_sNewFluffer);
+            memcpy(&FLUFFER, &Local_sNewFluffer, sizeof(Fluffer_t));
+        }
+    }
+
+    /*	03. drain & check	*/
+    Local_u32Dropped += ack_sequences(UINT16_MAX, &Local_u32Expected);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, Local_u32Dropped, "ReadEntry Failed @dropped\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(BENCH_ENTRIES, Local_u32Expected, "ReadEntry Failed @last\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "WriteEntry Failed @violations\n");
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_service(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_service_consistency);
+    RUN_TEST(bench_fluffer_service_overrun);
+    RUN_TEST(bench_fluffer_service_unmarked);
+    RUN_TEST(bench_fluffer_service_latency);
+    RUN_TEST(bench_fluffer_service_erase_ahead);
+    RUN_TEST(bench_fluffer_service_remount);
+    UNITY_END();
+}
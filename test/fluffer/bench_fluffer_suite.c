@@ -0,0 +1,360 @@
+/******************************************************************************
+ * @file      bench_fluffer_suite.c
+ * @brief     Host benchmark suite, drives Fluffer_enWriteEntry,
+ *            Fluffer_enReadEntry & Fluffer_enMarkEntry on the flash memory
+ *            simulator (test/host/flash_sim.c, STM32F103 timing) under
+ *            producer/consumer mixes, for a sweep of element size, word
+ *            size, pages per block & blocks. Reports ops/s, p50/p99/max
+ *            latency (simulated), handle calls per op, write amplification
+ *            & erases per 1k entries per operation, as CSV on stdout.
+ *            Results only depend on the build configurations, so runs of
+ *            different releases can be compared line by line.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fluffer.h>
+
+
+#define BENCH_BLOCKS_WRITTEN		20			/*	entries written per run, in blocks' worth of entries	*/
+#define BENCH_MAX_SAMPLES			16384		/*	maximum latency samples per operation per run	*/
+#define BENCH_MAX_ELEMENT_SIZE		64
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+#define BENCH_BUFFER_NAME			"ring"
+#else
+#define BENCH_BUFFER_NAME			"copy"
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+#if FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP
+#define BENCH_LAYOUT_NAME			"bitmap"
+#else
+#define BENCH_LAYOUT_NAME			"interleaved"
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+#define BENCH_CLEANUP_NAME			"incremental"
+#else
+#define BENCH_CLEANUP_NAME			"blocking"
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+
+#if FLUFFER_EVICT_MODE == FLUFFER_EVICT_CHUNK
+#define BENCH_EVICT_NAME			"chunk"
+#else
+#define BENCH_EVICT_NAME			"entry"
+#endif	/*	FLUFFER_EVICT_MODE	*/
+
+
+/**
+ * @brief Producer/consumer mixes
+ * */
+typedef enum bench_scenario_t {
+    BENCH_STEADY,			/**<  each write is read & marked right away  */
+    BENCH_BLACKOUT,         /**<  3/4 of a block's worth of entries is written with no consumer, then drained  */
+    BENCH_MIGRATION,        /**<  3/4 of a block's worth of entries is kept unmarked, so each clean up copies it  */
+    BENCH_SATURATED,        /**<  entries are written with no consumer, so the oldest entries are dropped (FLUFFER_EVICT_MODE), then drained  */
+    BENCH_SCENARIOS,
+}Bench_Scenario_t;
+
+/**
+ * @brief Measured operations
+ * */
+typedef enum bench_op_t {
+    BENCH_OP_WRITE,
+    BENCH_OP_READ,
+    BENCH_OP_MARK,
+    BENCH_OPS,
+}Bench_Op_t;
+
+/**
+ * @brief Per operation measurements of a run
+ * */
+typedef struct bench_op_stats_t {
+    uint32_t latency_ns[BENCH_MAX_SAMPLES];	/**<  simulated time of each call  */
+    uint32_t count;                         /**<  number of calls  */
+    uint64_t time_ns;                       /**<  simulated time of all calls  */
+    uint32_t handle_calls;                  /**<  read, write & erase handle calls  */
+    uint32_t program_bytes;                 /**<  bytes programmed  */
+    uint32_t erases;                        /**<  page erases  */
+}Bench_OpStats_t;
+
+static const char * const BenchScenarioNames[BENCH_SCENARIOS] = {"steady", "blackout", "migration", "saturated"};
+static const char * const BenchOpNames[BENCH_OPS] = {"write", "read", "mark"};
+
+static const uint8_t BenchElementSizes[] = {4, 16, 64};
+static const uint8_t BenchWordSizes[] = {1, 2, 4};
+static const uint8_t BenchPagesPerBlock[] = {1, 4};
+static const uint8_t BenchBlocks[] = {2, 4};
+
+/*	instance workspace (FLUFFER_WORKSPACE_INSTANCE), only the smallest allowed size is used	*/
+static uint8_t BenchWorkspace[FLUFFER_WORKSPACE_SIZE(BENCH_MAX_ELEMENT_SIZE, 4, BENCH_MAX_ELEMENT_SIZE + 4)];
+
+static Bench_OpStats_t BenchOps[BENCH_OPS];
+static FlashSim_Stats_t BenchStatsBefore;
+
+static int compare_u32(const void * pvA, const void * pvB)
+{
+    uint32_t Local_u32A = *(const uint32_t *)pvA;
+    uint32_t Local_u32B = *(const uint32_t *)pvB;
+
+    return (Local_u32A > Local_u32B) - (Local_u32A < Local_u32B);
+}
+
+static void op_begin(void)
+{
+    BenchStatsBefore = *FlashSim_psGetStats();
+}
+
+static void op_end(Bench_Op_t enOp)
+{
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    Bench_OpStats_t * Local_psOp = &BenchOps[enOp];
+    uint64_t Local_u64Latency = Local_psStats->time_ns - BenchStatsBefore.time_ns;
+
+    TEST_ASSERT_TRUE_MESSAGE(Local_psOp->count < BENCH_MAX_SAMPLES, "Too many samples\n");
+
+    Local_psOp->latency_ns[Local_psOp->count++] = (uint32_t)Local_u64Latency;
+    Local_psOp->time_ns += Local_u64Latency;
+    Local_psOp->handle_calls += (Local_psStats->read_calls - BenchStatsBefore.read_calls) +
+                                (Local_psStats->write_calls - BenchStatsBefore.write_calls) +
+                                (Local_psStats->erases - BenchStatsBefore.erases);
+    Local_psOp->program_bytes += Local_psStats->program_bytes - BenchStatsBefore.program_bytes;
+    Local_psOp->erases += Local_psStats->erases - BenchStatsBefore.erases;
+}
+
+/*	simulated memory is STM32F103 flash, with the instance's word size as program unit	*/
+static uint8_t init_instance(Fluffer_t * psFluffer, uint8_t u8ElementSize, uint8_t u8WordSize, uint8_t u8PagesPerBlock, uint8_t u8Blocks)
+{
+    FlashSim_Config_t Local_sMemory = FlashSim_sPresetStm32f1;
+
+    Local_sMemory.program_unit = u8WordSize;
+    Local_sMemory.program_page = u8WordSize;
+    TEST_ASSERT_TRUE_MESSAGE(FlashSim_u8Init(&Local_sMemory), "Memory config error\n");
+
+    memset(psFluffer, 0x00, sizeof(Fluffer_t));
+    psFluffer->cfg.page_size = Local_sMemory.page_size;
+    psFluffer->cfg.blocks = u8Blocks;
+    psFluffer->cfg.pages_pre_block = u8PagesPerBlock;
+    psFluffer->cfg.start_page = 0;
+    psFluffer->cfg.word_size = u8WordSize;
+    psFluffer->cfg.element_size = u8ElementSize;
+    psFluffer->workspace.buffer = BenchWorkspace;
+    psFluffer->workspace.size = FLUFFER_WORKSPACE_SIZE(u8ElementSize, u8WordSize, u8ElementSize + u8WordSize);
+    FlashSim_vidSetHandles(&psFluffer->handles);
+
+    /*	configurations not supported by the build (ex: 2 blocks ring buffer) are skipped	*/
+    return Fluffer_enInitialize(psFluffer) == FLUFFER_ERROR_NONE;
+}
+
+/*	entries hold a sequence number, so reordered entries can be detected	*/
+static void write_entry(Fluffer_t * psFluffer, uint32_t u32Sequence)
+{
+    uint8_t Local_au8Entry[BENCH_MAX_ELEMENT_SIZE];
+
+    memset(Local_au8Entry, (uint8_t)u32Sequence, sizeof(Local_au8Entry));
+    memcpy(Local_au8Entry, &u32Sequence, sizeof(u32Sequence));
+
+    op_begin();
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(psFluffer, Local_au8Entry), "WriteEntry error\n");
+    op_end(BENCH_OP_WRITE);
+}
+
+/*	read & mark the oldest entry, checks sequence numbers increase, returns 0 if fluffer is empty	*/
+static uint8_t ack_entry(Fluffer_t * psFluffer, uint32_t * pu32Expected)
+{
+    uint8_t Local_au8Entry[BENCH_MAX_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint32_t Local_u32Sequence;
+    Fluffer_Error_t Local_enError;
+
+    Fluffer_enInitReader(psFluffer, &Local_sReader);
+
+    op_begin();
+    Local_enError = Fluffer_enReadEntry(psFluffer, &Local_sReader, Local_au8Entry);
+    if(Local_enError != FLUFFER_ERROR_NONE)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_EMPTY, Local_enError, "ReadEntry error\n");
+        return 0;
+    }
+    op_end(BENCH_OP_READ);
+
+    memcpy(&Local_u32Sequence, Local_au8Entry, sizeof(Local_u32Sequence));
+    TEST_ASSERT_TRUE_MESSAGE(Local_u32Sequence >= (*pu32Expected), "ReadEntry Failed @order\n");
+    (*pu32Expected) = Local_u32Sequence + 1;
+
+    op_begin();
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(psFluffer), "MarkEntry error\n");
+    op_end(BENCH_OP_MARK);
+
+    return 1;
+}
+
+/*	run a scenario, BENCH_BLOCKS_WRITTEN blocks' worth of entries are written	*/
+static void run_scenario(Fluffer_t * psFluffer, Bench_Scenario_t enScenario)
+{
+    uint32_t Local_u32Entries;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Expected = 0;
+    uint16_t Local_u16Backlog = (psFluffer->context.size * 3) / 4;
+
+    memset(BenchOps, 0x00, sizeof(BenchOps));
+    Local_u32Entries = MIN((uint32_t)psFluffer->context.size * BENCH_BLOCKS_WRITTEN, BENCH_MAX_SAMPLES);
+
+    for(Local_u32Sequence = 0; Local_u32Sequence < Local_u32Entries; Local_u32Sequence++)
+    {
+        write_entry(psFluffer, Local_u32Sequence);
+
+        if(enScenario == BENCH_STEADY)
+        {
+            ack_entry(psFluffer, &Local_u32Expected);
+        }
+        else if(enScenario == BENCH_BLACKOUT)
+        {
+            /*	connection is back, drain all entries	*/
+            if(((Local_u32Sequence + 1) % Local_u16Backlog) == 0)
+            {
+                while(ack_entry(psFluffer, &Local_u32Expected));
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+        }
+        else if(enScenario == BENCH_MIGRATION)
+        {
+            if((psFluffer->context.tail - psFluffer->context.head) > Local_u16Backlog)
+            {
+                ack_entry(psFluffer, &Local_u32Expected);
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    /*	drain entries left	*/
+    while(ack_entry(psFluffer, &Local_u32Expected));
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "Illegal program\n");
+}
+
+static void print_results(const Fluffer_t * psFluffer, Bench_Scenario_t enScenario)
+{
+    Bench_OpStats_t * Local_psOp;
+    uint32_t Local_u32Written = BenchOps[BENCH_OP_WRITE].count;
+    uint8_t Local_u8Op;
+
+    for(Local_u8Op = 0; Local_u8Op < BENCH_OPS; Local_u8Op++)
+    {
+        Local_psOp = &BenchOps[Local_u8Op];
+        if(IS_ZERO(Local_psOp->count))
+        {
+            continue;
+        }
+
+        qsort(Local_psOp->latency_ns, Local_psOp->count, sizeof(uint32_t), compare_u32);
+
+        printf("%s,%s,%s,%s,%s,%s,%u,%u,%u,%u,%u,%lu,%.0f,%lu,%lu,%lu,%.3f,%.3f,%.2f\n",
+            BENCH_BUFFER_NAME, BENCH_LAYOUT_NAME, BENCH_CLEANUP_NAME, BENCH_EVICT_NAME,
+            BenchScenarioNames[enScenario], BenchOpNames[Local_u8Op],
+            (unsigned int)psFluffer->cfg.element_size, (unsigned int)psFluffer->cfg.word_size,
+            (unsigned int)psFluffer->cfg.pages_pre_block, (unsigned int)psFluffer->cfg.blocks,
+            (unsigned int)psFluffer->context.size,
+            (unsigned long)Local_psOp->count,
+            IS_ZERO(Local_psOp->time_ns) ? 0.0 : (Local_psOp->count * 1e9) / (double)Local_psOp->time_ns,
+            (unsigned long)Local_psOp->latency_ns[((Local_psOp->count - 1) * 50) / 100],
+            (unsigned long)Local_psOp->latency_ns[((Local_psOp->count - 1) * 99) / 100],
+            (unsigned long)Local_psOp->latency_ns[Local_psOp->count - 1],
+            (double)Local_psOp->handle_calls / Local_psOp->count,
+            (double)Local_psOp->program_bytes / ((double)Local_u32Written * psFluffer->cfg.element_size),
+            (Local_psOp->erases * 1000.0) / Local_u32Written);
+    }
+}
+
+static void bench_fluffer_suite_sweep(void);
+
+/**
+ * Sweep, for each element size, word size (up to FLUFFER_MAX_MEMORY_WORD_SIZE), pages per block & blocks:
+ * 01. initialize a new instance on an erased simulated memory, skip configurations the build doesn't support
+ * 02. run each scenario on it (write, read & mark), drain entries left, check entries are read in order & no
+ *     illegal programs
+ * 03. print a CSV line per scenario & operation, write amplification & erases per 1k entries are
+ *     per written entry, so the lines of a scenario add up
+ * */
+static void bench_fluffer_suite_sweep(void)
+{
+    Fluffer_t Local_sFluffer;
+    uint8_t Local_u8Element;
+    uint8_t Local_u8Word;
+    uint8_t Local_u8Pages;
+    uint8_t Local_u8Blocks;
+    uint8_t Local_u8Scenario;
+
+    printf("\nbuffer,layout,cleanup,evict,scenario,op,element_size,word_size,pages_per_block,blocks,entries_per_block,"
+           "ops,ops_per_s,p50_ns,p99_ns,max_ns,handle_calls_per_op,write_amp,erases_per_1k\n");
+
+    for(Local_u8Element = 0; Local_u8Element < sizeof(BenchElementSizes); Local_u8Element++)
+    {
+        for(Local_u8Word = 0; Local_u8Word < sizeof(BenchWordSizes); Local_u8Word++)
+        {
+            if(BenchWordSizes[Local_u8Word] > FLUFFER_MAX_MEMORY_WORD_SIZE)
+            {
+                continue;
+            }
+
+            for(Local_u8Pages = 0; Local_u8Pages < sizeof(BenchPagesPerBlock); Local_u8Pages++)
+            {
+                for(Local_u8Blocks = 0; Local_u8Blocks < sizeof(BenchBlocks); Local_u8Blocks++)
+                {
+                    for(Local_u8Scenario = 0; Local_u8Scenario < BENCH_SCENARIOS; Local_u8Scenario++)
+                    {
+                        /*	01. initialize	*/
+                        if(!init_instance(&Local_sFluffer, BenchElementSizes[Local_u8Element], BenchWordSizes[Local_u8Word],
+                                          BenchPagesPerBlock[Local_u8Pages], BenchBlocks[Local_u8Blocks]))
+                        {
+                            continue;
+                        }
+
+                        /*	02. run	*/
+                        run_scenario(&Local_sFluffer, (Bench_Scenario_t)Local_u8Scenario);
+
+                        /*	03. report	*/
+                        print_results(&Local_sFluffer, (Bench_Scenario_t)Local_u8Scenario);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_suite(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_suite_sweep);
+    UNITY_END();
+}
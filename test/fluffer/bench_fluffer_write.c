@@ -0,0 +1,209 @@
+/******************************************************************************
+ * @file      bench_fluffer_write.c
+ * @brief     Host benchmark, compares Fluffer_enWriteEntries (batched) to
+ *            Fluffer_enWriteEntry (single entry) in entries/s, write handle
+ *            calls (flash program operations) per entry & bytes programmed
+ *            per entry, and checks both paths leave the same memory content.
+ *            Runs on the host flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define MEMORY_PAGES				4
+#define MEMORY_SIZE					(MEMORY_PAGES * 1024)		/*	STM32F1 preset pages are 1 KB	*/
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_MAX_BATCH				64
+#define BENCH_ENTRIES				20000UL
+
+
+/*	1st instance (FLUFFER) on the first MEMORY_PAGES pages, the 2nd one on the MEMORY_PAGES pages after them	*/
+static void setup_instances(Fluffer_t * psSecond)
+{
+    setup_fluffer(&FlashSim_sPresetStm32f1, 2, MEMORY_PAGES / 2, BENCH_ELEMENT_SIZE);
+
+    memcpy(psSecond, &FLUFFER, sizeof(Fluffer_t));
+    memset(&psSecond->context, 0x00, sizeof(Fluffer_Context_t));
+    psSecond->cfg.start_page = MEMORY_PAGES;
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enInitialize(psSecond), "Init error\n");
+}
+
+static void fill_batch(uint8_t * pu8Buffer, uint16_t u16Count, uint32_t u32FirstEntry)
+{
+    uint16_t Local_u16Index;
+
+    for(Local_u16Index = 0; Local_u16Index < u16Count; Local_u16Index++)
+    {
+        memset(&pu8Buffer[Local_u16Index * BENCH_ELEMENT_SIZE], (uint8_t)((u32FirstEntry + Local_u16Index) % FLUFFER_CLEAN_BYTE_CONTENT), BENCH_ELEMENT_SIZE);
+    }
+}
+
+/**
+ * @brief write a batch using single or batched path, then consumer marks u16Marks entries
+ * */
+static void write_batch(Fluffer_t * psFluffer, uint8_t * pu8Batch, uint16_t u16Count, uint8_t u8Batched, uint16_t u16Marks)
+{
+    Fluffer_Error_t Local_enError;
+    uint16_t Local_u16Written = 0;
+    uint16_t Local_u16Index;
+
+    if(u8Batched)
+    {
+        Local_enError = Fluffer_enWriteEntries(psFluffer, pu8Batch, u16Count, &Local_u16Written);
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "WriteEntries error\n");
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(u16Count, Local_u16Written, "WriteEntries count\n");
+    }
+    else
+    {
+        for(Local_u16Index = 0; Local_u16Index < u16Count; Local_u16Index++)
+        {
+            Local_enError = Fluffer_enWriteEntry(psFluffer, &pu8Batch[Local_u16Index * BENCH_ELEMENT_SIZE]);
+            TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Local_enError, "WriteEntry error\n");
+        }
+    }
+
+    for(Local_u16Index = 0; Local_u16Index < u16Marks; Local_u16Index++)
+    {
+        Fluffer_enMarkEntry(psFluffer);
+    }
+}
+
+/**
+ * @brief read all unmarked entries of given instance, packed into given buffer
+ * */
+static void read_all(Fluffer_t * psFluffer, uint8_t * pu8Buffer)
+{
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Index;
+
+    Fluffer_enInitReader(psFluffer, &Local_sReader);
+
+    for(Local_u16Index = 0; Local_u16Index < (psFluffer->context.tail - psFluffer->context.head); Local_u16Index++)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(psFluffer, &Local_sReader, &pu8Buffer[Local_u16Index * BENCH_ELEMENT_SIZE]), "ReadEntry error\n");
+    }
+}
+
+static void bench_fluffer_write_equivalence(void);
+static void bench_fluffer_write_throughput(void);
+
+/**
+ * Equivalence scenario, for batch sizes 1 .. BENCH_MAX_BATCH:
+ * 01. initialize 2 instances on separate pages of the memory
+ * 02. write the same entries using single entry writes to 1st instance, and batched writes to the 2nd,
+ *     consumer marks half of each batch (so main buffer overflows & oldest entries are dropped)
+ * 03. check both instances hold the same unmarked entries, batched path may do fewer clean ups
+ *     so the main buffer's block & position are not compared
+ * */
+static void bench_fluffer_write_equivalence(void)
+{
+    uint8_t Local_au8Batch[BENCH_MAX_BATCH * BENCH_ELEMENT_SIZE];
+    static uint8_t Local_au8Single[MEMORY_SIZE];
+    static uint8_t Local_au8Batched[MEMORY_SIZE];
+    Fluffer_t Local_sBatch;
+    uint16_t Local_u16BatchSize;
+    uint32_t Local_u32Entry;
+
+    for(Local_u16BatchSize = 1; Local_u16BatchSize <= BENCH_MAX_BATCH; Local_u16BatchSize++)
+    {
+        /*	01. initialize both instances	*/
+        setup_instances(&Local_sBatch);
+
+        /*	02. write 4 main buffers worth of entries	*/
+        for(Local_u32Entry = 0; Local_u32Entry < (4UL * FLUFFER.context.size); Local_u32Entry += Local_u16BatchSize)
+        {
+            fill_batch(Local_au8Batch, Local_u16BatchSize, Local_u32Entry);
+            write_batch(&FLUFFER, Local_au8Batch, Local_u16BatchSize, FALSE, Local_u16BatchSize / 2);
+            write_batch(&Local_sBatch, Local_au8Batch, Local_u16BatchSize, TRUE, Local_u16BatchSize / 2);
+        }
+
+        /*	03. compare	*/
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(FLUFFER.context.tail - FLUFFER.context.head,
+            Local_sBatch.context.tail - Local_sBatch.context.head, "WriteEntries Failed @count\n");
+
+        read_all(&FLUFFER, Local_au8Single);
+        read_all(&Local_sBatch, Local_au8Batched);
+
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(Local_au8Single, Local_au8Batched,
+            (FLUFFER.context.tail - FLUFFER.context.head) * BENCH_ELEMENT_SIZE, "WriteEntries Failed @entries\n");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "WriteEntries Failed @violations\n");
+    }
+}
+
+/**
+ * Throughput scenario, for batch sizes 1, 4, 16, 64, for each write path:
+ * 01. initialize instance
+ * 02. write BENCH_ENTRIES entries in batches, consumer marks each batch after it is written
+ * 03. report entries/s, write handle calls per entry, bytes programmed per entry, erases per 1k entries
+ * */
+static void bench_fluffer_write_throughput(void)
+{
+    uint8_t Local_au8Batch[BENCH_MAX_BATCH * BENCH_ELEMENT_SIZE];
+    uint16_t Local_u16BatchSize;
+    uint8_t Local_u8Batched;
+    uint32_t Local_u32Entry;
+    clock_t Local_tStart;
+    double Local_dSeconds;
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+
+    printf("\nelement size: %u, word size: %u, run buffer: %u\n", BENCH_ELEMENT_SIZE, FlashSim_sPresetStm32f1.program_unit, FLUFFER_WRITE_RUN_SIZE);
+    printf("%8s %8s %14s %14s %14s %14s\n", "path", "batch", "entries/s", "writes/entry", "bytes/entry", "erases/1k");
+
+    for(Local_u16BatchSize = 1; Local_u16BatchSize <= BENCH_MAX_BATCH; Local_u16BatchSize <<= 2)
+    {
+        for(Local_u8Batched = 0; Local_u8Batched < 2; Local_u8Batched++)
+        {
+            /*	01. initialize instance	*/
+            setup_fluffer(&FlashSim_sPresetStm32f1, 2, MEMORY_PAGES / 2, BENCH_ELEMENT_SIZE);
+            fill_batch(Local_au8Batch, Local_u16BatchSize, 0);
+
+            /*	02. write entries	*/
+            Local_tStart = clock();
+            for(Local_u32Entry = 0; Local_u32Entry < BENCH_ENTRIES; Local_u32Entry += Local_u16BatchSize)
+            {
+                write_batch(&FLUFFER, Local_au8Batch, Local_u16BatchSize, Local_u8Batched, Local_u16BatchSize);
+            }
+            Local_dSeconds = (double)(clock() - Local_tStart) / CLOCKS_PER_SEC;
+
+            /*	03. report, mark writes are included in write handle calls	*/
+            printf("%8s %8u %14.0f %14.3f %14.2f %14.2f\n",
+                (Local_u8Batched) ? "batch" : "single",
+                (unsigned int)Local_u16BatchSize,
+                (Local_dSeconds > 0) ? ((double)BENCH_ENTRIES / Local_dSeconds) : 0.0,
+                (double)Local_psStats->write_calls / BENCH_ENTRIES,
+                (double)Local_psStats->program_bytes / BENCH_ENTRIES,
+                ((double)Local_psStats->erases * 1000.0) / BENCH_ENTRIES);
+        }
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_fluffer_write(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_fluffer_write_equivalence);
+    RUN_TEST(bench_fluffer_write_throughput);
+    UNITY_END();
+}
@@ -10,5 +10,20 @@
 
 void test_fluffer_basic(void);
 void test_fluffer_mem_config(void);
+void bench_fluffer_mount(void);
+void bench_fluffer_write(void);
+void bench_fluffer_read(void);
+void bench_fluffer_layout(void);
+void bench_fluffer_service(void);
+void bench_fluffer_ring(void);
+void bench_fluffer_suite(void);
+void test_fluffer_queue(void);
+void test_fluffer_cache(void);
+void test_fluffer_states(void);
+void test_fluffer_async(void);
+void bench_fluffer_large(void);
+void test_fluffer_crc(void);
+void test_fluffer_power(void);
+void test_fluffer_wear(void);
 
 #endif /* __FLUFFER_TEST_FLUFFER_H__ */
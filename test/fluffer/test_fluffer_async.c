@@ -0,0 +1,280 @@
+/******************************************************************************
+ * @file      test_fluffer_async.c
+ * @brief     Host tests of asynchronous erases (erase handle that only starts
+ *            the erase, and a poll handle): Fluffer_enService never waits for
+ *            an erase while a main loop keeps running, API calls made while an
+ *            erase is in progress wait for it, and entries are kept in order.
+ *            Runs on the host flash memory simulator (SPI NOR timing).
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define ASYNC_ELEMENT_SIZE			16
+#define ASYNC_TICK_NS				1000000ULL		/*	main loop period (sensor sampling)	*/
+#define ASYNC_WRITE_TICKS			4				/*	an entry is written every ASYNC_WRITE_TICKS ticks	*/
+#define ASYNC_TICKS					8000
+#define ASYNC_UNMARKED				100				/*	oldest entry is marked once there are more unmarked entries	*/
+#define ASYNC_CACHE_CAPACITY		32				/*	more than the entries written during an erase	*/
+#define ASYNC_CACHE_MAX_DIRTY		4
+
+/*	synchronous erase handle run, asynchronous (FLUFFER_ERASE_ASYNC only), then asynchronous with a write-back cache	*/
+#if FLUFFER_ERASE_MODE == FLUFFER_ERASE_SYNC
+#define ASYNC_RUNS					1
+#elif FLUFFER_CACHE_MODE == FLUFFER_CACHE_WRITE_BACK
+#define ASYNC_RUNS					3
+#else
+#define ASYNC_RUNS					2
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+
+/*	write-back cache, used with FLUFFER_CACHE_WRITE_BACK	*/
+static uint8_t CACHE[ASYNC_CACHE_CAPACITY * ASYNC_ELEMENT_SIZE];
+
+/*
+ * fluffer instance on the simulator (SPI NOR), 4 blocks of 2 4 KB sectors each, with the synchronous
+ * or the asynchronous erase handle, and a write-back cache (FLUFFER_CACHE_WRITE_BACK only) or none
+ * */
+static void setup_async(uint8_t u8Async, uint8_t u8Cache)
+{
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetSpiNor));
+    config_fluffer(&FlashSim_sPresetSpiNor, 4, 2, ASYNC_ELEMENT_SIZE);
+
+    if(u8Cache)
+    {
+        FLUFFER.cache.buffer = CACHE;
+        FLUFFER.cache.capacity = ASYNC_CACHE_CAPACITY;
+        FLUFFER.cache.max_dirty = ASYNC_CACHE_MAX_DIRTY;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    if(u8Async)
+    {
+        FlashSim_vidSetAsyncHandles(&FLUFFER.handles);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+    FlashSim_vidResetStats();
+}
+
+/*
+ * main loop: every tick, call Fluffer_enService once, every ASYNC_WRITE_TICKS ticks write an entry, and mark
+ * the oldest ones past ASYNC_UNMARKED unless an erase is in progress. Virtual time spent in fluffer calls is
+ * the main loop's stall
+ * */
+static void run_main_loop(uint64_t * pu64MaxService, uint64_t * pu64MaxWrite, uint64_t * pu64Stall, uint16_t * pu16Last)
+{
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    uint8_t Local_au8Entry[ASYNC_ELEMENT_SIZE];
+    uint16_t Local_u16Sequence = 0;
+    uint32_t Local_u32Tick;
+    uint64_t Local_u64Start;
+    uint8_t Local_u8Busy;
+
+    (*pu64MaxService) = 0;
+    (*pu64MaxWrite) = 0;
+
+    for(Local_u32Tick = 0; Local_u32Tick < ASYNC_TICKS; Local_u32Tick++)
+    {
+        /*	sensor sampling, an erase started earlier goes on meanwhile	*/
+        FlashSim_vidAdvance(ASYNC_TICK_NS);
+
+        Local_u64Start = Local_psStats->time_ns;
+        (void)Fluffer_enService(&FLUFFER, 1);
+        (*pu64MaxService) = MAX(*pu64MaxService, Local_psStats->time_ns - Local_u64Start);
+
+        if((Local_u32Tick % ASYNC_WRITE_TICKS) == 0)
+        {
+            Local_u64Start = Local_psStats->time_ns;
+            make_entry(Local_au8Entry, Local_u16Sequence);
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8Entry));
+
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enIsBusy(&FLUFFER, &Local_u8Busy));
+
+            if(!Local_u8Busy && ((FLUFFER.context.tail - FLUFFER.context.head) > ASYNC_UNMARKED))
+            {
+                TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, (uint16_t)(FLUFFER.context.tail - FLUFFER.context.head - ASYNC_UNMARKED)));
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+
+            (*pu64MaxWrite) = MAX(*pu64MaxWrite, Local_psStats->time_ns - Local_u64Start);
+            Local_u16Sequence++;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    (*pu64Stall) = Local_psStats->time_ns;
+    (*pu16Last) = Local_u16Sequence - 1;
+}
+
+static void test_fluffer_async_service(void);
+#if FLUFFER_ERASE_MODE == FLUFFER_ERASE_ASYNC
+static void test_fluffer_async_busy(void);
+#endif	/*	FLUFFER_ERASE_MODE	*/
+
+/**
+ * Test scenario, for the synchronous then the asynchronous erase handle (FLUFFER_ERASE_ASYNC only, then the
+ * asynchronous erase handle with a write-back cache, FLUFFER_CACHE_WRITE_BACK only):
+ * 01. run the main loop, several clean ups are done, report worst Fluffer_enService & write stalls, total stall
+ * 02. check no memory access was made while an erase was in progress
+ * 03. flush & re-initialize, check unmarked entries are the last ones written, in order
+ * 04. check a Fluffer_enService call never waited for an erase with the asynchronous erase handle, and did
+ *     with the synchronous one. With the cache, check writes don't wait for erases either (unless the write
+ *     does a blocking clean up)
+ * */
+static void test_fluffer_async_service(void)
+{
+    const char * Local_apcNames[] = {"sync", "async", "cached"};
+    uint64_t Local_u64MaxService;
+    uint64_t Local_u64MaxWrite;
+    uint64_t Local_u64Stall;
+    uint16_t Local_u16Last;
+    uint16_t Local_u16Count;
+    uint8_t Local_u8Run;
+
+    printf("\n%8s %8s %8s %16s %16s %12s\n", "erase", "erases", "polls", "max service us", "max write us", "stall ms");
+
+    for(Local_u8Run = 0; Local_u8Run < ASYNC_RUNS; Local_u8Run++)
+    {
+        /*	01. main loop	*/
+        setup_async(Local_u8Run >= 1, Local_u8Run == 2);
+        run_main_loop(&Local_u64MaxService, &Local_u64MaxWrite, &Local_u64Stall, &Local_u16Last);
+
+        printf("%8s %8lu %8lu %16lu %16lu %12lu\n", Local_apcNames[Local_u8Run], (unsigned long)FlashSim_psGetStats()->erases,
+            (unsigned long)FlashSim_psGetStats()->polls, (unsigned long)(Local_u64MaxService / 1000ULL),
+            (unsigned long)(Local_u64MaxWrite / 1000ULL), (unsigned long)(Local_u64Stall / 1000000ULL));
+
+        /*	02. memory accesses	*/
+        TEST_ASSERT_TRUE(FlashSim_psGetStats()->erases > 1);
+        TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+
+        /*	03. entries	*/
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enFlush(&FLUFFER));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+        TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+        Local_u16Count = (uint16_t)(FLUFFER.context.tail - FLUFFER.context.head);
+        TEST_ASSERT_TRUE(Local_u16Count >= ASYNC_UNMARKED);
+        check_entries(Local_u16Last + 1 - Local_u16Count, Local_u16Count);
+
+        /*	04. worst Fluffer_enService stall	*/
+        if(Local_u8Run >= 1)
+        {
+            TEST_ASSERT_TRUE(Local_u64MaxService < (FlashSim_sPresetSpiNor.erase_ns / 10));
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(Local_u64MaxService >= FlashSim_sPresetSpiNor.erase_ns);
+        }
+
+#if (FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL) || (FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING)
+        if(Local_u8Run == 2)
+        {
+            TEST_ASSERT_TRUE(Local_u64MaxWrite < (FlashSim_sPresetSpiNor.erase_ns / 10));
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+    }
+}
+
+#if FLUFFER_ERASE_MODE == FLUFFER_ERASE_ASYNC
+/**
+ * Test scenario (asynchronous erase handle):
+ * 01. write 10 entries, program the block to be erased ahead, so its page isn't blank
+ * 02. call Fluffer_enService, check it starts the erase & returns busy without waiting for it
+ * 03. call Fluffer_enService again, check it only polls & returns busy
+ * 04. read an entry while the erase is in progress, check it waits for the erase & reads the entry
+ * 05. call Fluffer_enService, check nothing is pending
+ * */
+static void test_fluffer_async_busy(void)
+{
+    const FlashSim_Stats_t * Local_psStats = FlashSim_psGetStats();
+    uint8_t Local_au8Entry[ASYNC_ELEMENT_SIZE];
+    uint8_t Local_au8Read[ASYNC_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint64_t Local_u64Start;
+
+    setup_async(1, 0);
+
+    /*	01. entries, and a page to erase ahead	*/
+    write_entries(0, 10);
+
+    TEST_ASSERT_EQUAL(FLUFFER_CLEANUP_ERASE, FLUFFER.cleanup.state);
+    memset(Local_au8Entry, 0x00, sizeof(Local_au8Entry));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite((uint32_t)FLUFFER.cleanup.block * FLUFFER.cfg.pages_pre_block * FLUFFER.cfg.page_size, Local_au8Entry, sizeof(Local_au8Entry)));
+    FlashSim_vidResetStats();
+
+    /*	02. erase is started	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_BUSY, Fluffer_enService(&FLUFFER, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->erases);
+    TEST_ASSERT_TRUE(Local_psStats->time_ns < (FlashSim_sPresetSpiNor.erase_ns / 10));
+
+    /*	03. erase is in progress	*/
+    FlashSim_vidResetStats();
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_BUSY, Fluffer_enService(&FLUFFER, 4));
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->read_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->erases);
+    TEST_ASSERT_TRUE(Local_psStats->polls >= 1);
+
+    /*	04. read waits for the erase	*/
+    Local_u64Start = Local_psStats->time_ns;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Read));
+    make_entry(Local_au8Entry, 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Entry, Local_au8Read, ASYNC_ELEMENT_SIZE);
+    TEST_ASSERT_TRUE((Local_psStats->time_ns - Local_u64Start) > (FlashSim_sPresetSpiNor.erase_ns / 2));
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+
+    /*	05. block is erased	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enService(&FLUFFER, 1));
+    TEST_ASSERT_EQUAL(FLUFFER_CLEANUP_IDLE, FLUFFER.cleanup.state);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+}
+#endif	/*	FLUFFER_ERASE_MODE	*/
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_async(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fluffer_async_service);
+#if FLUFFER_ERASE_MODE == FLUFFER_ERASE_ASYNC
+    RUN_TEST(test_fluffer_async_busy);
+#endif	/*	FLUFFER_ERASE_MODE	*/
+    UNITY_END();
+}
@@ -39,6 +39,9 @@
 /*	emulated flash mmory	*/
 static uint8_t MEMORY[MEMORY_PAGES][MEMORY_PAGE_SIZE];
 
+/*	instance workspace, used with FLUFFER_WORKSPACE_INSTANCE	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(BASIC_TEST_ELEMENT_SIZE, MEMORY_WORD_SIZE, 64)];
+
 static Fluffer_Handle_Error_t FlfrReadHandle(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len)
 {
     uint8_t page_index = u32Offset / MEMORY_PAGE_SIZE;
@@ -59,17 +62,15 @@ static Fluffer_Handle_Error_t FlfrWriteHandle(uint32_t u32Offset, uint8_t * pu8D
     return FH_ERR_NONE;
 }
 
-static Fluffer_Handle_Error_t FlfrEraseHandle(uint8_t u8PageIndex)
+static Fluffer_Handle_Error_t FlfrEraseHandle(Fluffer_Page_t PageIndex)
 {
-    memset(&MEMORY[u8PageIndex], 0xFF, MEMORY_PAGE_SIZE);
+    memset(&MEMORY[PageIndex], 0xFF, MEMORY_PAGE_SIZE);
     return FH_ERR_NONE;
 }
 
 static void set_default_handles(Fluffer_t * psFluffer)
 {
-    psFluffer->handles.read_handle = FlfrReadHandle;
-    psFluffer->handles.write_handle = FlfrWriteHandle;
-    psFluffer->handles.erase_handle = FlfrEraseHandle;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitHandles(&psFluffer->handles, FlfrReadHandle, FlfrWriteHandle, FlfrEraseHandle));
 }
 
 /*
@@ -91,6 +92,8 @@ static void memcfg(Fluffer_t * psFluffer)
     psFluffer->cfg.start_page = 0;
     psFluffer->cfg.word_size = MEMORY_WORD_SIZE;
     psFluffer->cfg.element_size = BASIC_TEST_ELEMENT_SIZE;
+    psFluffer->workspace.buffer = WORKSPACE;
+    psFluffer->workspace.size = sizeof(WORKSPACE);
 }
 
 static void fill_buffer(uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Fill)
@@ -102,6 +105,7 @@ static void fill_buffer(uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Fill)
 }
 
 static void test_fluffer_basic_functions(void);
+static void test_fluffer_basic_handles(void);
 
 /**
  * Test scenario:
@@ -416,6 +420,36 @@ static void test_fluffer_basic_functions(void)
     TEST_ASSERT_MESSAGE(Local_sNewFluffer.context.main_buffer == Local_sFluffer.context.main_buffer, "Init Failed @main_buffer");
 }
 
+/**
+ * Test scenario (handles initialization):
+ * 01. fill handles with garbage, initialize them: memory handles are set, optional handles are cleared
+ * 02. test null handles pointer & null memory handles == error null pointer
+ * */
+static void test_fluffer_basic_handles(void)
+{
+    Fluffer_Handles_t Local_sHandles;
+
+    /*	01. garbage optional handles are cleared	*/
+    memset(&Local_sHandles, 0xA5, sizeof(Fluffer_Handles_t));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitHandles(&Local_sHandles, FlfrReadHandle, FlfrWriteHandle, FlfrEraseHandle));
+    TEST_ASSERT_TRUE(Local_sHandles.read_handle == FlfrReadHandle);
+    TEST_ASSERT_TRUE(Local_sHandles.write_handle == FlfrWriteHandle);
+    TEST_ASSERT_TRUE(Local_sHandles.erase_handle == FlfrEraseHandle);
+    TEST_ASSERT_NULL(Local_sHandles.load_handle);
+    TEST_ASSERT_NULL(Local_sHandles.save_handle);
+    TEST_ASSERT_NULL(Local_sHandles.map_handle);
+    TEST_ASSERT_NULL(Local_sHandles.begin_handle);
+    TEST_ASSERT_NULL(Local_sHandles.end_handle);
+    TEST_ASSERT_NULL(Local_sHandles.poll_handle);
+    TEST_ASSERT_NULL(Local_sHandles.crc_handle);
+
+    /*	02. null pointers	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enInitHandles(NULL, FlfrReadHandle, FlfrWriteHandle, FlfrEraseHandle));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enInitHandles(&Local_sHandles, NULL, FlfrWriteHandle, FlfrEraseHandle));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enInitHandles(&Local_sHandles, FlfrReadHandle, NULL, FlfrEraseHandle));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enInitHandles(&Local_sHandles, FlfrReadHandle, FlfrWriteHandle, NULL));
+}
+
 void setUp(void)
 {
 }
@@ -428,5 +462,6 @@ void test_fluffer(void)
 {
     UNITY_BEGIN();
     RUN_TEST(test_fluffer_basic_functions);
+    RUN_TEST(test_fluffer_basic_handles);
     UNITY_END();
 }
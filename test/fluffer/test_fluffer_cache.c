@@ -0,0 +1,193 @@
+/******************************************************************************
+ * @file      test_fluffer_cache.c
+ * @brief     Host tests of the write-back cache (FLUFFER_CACHE_WRITE_BACK):
+ *            entries are coalesced up to max dirty, written by a single write
+ *            handle call, flushed on demand, and kept in order with batch
+ *            writes. Runs on the host flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define CACHE_ELEMENT_SIZE			8
+#define CACHE_CAPACITY				8
+
+
+/*	write-back cache buffer	*/
+static uint8_t CACHE[CACHE_CAPACITY * CACHE_ELEMENT_SIZE];
+
+/*
+ * fluffer instance on the simulator (STM32F1 preset), 4 blocks of a page each, with a cache of
+ * CACHE_CAPACITY entries (none if u16Capacity is 0)
+ * */
+static void setup_cache(uint16_t u16Capacity, uint16_t u16MaxDirty)
+{
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    config_fluffer(&FlashSim_sPresetStm32f1, 4, 1, CACHE_ELEMENT_SIZE);
+    FLUFFER.cache.buffer = CACHE;
+    FLUFFER.cache.capacity = u16Capacity;
+    FLUFFER.cache.max_dirty = u16MaxDirty;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+    FlashSim_vidResetStats();
+}
+
+static void test_fluffer_cache_coalesce(void);
+static void test_fluffer_cache_flush(void);
+static void test_fluffer_cache_batch(void);
+static void test_fluffer_cache_none(void);
+
+/**
+ * Test scenario (max dirty 4):
+ * 01. write 3 entries, check nothing is written to memory & instance is still empty
+ * 02. write the 4th entry, check the 4 entries are written by a single write handle call
+ * 03. write 60 more entries (main buffer is cleaned up in between), check a write handle call per 4 entries
+ * 04. check entries are in order
+ * */
+static void test_fluffer_cache_coalesce(void)
+{
+    uint8_t Local_u8Empty;
+
+#if FLUFFER_CACHE_MODE != FLUFFER_CACHE_WRITE_BACK
+    TEST_IGNORE_MESSAGE("FLUFFER_CACHE_WRITE_BACK only");
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+    setup_cache(CACHE_CAPACITY, 4);
+
+    /*	01. cached	*/
+    write_entries(0, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->write_calls);
+    TEST_ASSERT_EQUAL_UINT16(3, FLUFFER.cache.dirty);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enIsEmpty(&FLUFFER, &Local_u8Empty));
+    TEST_ASSERT_TRUE(Local_u8Empty);
+
+    /*	02. max dirty	*/
+    write_entries(3, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->write_calls);
+    TEST_ASSERT_EQUAL_UINT16(0, FLUFFER.cache.dirty);
+
+    /*	03. more entries	*/
+    FlashSim_vidResetStats();
+    write_entries(4, 60);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    TEST_ASSERT_TRUE(FlashSim_psGetStats()->write_calls >= 15);
+    TEST_ASSERT_TRUE(FlashSim_psGetStats()->write_calls <= 17);
+
+    /*	04. order	*/
+    check_entries(0, 64);
+}
+
+/**
+ * Test scenario (max dirty 0, the whole cache):
+ * 01. write 5 entries, check nothing is written to memory
+ * 02. flush, check the 5 entries are written by a single write handle call
+ * 03. flush again, check nothing is written
+ * 04. check entries are in order
+ * */
+static void test_fluffer_cache_flush(void)
+{
+#if FLUFFER_CACHE_MODE != FLUFFER_CACHE_WRITE_BACK
+    TEST_IGNORE_MESSAGE("FLUFFER_CACHE_WRITE_BACK only");
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+    setup_cache(CACHE_CAPACITY, 0);
+
+    /*	01. cached	*/
+    write_entries(0, 5);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->write_calls);
+
+    /*	02. flush	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enFlush(&FLUFFER));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->write_calls);
+    TEST_ASSERT_EQUAL_UINT16(0, FLUFFER.cache.dirty);
+
+    /*	03. empty cache	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enFlush(&FLUFFER));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->write_calls);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enFlush(NULL));
+
+    /*	04. order	*/
+    check_entries(0, 5);
+}
+
+/**
+ * Test scenario (max dirty 0, the whole cache):
+ * 01. write 3 entries by Fluffer_enWriteEntry, then 4 entries by Fluffer_enWriteEntries
+ * 02. check cached entries were written first, & the cache is empty
+ * */
+static void test_fluffer_cache_batch(void)
+{
+    uint8_t Local_au8Entries[4 * CACHE_ELEMENT_SIZE];
+    uint16_t Local_u16Written;
+    uint16_t Local_u16Index;
+
+#if FLUFFER_CACHE_MODE != FLUFFER_CACHE_WRITE_BACK
+    TEST_IGNORE_MESSAGE("FLUFFER_CACHE_WRITE_BACK only");
+#endif	/*	FLUFFER_CACHE_MODE	*/
+
+    setup_cache(CACHE_CAPACITY, 0);
+
+    /*	01. single entries, then a batch	*/
+    write_entries(0, 3);
+
+    for(Local_u16Index = 0; Local_u16Index < 4; Local_u16Index++)
+    {
+        make_entry(&Local_au8Entries[Local_u16Index * CACHE_ELEMENT_SIZE], 3 + Local_u16Index);
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntries(&FLUFFER, Local_au8Entries, 4, &Local_u16Written));
+    TEST_ASSERT_EQUAL_UINT16(4, Local_u16Written);
+
+    /*	02. order	*/
+    TEST_ASSERT_EQUAL_UINT16(0, FLUFFER.cache.dirty);
+    check_entries(0, 7);
+}
+
+/**
+ * Test scenario (no cache, 0 capacity):
+ * 01. write 5 entries, check each is written by its own write handle call
+ * 02. check flush does nothing
+ * */
+static void test_fluffer_cache_none(void)
+{
+    setup_cache(0, 0);
+
+    /*	01. write through	*/
+    write_entries(0, 5);
+    TEST_ASSERT_EQUAL_UINT32(5, FlashSim_psGetStats()->write_calls);
+
+    /*	02. flush	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enFlush(&FLUFFER));
+    TEST_ASSERT_EQUAL_UINT32(5, FlashSim_psGetStats()->write_calls);
+    check_entries(0, 5);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_cache(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fluffer_cache_coalesce);
+    RUN_TEST(test_fluffer_cache_flush);
+    RUN_TEST(test_fluffer_cache_batch);
+    RUN_TEST(test_fluffer_cache_none);
+    UNITY_END();
+}
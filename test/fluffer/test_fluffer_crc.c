@@ -0,0 +1,263 @@
+/******************************************************************************
+ * @file      test_fluffer_crc.c
+ * @brief     Host tests of entries' CRCs (FLUFFER_CRC_ENTRY): the software CRC
+ *            matches the CRC unit, entries are read back by all read APIs with
+ *            either CRC, and a corrupt entry is reported by each of them.
+ *            Runs on the host flash memory simulator (SPI NOR, memory mapped)
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+#include <crc_unit.h>
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+
+#define CRC_ELEMENT_SIZE			13				/*	not a multiple of 4, the CRC's last word is padded	*/
+#define CRC_ENTRIES					40
+#define CRC_BATCH					8
+
+/*	STM32 CRC unit result of the single word 0x12345678	*/
+#define CRC_KNOWN_WORD_CRC			0xDF8A8A2BUL
+
+
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+
+/*
+ * fluffer instance on the erased simulator (memory mapped SPI NOR), u8Blocks blocks of a 4 KB sector each
+ * */
+static void setup_crc(uint8_t u8Blocks)
+{
+    FlashSim_Config_t Local_sConfig = FlashSim_sPresetSpiNor;
+
+    Local_sConfig.mapped = 1;
+    setup_fluffer(&Local_sConfig, u8Blocks, 1, CRC_ELEMENT_SIZE);
+}
+
+static void test_fluffer_crc_unit(void);
+static void test_fluffer_crc_read(void);
+static void test_fluffer_crc_corrupt(void);
+
+/**
+ * CRC unit against fluffer's software CRC:
+ * 01. CRC unit's result of a known word
+ * 02. write entries with the software CRC, each entry's stored CRC == CRC unit's result of its data
+ * */
+static void test_fluffer_crc_unit(void)
+{
+    const uint8_t Local_au8Word[4] = {0x78, 0x56, 0x34, 0x12};
+    const uint8_t * Local_pu8Record;
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Len;
+    uint16_t Local_u16Sequence;
+    uint32_t Local_u32Crc;
+
+    /*	01. known word	*/
+    CrcMock_vidClear();
+    CrcUnit_vidInitialize();
+    TEST_ASSERT_EQUAL_HEX32(CRC_KNOWN_WORD_CRC, CrcUnit_u32Calculate(Local_au8Word, sizeof(Local_au8Word)));
+
+    /*	02. software CRCs	*/
+    setup_crc(4);
+    write_entries(0, CRC_ENTRIES);
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+
+    for(Local_u16Sequence = 0; Local_u16Sequence < CRC_ENTRIES; Local_u16Sequence++)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Record, &Local_u16Len));
+        Local_u32Crc = (uint32_t)Local_pu8Record[CRC_ELEMENT_SIZE] | ((uint32_t)Local_pu8Record[CRC_ELEMENT_SIZE + 1] << 8) |
+                       ((uint32_t)Local_pu8Record[CRC_ELEMENT_SIZE + 2] << 16) | ((uint32_t)Local_pu8Record[CRC_ELEMENT_SIZE + 3] << 24);
+        TEST_ASSERT_EQUAL_HEX32(CrcUnit_u32Calculate(Local_pu8Record, CRC_ELEMENT_SIZE), Local_u32Crc);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, CrcMock_psGetStats()->violations);
+}
+
+/**
+ * For the software CRC, then the CRC unit's handle:
+ * 01. write entries by single writes & batches, past a clean up (entries & their CRCs are copied)
+ * 02. read entries by Fluffer_enReadEntry
+ * 03. read entries by Fluffer_enReadEntries, with a buffer of an entry (read through the entry buffer) & of a batch
+ * 04. read entries by Fluffer_enPeekEntry
+ * */
+static void test_fluffer_crc_read(void)
+{
+    uint8_t Local_au8Batch[CRC_BATCH * CRC_ELEMENT_SIZE];
+    uint8_t Local_au8Expected[CRC_ELEMENT_SIZE];
+    const uint8_t * Local_pu8Entry;
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Sequence;
+    uint16_t Local_u16First;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Index;
+    uint16_t Local_u16Max;
+    uint8_t Local_u8Handle;
+
+    for(Local_u8Handle = 0; Local_u8Handle < 2; Local_u8Handle++)
+    {
+        setup_crc(2);
+        CrcMock_vidClear();
+        CrcUnit_vidInitialize();
+        FLUFFER.handles.crc_handle = Local_u8Handle ? CrcUnit_u32Calculate : NULL;
+
+        /*	01. write & mark, until the main buffer was cleaned up	*/
+        for(Local_u16Sequence = 0, Local_u16Count = CRC_BATCH; Local_u16Sequence < (FLUFFER.context.size + CRC_ENTRIES); Local_u16Sequence += Local_u16Count)
+        {
+            /*	single entries & batches, in turns	*/
+            Local_u16Count = (Local_u16Count == 1) ? CRC_BATCH : 1;
+
+            for(Local_u16Index = 0; Local_u16Index < Local_u16Count; Local_u16Index++)
+            {
+                make_entry(&Local_au8Batch[Local_u16Index * CRC_ELEMENT_SIZE], Local_u16Sequence + Local_u16Index);
+            }
+
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntries(&FLUFFER, Local_au8Batch, Local_u16Count, &Local_u16Index));
+            TEST_ASSERT_EQUAL_UINT16(Local_u16Count, Local_u16Index);
+
+            while((FLUFFER.context.tail - FLUFFER.context.head) > CRC_ENTRIES)
+            {
+                TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER));
+            }
+        }
+
+        Local_u16First = (uint16_t)(Local_u16Sequence - CRC_ENTRIES);
+
+        /*	02. single reads	*/
+        check_entries(Local_u16First, CRC_ENTRIES);
+
+        /*	03. batch reads	*/
+        for(Local_u16Max = 1; Local_u16Max <= CRC_BATCH; Local_u16Max += CRC_BATCH - 1)
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+            Local_u16Sequence = Local_u16First;
+
+            while(Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Batch, Local_u16Max, &Local_u16Count) == FLUFFER_ERROR_NONE)
+            {
+                TEST_ASSERT_TRUE((Local_u16Count > 0) && (Local_u16Count <= Local_u16Max));
+
+                for(Local_u16Index = 0; Local_u16Index < Local_u16Count; Local_u16Index++)
+                {
+                    make_entry(Local_au8Expected, Local_u16Sequence++);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, &Local_au8Batch[Local_u16Index * CRC_ELEMENT_SIZE], CRC_ELEMENT_SIZE);
+                }
+            }
+
+            TEST_ASSERT_EQUAL_UINT16(Local_u16First + CRC_ENTRIES, Local_u16Sequence);
+        }
+
+        /*	04. peeks	*/
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+        Local_u16Sequence = Local_u16First;
+
+        while(Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Entry, &Local_u16Count) == FLUFFER_ERROR_NONE)
+        {
+            TEST_ASSERT_EQUAL_UINT16(CRC_ELEMENT_SIZE, Local_u16Count);
+            make_entry(Local_au8Expected, Local_u16Sequence++);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_pu8Entry, CRC_ELEMENT_SIZE);
+        }
+
+        TEST_ASSERT_EQUAL_UINT16(Local_u16First + CRC_ENTRIES, Local_u16Sequence);
+
+        /*	CRC unit is used by its handle only	*/
+        TEST_ASSERT_EQUAL_UINT32(0, CrcMock_psGetStats()->violations);
+        TEST_ASSERT_EQUAL(Local_u8Handle, !IS_ZERO(CrcMock_psGetStats()->words));
+        TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    }
+}
+
+/**
+ * 01. write entries, clear a bit of an entry's data in memory
+ * 02. Fluffer_enReadEntry: corrupt entry is reported & copied, reader moves past it, next entry is read
+ * 03. Fluffer_enReadEntries: batch stops before the corrupt entry, next call reports it alone, then reads go on
+ * 04. Fluffer_enPeekEntry: corrupt entry is reported, pointer is set
+ * */
+static void test_fluffer_crc_corrupt(void)
+{
+    uint8_t Local_au8Batch[CRC_BATCH * CRC_ELEMENT_SIZE];
+    uint8_t Local_au8Expected[CRC_ELEMENT_SIZE];
+    const uint8_t * Local_pu8Entry;
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Count;
+    uint8_t Local_u8Byte;
+
+    /*	01. write & corrupt entry 1 (top bit of its 2nd byte)	*/
+    setup_crc(4);
+    write_entries(0, CRC_BATCH);
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Entry, &Local_u16Count));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Entry, &Local_u16Count));
+    Local_u8Byte = Local_pu8Entry[1] & 0x7F;
+    TEST_ASSERT_NOT_EQUAL(Local_pu8Entry[1], Local_u8Byte);
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite((uint32_t)(Local_pu8Entry + 1 - FlashSim_pu8Map()), &Local_u8Byte, 1));
+
+    /*	02. single reads	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Batch));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_CRC, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Batch));
+    TEST_ASSERT_EQUAL_UINT8(Local_u8Byte, Local_au8Batch[1]);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Batch));
+    make_entry(Local_au8Expected, 2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_au8Batch, CRC_ELEMENT_SIZE);
+
+    /*	03. batch reads	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Batch, CRC_BATCH, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(1, Local_u16Count);
+    make_entry(Local_au8Expected, 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_au8Batch, CRC_ELEMENT_SIZE);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_CRC, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Batch, CRC_BATCH, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(1, Local_u16Count);
+    TEST_ASSERT_EQUAL_UINT8(Local_u8Byte, Local_au8Batch[1]);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Batch, CRC_BATCH, &Local_u16Count));
+    TEST_ASSERT_TRUE(Local_u16Count > 0);
+    make_entry(Local_au8Expected, 2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_au8Batch, CRC_ELEMENT_SIZE);
+
+    while(Local_sReader.id < FLUFFER.context.tail)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntries(&FLUFFER, &Local_sReader, Local_au8Batch, CRC_BATCH, &Local_u16Count));
+    }
+
+    /*	04. peeks	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Entry, &Local_u16Count));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_CRC, Fluffer_enPeekEntry(&FLUFFER, &Local_sReader, &Local_pu8Entry, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT8(Local_u8Byte, Local_pu8Entry[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, Local_sReader.id);
+}
+
+#endif	/*	FLUFFER_CRC_MODE	*/
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_crc(void)
+{
+    UNITY_BEGIN();
+#if FLUFFER_CRC_MODE == FLUFFER_CRC_ENTRY
+    RUN_TEST(test_fluffer_crc_unit);
+    RUN_TEST(test_fluffer_crc_read);
+    RUN_TEST(test_fluffer_crc_corrupt);
+#endif	/*	FLUFFER_CRC_MODE	*/
+    UNITY_END();
+}
@@ -38,6 +38,9 @@
 /*	emulated flash mmory	*/
 static uint8_t MEMORY[MEMORY_PAGES][MEMORY_PAGE_SIZE];
 
+/*	instance workspace, used with FLUFFER_WORKSPACE_INSTANCE	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(BASIC_TEST_ELEMENT_SIZE, MEMORY_WORD_SIZE, 64)];
+
 static Fluffer_Handle_Error_t FlfrReadHandle(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len)
 {
     uint8_t page_index = u32Offset / MEMORY_PAGE_SIZE;
@@ -58,17 +61,15 @@ static Fluffer_Handle_Error_t FlfrWriteHandle(uint32_t u32Offset, uint8_t * pu8D
     return FH_ERR_NONE;
 }
 
-static Fluffer_Handle_Error_t FlfrEraseHandle(uint8_t u8PageIndex)
+static Fluffer_Handle_Error_t FlfrEraseHandle(Fluffer_Page_t PageIndex)
 {
-    memset(&MEMORY[u8PageIndex], 0xFF, MEMORY_PAGE_SIZE);
+    memset(&MEMORY[PageIndex], 0xFF, MEMORY_PAGE_SIZE);
     return FH_ERR_NONE;
 }
 
 static void set_default_handles(Fluffer_t * psFluffer)
 {
-    psFluffer->handles.read_handle = FlfrReadHandle;
-    psFluffer->handles.write_handle = FlfrWriteHandle;
-    psFluffer->handles.erase_handle = FlfrEraseHandle;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitHandles(&psFluffer->handles, FlfrReadHandle, FlfrWriteHandle, FlfrEraseHandle));
 }
 
 /*
@@ -90,6 +91,8 @@ static void memcfg(Fluffer_t * psFluffer)
     psFluffer->cfg.start_page = 0;
     psFluffer->cfg.word_size = 2;
     psFluffer->cfg.element_size = BASIC_TEST_ELEMENT_SIZE;
+    psFluffer->workspace.buffer = WORKSPACE;
+    psFluffer->workspace.size = sizeof(WORKSPACE);
 }
 
 static void fill_buffer(uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Fill)
@@ -0,0 +1,313 @@
+/******************************************************************************
+ * @file      test_fluffer_power.c
+ * @brief     Host power cut injection tests: a producer & consumer loop is cut
+ *            after each single program (write handle call) or erase step, then
+ *            a new instance is mounted on the memory as left. Checks the mount
+ *            finishes or rolls back an interrupted clean up without purging the
+ *            memory, no unmarked entry is lost, and entries are written & read
+ *            on. Runs on the host flash memory simulator (STM32F103 preset,
+ *            SPI NOR preset with bitmap layout bit marks).
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define POWER_ELEMENT_SIZE			8
+#define POWER_PAGES					2				/*	pages per block	*/
+#define POWER_UNMARKED				24				/*	entries left unmarked by the consumer, copied by each clean up	*/
+#define POWER_BLOCK_FILLS			3				/*	main buffers filled by the loop, so it goes through a few clean ups	*/
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+#define POWER_MIN_BLOCKS			3				/*	ring needs a block to erase ahead of the written ones	*/
+#else
+#define POWER_MIN_BLOCKS			2
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+/*	brands written by fluffer: main buffer, and block entries are copied into (clean up in progress)	*/
+#define POWER_MAIN_BRAND			0x00
+#define POWER_COPY_BRAND			0xF0
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+#define POWER_PRESET				FlashSim_sPresetSpiNor	/*	bit marks program a word more than once, STM32F1 flash can't	*/
+#else
+#define POWER_PRESET				FlashSim_sPresetStm32f1
+#endif	/*	FLUFFER_LAYOUT	*/
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+#define POWER_BRAND_OFFSET			4				/*	brand follows the block's erase count	*/
+#else
+#define POWER_BRAND_OFFSET			0
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+
+/*	program & erase steps done since the loop started	*/
+static uint32_t STEPS = 0;
+
+/*	last step done before the power cut, 0 if power is never cut	*/
+static uint32_t CUT_STEP = 0;
+
+/*	1 once power is cut, following program & erase steps are dropped	*/
+static uint8_t POWER_OFF = 0;
+
+/*	producer & consumer progress acknowledged before the power cut	*/
+typedef struct power_progress_t {
+    uint16_t written;				/*	entries whose write returned	*/
+    uint16_t marked;				/*	entries whose mark returned	*/
+} Power_Progress_t;
+
+/*
+ * take a program or erase step, returns 1 if it's done, 0 if it's dropped (power is off)
+ * */
+static uint8_t take_step(void)
+{
+    if(POWER_OFF)
+    {
+        return 0;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    STEPS++;
+    POWER_OFF = (STEPS == CUT_STEP);
+
+    return 1;
+}
+
+/*
+ * write handle, each call is a single step
+ * */
+static Fluffer_Handle_Error_t power_write(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len)
+{
+    return take_step() ? FlashSim_enWrite(u32Offset, pu8Data, u16Len) : FH_ERR_NONE;
+}
+
+/*
+ * erase handle, each call is a single step
+ * */
+static Fluffer_Handle_Error_t power_erase(Fluffer_Page_t PageIndex)
+{
+    return take_step() ? FlashSim_enErase(PageIndex) : FH_ERR_NONE;
+}
+
+/*
+ * fluffer instance on the simulator, u8Blocks blocks of POWER_PAGES pages each. Memory is erased only if
+ * u8Erase is set, otherwise the instance is mounted on the memory as left by the power cut
+ * */
+static void setup_power(uint8_t u8Blocks, uint8_t u8Erase)
+{
+    FlashSim_Config_t Local_sMemory = POWER_PRESET;
+
+    /*	mapped, so blocks' brands can be checked in place	*/
+    Local_sMemory.mapped = 1;
+
+    if(u8Erase)
+    {
+        TEST_ASSERT_TRUE(FlashSim_u8Init(&Local_sMemory));
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    config_fluffer(&Local_sMemory, u8Blocks, POWER_PAGES, POWER_ELEMENT_SIZE);
+    FLUFFER.handles.write_handle = power_write;
+    FLUFFER.handles.erase_handle = power_erase;
+
+    POWER_OFF = 0;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+}
+
+/*
+ * producer & consumer loop from the given progress on, until u16Last is written or power is cut: an entry
+ * is written, entries are marked down to POWER_UNMARKED, then a clean up slice is done. Returns progress
+ * acknowledged before the cut
+ * */
+static Power_Progress_t run_loop(Power_Progress_t sProgress, uint16_t u16Last)
+{
+    uint8_t Local_au8Entry[POWER_ELEMENT_SIZE];
+    Power_Progress_t Local_sProgress = sProgress;
+
+    while(!POWER_OFF && (Local_sProgress.written <= u16Last))
+    {
+        make_entry(Local_au8Entry, Local_sProgress.written);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8Entry));
+        Local_sProgress.written += !POWER_OFF;
+
+        while(!POWER_OFF && ((Local_sProgress.written - Local_sProgress.marked) > POWER_UNMARKED))
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER));
+            Local_sProgress.marked += !POWER_OFF;
+        }
+
+        if(!POWER_OFF)
+        {
+            Fluffer_enService(&FLUFFER, 1);
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    return Local_sProgress;
+}
+
+/*
+ * read all unmarked entries, check they're consecutive, from sProgress.marked (or the next one, if its mark
+ * was cut) to the last written (or the next one, if its write was cut). Returns progress kept in memory
+ * */
+static Power_Progress_t check_progress(Power_Progress_t sProgress)
+{
+    uint8_t Local_au8Read[POWER_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    Power_Progress_t Local_sKept;
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+
+    /*	no unmarked entry, at most the last written entry was marked by a cut mark	*/
+    if(Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Read) == FLUFFER_ERROR_EMPTY)
+    {
+        TEST_ASSERT_TRUE(sProgress.written <= (sProgress.marked + 1));
+        Local_sKept.written = sProgress.written;
+        Local_sKept.marked = sProgress.written;
+
+        return Local_sKept;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    Local_sKept.marked = (uint16_t)((Local_au8Read[0] << 8) | Local_au8Read[POWER_ELEMENT_SIZE - 1]);
+    TEST_ASSERT_TRUE((Local_sKept.marked == sProgress.marked) || (Local_sKept.marked == (sProgress.marked + 1)));
+
+    Local_sKept.written = (uint16_t)(Local_sKept.marked + (FLUFFER.context.tail - FLUFFER.context.head));
+    check_entries(Local_sKept.marked, Local_sKept.written - Local_sKept.marked);
+    TEST_ASSERT_TRUE((Local_sKept.written == sProgress.written) || (Local_sKept.written == (sProgress.written + 1)));
+
+    return Local_sKept;
+}
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+
+/*
+ * count blocks whose brand word (first & last byte) is filled with the given brand
+ * */
+static uint8_t count_brands(uint8_t u8Blocks, uint8_t u8Brand)
+{
+    const uint8_t * Local_pu8Map = FlashSim_pu8Map();
+    uint32_t Local_u32Block;
+    uint8_t Local_u8Count = 0;
+
+    for(Local_u32Block = 0; Local_u32Block < u8Blocks; Local_u32Block++)
+    {
+        Local_u8Count += (Local_pu8Map[Local_u32Block * POWER_PAGES * FLUFFER.cfg.page_size + POWER_BRAND_OFFSET] == u8Brand) &&
+                         (Local_pu8Map[Local_u32Block * POWER_PAGES * FLUFFER.cfg.page_size + POWER_BRAND_OFFSET + FLUFFER.cfg.word_size - 1] == u8Brand);
+    }
+
+    return Local_u8Count;
+}
+
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+static void test_fluffer_power_cut(void);
+
+/**
+ * For 3 blocks, then 2 blocks (copy mode only, each block follows the other), count the steps of a loop filling
+ * POWER_BLOCK_FILLS main buffers. Then for each step:
+ * 01. run the loop on an erased memory, cut power right after the step
+ * 02. mount a new instance on the memory: no memory purge (fewer erases than allocated pages)
+ * 03. unmarked entries are kept (marks & writes acknowledged before the cut are kept)
+ * 04. write & mark a main buffer's worth of entries, all entries are read back
+ * In copy mode, cuts must have left both a partial copy (copy brand next to the main buffer) and a
+ * finished copy (copy brand only) to the mount
+ * */
+static void test_fluffer_power_cut(void)
+{
+    const Power_Progress_t Local_sStart = {0, 0};
+    Power_Progress_t Local_sProgress;
+    uint32_t Local_u32Steps;
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+    uint32_t Local_u32RolledBack = 0;
+    uint32_t Local_u32Finished = 0;
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+    uint16_t Local_u16Last;
+    uint8_t Local_u8Blocks;
+
+    for(Local_u8Blocks = 3; Local_u8Blocks >= POWER_MIN_BLOCKS; Local_u8Blocks--)
+    {
+        /*	steps of the whole loop	*/
+        setup_power(Local_u8Blocks, 1);
+        Local_u16Last = (uint16_t)(POWER_BLOCK_FILLS * FLUFFER.context.size);
+        STEPS = 0;
+        CUT_STEP = 0;
+        run_loop(Local_sStart, Local_u16Last);
+        Local_u32Steps = STEPS;
+
+        for(CUT_STEP = 1; CUT_STEP <= Local_u32Steps; CUT_STEP++)
+        {
+            /*	01. cut	*/
+            setup_power(Local_u8Blocks, 1);
+            STEPS = 0;
+            Local_sProgress = run_loop(Local_sStart, Local_u16Last);
+            TEST_ASSERT_TRUE(POWER_OFF);
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+            Local_u32RolledBack += (count_brands(Local_u8Blocks, POWER_COPY_BRAND) == 1) && (count_brands(Local_u8Blocks, POWER_MAIN_BRAND) == 1);
+            Local_u32Finished += (count_brands(Local_u8Blocks, POWER_COPY_BRAND) == 1) && (count_brands(Local_u8Blocks, POWER_MAIN_BRAND) == 0);
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+            /*	02. mount	*/
+            FlashSim_vidResetStats();
+            setup_power(Local_u8Blocks, 0);
+            TEST_ASSERT_TRUE(FlashSim_psGetStats()->erases < (Local_u8Blocks * POWER_PAGES));
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+            TEST_ASSERT_EQUAL_UINT8(1, count_brands(Local_u8Blocks, POWER_MAIN_BRAND));
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+
+            /*	03. kept entries	*/
+            Local_sProgress = check_progress(Local_sProgress);
+
+            /*	04. write on, from the entries kept	*/
+            Local_sProgress = run_loop(Local_sProgress, (uint16_t)(Local_sProgress.written + FLUFFER.context.size));
+            check_progress(Local_sProgress);
+            TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+        }
+    }
+
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_COPY
+    /*	cuts hit both clean up steps: while copying, and after the copy was complete	*/
+    TEST_ASSERT_TRUE(Local_u32RolledBack > 0);
+    TEST_ASSERT_TRUE(Local_u32Finished > 0);
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_power(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fluffer_power_cut);
+    UNITY_END();
+}
@@ -0,0 +1,346 @@
+/******************************************************************************
+ * @file      test_fluffer_queue.c
+ * @brief     Host tests of fluffer queue: initialization, order across the
+ *            slots' wrap, overflow policies, pushes from a simulated ISR during
+ *            a drain, and flush. Runs on the host flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer.h>
+#include <fluffer_queue.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define QUEUE_ELEMENT_SIZE			8
+#define QUEUE_CAPACITY				16
+#define QUEUE_BATCH_SIZE			4
+
+#define ISR_ENTRIES					20
+
+
+/*	queue buffers	*/
+static uint8_t SLOTS[QUEUE_CAPACITY * QUEUE_ELEMENT_SIZE];
+static uint8_t BATCH[QUEUE_BATCH_SIZE * QUEUE_ELEMENT_SIZE];
+
+static Fluffer_Queue_t QUEUE;
+
+/*	entries left to push by the simulated ISR, and its next entry's sequence number	*/
+static uint16_t ISR_LEFT;
+static uint16_t ISR_SEQUENCE;
+
+/*	saved warm context	*/
+static uint8_t CONTEXT[64];
+static uint16_t CONTEXT_SAVES;
+
+/*	write handle that interrupts itself, pushing an entry (as an ISR would) on each call	*/
+static Fluffer_Handle_Error_t IsrWriteHandle(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+
+    if(!IS_ZERO(ISR_LEFT))
+    {
+        make_entry(Local_au8Entry, ISR_SEQUENCE++);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+        ISR_LEFT--;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return FlashSim_enWrite(u32Offset, pu8Data, u16Len);
+}
+
+static Fluffer_Handle_Error_t ContextLoadHandle(uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    if(IS_ZERO(CONTEXT_SAVES) || (u16Len > sizeof(CONTEXT)))
+    {
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    memcpy(pu8Buffer, CONTEXT, u16Len);
+    return FH_ERR_NONE;
+}
+
+static Fluffer_Handle_Error_t ContextSaveHandle(uint8_t * pu8Data, uint16_t u16Len)
+{
+    if(u16Len > sizeof(CONTEXT))
+    {
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    memcpy(CONTEXT, pu8Data, u16Len);
+    CONTEXT_SAVES++;
+    return FH_ERR_NONE;
+}
+
+/*
+ * fluffer instance on the simulator (STM32F1 preset), 4 blocks of a page each, and a queue in front of it
+ * */
+static void setup_queue(uint16_t u16Capacity, uint16_t u16BatchSize, Fluffer_Queue_Policy_t enPolicy)
+{
+    setup_fluffer(&FlashSim_sPresetStm32f1, 4, 1, QUEUE_ELEMENT_SIZE);
+
+    memset(&QUEUE, 0x00, sizeof(Fluffer_Queue_t));
+    QUEUE.fluffer = &FLUFFER;
+    QUEUE.slots = SLOTS;
+    QUEUE.batch = BATCH;
+    QUEUE.capacity = u16Capacity;
+    QUEUE.batch_size = u16BatchSize;
+    QUEUE.policy = enPolicy;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueInitialize(&QUEUE));
+}
+
+static void test_fluffer_queue_init(void);
+static void test_fluffer_queue_order(void);
+static void test_fluffer_queue_drop_newest(void);
+static void test_fluffer_queue_drop_oldest(void);
+static void test_fluffer_queue_isr(void);
+static void test_fluffer_queue_flush(void);
+
+/**
+ * Test scenario:
+ * 01. check null pointers are rejected
+ * 02. check capacity that isn't a power of 2, 0 batch size & invalid policy are rejected
+ * 03. check a valid queue is empty after initialization
+ * */
+static void test_fluffer_queue_init(void)
+{
+    uint16_t Local_u16Count;
+
+    setup_queue(QUEUE_CAPACITY, QUEUE_BATCH_SIZE, FLUFFER_QUEUE_DROP_NEWEST);
+
+    /*	01. null pointers	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enQueueInitialize(NULL));
+    QUEUE.batch = NULL;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enQueueInitialize(&QUEUE));
+    QUEUE.batch = BATCH;
+
+    /*	02. parameters	*/
+    QUEUE.capacity = 12;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enQueueInitialize(&QUEUE));
+    QUEUE.capacity = 0;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enQueueInitialize(&QUEUE));
+    QUEUE.capacity = QUEUE_CAPACITY;
+    QUEUE.batch_size = 0;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enQueueInitialize(&QUEUE));
+    QUEUE.batch_size = QUEUE_BATCH_SIZE;
+    QUEUE.policy = (Fluffer_Queue_Policy_t)2;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enQueueInitialize(&QUEUE));
+    QUEUE.policy = FLUFFER_QUEUE_DROP_NEWEST;
+
+    /*	03. empty	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueInitialize(&QUEUE));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueCount(&QUEUE, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(0, Local_u16Count);
+}
+
+/**
+ * Test scenario (capacity 8, batch of 3 entries):
+ * 01. push 6 entries & drain them, 5 times, so slots wrap & batches are split at the slots' end
+ * 02. check a drain's maximum is respected
+ * 03. check fluffer instance holds all entries in push order
+ * */
+static void test_fluffer_queue_order(void)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+    uint16_t Local_u16Sequence = 0;
+    uint16_t Local_u16Drained;
+    uint16_t Local_u16Round;
+    uint16_t Local_u16Index;
+
+    setup_queue(8, 3, FLUFFER_QUEUE_DROP_NEWEST);
+
+    /*	01. push & drain	*/
+    for(Local_u16Round = 0; Local_u16Round < 5; Local_u16Round++)
+    {
+        for(Local_u16Index = 0; Local_u16Index < 6; Local_u16Index++)
+        {
+            make_entry(Local_au8Entry, Local_u16Sequence++);
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+        }
+
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, UINT16_MAX, &Local_u16Drained));
+        TEST_ASSERT_EQUAL_UINT16(6, Local_u16Drained);
+    }
+
+    /*	02. maximum	*/
+    for(Local_u16Index = 0; Local_u16Index < 5; Local_u16Index++)
+    {
+        make_entry(Local_au8Entry, Local_u16Sequence++);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, 4, &Local_u16Drained));
+    TEST_ASSERT_EQUAL_UINT16(4, Local_u16Drained);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, 4, &Local_u16Drained));
+    TEST_ASSERT_EQUAL_UINT16(1, Local_u16Drained);
+
+    /*	03. order	*/
+    TEST_ASSERT_EQUAL_UINT32(0, QUEUE.dropped);
+    check_entries(0, Local_u16Sequence);
+}
+
+/**
+ * Test scenario (capacity 8, FLUFFER_QUEUE_DROP_NEWEST):
+ * 01. push 11 entries, check the last 3 pushes return FLUFFER_ERROR_FULL & are counted as dropped
+ * 02. drain, check fluffer instance holds the first 8 entries
+ * */
+static void test_fluffer_queue_drop_newest(void)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+    uint16_t Local_u16Drained;
+    uint16_t Local_u16Index;
+
+    setup_queue(8, QUEUE_BATCH_SIZE, FLUFFER_QUEUE_DROP_NEWEST);
+
+    /*	01. overflow	*/
+    for(Local_u16Index = 0; Local_u16Index < 11; Local_u16Index++)
+    {
+        make_entry(Local_au8Entry, Local_u16Index);
+        TEST_ASSERT_EQUAL((Local_u16Index < 8) ? FLUFFER_ERROR_NONE : FLUFFER_ERROR_FULL, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, QUEUE.dropped);
+
+    /*	02. drain	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, UINT16_MAX, &Local_u16Drained));
+    TEST_ASSERT_EQUAL_UINT16(8, Local_u16Drained);
+    check_entries(0, 8);
+}
+
+/**
+ * Test scenario (capacity 8, FLUFFER_QUEUE_DROP_OLDEST):
+ * 01. push 11 entries, check all pushes succeed, 3 entries are counted as dropped & queue is full
+ * 02. drain, check fluffer instance holds the last 8 entries
+ * */
+static void test_fluffer_queue_drop_oldest(void)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+    uint16_t Local_u16Drained;
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Index;
+
+    setup_queue(8, QUEUE_BATCH_SIZE, FLUFFER_QUEUE_DROP_OLDEST);
+
+    /*	01. overflow	*/
+    for(Local_u16Index = 0; Local_u16Index < 11; Local_u16Index++)
+    {
+        make_entry(Local_au8Entry, Local_u16Index);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, QUEUE.dropped);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueCount(&QUEUE, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(8, Local_u16Count);
+
+    /*	02. drain	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, UINT16_MAX, &Local_u16Drained));
+    TEST_ASSERT_EQUAL_UINT16(8, Local_u16Drained);
+    check_entries(3, 8);
+}
+
+/**
+ * Test scenario (capacity 16, batch of 4 entries):
+ * 01. push 8 entries
+ * 02. drain, while each write handle call pushes an entry (simulated ISR) until ISR_ENTRIES are pushed
+ * 03. check all entries are drained in push order, none dropped
+ * */
+static void test_fluffer_queue_isr(void)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+    uint16_t Local_u16Drained;
+    uint16_t Local_u16Count;
+
+    setup_queue(QUEUE_CAPACITY, QUEUE_BATCH_SIZE, FLUFFER_QUEUE_DROP_NEWEST);
+    FLUFFER.handles.write_handle = IsrWriteHandle;
+
+    /*	01. push	*/
+    for(ISR_SEQUENCE = 0; ISR_SEQUENCE < 8; ISR_SEQUENCE++)
+    {
+        make_entry(Local_au8Entry, ISR_SEQUENCE);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+    }
+
+    /*	02. drain with interrupts	*/
+    ISR_LEFT = ISR_ENTRIES;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueDrain(&QUEUE, UINT16_MAX, &Local_u16Drained));
+    TEST_ASSERT_EQUAL_UINT16(0, ISR_LEFT);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueCount(&QUEUE, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(0, Local_u16Count);
+
+    /*	03. check	*/
+    TEST_ASSERT_EQUAL_UINT16(8 + ISR_ENTRIES, Local_u16Drained);
+    TEST_ASSERT_EQUAL_UINT32(0, QUEUE.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    check_entries(0, 8 + ISR_ENTRIES);
+}
+
+/**
+ * Test scenario:
+ * 01. set load & save handles, push 10 entries
+ * 02. flush, check queue is empty & warm context is saved once (never without FLUFFER_CONTEXT_WARM)
+ * 03. check fluffer instance holds all entries
+ * */
+static void test_fluffer_queue_flush(void)
+{
+    uint8_t Local_au8Entry[QUEUE_ELEMENT_SIZE];
+    uint16_t Local_u16Count;
+    uint16_t Local_u16Index;
+
+    setup_queue(QUEUE_CAPACITY, QUEUE_BATCH_SIZE, FLUFFER_QUEUE_DROP_NEWEST);
+
+    /*	01. push	*/
+    CONTEXT_SAVES = 0;
+    FLUFFER.handles.load_handle = ContextLoadHandle;
+    FLUFFER.handles.save_handle = ContextSaveHandle;
+
+    for(Local_u16Index = 0; Local_u16Index < 10; Local_u16Index++)
+    {
+        make_entry(Local_au8Entry, Local_u16Index);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueuePush(&QUEUE, Local_au8Entry));
+    }
+
+    /*	02. flush	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueFlush(&QUEUE));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enQueueCount(&QUEUE, &Local_u16Count));
+    TEST_ASSERT_EQUAL_UINT16(0, Local_u16Count);
+#if FLUFFER_CONTEXT_MODE == FLUFFER_CONTEXT_WARM
+    TEST_ASSERT_EQUAL_UINT16(1, CONTEXT_SAVES);
+#else
+    TEST_ASSERT_EQUAL_UINT16(0, CONTEXT_SAVES);
+#endif	/*	FLUFFER_CONTEXT_MODE	*/
+
+    /*	03. check	*/
+    check_entries(0, 10);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_queue(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fluffer_queue_init);
+    RUN_TEST(test_fluffer_queue_order);
+    RUN_TEST(test_fluffer_queue_drop_newest);
+    RUN_TEST(test_fluffer_queue_drop_oldest);
+    RUN_TEST(test_fluffer_queue_isr);
+    RUN_TEST(test_fluffer_queue_flush);
+    UNITY_END();
+}
@@ -0,0 +1,300 @@
+/******************************************************************************
+ * @file      test_fluffer_states.c
+ * @brief     Host tests of multi-state marks (FLUFFER_MARK_STATES > 2): entries
+ *            are advanced through intermediate states by programming only the
+ *            bits each state clears, states survive a re-initialization and
+ *            are kept when entries are copied by a clean up. Runs on the host
+ *            flash memory simulator.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define STATES_ELEMENT_SIZE			8
+#define STATES_SENT					1
+#define STATES_ACKED				(FLUFFER_MARK_STATES - 2)
+
+
+#if FLUFFER_MARK_STATES > 2
+/*
+ * advance u16Count entries, starting from the u16Skip'th unmarked entry, to the given state
+ * */
+static void advance_entries(uint16_t u16Skip, uint16_t u16Count, uint8_t u8State)
+{
+    Fluffer_Reader_t Local_sReader;
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    Local_sReader.id += u16Skip;
+
+    while(u16Count--)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enAdvanceEntry(&FLUFFER, &Local_sReader, u8State));
+    }
+}
+
+/*
+ * check unmarked entries' sequence numbers start from u16First, and the first entries are in the given
+ * states: u16Acked entries acked, then u16Sent entries sent, the rest are written
+ * */
+static void check_states(uint16_t u16First, uint16_t u16Count, uint16_t u16Acked, uint16_t u16Sent)
+{
+    uint8_t Local_au8Read[STATES_ELEMENT_SIZE];
+    uint8_t Local_au8Expected[STATES_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Index;
+    uint8_t Local_u8State;
+    uint8_t Local_u8Expected;
+
+    TEST_ASSERT_EQUAL_UINT16(u16Count, FLUFFER.context.tail - FLUFFER.context.head);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+
+    for(Local_u16Index = 0; Local_u16Index < u16Count; Local_u16Index++)
+    {
+        Local_u8Expected = (Local_u16Index < u16Acked) ? STATES_ACKED :
+                           (Local_u16Index < (u16Acked + u16Sent)) ? STATES_SENT : FLUFFER_ENTRY_STATE_WRITTEN;
+
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, &Local_u8State));
+        TEST_ASSERT_EQUAL_UINT8(Local_u8Expected, Local_u8State);
+
+        make_entry(Local_au8Expected, u16First + Local_u16Index);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Read));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_au8Read, STATES_ELEMENT_SIZE);
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, &Local_u8State));
+}
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+static void test_fluffer_states_advance(void);
+static void test_fluffer_states_remount(void);
+static void test_fluffer_states_cleanup(void);
+static void test_fluffer_states_once(void);
+static void test_fluffer_states_errors(void);
+
+/**
+ * Test scenario (SPI NOR, any bit can be cleared):
+ * 01. write 10 entries, advance 6 entries to sent, then 3 of them to acked
+ * 02. check states, each advance is a single write handle call of a mark
+ * 03. advance acked entries to sent, check nothing is written & reader moves
+ * 04. mark 2 entries, check remaining states
+ * */
+static void test_fluffer_states_advance(void)
+{
+#if FLUFFER_MARK_STATES > 2
+    Fluffer_Reader_t Local_sReader;
+
+    setup_fluffer(&FlashSim_sPresetSpiNor, 4, 1, STATES_ELEMENT_SIZE);
+
+    /*	01. advance	*/
+    write_entries(0, 10);
+    FlashSim_vidResetStats();
+    advance_entries(0, 6, STATES_SENT);
+    advance_entries(0, 3, STATES_ACKED);
+
+    /*	02. states	*/
+    TEST_ASSERT_EQUAL_UINT32((STATES_ACKED == STATES_SENT) ? 6 : 9, FlashSim_psGetStats()->write_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    check_states(0, 10, 3, 3);
+
+    /*	03. states aren't cleared back	*/
+    FlashSim_vidResetStats();
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enAdvanceEntry(&FLUFFER, &Local_sReader, STATES_SENT));
+    TEST_ASSERT_EQUAL_UINT16(FLUFFER.context.head + 1, Local_sReader.id);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->write_calls);
+
+    /*	04. marked entries are removed	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, 2));
+    check_states(2, 8, 1, 3);
+#else
+    TEST_IGNORE_MESSAGE("FLUFFER_MARK_STATES > 2 only");
+#endif	/*	FLUFFER_MARK_STATES	*/
+}
+
+/**
+ * Test scenario (SPI NOR):
+ * 01. write 20 entries, mark 5, advance 4 to acked & 6 more to sent
+ * 02. re-initialize the instance, check head, tail & states are recovered
+ * */
+static void test_fluffer_states_remount(void)
+{
+#if FLUFFER_MARK_STATES > 2
+    uint16_t Local_u16Head;
+    uint16_t Local_u16Tail;
+
+    setup_fluffer(&FlashSim_sPresetSpiNor, 4, 1, STATES_ELEMENT_SIZE);
+
+    /*	01. states	*/
+    write_entries(0, 20);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, 5));
+    advance_entries(0, 10, STATES_SENT);
+    advance_entries(0, 4, STATES_ACKED);
+    Local_u16Head = FLUFFER.context.head;
+    Local_u16Tail = FLUFFER.context.tail;
+
+    /*	02. re-initialize	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+    TEST_ASSERT_EQUAL_UINT16(Local_u16Head, FLUFFER.context.head);
+    TEST_ASSERT_EQUAL_UINT16(Local_u16Tail, FLUFFER.context.tail);
+    check_states(5, 15, 4, 6);
+#else
+    TEST_IGNORE_MESSAGE("FLUFFER_MARK_STATES > 2 only");
+#endif	/*	FLUFFER_MARK_STATES	*/
+}
+
+/**
+ * Test scenario (SPI NOR):
+ * 01. write 100 entries, mark 20, advance 30 to sent
+ * 02. write entries until the main buffer is cleaned up (the tail moves into another block with the ring buffer),
+ *     with the incremental clean up, advance 10 more entries to sent once they're copied
+ * 03. check states are kept
+ * */
+static void test_fluffer_states_cleanup(void)
+{
+#if FLUFFER_MARK_STATES > 2
+    uint16_t Local_u16Written = 100;
+    uint16_t Local_u16Sent = 30;
+    uint16_t Local_u16First;
+    uint8_t Local_u8Block;
+
+    setup_fluffer(&FlashSim_sPresetSpiNor, 4, 1, STATES_ELEMENT_SIZE);
+
+    /*	01. states	*/
+    write_entries(0, 100);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, 20));
+    advance_entries(0, Local_u16Sent, STATES_SENT);
+    Local_u8Block = FLUFFER.context.main_buffer;
+
+    /*	02. clean up	*/
+#if FLUFFER_BUFFER_MODE == FLUFFER_BUFFER_RING
+    (void)Local_u8Block;
+
+    while(FLUFFER.context.tail <= FLUFFER.context.size)
+#else
+    while(FLUFFER.context.main_buffer == Local_u8Block)
+#endif	/*	FLUFFER_BUFFER_MODE	*/
+    {
+        write_entries(Local_u16Written, 1);
+        Local_u16Written++;
+
+#if FLUFFER_CLEANUP_MODE == FLUFFER_CLEANUP_INCREMENTAL
+        if((FLUFFER.cleanup.state == FLUFFER_CLEANUP_COPY) && (FLUFFER.cleanup.next_id > (FLUFFER.context.head + 40)) && (Local_u16Sent == 30))
+        {
+            /*	copied entries are advanced in both blocks	*/
+            advance_entries(Local_u16Sent, 10, STATES_SENT);
+            Local_u16Sent += 10;
+        }
+        else
+        {
+            (void)Fluffer_enService(&FLUFFER, 1);
+        }
+#endif	/*	FLUFFER_CLEANUP_MODE	*/
+    }
+
+    /*	03. states, oldest entries may be dropped to leave FLUFFER_EVICT_CHUNK free entries	*/
+    Local_u16First = Local_u16Written - (FLUFFER.context.tail - FLUFFER.context.head);
+    TEST_ASSERT_TRUE(Local_u16First >= 20);
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    check_states(Local_u16First, Local_u16Written - Local_u16First, 0, ((20 + Local_u16Sent) > Local_u16First) ? (20 + Local_u16Sent - Local_u16First) : 0);
+#else
+    TEST_IGNORE_MESSAGE("FLUFFER_MARK_STATES > 2 only");
+#endif	/*	FLUFFER_MARK_STATES	*/
+}
+
+/**
+ * Test scenario (STM32F1, a half word is programmed once, unless it's cleared to 0):
+ * 01. write 10 entries, advance 5 to sent, mark 5
+ * 02. check states, and no illegal program
+ * */
+static void test_fluffer_states_once(void)
+{
+#if FLUFFER_MARK_STATES > 2
+    setup_fluffer(&FlashSim_sPresetStm32f1, 4, 1, STATES_ELEMENT_SIZE);
+
+    /*	01. sent, then marked	*/
+    write_entries(0, 10);
+    advance_entries(0, 5, STATES_SENT);
+    check_states(0, 10, 0, 5);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(&FLUFFER, 5));
+
+    /*	02. states	*/
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+    check_states(5, 5, 0, 0);
+#else
+    TEST_IGNORE_MESSAGE("FLUFFER_MARK_STATES > 2 only");
+#endif	/*	FLUFFER_MARK_STATES	*/
+}
+
+/**
+ * Test scenario:
+ * 01. check null pointers
+ * 02. check written & marked states can't be advanced to
+ * 03. check reader out of unmarked entries
+ * */
+static void test_fluffer_states_errors(void)
+{
+    Fluffer_Reader_t Local_sReader;
+    uint8_t Local_u8State;
+
+    setup_fluffer(&FlashSim_sPresetSpiNor, 4, 1, STATES_ELEMENT_SIZE);
+    write_entries(0, 3);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+
+    /*	01. null pointers	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enGetEntryState(NULL, &Local_sReader, &Local_u8State));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enGetEntryState(&FLUFFER, NULL, &Local_u8State));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, NULL));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enAdvanceEntry(NULL, &Local_sReader, 1));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enAdvanceEntry(&FLUFFER, NULL, 1));
+
+    /*	02. written & marked	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enAdvanceEntry(&FLUFFER, &Local_sReader, FLUFFER_ENTRY_STATE_WRITTEN));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enAdvanceEntry(&FLUFFER, &Local_sReader, FLUFFER_ENTRY_STATE_MARKED));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, &Local_u8State));
+    TEST_ASSERT_EQUAL_UINT8(FLUFFER_ENTRY_STATE_WRITTEN, Local_u8State);
+
+    /*	03. marked entry & tail	*/
+    Local_sReader.id = FLUFFER.context.head - 1;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, &Local_u8State));
+    Local_sReader.id = FLUFFER.context.tail;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enGetEntryState(&FLUFFER, &Local_sReader, &Local_u8State));
+
+#if FLUFFER_MARK_STATES > 2
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enAdvanceEntry(&FLUFFER, &Local_sReader, STATES_SENT));
+#endif	/*	FLUFFER_MARK_STATES	*/
+
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->violations);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_states(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fluffer_states_advance);
+    RUN_TEST(test_fluffer_states_remount);
+    RUN_TEST(test_fluffer_states_cleanup);
+    RUN_TEST(test_fluffer_states_once);
+    RUN_TEST(test_fluffer_states_errors);
+    UNITY_END();
+}
@@ -0,0 +1,267 @@
+/******************************************************************************
+ * @file      test_fluffer_wear.c
+ * @brief     Host tests of blocks' erase counts (FLUFFER_WEAR_LEVEL): clean ups
+ *            copy entries into the least worn block, erase counts match the
+ *            memory's page erases & are kept across mounts, worn blocks are
+ *            skipped. Runs on the host flash memory simulator (STM32F1)
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer_config.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+#include <test_fluffer.h>
+
+
+#define WEAR_ELEMENT_SIZE			8
+#define WEAR_BLOCKS					4
+#define WEAR_PAGES					2				/*	pages per block	*/
+#define WEAR_UNMARKED				24				/*	entries left unmarked by the consumer, copied by each clean up	*/
+#define WEAR_CLEANUPS				40
+#define WEAR_WORN_COUNT				100				/*	erase count of the worn blocks, programmed before the first mount	*/
+
+
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+
+/*
+ * fluffer instance mounted on the simulator's content, WEAR_BLOCKS blocks of WEAR_PAGES pages each
+ * */
+static void mount_fluffer(void)
+{
+    config_fluffer(&FlashSim_sPresetStm32f1, WEAR_BLOCKS, WEAR_PAGES, WEAR_ELEMENT_SIZE);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+}
+
+/*
+ * producer & consumer loop until u16CleanUps clean ups switched the main buffer: an entry is written,
+ * entries are marked down to WEAR_UNMARKED, then a clean up slice is done. The pending clean up is
+ * finished at the end. Returns a mask of the blocks used as main buffer
+ * */
+static uint32_t run_cleanups(uint16_t u16CleanUps)
+{
+    uint32_t Local_u32Mains = 0;
+    uint16_t Local_u16Written = 0;
+    uint16_t Local_u16Switches = 0;
+    uint8_t Local_u8Main = FLUFFER.context.main_buffer;
+    uint8_t Local_u8Empty;
+
+    while(Local_u16Switches < u16CleanUps)
+    {
+        write_entries(Local_u16Written, 1);
+        Local_u16Written++;
+
+        while((FLUFFER.context.tail - FLUFFER.context.head) > WEAR_UNMARKED)
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER));
+        }
+
+        Fluffer_enService(&FLUFFER, 1);
+
+        if(FLUFFER.context.main_buffer != Local_u8Main)
+        {
+            Local_u8Main = FLUFFER.context.main_buffer;
+            Local_u32Mains |= 1UL << Local_u8Main;
+            Local_u16Switches++;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    /*	new main buffer is branded, & the erase count of the old one is programmed back	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enIdleErase(&FLUFFER));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enIsEmpty(&FLUFFER, &Local_u8Empty));
+    TEST_ASSERT_FALSE(Local_u8Empty);
+
+    return Local_u32Mains;
+}
+
+/*
+ * check erase counts' statistics match the memory's erases of the blocks' first pages (each was erased
+ * once more than its erase count, by the first mount)
+ * */
+static void check_stats(const Fluffer_Wear_Stats_t * psStats)
+{
+    uint32_t Local_u32Min = 0xFFFFFFFFUL;
+    uint32_t Local_u32Max = 0;
+    uint32_t Local_u32Sum = 0;
+    uint32_t Local_u32Erases;
+    uint8_t Local_u8Block;
+
+    for(Local_u8Block = 0; Local_u8Block < WEAR_BLOCKS; Local_u8Block++)
+    {
+        Local_u32Erases = FlashSim_u32GetEraseCount(Local_u8Block * WEAR_PAGES) - 1;
+        Local_u32Min = MIN(Local_u32Min, Local_u32Erases);
+        Local_u32Max = MAX(Local_u32Max, Local_u32Erases);
+        Local_u32Sum += Local_u32Erases;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(Local_u32Min, psStats->min);
+    TEST_ASSERT_EQUAL_UINT32(Local_u32Max, psStats->max);
+    TEST_ASSERT_EQUAL_UINT32(Local_u32Sum / WEAR_BLOCKS, psStats->mean);
+}
+
+static void test_fluffer_wear_even(void);
+static void test_fluffer_wear_worn(void);
+static void test_fluffer_wear_mount(void);
+
+/**
+ * Even wear:
+ * 01. prepare an erased memory, all erase counts are 0, sequence is 0
+ * 02. run WEAR_CLEANUPS clean ups, sequence == WEAR_CLEANUPS, all blocks were main buffers
+ * 03. erase counts match the memory's erases, & are within 1 of each other
+ * */
+static void test_fluffer_wear_even(void)
+{
+    Fluffer_Wear_Stats_t Local_sStats;
+
+    /*	01. prepared memory	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, WEAR_BLOCKS, WEAR_PAGES, WEAR_ELEMENT_SIZE);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_EQUAL_UINT32(0, Local_sStats.min);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_sStats.max);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_sStats.sequence);
+
+    /*	02. clean ups	*/
+    TEST_ASSERT_EQUAL_HEX32((1UL << WEAR_BLOCKS) - 1, run_cleanups(WEAR_CLEANUPS));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_EQUAL_UINT32(WEAR_CLEANUPS, Local_sStats.sequence);
+
+    /*	03. even erase counts	*/
+    check_stats(&Local_sStats);
+    TEST_ASSERT_TRUE(Local_sStats.min >= ((WEAR_CLEANUPS / WEAR_BLOCKS) - 1));
+    TEST_ASSERT_TRUE((Local_sStats.max - Local_sStats.min) <= 1);
+}
+
+/**
+ * Worn blocks skipped:
+ * 01. program erase counts 0, WEAR_WORN_COUNT, 0, WEAR_WORN_COUNT into an erased memory, prepare it: counts are kept
+ * 02. run WEAR_CLEANUPS / 2 clean ups, worn blocks are never main buffers, nor erased again
+ * 03. unworn blocks caught up with worn ones, run more clean ups: all blocks are used
+ * */
+static void test_fluffer_wear_worn(void)
+{
+    uint8_t Local_au8Count[4] = {0x00, 0x00, 0x00, 0x00};
+    Fluffer_Wear_Stats_t Local_sStats;
+    uint8_t Local_u8Block;
+
+    /*	01. worn blocks	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+
+    for(Local_u8Block = 0; Local_u8Block < WEAR_BLOCKS; Local_u8Block++)
+    {
+        Local_au8Count[0] = (Local_u8Block & 1) ? WEAR_WORN_COUNT : 0;
+        TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite((uint32_t)Local_u8Block * WEAR_PAGES * FlashSim_sPresetStm32f1.page_size, Local_au8Count, sizeof(Local_au8Count)));
+    }
+
+    mount_fluffer();
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_EQUAL_UINT32(1, Local_sStats.min);
+    TEST_ASSERT_EQUAL_UINT32(WEAR_WORN_COUNT + 1, Local_sStats.max);
+
+    /*	02. worn blocks are skipped	*/
+    TEST_ASSERT_EQUAL_HEX32(0x05, run_cleanups(WEAR_CLEANUPS / 2));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_u32GetEraseCount(1 * WEAR_PAGES));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_u32GetEraseCount(3 * WEAR_PAGES));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_EQUAL_UINT32(WEAR_WORN_COUNT + 1, Local_sStats.max);
+    TEST_ASSERT_EQUAL_UINT32(WEAR_CLEANUPS / 2, Local_sStats.sequence);
+
+    /*	03. all blocks are used once erase counts caught up	*/
+    run_cleanups(2 * WEAR_WORN_COUNT);
+    TEST_ASSERT_EQUAL_HEX32((1UL << WEAR_BLOCKS) - 1, run_cleanups(WEAR_CLEANUPS));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_TRUE((Local_sStats.max - Local_sStats.min) <= 1);
+}
+
+/**
+ * Erase counts across mounts:
+ * 01. run clean ups, get statistics
+ * 02. mount a new instance on the memory: statistics are the same, no erase
+ * 03. run more clean ups: sequence goes on, erase counts stay even & match the memory's erases
+ * */
+static void test_fluffer_wear_mount(void)
+{
+    Fluffer_Wear_Stats_t Local_sStats;
+    Fluffer_Wear_Stats_t Local_sMounted;
+
+    /*	01. clean ups	*/
+    setup_fluffer(&FlashSim_sPresetStm32f1, WEAR_BLOCKS, WEAR_PAGES, WEAR_ELEMENT_SIZE);
+    run_cleanups(WEAR_CLEANUPS / 4);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+
+    /*	02. mount	*/
+    FlashSim_vidResetStats();
+    mount_fluffer();
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_psGetStats()->erases);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sMounted));
+    TEST_ASSERT_EQUAL_UINT32(Local_sStats.min, Local_sMounted.min);
+    TEST_ASSERT_EQUAL_UINT32(Local_sStats.max, Local_sMounted.max);
+    TEST_ASSERT_EQUAL_UINT32(Local_sStats.mean, Local_sMounted.mean);
+    TEST_ASSERT_EQUAL_UINT32(Local_sStats.sequence, Local_sMounted.sequence);
+
+    /*	03. clean ups go on	*/
+    run_cleanups(WEAR_CLEANUPS);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+    TEST_ASSERT_EQUAL_UINT32(WEAR_CLEANUPS + (WEAR_CLEANUPS / 4), Local_sStats.sequence);
+    check_stats(&Local_sStats);
+    TEST_ASSERT_TRUE((Local_sStats.max - Local_sStats.min) <= 1);
+}
+
+#endif	/*	FLUFFER_WEAR_MODE	*/
+
+static void test_fluffer_wear_params(void);
+
+/**
+ * Parameters:
+ * 01. null instance or statistics pointer
+ * 02. erase counts aren't kept without FLUFFER_WEAR_LEVEL
+ * */
+static void test_fluffer_wear_params(void)
+{
+    Fluffer_Wear_Stats_t Local_sStats;
+
+    setup_fluffer(&FlashSim_sPresetStm32f1, WEAR_BLOCKS, WEAR_PAGES, WEAR_ELEMENT_SIZE);
+
+    /*	01. null pointers	*/
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enGetWearStats(NULL, &Local_sStats));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NULLPTR, Fluffer_enGetWearStats(&FLUFFER, NULL));
+
+    /*	02. wear mode	*/
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+#else
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_PARAM, Fluffer_enGetWearStats(&FLUFFER, &Local_sStats));
+#endif	/*	FLUFFER_WEAR_MODE	*/
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fluffer_wear(void)
+{
+    UNITY_BEGIN();
+#if FLUFFER_WEAR_MODE == FLUFFER_WEAR_LEVEL
+    RUN_TEST(test_fluffer_wear_even);
+    RUN_TEST(test_fluffer_wear_worn);
+    RUN_TEST(test_fluffer_wear_mount);
+#endif	/*	FLUFFER_WEAR_MODE	*/
+    RUN_TEST(test_fluffer_wear_params);
+    UNITY_END();
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * @file      crc_mock.c
+ * @brief     Host mock of the STM32F1 CRC calculation unit, see crc_mock.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <crc_mock.h>
+
+
+#define CRC_MOCK_POLYNOMIAL			0x04C11DB7UL
+
+/* ------------------------------------------------------------------------- */
+
+/*	mocked registers	*/
+CRC_TypeDef CrcMock_sCrc;
+
+/*	unit's clock is enabled	*/
+static uint8_t CrcMock_u8Clock = 0;
+
+/*	statistics since last clear	*/
+static CrcMock_Stats_t CrcMock_sStats;
+
+/* ------------------------------------------------------------------------- */
+
+void CrcMock_vidClear(void)
+{
+    memset(&CrcMock_sCrc, 0x00, sizeof(CrcMock_sCrc));
+    CrcMock_sCrc.DR = 0xFFFFFFFFUL;
+    CrcMock_u8Clock = 0;
+    memset(&CrcMock_sStats, 0x00, sizeof(CrcMock_sStats));
+}
+
+/* ------------------------------------------------------------------------- */
+
+void CrcMock_vidEnableClock(void)
+{
+    CrcMock_u8Clock = 1;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void CrcMock_vidReset(void)
+{
+    if(!CrcMock_u8Clock)
+    {
+        CrcMock_sStats.violations++;
+    }
+
+    CrcMock_sCrc.DR = 0xFFFFFFFFUL;
+    CrcMock_sStats.resets++;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void CrcMock_vidFeed(uint32_t u32Word)
+{
+    uint32_t Local_u32Crc = CrcMock_sCrc.DR ^ u32Word;
+    uint8_t Local_u8Bit;
+
+    if(!CrcMock_u8Clock)
+    {
+        CrcMock_sStats.violations++;
+    }
+
+    /*	word is shifted in from its most significant bit	*/
+    for(Local_u8Bit = 0; Local_u8Bit < 32; Local_u8Bit++)
+    {
+        Local_u32Crc = (Local_u32Crc & 0x80000000UL) ? ((Local_u32Crc << 1) ^ CRC_MOCK_POLYNOMIAL) : (Local_u32Crc << 1);
+    }
+
+    CrcMock_sCrc.DR = Local_u32Crc;
+    CrcMock_sStats.words++;
+}
+
+/* ------------------------------------------------------------------------- */
+
+const CrcMock_Stats_t * CrcMock_psGetStats(void)
+{
+    return &CrcMock_sStats;
+}
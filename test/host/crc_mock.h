@@ -0,0 +1,88 @@
+/******************************************************************************
+ * @file      crc_mock.h
+ * @brief     Host mock of the STM32F1 CRC calculation unit registers & clock
+ *            enable, so crc_unit can be built and run on a Linux host. Words
+ *            fed to the data register are calculated bit by bit, apart from
+ *            fluffer's table driven software CRC
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __CRC_MOCK_H__
+#define __CRC_MOCK_H__
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief CRC unit registers, same as stm32f103xb.h
+ * */
+typedef struct
+{
+    volatile uint32_t DR;
+    volatile uint8_t  IDR;
+    uint8_t           RESERVED0;
+    uint16_t          RESERVED1;
+    volatile uint32_t CR;
+} CRC_TypeDef;
+
+#define CRC_CR_RESET				0x00000001UL
+
+extern CRC_TypeDef CrcMock_sCrc;
+#define CRC							(&CrcMock_sCrc)
+
+/**
+ * @brief CRC unit's clock enable, same as stm32f1xx_hal_rcc.h
+ * */
+#define __HAL_RCC_CRC_CLK_ENABLE()	CrcMock_vidEnableClock()
+
+/**
+ * @brief Reset & word store to the CRC unit, crc_unit resets & feeds the unit through them
+ * */
+#define CRC_UNIT_RESET()			CrcMock_vidReset()
+#define CRC_UNIT_FEED(word)			CrcMock_vidFeed((word))
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief CRC mock statistics since last clear
+ * */
+typedef struct crc_mock_stats_t {
+    uint32_t resets;                /**<  data register resets  */
+    uint32_t words;                 /**<  words fed  */
+    uint32_t violations;            /**<  resets & words fed while the unit's clock isn't enabled  */
+}CrcMock_Stats_t;
+
+/**
+ * @brief  Disable the unit's clock, reset its registers & clear statistics
+ * @return void
+ * */
+void CrcMock_vidClear(void);
+
+/**
+ * @brief  Enable the unit's clock
+ * @return void
+ * */
+void CrcMock_vidEnableClock(void);
+
+/**
+ * @brief  Reset the data register to 0xFFFFFFFF
+ * @return void
+ * */
+void CrcMock_vidReset(void);
+
+/**
+ * @brief  Feed a word to the CRC calculation, the data register holds the new CRC
+ * @param  u32Word
+ * @return void
+ * */
+void CrcMock_vidFeed(uint32_t u32Word);
+
+/**
+ * @brief  Get statistics since last clear
+ * @return pointer to statistics
+ * */
+const CrcMock_Stats_t * CrcMock_psGetStats(void);
+
+#endif /* __CRC_MOCK_H__ */
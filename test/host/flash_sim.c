@@ -0,0 +1,446 @@
+/******************************************************************************
+ * @file      flash_sim.c
+ * @brief     Host flash memory simulator, see flash_sim.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <utils.h>
+#include <flash_sim.h>
+
+/**
+ * @brief Erased byte content
+ * */
+#define FLASH_SIM_ERASED_BYTE			0xFF
+
+/**
+ * @brief Get simulated memory size (bytes)
+ * */
+#define FLASH_SIM_SIZE()				((uint32_t)FlashSim_sConfig.pages * FlashSim_sConfig.page_size)
+
+/**
+ * @brief Round an offset down to its program unit's start
+ * */
+#define FLASH_SIM_UNIT_START(u32Offset)	(((u32Offset) / FlashSim_sConfig.program_unit) * FlashSim_sConfig.program_unit)
+
+/* ------------------------------------------------------------------------------------ */
+
+const FlashSim_Config_t FlashSim_sPresetStm32f1 = {
+    .page_size = 1024,
+    .pages = 64,
+    .program_unit = 2,
+    .program_page = 2,
+    .rule = FLASH_SIM_RULE_ONCE,
+    .program_op_ns = 52500,
+    .program_byte_ns = 0,
+    .erase_ns = 20000000,
+    .read_op_ns = 0,
+    .read_byte_ns = 14,
+    .unlock_ns = 1000,
+    .mapped = 1,
+};
+
+const FlashSim_Config_t FlashSim_sPresetSpiNor = {
+    .page_size = 4096,
+    .pages = 64,
+    .program_unit = 1,
+    .program_page = 256,
+    .rule = FLASH_SIM_RULE_CLEAR_BITS,
+    .program_op_ns = 50000,
+    .program_byte_ns = 2500,
+    .erase_ns = 45000000,
+    .read_op_ns = 1000,
+    .read_byte_ns = 200,
+    .unlock_ns = 0,
+    .mapped = 0,
+};
+
+/*	simulated memory configurations	*/
+static FlashSim_Config_t FlashSim_sConfig;
+
+/*	simulated memory content	*/
+static uint8_t FlashSim_au8Memory[FLASH_SIM_MAX_SIZE];
+
+/*	erase count of each page	*/
+static uint32_t FlashSim_au32EraseCount[FLASH_SIM_MAX_PAGES];
+
+/*	statistics since last reset	*/
+static FlashSim_Stats_t FlashSim_sStats;
+
+/*	nested programming sessions, memory is unlocked while it's not 0	*/
+static uint8_t FlashSim_u8SessionDepth;
+
+/*	virtual clock since FlashSim_u8Init (ns), statistics' time_ns doesn't include time given by FlashSim_vidAdvance	*/
+static uint64_t FlashSim_u64Clock;
+
+/*	clock at which an erase started by FlashSim_enEraseAsync is done	*/
+static uint64_t FlashSim_u64BusyUntil;
+
+/**
+ * @brief  Check if programming a unit with the given content is allowed by the program rule
+ * @param  pu8Current unit's current content
+ * @param  pu8New unit's new content (bytes outside the write keep their current content)
+ * @return 1 if program is legal, 0 otherwise
+ * */
+static uint8_t FlashSim_u8ProgramIsLegal(const uint8_t * pu8Current, const uint8_t * pu8New);
+
+/**
+ * @brief  Account for a memory unlock & lock around a write or erase call, unless a session keeps it unlocked
+ * @return void
+ * */
+static void FlashSim_vidUnlock(void);
+
+/**
+ * @brief  Spend time in a memory access, the clock & statistics' time_ns are advanced
+ * @param  u64Ns time spent (ns)
+ * @return void
+ * */
+static void FlashSim_vidSpend(uint64_t u64Ns);
+
+/**
+ * @brief  Check if a memory access is made while an erase started by FlashSim_enEraseAsync is still in
+ *         progress, and count it as a violation
+ * @return 1 if the memory is busy, 0 otherwise
+ * */
+static uint8_t FlashSim_u8BusyViolation(void);
+
+/**
+ * @brief  Erase a page of the simulated memory
+ * @param  PageIndex page index
+ * @param  u8Wait 1 if the erase time is spent by the call, 0 if the memory is left busy for the erase time
+ * @return Fluffer_Handle_Error_t
+ * */
+static Fluffer_Handle_Error_t FlashSim_enErasePage(Fluffer_Page_t PageIndex, uint8_t u8Wait);
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Check if programming a unit with the given content is allowed by the program rule
+ * @param  pu8Current unit's current content
+ * @param  pu8New unit's new content (bytes outside the write keep their current content)
+ * @return 1 if program is legal, 0 otherwise
+ * */
+static uint8_t FlashSim_u8ProgramIsLegal(const uint8_t * pu8Current, const uint8_t * pu8New)
+{
+    uint8_t Local_u8Erased = 1;			/*	unit is erased	*/
+    uint8_t Local_u8Zeros = 1;			/*	unit is cleared to all zeros	*/
+    uint16_t Local_u16Index;
+
+    for(Local_u16Index = 0; Local_u16Index < FlashSim_sConfig.program_unit; Local_u16Index++)
+    {
+        /*	a bit can't be programmed from 0 to 1, whatever the rule is	*/
+        if((pu8Current[Local_u16Index] & pu8New[Local_u16Index]) != pu8New[Local_u16Index])
+        {
+            return 0;
+        }
+
+        Local_u8Erased &= (pu8Current[Local_u16Index] == FLASH_SIM_ERASED_BYTE);
+        Local_u8Zeros &= IS_ZERO(pu8New[Local_u16Index]);
+    }
+
+    return (FlashSim_sConfig.rule == FLASH_SIM_RULE_CLEAR_BITS) || Local_u8Erased || Local_u8Zeros;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Account for a memory unlock & lock around a write or erase call, unless a session keeps it unlocked
+ * @return void
+ * */
+static void FlashSim_vidUnlock(void)
+{
+    if(IS_ZERO(FlashSim_u8SessionDepth))
+    {
+        FlashSim_sStats.unlocks++;
+        FlashSim_vidSpend(FlashSim_sConfig.unlock_ns);
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Spend time in a memory access, the clock & statistics' time_ns are advanced
+ * @param  u64Ns time spent (ns)
+ * @return void
+ * */
+static void FlashSim_vidSpend(uint64_t u64Ns)
+{
+    FlashSim_u64Clock += u64Ns;
+    FlashSim_sStats.time_ns += u64Ns;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Check if a memory access is made while an erase started by FlashSim_enEraseAsync is still in
+ *         progress, and count it as a violation
+ * @return 1 if the memory is busy, 0 otherwise
+ * */
+static uint8_t FlashSim_u8BusyViolation(void)
+{
+    if(FlashSim_u64Clock < FlashSim_u64BusyUntil)
+    {
+        FlashSim_sStats.violations++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Erase a page of the simulated memory
+ * @param  PageIndex page index
+ * @param  u8Wait 1 if the erase time is spent by the call, 0 if the memory is left busy for the erase time
+ * @return Fluffer_Handle_Error_t
+ * */
+static Fluffer_Handle_Error_t FlashSim_enErasePage(Fluffer_Page_t PageIndex, uint8_t u8Wait)
+{
+    if(FlashSim_u8BusyViolation())
+    {
+        return FH_ERR_BUSY;
+    }
+
+    if(PageIndex >= FlashSim_sConfig.pages)
+    {
+        FlashSim_sStats.violations++;
+        return FH_ERR_INVALID_PAGE;
+    }
+
+    memset(&FlashSim_au8Memory[(uint32_t)PageIndex * FlashSim_sConfig.page_size], FLASH_SIM_ERASED_BYTE, FlashSim_sConfig.page_size);
+
+    FlashSim_vidUnlock();
+
+    FlashSim_au32EraseCount[PageIndex]++;
+    FlashSim_sStats.erases++;
+
+    if(u8Wait)
+    {
+        FlashSim_vidSpend(FlashSim_sConfig.erase_ns);
+    }
+    else
+    {
+        FlashSim_u64BusyUntil = FlashSim_u64Clock + FlashSim_sConfig.erase_ns;
+    }
+
+    return FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+uint8_t FlashSim_u8Init(const FlashSim_Config_t * const psConfig)
+{
+    if( IS_NULLPTR(psConfig) || IS_ZERO(psConfig->page_size) || IS_ZERO(psConfig->pages) ||
+        (psConfig->pages > FLASH_SIM_MAX_PAGES) ||
+        (((uint32_t)psConfig->pages * psConfig->page_size) > FLASH_SIM_MAX_SIZE) ||
+        IS_ZERO(psConfig->program_unit) || (psConfig->program_unit > FLASH_SIM_MAX_PROGRAM_UNIT) || IS_ZERO(psConfig->program_page) ||
+        ((psConfig->page_size % psConfig->program_unit) != 0) ||
+        ((psConfig->program_page % psConfig->program_unit) != 0))
+    {
+        return 0;
+    }
+
+    FlashSim_sConfig = *psConfig;
+
+    memset(FlashSim_au8Memory, FLASH_SIM_ERASED_BYTE, sizeof(FlashSim_au8Memory));
+    memset(FlashSim_au32EraseCount, 0x00, sizeof(FlashSim_au32EraseCount));
+    FlashSim_u8SessionDepth = 0;
+    FlashSim_u64Clock = 0;
+    FlashSim_u64BusyUntil = 0;
+    FlashSim_vidResetStats();
+
+    return 1;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void FlashSim_vidSetHandles(Fluffer_Handles_t * const psHandles)
+{
+    Fluffer_enInitHandles(psHandles, FlashSim_enRead, FlashSim_enWrite, FlashSim_enErase);
+    psHandles->map_handle = FlashSim_sConfig.mapped ? FlashSim_pu8Map : NULL;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void FlashSim_vidSetAsyncHandles(Fluffer_Handles_t * const psHandles)
+{
+    FlashSim_vidSetHandles(psHandles);
+    psHandles->erase_handle = FlashSim_enEraseAsync;
+    psHandles->poll_handle = FlashSim_enPoll;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enRead(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    if(FlashSim_u8BusyViolation())
+    {
+        return FH_ERR_BUSY;
+    }
+
+    if((u32Offset + u16Len) > FLASH_SIM_SIZE())
+    {
+        FlashSim_sStats.violations++;
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    memcpy(pu8Buffer, &FlashSim_au8Memory[u32Offset], u16Len);
+
+    FlashSim_sStats.read_calls++;
+    FlashSim_sStats.read_bytes += u16Len;
+    FlashSim_vidSpend(FlashSim_sConfig.read_op_ns + ((uint64_t)u16Len * FlashSim_sConfig.read_byte_ns));
+
+    return FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enWrite(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len)
+{
+    uint8_t Local_au8Unit[FLASH_SIM_MAX_PROGRAM_UNIT];		/*	unit's new content	*/
+    uint32_t Local_u32Start;		/*	1st programmed unit's offset	*/
+    uint32_t Local_u32End;			/*	offset after last programmed unit	*/
+    uint32_t Local_u32Unit;			/*	offset of unit being checked or programmed	*/
+    uint32_t Local_u32Byte;			/*	offset of byte in unit	*/
+    uint32_t Local_u32Ops;			/*	program operations	*/
+
+    if(FlashSim_u8BusyViolation())
+    {
+        return FH_ERR_BUSY;
+    }
+
+    if((u32Offset + u16Len) > FLASH_SIM_SIZE())
+    {
+        FlashSim_sStats.violations++;
+        return FH_ERR_INVALID_ADDRESS;
+    }
+
+    if(IS_ZERO(u16Len))
+    {
+        return FH_ERR_NONE;
+    }
+
+    Local_u32Start = FLASH_SIM_UNIT_START(u32Offset);
+    Local_u32End = FLASH_SIM_UNIT_START(u32Offset + u16Len - 1) + FlashSim_sConfig.program_unit;
+
+    /*	check all units before programming any of them, a rejected write leaves memory as is	*/
+    for(Local_u32Unit = Local_u32Start; Local_u32Unit < Local_u32End; Local_u32Unit += FlashSim_sConfig.program_unit)
+    {
+        for(Local_u32Byte = 0; Local_u32Byte < FlashSim_sConfig.program_unit; Local_u32Byte++)
+        {
+            Local_au8Unit[Local_u32Byte] = IN_RANGE_IN(Local_u32Unit + Local_u32Byte, u32Offset, u32Offset + u16Len - 1) ?
+                pu8Data[Local_u32Unit + Local_u32Byte - u32Offset] : FlashSim_au8Memory[Local_u32Unit + Local_u32Byte];
+        }
+
+        if(!FlashSim_u8ProgramIsLegal(&FlashSim_au8Memory[Local_u32Unit], Local_au8Unit))
+        {
+            FlashSim_sStats.violations++;
+            return FH_ERR_CORRUPTED_BLOCK;
+        }
+    }
+
+    /*	bytes outside the write keep their content, the rule only allows clearing bits	*/
+    memcpy(&FlashSim_au8Memory[u32Offset], pu8Data, u16Len);
+
+    /*	a program operation can't cross a program page boundary	*/
+    Local_u32Ops = ((Local_u32End - 1) / FlashSim_sConfig.program_page) - (Local_u32Start / FlashSim_sConfig.program_page) + 1;
+
+    FlashSim_vidUnlock();
+
+    FlashSim_sStats.write_calls++;
+    FlashSim_sStats.program_ops += Local_u32Ops;
+    FlashSim_sStats.program_bytes += Local_u32End - Local_u32Start;
+    FlashSim_vidSpend(((uint64_t)Local_u32Ops * FlashSim_sConfig.program_op_ns) +
+                      ((uint64_t)(Local_u32End - Local_u32Start) * FlashSim_sConfig.program_byte_ns));
+
+    return FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enErase(Fluffer_Page_t PageIndex)
+{
+    return FlashSim_enErasePage(PageIndex, 1);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enEraseAsync(Fluffer_Page_t PageIndex)
+{
+    return FlashSim_enErasePage(PageIndex, 0);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enPoll(void)
+{
+    FlashSim_sStats.polls++;
+    FlashSim_vidSpend(FLASH_SIM_POLL_NS);
+
+    return (FlashSim_u64Clock < FlashSim_u64BusyUntil) ? FH_ERR_BUSY : FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void FlashSim_vidAdvance(uint64_t u64Ns)
+{
+    FlashSim_u64Clock += u64Ns;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enBeginSession(void)
+{
+    /*	outermost begin unlocks the memory	*/
+    FlashSim_vidUnlock();
+    FlashSim_u8SessionDepth++;
+
+    return FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+Fluffer_Handle_Error_t FlashSim_enEndSession(void)
+{
+    if(IS_ZERO(FlashSim_u8SessionDepth))
+    {
+        FlashSim_sStats.violations++;
+        return FH_ERR_NULLPTR;
+    }
+
+    FlashSim_u8SessionDepth--;
+
+    return FH_ERR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+const uint8_t * FlashSim_pu8Map(void)
+{
+    return FlashSim_sConfig.mapped ? FlashSim_au8Memory : NULL;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+const FlashSim_Stats_t * FlashSim_psGetStats(void)
+{
+    return &FlashSim_sStats;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void FlashSim_vidResetStats(void)
+{
+    memset(&FlashSim_sStats, 0x00, sizeof(FlashSim_sStats));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+uint32_t FlashSim_u32GetEraseCount(uint16_t u16PageIndex)
+{
+    return (u16PageIndex < FlashSim_sConfig.pages) ? FlashSim_au32EraseCount[u16PageIndex] : 0;
+}
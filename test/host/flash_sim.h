@@ -0,0 +1,235 @@
+/******************************************************************************
+ * @file      flash_sim.h
+ * @brief     Host flash memory simulator, a RAM backed flash with a program
+ *            rule, program granularity, timing model (virtual time) and per
+ *            page erase counters. Its read, write, erase & map functions
+ *            match Fluffer_Handles_t, so a fluffer instance can run on top of
+ *            it on a Linux host. Erases can also be left in progress (async
+ *            erase & poll handles) while the virtual clock advances. A single simulated memory is shared by all
+ *            users, configured by FlashSim_u8Init.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __FLASH_SIM_H__
+#define __FLASH_SIM_H__
+
+#include <stdint.h>
+#include <fluffer.h>
+
+/**
+ * @brief Simulated memory size (bytes), pages * page_size must not exceed it
+ * */
+#ifndef FLASH_SIM_MAX_SIZE
+#define FLASH_SIM_MAX_SIZE				(256UL * 1024UL)
+#endif	/*	FLASH_SIM_MAX_SIZE	*/
+
+/**
+ * @brief Maximum number of simulated pages, limited to 256 by the erase handle's 8 bit page index
+ * unless fluffer is built with FLUFFER_ADDRESSING_32
+ * */
+#ifndef FLASH_SIM_MAX_PAGES
+#if FLUFFER_ADDRESSING == FLUFFER_ADDRESSING_32
+#define FLASH_SIM_MAX_PAGES				4096
+#else
+#define FLASH_SIM_MAX_PAGES				256
+#endif	/*	FLUFFER_ADDRESSING	*/
+#endif	/*	FLASH_SIM_MAX_PAGES	*/
+
+/**
+ * @brief Maximum program unit size (bytes)
+ * */
+#define FLASH_SIM_MAX_PROGRAM_UNIT		8
+
+/**
+ * @brief Time of a poll of an asynchronous erase (ns), ex: a status register read
+ * */
+#define FLASH_SIM_POLL_NS				1000
+
+/**
+ * @brief Program rules, define which programs are legal for a program unit that isn't erased
+ * */
+typedef enum flash_sim_rule_t {
+    FLASH_SIM_RULE_ONCE,			/**<  a unit is programmed once after an erase, or cleared to all zeros (ex: STM32F1 flash)  */
+    FLASH_SIM_RULE_CLEAR_BITS,      /**<  any bit can be cleared (1 to 0) at any time (ex: NOR flash)  */
+}FlashSim_Rule_t;
+
+/**
+ * @brief Simulated memory configurations, geometry & timing model
+ * */
+typedef struct flash_sim_config_t {
+    uint16_t page_size;				/**<  erase unit size (bytes)  */
+    uint16_t pages;                 /**<  number of pages  */
+    uint16_t program_unit;          /**<  smallest programmed unit (bytes), partial units are padded with their current content  */
+    uint16_t program_page;          /**<  maximum bytes programmed by a single program operation, writes are split at its boundaries  */
+    FlashSim_Rule_t rule;           /**<  program rule for units that aren't erased  */
+    uint32_t program_op_ns;         /**<  fixed time of a program operation (ns)  */
+    uint32_t program_byte_ns;       /**<  time per programmed byte (ns)  */
+    uint32_t erase_ns;              /**<  page erase time (ns)  */
+    uint32_t read_op_ns;            /**<  fixed time of a read (ns)  */
+    uint32_t read_byte_ns;          /**<  time per read byte (ns)  */
+    uint32_t unlock_ns;             /**<  time to unlock & lock the memory (ns), once per write or erase call outside a session  */
+    uint8_t  mapped;                /**<  1 if memory is memory mapped (map handle is available), 0 otherwise  */
+}FlashSim_Config_t;
+
+/**
+ * @brief Simulated memory statistics, accumulated since the last FlashSim_vidResetStats call
+ * */
+typedef struct flash_sim_stats_t {
+    uint32_t read_calls;			/**<  read handle calls  */
+    uint32_t read_bytes;            /**<  bytes read  */
+    uint32_t write_calls;           /**<  write handle calls  */
+    uint32_t program_ops;           /**<  program operations (a write is split at program_page boundaries)  */
+    uint32_t program_bytes;         /**<  bytes programmed, including padding of partial units  */
+    uint32_t erases;                /**<  page erases  */
+    uint32_t violations;            /**<  rejected writes (illegal program, out of range)  */
+    uint32_t unlocks;               /**<  memory unlocks, by write & erase calls outside a session, and by outermost session begins  */
+    uint32_t polls;                 /**<  poll handle calls  */
+    uint64_t time_ns;               /**<  virtual time spent in reads, programs, erases & polls (ns), an asynchronous erase's
+                                         time isn't spent by its caller  */
+}FlashSim_Stats_t;
+
+/**
+ * @brief STM32F103 internal flash: 1 KB pages, half word programs (~52.5 us each), ~20 ms page erase,
+ *        memory mapped, a half word is programmed once after an erase, ~1 us to unlock & lock the flash controller
+ * */
+extern const FlashSim_Config_t FlashSim_sPresetStm32f1;
+
+/**
+ * @brief Typical SPI NOR flash (W25Q class, 40 MHz single SPI): 4 KB sector erase (~45 ms), 256 B page
+ *        program (~0.7 ms), not memory mapped, any bit can be cleared
+ * */
+extern const FlashSim_Config_t FlashSim_sPresetSpiNor;
+
+/**
+ * @brief  Configure the simulated memory, erase all pages, reset erase counters & statistics
+ * @param  psConfig memory configurations, pages * page_size must not exceed FLASH_SIM_MAX_SIZE,
+ *         pages must not exceed FLASH_SIM_MAX_PAGES, program_unit must not exceed FLASH_SIM_MAX_PROGRAM_UNIT,
+ *         page_size & program_page must be multiples of program_unit
+ * @return 1 if configurations are valid, 0 otherwise
+ * */
+uint8_t FlashSim_u8Init(const FlashSim_Config_t * const psConfig);
+
+/**
+ * @brief  Set fluffer handles to the simulated memory's read, write & erase (and map, if memory mapped),
+ *         load, save & session handles are cleared
+ * @param  psHandles pointer to fluffer instance's handles
+ * @return void
+ * */
+void FlashSim_vidSetHandles(Fluffer_Handles_t * const psHandles);
+
+/**
+ * @brief  Set fluffer handles as FlashSim_vidSetHandles does, with the asynchronous erase & poll handles
+ * @param  psHandles pointer to fluffer instance's handles
+ * @return void
+ * */
+void FlashSim_vidSetAsyncHandles(Fluffer_Handles_t * const psHandles);
+
+/**
+ * @brief  Read bytes from the simulated memory (Fluffer_Read_Handle_t)
+ * @param  u32Offset offset of 1st byte to read
+ * @param  pu8Buffer buffer to copy read bytes into
+ * @param  u16Len number of bytes to read
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if no errors occurred
+ *         FH_ERR_INVALID_ADDRESS : if read is out of memory range
+ *         FH_ERR_BUSY : if an asynchronous erase is in progress (counted as a violation)
+ * */
+Fluffer_Handle_Error_t FlashSim_enRead(uint32_t u32Offset, uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief  Program bytes into the simulated memory (Fluffer_Write_Handle_t). The write is checked against
+ *         the program rule before any byte is programmed, bytes of partially written units keep their
+ *         current content
+ * @param  u32Offset offset of 1st byte to program
+ * @param  pu8Data bytes to program
+ * @param  u16Len number of bytes to program
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if no errors occurred
+ *         FH_ERR_INVALID_ADDRESS : if write is out of memory range
+ *         FH_ERR_CORRUPTED_BLOCK : if write breaks the program rule (ex: a bit programmed from 0 to 1),
+ *         nothing is programmed
+ *         FH_ERR_BUSY : if an asynchronous erase is in progress (counted as a violation)
+ * */
+Fluffer_Handle_Error_t FlashSim_enWrite(uint32_t u32Offset, uint8_t * pu8Data, uint16_t u16Len);
+
+/**
+ * @brief  Erase a page of the simulated memory (Fluffer_Erase_Handle_t)
+ * @param  PageIndex page index
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if no errors occurred
+ *         FH_ERR_INVALID_PAGE : if page index is out of range
+ *         FH_ERR_BUSY : if an asynchronous erase is in progress (counted as a violation)
+ * */
+Fluffer_Handle_Error_t FlashSim_enErase(Fluffer_Page_t PageIndex);
+
+/**
+ * @brief  Start erasing a page of the simulated memory (asynchronous Fluffer_Erase_Handle_t). The page is
+ *         erased right away, but the memory is busy for erase_ns of virtual time, the call doesn't spend it
+ * @param  PageIndex page index
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if no errors occurred
+ *         FH_ERR_INVALID_PAGE : if page index is out of range
+ *         FH_ERR_BUSY : if an asynchronous erase is in progress (counted as a violation)
+ * */
+Fluffer_Handle_Error_t FlashSim_enEraseAsync(Fluffer_Page_t PageIndex);
+
+/**
+ * @brief  Check if an erase started by FlashSim_enEraseAsync is still in progress (Fluffer_Poll_Handle_t),
+ *         each call spends FLASH_SIM_POLL_NS
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if the memory is ready
+ *         FH_ERR_BUSY : if the erase is still in progress
+ * */
+Fluffer_Handle_Error_t FlashSim_enPoll(void);
+
+/**
+ * @brief  Advance the virtual clock without a memory access (ex: application work between fluffer calls), an
+ *         asynchronous erase goes on meanwhile. Statistics' time_ns isn't advanced
+ * @param  u64Ns time to advance (ns)
+ * @return void
+ * */
+void FlashSim_vidAdvance(uint64_t u64Ns);
+
+/**
+ * @brief  Begin a programming session (Fluffer_Session_Handle_t), the memory is unlocked by the outermost
+ *         begin & kept unlocked for all write & erase calls until the matching end. Sessions may be nested
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : always
+ * */
+Fluffer_Handle_Error_t FlashSim_enBeginSession(void);
+
+/**
+ * @brief  End a programming session (Fluffer_Session_Handle_t), the memory is locked by the outermost end
+ * @return Fluffer_Handle_Error_t
+ *         FH_ERR_NONE : if no errors occurred
+ *         FH_ERR_NULLPTR : if no session was begun (counted as a violation)
+ * */
+Fluffer_Handle_Error_t FlashSim_enEndSession(void);
+
+/**
+ * @brief  Get a pointer to offset 0 of the simulated memory (Fluffer_Map_Handle_t)
+ * @return pointer to offset 0, NULL if the memory isn't memory mapped
+ * */
+const uint8_t * FlashSim_pu8Map(void);
+
+/**
+ * @brief  Get statistics accumulated since the last FlashSim_vidResetStats call
+ * @return pointer to statistics
+ * */
+const FlashSim_Stats_t * FlashSim_psGetStats(void);
+
+/**
+ * @brief  Reset statistics (including virtual time), erase counters are kept
+ * @return void
+ * */
+void FlashSim_vidResetStats(void);
+
+/**
+ * @brief  Get number of times a page was erased since FlashSim_u8Init
+ * @param  u16PageIndex page index
+ * @return erase count, 0 if page index is out of range
+ * */
+uint32_t FlashSim_u32GetEraseCount(uint16_t u16PageIndex);
+
+#endif /* __FLASH_SIM_H__ */
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * @file      fpec_mock.c
+ * @brief     Host mock of the STM32F1 FPEC, see fpec_mock.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <main.h>
+#include <utils.h>
+#include <fpec_mock.h>
+
+
+/*	Linux mmap flags, hidden by -std=c99	*/
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS				0x20
+#endif	/*	MAP_ANONYMOUS	*/
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE			0x100000
+#endif	/*	MAP_FIXED_NOREPLACE	*/
+
+/* ------------------------------------------------------------------------- */
+
+/*	mocked registers	*/
+FLASH_TypeDef FpecMock_sFlash;
+DWT_Type FpecMock_sDwt;
+CoreDebug_Type FpecMock_sCoreDebug;
+
+/*	mocked flash, mapped at FPEC_MOCK_FLASH_BASE	*/
+static uint8_t * FpecMock_pu8Flash = NULL;
+
+/*	statistics since last reset	*/
+static FpecMock_Stats_t FpecMock_sStats;
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief  Map the mocked flash at its target address, before main()
+ * @return void
+ * */
+static void FpecMock_vidMap(void) __attribute__((constructor));
+
+/**
+ * @brief  Get offset of an absolute address (or its alias from 0x00000000) in the mocked flash
+ * @param  u32Address address
+ * @param  pu32Offset pointer to a uint32_t variable, to store the offset in it
+ * @return uint8_t 1 if the address is in the mocked flash, 0 otherwise
+ * */
+static uint8_t FpecMock_u8GetOffset(uint32_t u32Address, uint32_t * pu32Offset);
+
+/**
+ * @brief  Advance the cycle counter, if it's enabled
+ * @param  u32Cycles cycles to add
+ * @return void
+ * */
+static void FpecMock_vidSpend(uint32_t u32Cycles);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief  Map the mocked flash at its target address, before main()
+ * @return void
+ * */
+static void FpecMock_vidMap(void)
+{
+    void * Local_pvFlash;
+
+    Local_pvFlash = mmap((void *)FPEC_MOCK_FLASH_BASE, FPEC_MOCK_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if((Local_pvFlash != MAP_FAILED) && (Local_pvFlash == (void *)FPEC_MOCK_FLASH_BASE))
+    {
+        FpecMock_pu8Flash = (uint8_t *)Local_pvFlash;
+        (void)FpecMock_u8Reset();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief  Get offset of an absolute address (or its alias from 0x00000000) in the mocked flash
+ * @param  u32Address address
+ * @param  pu32Offset pointer to a uint32_t variable, to store the offset in it
+ * @return uint8_t 1 if the address is in the mocked flash, 0 otherwise
+ * */
+static uint8_t FpecMock_u8GetOffset(uint32_t u32Address, uint32_t * pu32Offset)
+{
+    if(u32Address >= FPEC_MOCK_FLASH_BASE)
+    {
+        u32Address -= FPEC_MOCK_FLASH_BASE;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    *pu32Offset = u32Address;
+
+    return (!IS_NULLPTR(FpecMock_pu8Flash) && (u32Address < FPEC_MOCK_FLASH_SIZE));
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief  Advance the cycle counter, if it's enabled
+ * @param  u32Cycles cycles to add
+ * @return void
+ * */
+static void FpecMock_vidSpend(uint32_t u32Cycles)
+{
+    if(READ_BIT(FpecMock_sCoreDebug.DEMCR, CoreDebug_DEMCR_TRCENA_Msk) && READ_BIT(FpecMock_sDwt.CTRL, DWT_CTRL_CYCCNTENA_Msk))
+    {
+        FpecMock_sDwt.CYCCNT += u32Cycles;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+uint8_t FpecMock_u8Reset(void)
+{
+    if(IS_NULLPTR(FpecMock_pu8Flash))
+    {
+        return 0;
+    }
+
+    memset(FpecMock_pu8Flash, 0xFF, FPEC_MOCK_FLASH_SIZE);
+    memset(&FpecMock_sFlash, 0x00, sizeof(FpecMock_sFlash));
+    memset(&FpecMock_sDwt, 0x00, sizeof(FpecMock_sDwt));
+    memset(&FpecMock_sCoreDebug, 0x00, sizeof(FpecMock_sCoreDebug));
+    FpecMock_sFlash.CR = FLASH_CR_LOCK;
+    FpecMock_vidResetStats();
+
+    return 1;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void FpecMock_vidProgram(uint32_t u32Address, uint16_t u16Data)
+{
+    uint32_t Local_u32Offset;
+    uint16_t Local_u16Current;
+
+    if( READ_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK) || !READ_BIT(FpecMock_sFlash.CR, FLASH_CR_PG) ||
+        !IS_ZERO(u32Address & 0x01) || !FpecMock_u8GetOffset(u32Address, &Local_u32Offset))
+    {
+        FpecMock_sStats.violations++;
+        return;
+    }
+
+    FpecMock_vidSpend(FPEC_MOCK_PROGRAM_CYCLES);
+
+    memcpy(&Local_u16Current, &FpecMock_pu8Flash[Local_u32Offset], sizeof(Local_u16Current));
+
+    /*	a half word is programmed once after an erase, unless it's cleared to 0	*/
+    if((Local_u16Current != 0xFFFF) && !IS_ZERO(u16Data))
+    {
+        FpecMock_sStats.program_errors++;
+        SET_BIT(FpecMock_sFlash.SR, FLASH_SR_PGERR);
+        return;
+    }
+
+    memcpy(&FpecMock_pu8Flash[Local_u32Offset], &u16Data, sizeof(u16Data));
+    FpecMock_sStats.program_ops++;
+    SET_BIT(FpecMock_sFlash.SR, FLASH_SR_EOP);
+}
+
+/* ------------------------------------------------------------------------- */
+
+void FpecMock_vidResetStats(void)
+{
+    memset(&FpecMock_sStats, 0x00, sizeof(FpecMock_sStats));
+}
+
+/* ------------------------------------------------------------------------- */
+
+const FpecMock_Stats_t * FpecMock_psGetStats(void)
+{
+    return &FpecMock_sStats;
+}
+
+/* ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    if(READ_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK))
+    {
+        CLEAR_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK);
+        FpecMock_sStats.unlocks++;
+        FpecMock_vidSpend(FPEC_MOCK_UNLOCK_CYCLES);
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    return HAL_OK;
+}
+
+/* ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    SET_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK);
+
+    return HAL_OK;
+}
+
+/* ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    HAL_StatusTypeDef Local_enStatus = HAL_OK;
+
+    FpecMock_sStats.hal_calls++;
+    FpecMock_vidSpend(FPEC_MOCK_HAL_CYCLES);
+
+    if((TypeProgram != FLASH_TYPEPROGRAM_HALFWORD) || READ_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK))
+    {
+        return HAL_ERROR;
+    }
+
+    CLEAR_BIT(FpecMock_sFlash.SR, FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR);
+    SET_BIT(FpecMock_sFlash.CR, FLASH_CR_PG);
+
+    FpecMock_vidProgram(Address, (uint16_t)Data);
+
+    if(READ_BIT(FpecMock_sFlash.SR, FLASH_SR_PGERR | FLASH_SR_WRPRTERR))
+    {
+        Local_enStatus = HAL_ERROR;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    CLEAR_BIT(FpecMock_sFlash.CR, FLASH_CR_PG);
+    CLEAR_BIT(FpecMock_sFlash.SR, FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR);
+
+    return Local_enStatus;
+}
+
+/* ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError)
+{
+    uint32_t Local_u32Offset;
+    uint32_t Local_u32Page;
+
+    *PageError = 0xFFFFFFFFUL;
+
+    if(READ_BIT(FpecMock_sFlash.CR, FLASH_CR_LOCK) || (pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES))
+    {
+        return HAL_ERROR;
+    }
+
+    for(Local_u32Page = 0; Local_u32Page < pEraseInit->NbPages; Local_u32Page++)
+    {
+        if(!FpecMock_u8GetOffset(pEraseInit->PageAddress + (Local_u32Page * FLASH_PAGE_SIZE), &Local_u32Offset))
+        {
+            *PageError = pEraseInit->PageAddress + (Local_u32Page * FLASH_PAGE_SIZE);
+            return HAL_ERROR;
+        }
+
+        FpecMock_vidSpend(FPEC_MOCK_ERASE_CYCLES);
+        memset(&FpecMock_pu8Flash[Local_u32Offset & ~(FLASH_PAGE_SIZE - 1)], 0xFF, FLASH_PAGE_SIZE);
+        FpecMock_sStats.erases++;
+    }
+
+    return HAL_OK;
+}
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * @file      fpec_mock.h
+ * @brief     Host mock of the STM32F1 flash program/erase controller (FPEC)
+ *            registers, the flash HAL calls used by flash_memory, and the
+ *            DWT cycle counter, so flash_memory can be built and run on a
+ *            Linux host. The flash is mapped at its target address, and
+ *            the cycle counter advances by a cost model of each operation
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __FPEC_MOCK_H__
+#define __FPEC_MOCK_H__
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Mocked flash, same as STM32F103xB
+ * */
+#define FPEC_MOCK_FLASH_BASE		0x08000000UL
+#define FPEC_MOCK_FLASH_SIZE		(128UL << 10)
+
+/**
+ * @brief Cost model, in cycles at 72 MHz
+ * */
+#define FPEC_MOCK_PROGRAM_CYCLES	3780UL		/**<  half word program, ~52.5 us  */
+#define FPEC_MOCK_ERASE_CYCLES		1440000UL	/**<  page erase, ~20 ms  */
+#define FPEC_MOCK_HAL_CYCLES		150UL		/**<  HAL_FLASH_Program overhead (process lock, tick based waits, flags)  */
+#define FPEC_MOCK_UNLOCK_CYCLES		72UL		/**<  HAL_FLASH_Unlock & HAL_FLASH_Lock of a locked FPEC, ~1 us  */
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Register access & bit manipulation, same as CMSIS
+ * */
+#define __IO						volatile
+#define SET_BIT(REG, BIT)			((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)			((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)			((REG) & (BIT))
+
+/**
+ * @brief FPEC registers, same as stm32f103xb.h
+ * */
+typedef struct
+{
+    __IO uint32_t ACR;
+    __IO uint32_t KEYR;
+    __IO uint32_t OPTKEYR;
+    __IO uint32_t SR;
+    __IO uint32_t CR;
+    __IO uint32_t AR;
+    __IO uint32_t RESERVED;
+    __IO uint32_t OBR;
+    __IO uint32_t WRPR;
+} FLASH_TypeDef;
+
+#define FLASH_SR_BSY				0x00000001UL
+#define FLASH_SR_PGERR				0x00000004UL
+#define FLASH_SR_WRPRTERR			0x00000010UL
+#define FLASH_SR_EOP				0x00000020UL
+
+#define FLASH_CR_PG					0x00000001UL
+#define FLASH_CR_PER				0x00000002UL
+#define FLASH_CR_LOCK				0x00000080UL
+
+extern FLASH_TypeDef FpecMock_sFlash;
+#define FLASH						(&FpecMock_sFlash)
+
+/**
+ * @brief DWT cycle counter & debug control registers, same as core_cm3.h (used members only)
+ * */
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk			0x00000001UL
+#define CoreDebug_DEMCR_TRCENA_Msk		0x01000000UL
+
+extern DWT_Type FpecMock_sDwt;
+extern CoreDebug_Type FpecMock_sCoreDebug;
+#define DWT							(&FpecMock_sDwt)
+#define CoreDebug					(&FpecMock_sCoreDebug)
+
+/**
+ * @brief Flash HAL, same as stm32f1xx_hal_flash.h & stm32f1xx_hal_flash_ex.h (used members only)
+ * */
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t PageAddress;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_FLAG_BSY				FLASH_SR_BSY
+#define FLASH_FLAG_PGERR			FLASH_SR_PGERR
+#define FLASH_FLAG_WRPERR			FLASH_SR_WRPRTERR
+#define FLASH_FLAG_EOP				FLASH_SR_EOP
+
+/*	status flags are cleared by writing 1 on target, mocked registers are plain memory	*/
+#define __HAL_FLASH_GET_FLAG(__FLAG__)		READ_BIT(FLASH->SR, (__FLAG__))
+#define __HAL_FLASH_CLEAR_FLAG(__FLAG__)	CLEAR_BIT(FLASH->SR, (__FLAG__))
+
+#define FLASH_PAGE_SIZE				0x400U
+#define FLASH_BANK_1				1U
+#define FLASH_TYPEERASE_PAGES		0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD	0x01U
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * PageError);
+
+/**
+ * @brief Half word store to the flash, flash_memory programs through it (FLASH_CR_PG must be set)
+ * */
+#define FLASH_MEMORY_PROGRAM_HALFWORD(address, data)	FpecMock_vidProgram((address), (data))
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief FPEC mock statistics since last reset
+ * */
+typedef struct fpec_mock_stats_t {
+    uint32_t hal_calls;             /**<  HAL_FLASH_Program calls  */
+    uint32_t program_ops;           /**<  half words programmed  */
+    uint32_t erases;                /**<  pages erased  */
+    uint32_t unlocks;               /**<  FPEC unlocks (HAL_FLASH_Unlock of a locked FPEC)  */
+    uint32_t program_errors;        /**<  programs of a half word that isn't erased (PGERR)  */
+    uint32_t violations;            /**<  stores while the FPEC is locked or FLASH_CR_PG isn't set, unaligned or out of range  */
+}FpecMock_Stats_t;
+
+/**
+ * @brief  Erase the whole mocked flash, lock the FPEC, clear registers, cycle counter & statistics.
+ *         The flash is mapped at FPEC_MOCK_FLASH_BASE before main() & erased
+ * @return uint8_t 1 if the flash is mapped, 0 otherwise
+ * */
+uint8_t FpecMock_u8Reset(void);
+
+/**
+ * @brief  Half word store to the mocked flash, programmed if the FPEC is unlocked & FLASH_CR_PG is set
+ * @param  u32Address absolute address (or its alias from 0x00000000), 16 bit aligned
+ * @param  u16Data half word to program
+ * @return void
+ * */
+void FpecMock_vidProgram(uint32_t u32Address, uint16_t u16Data);
+
+/**
+ * @brief  Clear statistics
+ * @return void
+ * */
+void FpecMock_vidResetStats(void);
+
+/**
+ * @brief  Get statistics since last reset
+ * @return pointer to statistics
+ * */
+const FpecMock_Stats_t * FpecMock_psGetStats(void);
+
+#endif /* __FPEC_MOCK_H__ */
@@ -0,0 +1,28 @@
+/******************************************************************************
+ * @file      host_main.c
+ * @brief     Host entry point, runs a single test or benchmark function on a
+ *            Linux host. The function is selected at compile time, because
+ *            every test file defines its own Unity setUp() & tearDown().
+ *
+ *            gcc -std=c99 -DDEBUG -include stdint.h -DHOST_TEST_ENTRY=bench_fluffer_mount \
+ *                -Itest/host -Iutils -IUART-DEBUG -Iboard_config -Iflash_memory -Ifluffer \
+ *                -Itest -Itest/unity -Itest/fluffer \
+ *                fluffer/fluffer.c test/unity/unity.c test/fluffer/bench_fluffer_mount.c \
+ *                test/host/host_main.c -o bench_fluffer_mount
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#ifndef HOST_TEST_ENTRY
+#error "HOST_TEST_ENTRY must be set to the test function to run, ex: -DHOST_TEST_ENTRY=test_fluffer"
+#endif	/*	HOST_TEST_ENTRY	*/
+
+void HOST_TEST_ENTRY(void);
+
+int main(void)
+{
+    HOST_TEST_ENTRY();
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+/******************************************************************************
+ * @file      main.h
+ * @brief     Host stand-in for the STM32CubeIDE generated main.h, provides the
+ *            few HAL types used by portable modules (fluffer, tests), the FPEC
+ *            mock used by flash_memory, and the CRC unit mock used by
+ *            crc_unit, so they can be built and run on a Linux host
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <fpec_mock.h>
+#include <crc_mock.h>
+
+/**
+ * @brief Flag status, same as stm32f1xx.h
+ * */
+typedef enum
+{
+    RESET = 0,
+    SET = !RESET
+} FlagStatus;
+
+#endif /* __MAIN_H */
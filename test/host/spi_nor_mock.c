@@ -0,0 +1,502 @@
+/******************************************************************************
+ * @file      spi_nor_mock.c
+ * @brief     Host stand-in of a SPI bus with a JEDEC SPI NOR flash on it, see
+ *            spi_nor_mock.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <utils.h>
+#include <spi_nor_mock.h>
+
+
+/*	erased byte content	*/
+#define SPI_NOR_MOCK_ERASED_BYTE		0xFF
+
+/* ------------------------------------------------------------------------------------ */
+
+const SpiNorMock_Config_t SpiNorMock_sPresetW25q = {
+    .jedec_id = 0xEF4018UL,
+    .byte_ns = 200,
+    .select_ns = 100,
+    .program_op_ns = 50000,
+    .program_byte_ns = 2500,
+    .sector_erase_ns = 45000000,
+    .block_erase_ns = 150000000,
+    .write_protected = 0,
+};
+
+const SpiNor_Bus_t SpiNorMock_sBus = {
+    .select_handle = SpiNorMock_enSelect,
+    .transmit_handle = SpiNorMock_enTransmit,
+    .receive_handle = SpiNorMock_enReceive,
+};
+
+/*	mocked memory	*/
+static uint8_t SpiNorMock_au8Memory[SPI_NOR_MOCK_SIZE];
+
+/*	memory & bus timing model	*/
+static SpiNorMock_Config_t SpiNorMock_sConfig;
+
+/*	statistics since last reset	*/
+static SpiNorMock_Stats_t SpiNorMock_sStats;
+
+/*	virtual time (ns), time at last statistics reset & time a program or erase ends	*/
+static uint64_t SpiNorMock_u64Now;
+static uint64_t SpiNorMock_u64StatsStart;
+static uint64_t SpiNorMock_u64BusyUntil;
+
+/*	memory state: selected, write enable latch	*/
+static uint8_t SpiNorMock_u8Selected;
+static uint8_t SpiNorMock_u8WriteEnabled;
+
+/*	command being clocked in: command byte (valid once u8HasCommand is set), address bytes expected
+ *	& received, address, data bytes clocked in or out after the address, data of a page program	*/
+static uint8_t SpiNorMock_u8HasCommand;
+static uint8_t SpiNorMock_u8Command;
+static uint8_t SpiNorMock_u8AddressBytes;
+static uint8_t SpiNorMock_u8AddressCount;
+static uint32_t SpiNorMock_u32Address;
+static uint32_t SpiNorMock_u32Data;
+static uint8_t SpiNorMock_au8Program[SPI_NOR_PAGE_SIZE];
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Advance virtual time
+ * @param  u64Ns time to add (ns)
+ * @return void
+ * */
+static void SpiNorMock_vidSpend(uint64_t u64Ns);
+
+/**
+ * @brief  Check if a program or erase is in progress
+ * @return 1 if busy, 0 otherwise
+ * */
+static uint8_t SpiNorMock_u8IsBusy(void);
+
+/**
+ * @brief  Get number of address bytes taken by a command
+ * @param  u8Command command
+ * @return 3 or 4, 0 if the command takes no address
+ * */
+static uint8_t SpiNorMock_u8GetAddressBytes(uint8_t u8Command);
+
+/**
+ * @brief  Execute the command clocked in, when the memory is deselected
+ * @return void
+ * */
+static void SpiNorMock_vidExecute(void);
+
+/**
+ * @brief  Execute a page program, bytes past the page's end wrap around to its start
+ * @return void
+ * */
+static void SpiNorMock_vidProgram(void);
+
+/**
+ * @brief  Execute a sector or block erase
+ * @param  u32Size erased size (bytes), the address is aligned down to it
+ * @param  u32Time erase time (ns)
+ * @return void
+ * */
+static void SpiNorMock_vidErase(uint32_t u32Size, uint32_t u32Time);
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Advance virtual time
+ * @param  u64Ns time to add (ns)
+ * @return void
+ * */
+static void SpiNorMock_vidSpend(uint64_t u64Ns)
+{
+    SpiNorMock_u64Now += u64Ns;
+    SpiNorMock_sStats.time_ns = SpiNorMock_u64Now - SpiNorMock_u64StatsStart;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Check if a program or erase is in progress
+ * @return 1 if busy, 0 otherwise
+ * */
+static uint8_t SpiNorMock_u8IsBusy(void)
+{
+    return SpiNorMock_u64Now < SpiNorMock_u64BusyUntil;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Get number of address bytes taken by a command
+ * @param  u8Command command
+ * @return 3 or 4, 0 if the command takes no address
+ * */
+static uint8_t SpiNorMock_u8GetAddressBytes(uint8_t u8Command)
+{
+    uint8_t Local_u8Bytes;
+
+    switch(u8Command)
+    {
+        case SPI_NOR_CMD_READ:
+        case SPI_NOR_CMD_PAGE_PROGRAM:
+        case SPI_NOR_CMD_SECTOR_ERASE:
+        case SPI_NOR_CMD_BLOCK_ERASE:
+            Local_u8Bytes = 3;
+            break;
+
+        case SPI_NOR_CMD_READ_4B:
+        case SPI_NOR_CMD_PAGE_PROGRAM_4B:
+        case SPI_NOR_CMD_SECTOR_ERASE_4B:
+        case SPI_NOR_CMD_BLOCK_ERASE_4B:
+            Local_u8Bytes = 4;
+            break;
+
+        default:
+            Local_u8Bytes = 0;
+            break;
+    }
+
+    return Local_u8Bytes;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Execute the command clocked in, when the memory is deselected
+ * @return void
+ * */
+static void SpiNorMock_vidExecute(void)
+{
+    SpiNorMock_Command_t * Local_psLog;
+
+    if(!SpiNorMock_u8HasCommand)
+    {
+        return;
+    }
+
+    if(SpiNorMock_sStats.logged < SPI_NOR_MOCK_LOG_SIZE)
+    {
+        Local_psLog = &SpiNorMock_sStats.log[SpiNorMock_sStats.logged];
+        Local_psLog->command = SpiNorMock_u8Command;
+        Local_psLog->address = SpiNorMock_u32Address;
+        Local_psLog->data = SpiNorMock_u32Data;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    SpiNorMock_sStats.logged++;
+
+    /*	only status reads are accepted during a program or erase	*/
+    if((SpiNorMock_u8Command != SPI_NOR_CMD_READ_STATUS) && SpiNorMock_u8IsBusy())
+    {
+        SpiNorMock_sStats.violations++;
+        return;
+    }
+
+    /*	address wasn't fully clocked in	*/
+    if(SpiNorMock_u8AddressCount < SpiNorMock_u8AddressBytes)
+    {
+        SpiNorMock_sStats.violations++;
+        return;
+    }
+
+    switch(SpiNorMock_u8Command)
+    {
+        case SPI_NOR_CMD_WRITE_ENABLE:
+            SpiNorMock_u8WriteEnabled = !SpiNorMock_sConfig.write_protected;
+            break;
+
+        case SPI_NOR_CMD_READ:
+        case SPI_NOR_CMD_READ_4B:
+            SpiNorMock_sStats.reads++;
+            SpiNorMock_sStats.read_bytes += SpiNorMock_u32Data;
+            break;
+
+        case SPI_NOR_CMD_PAGE_PROGRAM:
+        case SPI_NOR_CMD_PAGE_PROGRAM_4B:
+            SpiNorMock_vidProgram();
+            break;
+
+        case SPI_NOR_CMD_SECTOR_ERASE:
+        case SPI_NOR_CMD_SECTOR_ERASE_4B:
+            SpiNorMock_vidErase(SPI_NOR_SECTOR_SIZE, SpiNorMock_sConfig.sector_erase_ns);
+            SpiNorMock_sStats.sector_erases++;
+            break;
+
+        case SPI_NOR_CMD_BLOCK_ERASE:
+        case SPI_NOR_CMD_BLOCK_ERASE_4B:
+            SpiNorMock_vidErase(SPI_NOR_BLOCK_SIZE, SpiNorMock_sConfig.block_erase_ns);
+            SpiNorMock_sStats.block_erases++;
+            break;
+
+        default:
+            /*	status & ID reads have no effect	*/
+            break;
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Execute a page program, bytes past the page's end wrap around to its start
+ * @return void
+ * */
+static void SpiNorMock_vidProgram(void)
+{
+    uint32_t Local_u32Page = SpiNorMock_u32Address - (SpiNorMock_u32Address % SPI_NOR_PAGE_SIZE);
+    uint32_t Local_u32Column = SpiNorMock_u32Address % SPI_NOR_PAGE_SIZE;
+    uint32_t Local_u32Len = MIN(SpiNorMock_u32Data, SPI_NOR_PAGE_SIZE);
+    uint32_t Local_u32Index;
+    uint8_t * Local_pu8Byte;
+
+    if(!SpiNorMock_u8WriteEnabled || ((Local_u32Page + SPI_NOR_PAGE_SIZE) > SPI_NOR_MOCK_SIZE))
+    {
+        SpiNorMock_sStats.violations++;
+        return;
+    }
+
+    /*	a real memory wraps around, the driver must split programs at page boundaries	*/
+    if((Local_u32Column + SpiNorMock_u32Data) > SPI_NOR_PAGE_SIZE)
+    {
+        SpiNorMock_sStats.violations++;
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    for(Local_u32Index = 0; Local_u32Index < Local_u32Len; Local_u32Index++)
+    {
+        Local_pu8Byte = &SpiNorMock_au8Memory[Local_u32Page + ((Local_u32Column + Local_u32Index) % SPI_NOR_PAGE_SIZE)];
+
+        /*	a bit can't be programmed from 0 to 1	*/
+        if(((*Local_pu8Byte) & SpiNorMock_au8Program[Local_u32Index]) != SpiNorMock_au8Program[Local_u32Index])
+        {
+            SpiNorMock_sStats.violations++;
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+
+        (*Local_pu8Byte) &= SpiNorMock_au8Program[Local_u32Index];
+    }
+
+    SpiNorMock_u8WriteEnabled = 0;
+    SpiNorMock_u64BusyUntil = SpiNorMock_u64Now + SpiNorMock_sConfig.program_op_ns + ((uint64_t)Local_u32Len * SpiNorMock_sConfig.program_byte_ns);
+
+    SpiNorMock_sStats.programs++;
+    SpiNorMock_sStats.program_bytes += Local_u32Len;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+/**
+ * @brief  Execute a sector or block erase
+ * @param  u32Size erased size (bytes), the address is aligned down to it
+ * @param  u32Time erase time (ns)
+ * @return void
+ * */
+static void SpiNorMock_vidErase(uint32_t u32Size, uint32_t u32Time)
+{
+    uint32_t Local_u32Start = SpiNorMock_u32Address - (SpiNorMock_u32Address % u32Size);
+
+    if(!SpiNorMock_u8WriteEnabled || ((Local_u32Start + u32Size) > SPI_NOR_MOCK_SIZE))
+    {
+        SpiNorMock_sStats.violations++;
+        return;
+    }
+
+    memset(&SpiNorMock_au8Memory[Local_u32Start], SPI_NOR_MOCK_ERASED_BYTE, u32Size);
+
+    SpiNorMock_u8WriteEnabled = 0;
+    SpiNorMock_u64BusyUntil = SpiNorMock_u64Now + u32Time;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void SpiNorMock_vidReset(const SpiNorMock_Config_t * const psConfig)
+{
+    SpiNorMock_sConfig = *psConfig;
+
+    memset(SpiNorMock_au8Memory, SPI_NOR_MOCK_ERASED_BYTE, sizeof(SpiNorMock_au8Memory));
+
+    SpiNorMock_u64Now = 0;
+    SpiNorMock_u64BusyUntil = 0;
+    SpiNorMock_u8Selected = 0;
+    SpiNorMock_u8WriteEnabled = 0;
+    SpiNorMock_u8HasCommand = 0;
+
+    SpiNorMock_vidResetStats();
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+SpiNor_Error_t SpiNorMock_enSelect(uint8_t u8Select)
+{
+    if(u8Select && !SpiNorMock_u8Selected)
+    {
+        SpiNorMock_u8HasCommand = 0;
+        SpiNorMock_u8AddressBytes = 0;
+        SpiNorMock_u8AddressCount = 0;
+        SpiNorMock_u32Address = 0;
+        SpiNorMock_u32Data = 0;
+
+        SpiNorMock_sStats.commands++;
+        SpiNorMock_vidSpend(SpiNorMock_sConfig.select_ns);
+    }
+    else if(!u8Select && SpiNorMock_u8Selected)
+    {
+        SpiNorMock_vidExecute();
+    }
+    else
+    {
+        /*	do nothing	*/
+    }
+
+    SpiNorMock_u8Selected = u8Select ? 1 : 0;
+
+    return SPI_NOR_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+SpiNor_Error_t SpiNorMock_enTransmit(const uint8_t * pu8Data, uint16_t u16Len)
+{
+    uint16_t Local_u16Index;
+
+    if(!SpiNorMock_u8Selected)
+    {
+        SpiNorMock_sStats.violations++;
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    for(Local_u16Index = 0; Local_u16Index < u16Len; Local_u16Index++)
+    {
+        if(!SpiNorMock_u8HasCommand)
+        {
+            SpiNorMock_u8Command = pu8Data[Local_u16Index];
+            SpiNorMock_u8AddressBytes = SpiNorMock_u8GetAddressBytes(SpiNorMock_u8Command);
+            SpiNorMock_u8HasCommand = 1;
+        }
+        else if(SpiNorMock_u8AddressCount < SpiNorMock_u8AddressBytes)
+        {
+            SpiNorMock_u32Address = (SpiNorMock_u32Address << 8) | pu8Data[Local_u16Index];
+            SpiNorMock_u8AddressCount++;
+        }
+        else
+        {
+            /*	page program data is latched, other commands ignore it	*/
+            if(SpiNorMock_u32Data < SPI_NOR_PAGE_SIZE)
+            {
+                SpiNorMock_au8Program[SpiNorMock_u32Data] = pu8Data[Local_u16Index];
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+
+            SpiNorMock_u32Data++;
+        }
+    }
+
+    SpiNorMock_sStats.bus_bytes += u16Len;
+    SpiNorMock_vidSpend((uint64_t)u16Len * SpiNorMock_sConfig.byte_ns);
+
+    return SPI_NOR_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+SpiNor_Error_t SpiNorMock_enReceive(uint8_t * pu8Buffer, uint16_t u16Len)
+{
+    uint16_t Local_u16Index;
+    uint8_t Local_u8Byte;
+
+    if(!SpiNorMock_u8Selected)
+    {
+        SpiNorMock_sStats.violations++;
+        return SPI_NOR_ERROR_BUS;
+    }
+
+    for(Local_u16Index = 0; Local_u16Index < u16Len; Local_u16Index++)
+    {
+        /*	time passes while a byte is clocked out, a status read sees the end of a program or erase	*/
+        SpiNorMock_vidSpend(SpiNorMock_sConfig.byte_ns);
+
+        if(!SpiNorMock_u8HasCommand || (SpiNorMock_u8AddressCount < SpiNorMock_u8AddressBytes))
+        {
+            Local_u8Byte = 0xFF;
+        }
+        else if(SpiNorMock_u8Command == SPI_NOR_CMD_READ_STATUS)
+        {
+            Local_u8Byte = (SpiNorMock_u8IsBusy() ? SPI_NOR_STATUS_BUSY : 0) | (SpiNorMock_u8WriteEnabled ? SPI_NOR_STATUS_WEL : 0);
+            SpiNorMock_sStats.status_reads++;
+        }
+        else if(SpiNorMock_u8Command == SPI_NOR_CMD_READ_JEDEC_ID)
+        {
+            Local_u8Byte = (SpiNorMock_u32Data < 3) ? (uint8_t)(SpiNorMock_sConfig.jedec_id >> ((2 - SpiNorMock_u32Data) * 8)) : 0xFF;
+        }
+        else if(((SpiNorMock_u8Command == SPI_NOR_CMD_READ) || (SpiNorMock_u8Command == SPI_NOR_CMD_READ_4B)) && !SpiNorMock_u8IsBusy())
+        {
+            /*	a read wraps around at the memory's end	*/
+            if((SpiNorMock_u32Address + SpiNorMock_u32Data) >= SPI_NOR_MOCK_SIZE)
+            {
+                SpiNorMock_sStats.violations++;
+            }
+            else
+            {
+                /*	do nothing	*/
+            }
+
+            Local_u8Byte = SpiNorMock_au8Memory[(SpiNorMock_u32Address + SpiNorMock_u32Data) % SPI_NOR_MOCK_SIZE];
+        }
+        else
+        {
+            Local_u8Byte = 0xFF;
+        }
+
+        pu8Buffer[Local_u16Index] = Local_u8Byte;
+        SpiNorMock_u32Data++;
+    }
+
+    SpiNorMock_sStats.bus_bytes += u16Len;
+
+    return SPI_NOR_ERROR_NONE;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void SpiNorMock_vidAdvance(uint64_t u64Ns)
+{
+    SpiNorMock_vidSpend(u64Ns);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+const uint8_t * SpiNorMock_pu8GetMemory(void)
+{
+    return SpiNorMock_au8Memory;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+const SpiNorMock_Stats_t * SpiNorMock_psGetStats(void)
+{
+    return &SpiNorMock_sStats;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void SpiNorMock_vidResetStats(void)
+{
+    memset(&SpiNorMock_sStats, 0x00, sizeof(SpiNorMock_sStats));
+    SpiNorMock_u64StatsStart = SpiNorMock_u64Now;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * @file      spi_nor_mock.h
+ * @brief     Host stand-in of a SPI bus with a JEDEC SPI NOR flash on it, so
+ *            the spi_nor driver can be built and run on a Linux host. Its
+ *            select, transmit & receive functions match SpiNor_Bus_t. The
+ *            mocked memory decodes the commands clocked in (write enable,
+ *            read status, JEDEC ID, read, page program & sector/block erase,
+ *            3 & 4 byte addresses), executes them when it's deselected, and
+ *            advances a virtual time by a bus & memory timing model. Commands
+ *            that a real memory would ignore or execute differently (ex: a
+ *            program without write enable, a page program crossing its page)
+ *            are counted as violations
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __SPI_NOR_MOCK_H__
+#define __SPI_NOR_MOCK_H__
+
+#include <stdint.h>
+#include <spi_nor.h>
+
+/**
+ * @brief Mocked memory size (bytes)
+ * */
+#ifndef SPI_NOR_MOCK_SIZE
+#define SPI_NOR_MOCK_SIZE				(16UL * 1024UL * 1024UL)
+#endif	/*	SPI_NOR_MOCK_SIZE	*/
+
+/**
+ * @brief Commands kept in the command log
+ * */
+#define SPI_NOR_MOCK_LOG_SIZE			64
+
+/**
+ * @brief Mocked memory & bus timing model
+ * */
+typedef struct spi_nor_mock_config_t {
+    uint32_t jedec_id;					/**<  JEDEC ID (manufacturer, type, capacity)  */
+    uint32_t byte_ns;                   /**<  time to clock a byte in or out (ns), 8 clocks  */
+    uint32_t select_ns;                 /**<  chip select overhead (ns), once per command  */
+    uint32_t program_op_ns;             /**<  fixed time of a page program (ns)  */
+    uint32_t program_byte_ns;           /**<  time per programmed byte (ns)  */
+    uint32_t sector_erase_ns;           /**<  4 KB sector erase time (ns)  */
+    uint32_t block_erase_ns;            /**<  64 KB block erase time (ns)  */
+    uint8_t  write_protected;           /**<  1 if write enable is ignored (write protected memory), 0 otherwise  */
+}SpiNorMock_Config_t;
+
+/**
+ * @brief A logged command
+ * */
+typedef struct spi_nor_mock_command_t {
+    uint8_t  command;					/**<  command byte  */
+    uint32_t address;                   /**<  address clocked in, 0 if the command has none  */
+    uint32_t data;                      /**<  data bytes clocked in or out after the address  */
+}SpiNorMock_Command_t;
+
+/**
+ * @brief Mocked memory statistics, accumulated since the last SpiNorMock_vidResetStats call
+ * */
+typedef struct spi_nor_mock_stats_t {
+    uint32_t commands;					/**<  executed commands (chip selects)  */
+    uint32_t reads;                     /**<  read commands  */
+    uint32_t read_bytes;                /**<  bytes read by read commands  */
+    uint32_t programs;                  /**<  page program commands  */
+    uint32_t program_bytes;             /**<  bytes programmed  */
+    uint32_t sector_erases;             /**<  4 KB sector erases  */
+    uint32_t block_erases;              /**<  64 KB block erases  */
+    uint32_t status_reads;              /**<  status register bytes read  */
+    uint32_t bus_bytes;                 /**<  bytes clocked in & out  */
+    uint32_t violations;                /**<  commands while busy, programs & erases without write enable, page programs
+                                             crossing their page, bits programmed from 0 to 1, out of range addresses  */
+    uint64_t time_ns;                   /**<  virtual time (ns)  */
+    uint32_t logged;                    /**<  commands in the log (the first SPI_NOR_MOCK_LOG_SIZE are kept)  */
+    SpiNorMock_Command_t log[SPI_NOR_MOCK_LOG_SIZE];	/**<  command log  */
+}SpiNorMock_Stats_t;
+
+/**
+ * @brief Typical W25Q128 class memory on a 40 MHz single SPI bus: 0.2 us per byte, ~0.7 ms 256 B page program,
+ *        ~45 ms sector erase, ~150 ms block erase
+ * */
+extern const SpiNorMock_Config_t SpiNorMock_sPresetW25q;
+
+/**
+ * @brief Bus handles of the mocked memory, for SpiNor_enInitialize
+ * */
+extern const SpiNor_Bus_t SpiNorMock_sBus;
+
+/**
+ * @brief  Configure the mocked memory, erase it, deselect it, clear the virtual time & statistics
+ * @param  psConfig memory & bus timing model
+ * @return void
+ * */
+void SpiNorMock_vidReset(const SpiNorMock_Config_t * const psConfig);
+
+/**
+ * @brief  Chip select (SpiNor_Select_Handle_t), a command is executed when the memory is deselected
+ * @param  u8Select 1 to select the memory, 0 to deselect it
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_NONE : always
+ * */
+SpiNor_Error_t SpiNorMock_enSelect(uint8_t u8Select);
+
+/**
+ * @brief  Clock bytes into the selected memory (SpiNor_Transmit_Handle_t)
+ * @param  pu8Data bytes to clock in
+ * @param  u16Len number of bytes
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_NONE : if no errors occurred
+ *         SPI_NOR_ERROR_BUS : if the memory isn't selected
+ * */
+SpiNor_Error_t SpiNorMock_enTransmit(const uint8_t * pu8Data, uint16_t u16Len);
+
+/**
+ * @brief  Clock bytes out of the selected memory (SpiNor_Receive_Handle_t), all 1s for commands with no output
+ * @param  pu8Buffer buffer to store bytes in
+ * @param  u16Len number of bytes
+ * @return SpiNor_Error_t
+ *         SPI_NOR_ERROR_NONE : if no errors occurred
+ *         SPI_NOR_ERROR_BUS : if the memory isn't selected
+ * */
+SpiNor_Error_t SpiNorMock_enReceive(uint8_t * pu8Buffer, uint16_t u16Len);
+
+/**
+ * @brief  Advance the virtual time without bus traffic (ex: application work between driver calls), a program
+ *         or erase in progress goes on meanwhile
+ * @param  u64Ns time to advance (ns)
+ * @return void
+ * */
+void SpiNorMock_vidAdvance(uint64_t u64Ns);
+
+/**
+ * @brief  Get a pointer to address 0 of the mocked memory
+ * @return pointer to address 0
+ * */
+const uint8_t * SpiNorMock_pu8GetMemory(void);
+
+/**
+ * @brief  Get statistics since the last SpiNorMock_vidResetStats call
+ * @return pointer to statistics
+ * */
+const SpiNorMock_Stats_t * SpiNorMock_psGetStats(void);
+
+/**
+ * @brief  Reset statistics (including virtual time & command log)
+ * @return void
+ * */
+void SpiNorMock_vidResetStats(void);
+
+#endif /* __SPI_NOR_MOCK_H__ */
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * @file      test_fixture.c
+ * @brief     Shared fixture of the host fluffer tests, see test_fixture.h
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <flash_sim.h>
+#include <test_fixture.h>
+
+/**
+ * @brief Constant entries' bytes are XORed with
+ * */
+#define FIXTURE_ENTRY_PATTERN			0xA5
+
+/**
+ * @brief Entries per write run held by the workspace
+ * */
+#define FIXTURE_RUN_ENTRIES				16
+
+/* ------------------------------------------------------------------------------------ */
+
+/*	instance workspace, used with FLUFFER_WORKSPACE_INSTANCE	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(FIXTURE_MAX_ELEMENT_SIZE, FIXTURE_MAX_WORD_SIZE,
+                                                FIXTURE_RUN_ENTRIES * (FIXTURE_MAX_ELEMENT_SIZE + FLUFFER_CRC_SIZE + FIXTURE_MAX_WORD_SIZE))];
+
+Fluffer_t FLUFFER;
+
+/* ------------------------------------------------------------------------------------ */
+
+void make_entry(uint8_t * pu8Entry, uint16_t u16Sequence)
+{
+    memset(pu8Entry, FIXTURE_ENTRY_PATTERN ^ (uint8_t)u16Sequence, FLUFFER.cfg.element_size);
+    pu8Entry[0] = (uint8_t)(u16Sequence >> 8);
+    pu8Entry[FLUFFER.cfg.element_size - 1] = (uint8_t)u16Sequence;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void config_fluffer(const FlashSim_Config_t * psMemory, uint8_t u8Blocks, uint8_t u8PagesPerBlock, uint16_t u16ElementSize)
+{
+    TEST_ASSERT_TRUE(u16ElementSize <= FIXTURE_MAX_ELEMENT_SIZE);
+    TEST_ASSERT_TRUE(psMemory->program_unit <= FIXTURE_MAX_WORD_SIZE);
+
+    memset(&FLUFFER, 0x00, sizeof(Fluffer_t));
+    FLUFFER.cfg.page_size = psMemory->page_size;
+    FLUFFER.cfg.blocks = u8Blocks;
+    FLUFFER.cfg.pages_pre_block = u8PagesPerBlock;
+    FLUFFER.cfg.start_page = 0;
+    FLUFFER.cfg.word_size = psMemory->program_unit;
+    FLUFFER.cfg.element_size = u16ElementSize;
+    FLUFFER.workspace.buffer = WORKSPACE;
+    FLUFFER.workspace.size = sizeof(WORKSPACE);
+    FlashSim_vidSetHandles(&FLUFFER.handles);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void setup_fluffer(const FlashSim_Config_t * psMemory, uint8_t u8Blocks, uint8_t u8PagesPerBlock, uint16_t u16ElementSize)
+{
+    TEST_ASSERT_TRUE(FlashSim_u8Init(psMemory));
+    config_fluffer(psMemory, u8Blocks, u8PagesPerBlock, u16ElementSize);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&FLUFFER));
+    FlashSim_vidResetStats();
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void mount_copy(Fluffer_t * psNewFluffer)
+{
+    memcpy(psNewFluffer, &FLUFFER, sizeof(Fluffer_t));
+    memset(&psNewFluffer->context, 0x00, sizeof(Fluffer_Context_t));
+
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enInitialize(psNewFluffer), "Init error\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(FLUFFER.context.head, psNewFluffer->context.head, "Init Failed @head\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(FLUFFER.context.tail, psNewFluffer->context.tail, "Init Failed @tail\n");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(FLUFFER.context.size, psNewFluffer->context.size, "Init Failed @size\n");
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(FLUFFER.context.main_buffer, psNewFluffer->context.main_buffer, "Init Failed @main_buffer\n");
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void write_entries(uint16_t u16First, uint16_t u16Count)
+{
+    uint8_t Local_au8Entry[FIXTURE_MAX_ELEMENT_SIZE];
+    uint16_t Local_u16Index;
+
+    for(Local_u16Index = 0; Local_u16Index < u16Count; Local_u16Index++)
+    {
+        make_entry(Local_au8Entry, u16First + Local_u16Index);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8Entry));
+    }
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void check_entries(uint16_t u16First, uint16_t u16Count)
+{
+    uint8_t Local_au8Read[FIXTURE_MAX_ELEMENT_SIZE];
+    uint8_t Local_au8Expected[FIXTURE_MAX_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint16_t Local_u16Index = 0;
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&FLUFFER, &Local_sReader));
+
+    while(Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Read) == FLUFFER_ERROR_NONE)
+    {
+        make_entry(Local_au8Expected, u16First + Local_u16Index);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(Local_au8Expected, Local_au8Read, FLUFFER.cfg.element_size);
+        Local_u16Index++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(u16Count, Local_u16Index);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+void write_sequence(uint32_t u32Sequence)
+{
+    uint8_t Local_au8Entry[FIXTURE_MAX_ELEMENT_SIZE];
+
+    TEST_ASSERT_TRUE(FLUFFER.cfg.element_size >= sizeof(u32Sequence));
+
+    memset(Local_au8Entry, (uint8_t)u32Sequence, FLUFFER.cfg.element_size);
+    memcpy(Local_au8Entry, &u32Sequence, sizeof(u32Sequence));
+    TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&FLUFFER, Local_au8Entry), "WriteEntry error\n");
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+uint32_t ack_sequences(uint16_t u16Count, uint32_t * pu32Expected)
+{
+    uint8_t Local_au8Entry[FIXTURE_MAX_ELEMENT_SIZE];
+    Fluffer_Reader_t Local_sReader;
+    uint32_t Local_u32Sequence;
+    uint32_t Local_u32Dropped = 0;
+
+    Fluffer_enInitReader(&FLUFFER, &Local_sReader);
+    while(u16Count-- && (Fluffer_enReadEntry(&FLUFFER, &Local_sReader, Local_au8Entry) == FLUFFER_ERROR_NONE))
+    {
+        memcpy(&Local_u32Sequence, Local_au8Entry, sizeof(Local_u32Sequence));
+        TEST_ASSERT_TRUE_MESSAGE(Local_u32Sequence >= (*pu32Expected), "ReadEntry Failed @order\n");
+        TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE((uint8_t)Local_u32Sequence, &Local_au8Entry[sizeof(Local_u32Sequence)], FLUFFER.cfg.element_size - sizeof(Local_u32Sequence), "ReadEntry Failed @data\n");
+
+        Local_u32Dropped += Local_u32Sequence - (*pu32Expected);
+        (*pu32Expected) = Local_u32Sequence + 1;
+        TEST_ASSERT_EQUAL_MESSAGE(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&FLUFFER), "MarkEntry error\n");
+    }
+
+    return Local_u32Dropped;
+}
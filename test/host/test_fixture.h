@@ -0,0 +1,105 @@
+/******************************************************************************
+ * @file      test_fixture.h
+ * @brief     Shared fixture of the host fluffer tests: a fluffer instance on
+ *            the host flash memory simulator, entries with a sequence number
+ *            and their checks. Tests keep only their scenarios.
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __TEST_FIXTURE_H__
+#define __TEST_FIXTURE_H__
+
+#include <stdint.h>
+#include <fluffer.h>
+#include <flash_sim.h>
+
+/**
+ * @brief Maximum element size (bytes) of the fixture's instance
+ * */
+#define FIXTURE_MAX_ELEMENT_SIZE		64
+
+/**
+ * @brief Maximum word size (bytes) of the fixture's instance
+ * */
+#define FIXTURE_MAX_WORD_SIZE			2
+
+/**
+ * @brief Fixture's fluffer instance
+ * */
+extern Fluffer_t FLUFFER;
+
+/**
+ * @brief  Fill an entry of FLUFFER's element size with a sequence number: every byte is a constant
+ *         XOR the sequence's low byte, the first byte holds its high byte, the last its low byte
+ * @param  pu8Entry buffer of an entry
+ * @param  u16Sequence entry's sequence number
+ * @return void
+ * */
+void make_entry(uint8_t * pu8Entry, uint16_t u16Sequence);
+
+/**
+ * @brief  Configure FLUFFER on the simulator, without initializing it: psMemory's page & word sizes,
+ *         u8Blocks blocks of u8PagesPerBlock pages from page 0, the workspace and the simulator's
+ *         handles. Memory is left as is, so the instance can be mounted on the memory's content
+ * @param  psMemory simulated memory configurations
+ * @param  u8Blocks number of blocks
+ * @param  u8PagesPerBlock pages per block
+ * @param  u16ElementSize element size, must not exceed FIXTURE_MAX_ELEMENT_SIZE
+ * @return void
+ * */
+void config_fluffer(const FlashSim_Config_t * psMemory, uint8_t u8Blocks, uint8_t u8PagesPerBlock, uint16_t u16ElementSize);
+
+/**
+ * @brief  Erase the simulator with psMemory, configure FLUFFER by config_fluffer, initialize it, then
+ *         reset the simulator's statistics
+ * @param  psMemory simulated memory configurations
+ * @param  u8Blocks number of blocks
+ * @param  u8PagesPerBlock pages per block
+ * @param  u16ElementSize element size, must not exceed FIXTURE_MAX_ELEMENT_SIZE
+ * @return void
+ * */
+void setup_fluffer(const FlashSim_Config_t * psMemory, uint8_t u8Blocks, uint8_t u8PagesPerBlock, uint16_t u16ElementSize);
+
+/**
+ * @brief  Initialize psNewFluffer as FLUFFER after a reset: same configurations, handles & workspace,
+ *         context recovered from the memory's content. Check it finds FLUFFER's head, tail, size & main buffer
+ * @param  psNewFluffer pointer to the new instance
+ * @return void
+ * */
+void mount_copy(Fluffer_t * psNewFluffer);
+
+/**
+ * @brief  Write entries with consecutive sequence numbers by Fluffer_enWriteEntry
+ * @param  u16First first entry's sequence number
+ * @param  u16Count number of entries
+ * @return void
+ * */
+void write_entries(uint16_t u16First, uint16_t u16Count);
+
+/**
+ * @brief  Write an entry holding a 32 bit sequence number by Fluffer_enWriteEntry, for runs longer than
+ *         make_entry's: its first 4 bytes hold the sequence number, every other byte its low byte
+ * @param  u32Sequence entry's sequence number
+ * @return void
+ * */
+void write_sequence(uint32_t u32Sequence);
+
+/**
+ * @brief  Read & mark up to u16Count entries written by write_sequence, checking their sequence numbers
+ *         increase from the expected one, which is then moved past the last read entry
+ * @param  u16Count maximum number of entries to read & mark
+ * @param  pu32Expected pointer to the expected sequence number of the next entry
+ * @return uint32_t number of dropped entries (sequence numbers skipped)
+ * */
+uint32_t ack_sequences(uint16_t u16Count, uint32_t * pu32Expected);
+
+/**
+ * @brief  Check FLUFFER holds u16Count unmarked entries, with consecutive sequence numbers from u16First
+ * @param  u16First first unmarked entry's sequence number
+ * @param  u16Count number of unmarked entries
+ * @return void
+ * */
+void check_entries(uint16_t u16First, uint16_t u16Count);
+
+#endif /* __TEST_FIXTURE_H__ */
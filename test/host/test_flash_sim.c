@@ -0,0 +1,325 @@
+/******************************************************************************
+ * @file      test_flash_sim.c
+ * @brief     Host tests of the flash memory simulator: program rules, program
+ *            granularity, timing model & erase counters, a fluffer instance
+ *            running on top of it without illegal programs, and unlocks
+ *            saved by programming sessions
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <fluffer.h>
+#include <unity.h>
+#include <utils.h>
+#include <flash_sim.h>
+#include <test_flash_sim.h>
+
+
+#define TEST_ELEMENT_SIZE			16
+#define TEST_ENTRIES				2000
+#define TEST_BATCH					20
+
+#if (FLUFFER_LAYOUT == FLUFFER_LAYOUT_BITMAP) && (FLUFFER_BITMAP_MARK == FLUFFER_MARK_BIT)
+#define TEST_FLUFFER_PRESET			FlashSim_sPresetSpiNor	/*	bit marks program a word more than once, STM32F1 flash can't	*/
+#else
+#define TEST_FLUFFER_PRESET			FlashSim_sPresetStm32f1
+#endif	/*	FLUFFER_LAYOUT	*/
+
+
+/*	instance workspace, used with FLUFFER_WORKSPACE_INSTANCE	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(TEST_ELEMENT_SIZE, 2, TEST_BATCH * (TEST_ELEMENT_SIZE + 2))];
+
+
+static void test_flash_sim_erase(void);
+static void test_flash_sim_rule_clear_bits(void);
+static void test_flash_sim_rule_once(void);
+static void test_flash_sim_timing(void);
+static void test_flash_sim_fluffer(void);
+static void test_flash_sim_session(void);
+
+/*
+ * initialize a fluffer instance on the simulator (psMemory preset), 4 blocks of a page each
+ * */
+static void setup_fluffer(Fluffer_t * psFluffer, const FlashSim_Config_t * psMemory)
+{
+    memset(psFluffer, 0x00, sizeof(Fluffer_t));
+    psFluffer->cfg.page_size = psMemory->page_size;
+    psFluffer->cfg.blocks = 4;
+    psFluffer->cfg.pages_pre_block = 1;
+    psFluffer->cfg.start_page = 0;
+    psFluffer->cfg.word_size = psMemory->program_unit;
+    psFluffer->cfg.element_size = TEST_ELEMENT_SIZE;
+    psFluffer->workspace.buffer = WORKSPACE;
+    psFluffer->workspace.size = sizeof(WORKSPACE);
+    FlashSim_vidSetHandles(&psFluffer->handles);
+}
+
+/*
+ * write TEST_ENTRIES entries in batches, mark each batch's entries but the 1st, returns virtual time taken
+ * */
+static uint64_t write_batches(Fluffer_t * psFluffer)
+{
+    uint8_t Local_au8Batch[TEST_BATCH * TEST_ELEMENT_SIZE];
+    uint16_t Local_u16Written;
+    uint16_t Local_u16Index;
+
+    FlashSim_vidResetStats();
+
+    for(Local_u16Index = 0; Local_u16Index < TEST_ENTRIES; Local_u16Index += TEST_BATCH)
+    {
+        memset(Local_au8Batch, (uint8_t)Local_u16Index, sizeof(Local_au8Batch));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntries(psFluffer, Local_au8Batch, TEST_BATCH, &Local_u16Written));
+        TEST_ASSERT_EQUAL_UINT16(TEST_BATCH, Local_u16Written);
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntries(psFluffer, TEST_BATCH - 1));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "Illegal program\n");
+
+    return FlashSim_psGetStats()->time_ns;
+}
+
+/**
+ * Test scenario:
+ * 01. initialize simulator (STM32F1 preset), program bytes of page 1
+ * 02. erase page 1, check it's blank & its erase count, other pages' erase counts & virtual time
+ * 03. check out of range erase is rejected
+ * */
+static void test_flash_sim_erase(void)
+{
+    uint8_t Local_au8Data[4] = {0x12, 0x34, 0x56, 0x78};
+    uint8_t Local_au8Buffer[4];
+
+    /*	01. program	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(FlashSim_sPresetStm32f1.page_size, Local_au8Data, sizeof(Local_au8Data)));
+
+    /*	02. erase	*/
+    FlashSim_vidResetStats();
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enErase(1));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enRead(FlashSim_sPresetStm32f1.page_size, Local_au8Buffer, sizeof(Local_au8Buffer)));
+    TEST_ASSERT_EACH_EQUAL_UINT8(0xFF, Local_au8Buffer, sizeof(Local_au8Buffer));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_u32GetEraseCount(1));
+    TEST_ASSERT_EQUAL_UINT32(0, FlashSim_u32GetEraseCount(0));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->erases);
+    TEST_ASSERT_TRUE(FlashSim_psGetStats()->time_ns >= FlashSim_sPresetStm32f1.erase_ns);
+
+    /*	03. out of range	*/
+    TEST_ASSERT_EQUAL(FH_ERR_INVALID_PAGE, FlashSim_enErase(FlashSim_sPresetStm32f1.pages));
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->violations);
+}
+
+/**
+ * Test scenario (SPI NOR preset):
+ * 01. program a byte, then clear more of its bits
+ * 02. check programming a bit from 0 to 1 is rejected & memory is left as is
+ * 03. check out of range write is rejected
+ * */
+static void test_flash_sim_rule_clear_bits(void)
+{
+    uint8_t Local_u8Data;
+    uint8_t Local_u8Read;
+
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetSpiNor));
+
+    /*	01. clear bits	*/
+    Local_u8Data = 0x0F;
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(10, &Local_u8Data, 1));
+    Local_u8Data = 0x03;
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(10, &Local_u8Data, 1));
+
+    /*	02. 0 to 1	*/
+    Local_u8Data = 0x07;
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, FlashSim_enWrite(10, &Local_u8Data, 1));
+    FlashSim_enRead(10, &Local_u8Read, 1);
+    TEST_ASSERT_EQUAL_HEX8(0x03, Local_u8Read);
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->violations);
+
+    /*	03. out of range	*/
+    TEST_ASSERT_EQUAL(FH_ERR_INVALID_ADDRESS, FlashSim_enWrite((uint32_t)FlashSim_sPresetSpiNor.pages * FlashSim_sPresetSpiNor.page_size, &Local_u8Data, 1));
+}
+
+/**
+ * Test scenario (STM32F1 preset, half word program unit):
+ * 01. program a half word, check clearing more of its bits is rejected, but clearing it to 0x0000 is not
+ * 02. program a single byte of an erased half word, check the other byte can't be programmed afterwards
+ * 03. check a rejected write spanning a legal & an illegal half word programs nothing
+ * */
+static void test_flash_sim_rule_once(void)
+{
+    uint8_t Local_au8Data[4];
+    uint8_t Local_au8Read[4];
+
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+
+    /*	01. programmed once	*/
+    Local_au8Data[0] = 0x0F;
+    Local_au8Data[1] = 0x0F;
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(0, Local_au8Data, 2));
+    Local_au8Data[0] = 0x03;
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, FlashSim_enWrite(0, Local_au8Data, 2));
+    Local_au8Data[0] = 0x00;
+    Local_au8Data[1] = 0x00;
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(0, Local_au8Data, 2));
+
+    /*	02. partial half word	*/
+    Local_au8Data[0] = 0x55;
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(3, Local_au8Data, 1));
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, FlashSim_enWrite(2, Local_au8Data, 1));
+
+    /*	03. half word 4 is erased, half word 2 isn't	*/
+    memset(Local_au8Data, 0x11, sizeof(Local_au8Data));
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, FlashSim_enWrite(2, Local_au8Data, 4));
+    FlashSim_enRead(2, Local_au8Read, 4);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, Local_au8Read[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x55, Local_au8Read[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, Local_au8Read[2]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, Local_au8Read[3]);
+    TEST_ASSERT_EQUAL_UINT32(3, FlashSim_psGetStats()->violations);
+}
+
+/**
+ * Test scenario:
+ * 01. STM32F1 preset: check an unaligned 15 bytes write programs 8 half words, and its virtual time (with an unlock)
+ * 02. SPI NOR preset: check a 300 bytes write crossing a program page boundary takes 2 program operations,
+ *     and its virtual time, then check a read's virtual time
+ * */
+static void test_flash_sim_timing(void)
+{
+    uint8_t Local_au8Data[300];
+
+    memset(Local_au8Data, 0xA5, sizeof(Local_au8Data));
+
+    /*	01. half words	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(1, Local_au8Data, 15));
+    TEST_ASSERT_EQUAL_UINT32(8, FlashSim_psGetStats()->program_ops);
+    TEST_ASSERT_EQUAL_UINT32(16, FlashSim_psGetStats()->program_bytes);
+    TEST_ASSERT_EQUAL_UINT64((8ULL * FlashSim_sPresetStm32f1.program_op_ns) + FlashSim_sPresetStm32f1.unlock_ns, FlashSim_psGetStats()->time_ns);
+
+    /*	02. program pages	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetSpiNor));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(200, Local_au8Data, sizeof(Local_au8Data)));
+    TEST_ASSERT_EQUAL_UINT32(2, FlashSim_psGetStats()->program_ops);
+    TEST_ASSERT_EQUAL_UINT64((2ULL * FlashSim_sPresetSpiNor.program_op_ns) + (300ULL * FlashSim_sPresetSpiNor.program_byte_ns), FlashSim_psGetStats()->time_ns);
+
+    FlashSim_vidResetStats();
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enRead(200, Local_au8Data, 100));
+    TEST_ASSERT_EQUAL_UINT64(FlashSim_sPresetSpiNor.read_op_ns + (100ULL * FlashSim_sPresetSpiNor.read_byte_ns), FlashSim_psGetStats()->time_ns);
+    TEST_ASSERT_NULL(FlashSim_pu8Map());
+}
+
+/**
+ * Test scenario (STM32F1 preset, SPI NOR preset with bitmap layout bit marks, 4 blocks of a page each):
+ * 01. initialize a fluffer instance on the simulator
+ * 02. write TEST_ENTRIES entries, mark 3 of each 4 entries written, so clean ups & migrations are done
+ * 03. check the simulator rejected no writes, and all pages were erased
+ * */
+static void test_flash_sim_fluffer(void)
+{
+    uint8_t Local_au8Entry[TEST_ELEMENT_SIZE];
+    Fluffer_t Local_sFluffer;
+    uint16_t Local_u16Index;
+    uint8_t Local_u8Page;
+
+    /*	01. initialize	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&TEST_FLUFFER_PRESET));
+    setup_fluffer(&Local_sFluffer, &TEST_FLUFFER_PRESET);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+
+    /*	02. write & mark	*/
+    for(Local_u16Index = 0; Local_u16Index < TEST_ENTRIES; Local_u16Index++)
+    {
+        memset(Local_au8Entry, (uint8_t)Local_u16Index, sizeof(Local_au8Entry));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&Local_sFluffer, Local_au8Entry));
+
+        if((Local_u16Index % 4) != 0)
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&Local_sFluffer));
+        }
+    }
+
+    /*	03. check	*/
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, FlashSim_psGetStats()->violations, "Illegal program\n");
+    for(Local_u8Page = 0; Local_u8Page < Local_sFluffer.cfg.blocks; Local_u8Page++)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(FlashSim_u32GetEraseCount(Local_u8Page) > 0, "Page never erased\n");
+    }
+}
+
+/**
+ * Test scenario (STM32F1 preset, 4 blocks of a page each):
+ * 01. check session begin unlocks once for nested sessions & writes, and end without a begin is rejected
+ * 02. write & mark entries in batches by a fluffer instance without session handles, count unlocks
+ * 03. repeat with session handles, check unlocks are at most one per batch write, batch mark & clean up,
+ *     fewer than without sessions, and virtual time is shorter (FLUFFER_SESSION_HANDLES), or that the
+ *     handles are never called (unlocks unchanged)
+ * */
+static void test_flash_sim_session(void)
+{
+    uint8_t Local_au8Data[2] = {0x12, 0x34};
+    Fluffer_t Local_sFluffer;
+    uint32_t Local_u32Unlocks;
+    uint64_t Local_u64Time;
+
+    /*	01. nested sessions	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enBeginSession());
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enBeginSession());
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(0, Local_au8Data, sizeof(Local_au8Data)));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enEndSession());
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enWrite(2, Local_au8Data, sizeof(Local_au8Data)));
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enEndSession());
+    TEST_ASSERT_EQUAL_UINT32(1, FlashSim_psGetStats()->unlocks);
+    TEST_ASSERT_EQUAL(FH_ERR_NONE, FlashSim_enErase(1));
+    TEST_ASSERT_EQUAL_UINT32(2, FlashSim_psGetStats()->unlocks);
+    TEST_ASSERT_EQUAL(FH_ERR_NULLPTR, FlashSim_enEndSession());
+
+    /*	02. no sessions	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    setup_fluffer(&Local_sFluffer, &FlashSim_sPresetStm32f1);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+    Local_u64Time = write_batches(&Local_sFluffer);
+    Local_u32Unlocks = FlashSim_psGetStats()->unlocks;
+    TEST_ASSERT_TRUE(Local_u32Unlocks >= (2 * (TEST_ENTRIES / TEST_BATCH)));
+
+    /*	03. sessions	*/
+    TEST_ASSERT_TRUE(FlashSim_u8Init(&FlashSim_sPresetStm32f1));
+    setup_fluffer(&Local_sFluffer, &FlashSim_sPresetStm32f1);
+    Local_sFluffer.handles.begin_handle = FlashSim_enBeginSession;
+    Local_sFluffer.handles.end_handle = FlashSim_enEndSession;
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+#if FLUFFER_SESSION_MODE == FLUFFER_SESSION_HANDLES
+    TEST_ASSERT_TRUE(write_batches(&Local_sFluffer) < Local_u64Time);
+    TEST_ASSERT_TRUE(FlashSim_psGetStats()->unlocks < Local_u32Unlocks);
+    TEST_ASSERT_TRUE(FlashSim_psGetStats()->unlocks <= (3 * (TEST_ENTRIES / TEST_BATCH)));
+#else
+    TEST_ASSERT_EQUAL_UINT64(Local_u64Time, write_batches(&Local_sFluffer));
+    TEST_ASSERT_EQUAL_UINT32(Local_u32Unlocks, FlashSim_psGetStats()->unlocks);
+#endif	/*	FLUFFER_SESSION_MODE	*/
+    TEST_ASSERT_EQUAL(FH_ERR_NULLPTR, FlashSim_enEndSession());
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_flash_sim(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_flash_sim_erase);
+    RUN_TEST(test_flash_sim_rule_clear_bits);
+    RUN_TEST(test_flash_sim_rule_once);
+    RUN_TEST(test_flash_sim_timing);
+    RUN_TEST(test_flash_sim_fluffer);
+    RUN_TEST(test_flash_sim_session);
+    UNITY_END();
+}
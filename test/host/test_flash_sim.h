@@ -0,0 +1,13 @@
+/******************************************************************************
+ * @file      test_flash_sim.h
+ * @brief
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __FLASH_SIM_TEST_FLASH_SIM_H__
+#define __FLASH_SIM_TEST_FLASH_SIM_H__
+
+void test_flash_sim(void);
+
+#endif /* __FLASH_SIM_TEST_FLASH_SIM_H__ */
@@ -0,0 +1,218 @@
+/******************************************************************************
+ * @file      bench_spi_nor.c
+ * @brief     Host benchmark of the SPI NOR driver on the SPI bus stand-in
+ *            (W25Q timing, virtual time): read & program throughput, erase
+ *            time of a 64 KB region by sector & block erases, and fluffer
+ *            write throughput & erase time per clean up on the driver's
+ *            handles. Build with SPI_NOR_ERASE_UNIT_SECTORS of 16 to compare
+ *            fluffer blocks erased by 64 KB block erases
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <unity.h>
+#include <utils.h>
+#include <fluffer.h>
+#include <spi_nor.h>
+#include <spi_nor_mock.h>
+#include <test_spi_nor.h>
+
+
+#define BENCH_REGION_SIZE			SPI_NOR_BLOCK_SIZE
+#define BENCH_MAX_LEN				4096
+#define BENCH_ELEMENT_SIZE			16
+#define BENCH_CLEANUPS				4
+
+/*	KB/s of u32Bytes transferred in u64Ns	*/
+#define BENCH_KBPS(u32Bytes, u64Ns)	((unsigned long)(((uint64_t)(u32Bytes) * 1000000000ULL) / ((u64Ns) * 1024ULL)))
+
+
+/*	transfer lengths (bytes) & offset of the 1st transfer	*/
+static const uint16_t BENCH_LENGTHS[] = {16, 100, 256, 4096};
+static const uint16_t BENCH_OFFSETS[] = {0, 100, 0, 0};
+
+static uint8_t BUFFER[BENCH_MAX_LEN];
+
+/*	fluffer instance workspace (FLUFFER_WORKSPACE_INSTANCE), a program page of run buffer	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(BENCH_ELEMENT_SIZE, 1, SPI_NOR_PAGE_SIZE)];
+
+static void setup_memory(void)
+{
+    SpiNorMock_vidReset(&SpiNorMock_sPresetW25q);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enInitialize(&SpiNorMock_sBus, NULL));
+    SpiNorMock_vidResetStats();
+}
+
+static void bench_spi_nor_throughput(void);
+static void bench_spi_nor_erase(void);
+static void bench_spi_nor_fluffer(void);
+
+/**
+ * Throughput, for each length:
+ * 01. program BENCH_REGION_SIZE bytes by writes of the given length, report page programs, status reads & KB/s
+ * 02. read them back by reads of the given length, report KB/s
+ * */
+static void bench_spi_nor_throughput(void)
+{
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    uint8_t Local_u8Index;
+    uint32_t Local_u32Offset;
+    uint16_t Local_u16Len;
+
+    printf("\n%8s %8s %10s %12s %12s %10s\n", "bytes", "offset", "programs", "status rds", "write KB/s", "read KB/s");
+
+    for(Local_u8Index = 0; Local_u8Index < (sizeof(BENCH_LENGTHS) / sizeof(BENCH_LENGTHS[0])); Local_u8Index++)
+    {
+        /*	01. program	*/
+        setup_memory();
+        memset(BUFFER, Local_u8Index, sizeof(BUFFER));
+
+        for(Local_u32Offset = BENCH_OFFSETS[Local_u8Index]; Local_u32Offset < BENCH_REGION_SIZE; Local_u32Offset += Local_u16Len)
+        {
+            Local_u16Len = (uint16_t)MIN(BENCH_LENGTHS[Local_u8Index], BENCH_REGION_SIZE - Local_u32Offset);
+            TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(Local_u32Offset, BUFFER, Local_u16Len));
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+        printf("%8u %8u %10lu %12lu %12lu ", (unsigned int)BENCH_LENGTHS[Local_u8Index], (unsigned int)BENCH_OFFSETS[Local_u8Index],
+            (unsigned long)Local_psStats->programs, (unsigned long)Local_psStats->status_reads,
+            BENCH_KBPS(Local_psStats->program_bytes, Local_psStats->time_ns));
+
+        /*	02. read	*/
+        SpiNorMock_vidResetStats();
+
+        for(Local_u32Offset = BENCH_OFFSETS[Local_u8Index]; Local_u32Offset < BENCH_REGION_SIZE; Local_u32Offset += Local_u16Len)
+        {
+            Local_u16Len = (uint16_t)MIN(BENCH_LENGTHS[Local_u8Index], BENCH_REGION_SIZE - Local_u32Offset);
+            TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enRead(Local_u32Offset, BUFFER, Local_u16Len));
+        }
+
+        printf("%10lu\n", BENCH_KBPS(Local_psStats->read_bytes, Local_psStats->time_ns));
+    }
+}
+
+/**
+ * Erase of a programmed 64 KB region:
+ * 01. by SPI_NOR_BLOCK_SECTORS sector erases
+ * 02. by a single block erase
+ * 03. by SpiNor_enErase of each sector (fluffer's erase handle)
+ * */
+static void bench_spi_nor_erase(void)
+{
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    const char * Local_apcNames[] = {"sector", "block", "handle"};
+    uint8_t Local_u8Method;
+    uint32_t Local_u32Sector;
+
+    printf("\nblock erase: %u\n", (unsigned int)SPI_NOR_BLOCK_ERASE);
+    printf("%8s %8s %8s %10s\n", "method", "sectors", "blocks", "time ms");
+
+    for(Local_u8Method = 0; Local_u8Method < 3; Local_u8Method++)
+    {
+        setup_memory();
+        memset(BUFFER, 0x00, sizeof(BUFFER));
+
+        for(Local_u32Sector = 0; Local_u32Sector < SPI_NOR_BLOCK_SECTORS; Local_u32Sector++)
+        {
+            TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(Local_u32Sector * SPI_NOR_SECTOR_SIZE, BUFFER, SPI_NOR_PAGE_SIZE));
+        }
+
+        SpiNorMock_vidResetStats();
+
+        if(Local_u8Method == 1)
+        {
+#if (SPI_NOR_START_SECTOR % SPI_NOR_BLOCK_SECTORS) == 0
+            TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enEraseBlock(0));
+#else
+            continue;
+#endif	/*	SPI_NOR_START_SECTOR	*/
+        }
+        else
+        {
+            for(Local_u32Sector = 0; Local_u32Sector < SPI_NOR_BLOCK_SECTORS; Local_u32Sector++)
+            {
+                TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, (Local_u8Method == 0) ? SpiNor_enEraseSector(Local_u32Sector) : SpiNor_enErase(Local_u32Sector));
+            }
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+        printf("%8s %8lu %8lu %10lu\n", Local_apcNames[Local_u8Method], (unsigned long)Local_psStats->sector_erases,
+            (unsigned long)Local_psStats->block_erases, (unsigned long)(Local_psStats->time_ns / 1000000ULL));
+    }
+}
+
+/**
+ * Fluffer instance on the driver's handles, 4 blocks of SPI_NOR_ERASE_UNIT_SECTORS sectors:
+ * 01. write BENCH_CLEANUPS main buffers of entries, each marked once written
+ * 02. report entries/s, bus bytes per entry, erases & erase time per clean up
+ * */
+static void bench_spi_nor_fluffer(void)
+{
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    Fluffer_t Local_sFluffer;
+    uint8_t Local_au8Entry[BENCH_ELEMENT_SIZE];
+    uint32_t Local_u32Count;
+    uint32_t Local_u32Index;
+    uint64_t Local_u64EraseNs;
+
+    setup_memory();
+    memset(&Local_sFluffer, 0x00, sizeof(Fluffer_t));
+    Local_sFluffer.cfg.page_size = SPI_NOR_SECTOR_SIZE;
+    Local_sFluffer.cfg.word_size = 1;
+    Local_sFluffer.cfg.start_page = 0;
+    Local_sFluffer.cfg.pages_pre_block = SPI_NOR_ERASE_UNIT_SECTORS;
+    Local_sFluffer.cfg.blocks = 4;
+    Local_sFluffer.cfg.element_size = BENCH_ELEMENT_SIZE;
+    Local_sFluffer.workspace.buffer = WORKSPACE;
+    Local_sFluffer.workspace.size = sizeof(WORKSPACE);
+    SpiNor_vidSetHandles(&Local_sFluffer.handles);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+    SpiNorMock_vidResetStats();
+
+    /*	01. write & mark	*/
+    Local_u32Count = (uint32_t)BENCH_CLEANUPS * Local_sFluffer.context.size;
+    memset(Local_au8Entry, 0x5A, sizeof(Local_au8Entry));
+
+    for(Local_u32Index = 0; Local_u32Index < Local_u32Count; Local_u32Index++)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&Local_sFluffer, Local_au8Entry));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&Local_sFluffer));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+
+    /*	02. report	*/
+    Local_u64EraseNs = ((uint64_t)Local_psStats->sector_erases * SpiNorMock_sPresetW25q.sector_erase_ns) +
+                       ((uint64_t)Local_psStats->block_erases * SpiNorMock_sPresetW25q.block_erase_ns);
+
+    printf("\nerase unit: %lu sectors, block erase: %u\n", (unsigned long)SPI_NOR_ERASE_UNIT_SECTORS, (unsigned int)SPI_NOR_BLOCK_ERASE);
+    printf("%10s %10s %12s %10s %10s %16s\n", "entries", "entries/s", "bus B/entry", "sectors", "blocks", "erase ms/cleanup");
+    printf("%10lu %10lu %12lu %10lu %10lu %16lu\n", (unsigned long)Local_u32Count,
+        (unsigned long)(((uint64_t)Local_u32Count * 1000000000ULL) / Local_psStats->time_ns),
+        (unsigned long)(Local_psStats->bus_bytes / Local_u32Count),
+        (unsigned long)Local_psStats->sector_erases, (unsigned long)Local_psStats->block_erases,
+        (unsigned long)(Local_u64EraseNs / (BENCH_CLEANUPS * 1000000ULL)));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void bench_spi_nor(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(bench_spi_nor_throughput);
+    RUN_TEST(bench_spi_nor_erase);
+    RUN_TEST(bench_spi_nor_fluffer);
+    UNITY_END();
+}
@@ -0,0 +1,477 @@
+/******************************************************************************
+ * @file      test_spi_nor.c
+ * @brief     Host tests of the SPI NOR driver on the SPI bus stand-in: JEDEC
+ *            ID check, argument errors, command sequences of a write split at
+ *            page boundaries, sector & block erase selection, write protected
+ *            memory, asynchronous erases, and a fluffer instance running on
+ *            the driver's handles with no command a real memory would reject
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <main.h>
+#include <DEBUG_interface.h>
+#include <unity.h>
+#include <utils.h>
+#include <fluffer.h>
+#include <spi_nor.h>
+#include <spi_nor_mock.h>
+#include <test_spi_nor.h>
+
+
+#define TEST_REGION_ADDRESS			(SPI_NOR_START_SECTOR * SPI_NOR_SECTOR_SIZE)
+#define TEST_ELEMENT_SIZE			16
+#define TEST_KEPT_ENTRIES			10
+
+/*	mocked memory content at a region offset	*/
+#define TEST_MEMORY(o)				(SpiNorMock_pu8GetMemory() + TEST_REGION_ADDRESS + (o))
+
+
+static uint8_t DATA[3 * SPI_NOR_PAGE_SIZE];
+static uint8_t READ[3 * SPI_NOR_PAGE_SIZE];
+
+/*	fluffer instance workspace (FLUFFER_WORKSPACE_INSTANCE), a program page of run buffer	*/
+static uint8_t WORKSPACE[FLUFFER_WORKSPACE_SIZE(TEST_ELEMENT_SIZE, 1, SPI_NOR_PAGE_SIZE)];
+
+static void fill_buffer(uint8_t * pu8Buffer, uint16_t u16Len, uint8_t u8Seed)
+{
+    uint16_t Local_u16Index;
+
+    for(Local_u16Index = 0; Local_u16Index < u16Len; Local_u16Index++)
+    {
+        pu8Buffer[Local_u16Index] = (uint8_t)((Local_u16Index * 13) + u8Seed);
+    }
+}
+
+static uint8_t is_erased(const uint8_t * pu8Memory, uint32_t u32Len)
+{
+    uint32_t Local_u32Index;
+
+    for(Local_u32Index = 0; Local_u32Index < u32Len; Local_u32Index++)
+    {
+        if(pu8Memory[Local_u32Index] != 0xFF)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * mocked memory with the given timing, erased, driver initialized on it
+ * */
+static void setup_memory(const SpiNorMock_Config_t * psConfig)
+{
+    SpiNorMock_vidReset(psConfig);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enInitialize(&SpiNorMock_sBus, NULL));
+    SpiNorMock_vidResetStats();
+}
+
+/*	fluffer instance over 4 erase units of the region, handles are left unset	*/
+static void config_fluffer(Fluffer_t * psFluffer)
+{
+    memset(psFluffer, 0x00, sizeof(Fluffer_t));
+    psFluffer->cfg.page_size = SPI_NOR_SECTOR_SIZE;
+    psFluffer->cfg.word_size = 1;
+    psFluffer->cfg.start_page = 0;
+    psFluffer->cfg.pages_pre_block = SPI_NOR_ERASE_UNIT_SECTORS;
+    psFluffer->cfg.blocks = 4;
+    psFluffer->cfg.element_size = TEST_ELEMENT_SIZE;
+    psFluffer->workspace.buffer = WORKSPACE;
+    psFluffer->workspace.size = sizeof(WORKSPACE);
+}
+
+static void test_spi_nor_initialize(void);
+static void test_spi_nor_arguments(void);
+static void test_spi_nor_write_split(void);
+static void test_spi_nor_erase(void);
+static void test_spi_nor_write_protected(void);
+static void test_spi_nor_fluffer(void);
+static void test_spi_nor_async(void);
+
+/**
+ * 01. null bus & null bus handle are rejected
+ * 02. a bus with no memory (ID reads as all 1s or all 0s) isn't found
+ * 03. memory's JEDEC ID is read by a single command
+ * */
+static void test_spi_nor_initialize(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    SpiNorMock_Config_t Local_sConfig = SpiNorMock_sPresetW25q;
+    SpiNor_Bus_t Local_sBus = SpiNorMock_sBus;
+    uint32_t Local_u32Id = 0;
+
+    /*	01. null bus	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NULLPTR, SpiNor_enInitialize(NULL, &Local_u32Id));
+    Local_sBus.receive_handle = NULL;
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NULLPTR, SpiNor_enInitialize(&Local_sBus, &Local_u32Id));
+
+    /*	02. no memory	*/
+    Local_sConfig.jedec_id = 0xFFFFFFUL;
+    SpiNorMock_vidReset(&Local_sConfig);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NOT_FOUND, SpiNor_enInitialize(&SpiNorMock_sBus, &Local_u32Id));
+    Local_sConfig.jedec_id = 0;
+    SpiNorMock_vidReset(&Local_sConfig);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NOT_FOUND, SpiNor_enInitialize(&SpiNorMock_sBus, &Local_u32Id));
+
+    /*	03. JEDEC ID	*/
+    SpiNorMock_vidReset(&SpiNorMock_sPresetW25q);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enInitialize(&SpiNorMock_sBus, &Local_u32Id));
+    TEST_ASSERT_EQUAL_HEX32(SpiNorMock_sPresetW25q.jedec_id, Local_u32Id);
+    TEST_ASSERT_EQUAL_UINT32(1, SpiNorMock_psGetStats()->commands);
+    TEST_ASSERT_EQUAL_HEX8(SPI_NOR_CMD_READ_JEDEC_ID, SpiNorMock_psGetStats()->log[0].command);
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->violations);
+}
+
+/**
+ * 01. null buffers, zero lengths & out of region accesses are rejected, without any bus transfer
+ * 02. an access ending at the region's end is accepted
+ * */
+static void test_spi_nor_arguments(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+
+    setup_memory(&SpiNorMock_sPresetW25q);
+
+    /*	01. rejected	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NULLPTR, SpiNor_enRead(0, NULL, 1));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_ZERO_LEN, SpiNor_enRead(0, READ, 0));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enRead(SPI_NOR_OFFSET_END, READ, 2));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NULLPTR, SpiNor_enWrite(0, NULL, 1));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_ZERO_LEN, SpiNor_enWrite(0, DATA, 0));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enWrite(SPI_NOR_OFFSET_END, DATA, 2));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enEraseSector(SPI_NOR_ALLOCATED_SECTORS));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enErase(SPI_NOR_ALLOCATED_SECTORS));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enEraseBlock(SPI_NOR_ALLOCATED_SECTORS / SPI_NOR_BLOCK_SECTORS));
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->commands);
+
+    /*	02. region's last byte	*/
+    fill_buffer(DATA, 1, 0x11);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_OFFSET_END, DATA, 1));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enRead(SPI_NOR_OFFSET_END, READ, 1));
+    TEST_ASSERT_EQUAL_HEX8(DATA[0], READ[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->violations);
+}
+
+/**
+ * 01. write 2.5 pages starting in a page's middle
+ * 02. check a page program per page: write enable, status read, page program not crossing its page, wait
+ * 03. check data is read back by a single read command
+ * */
+static void test_spi_nor_write_split(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    const uint32_t Local_u32Offset = SPI_NOR_SECTOR_SIZE + 200;
+    const uint16_t Local_u16Len = 600;
+    const uint16_t Local_au16Chunks[] = {56, 256, 256, 32};
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    const SpiNorMock_Command_t * Local_psLog;
+    uint32_t Local_u32Address = TEST_REGION_ADDRESS + Local_u32Offset;
+    uint8_t Local_u8Chunk;
+
+    setup_memory(&SpiNorMock_sPresetW25q);
+
+    /*	01. write	*/
+    fill_buffer(DATA, Local_u16Len, 0x5A);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(Local_u32Offset, DATA, Local_u16Len));
+
+    /*	02. command sequences	*/
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+    TEST_ASSERT_EQUAL_UINT32(4, Local_psStats->programs);
+    TEST_ASSERT_EQUAL_UINT32(Local_u16Len, Local_psStats->program_bytes);
+    TEST_ASSERT_EQUAL_UINT32(4 * 4, Local_psStats->logged);
+
+    for(Local_u8Chunk = 0; Local_u8Chunk < 4; Local_u8Chunk++)
+    {
+        Local_psLog = &Local_psStats->log[Local_u8Chunk * 4];
+
+        TEST_ASSERT_EQUAL_HEX8(SPI_NOR_CMD_WRITE_ENABLE, Local_psLog[0].command);
+        TEST_ASSERT_EQUAL_HEX8(SPI_NOR_CMD_READ_STATUS, Local_psLog[1].command);
+        TEST_ASSERT_EQUAL_HEX8((SPI_NOR_ADDRESS_BYTES == 4) ? SPI_NOR_CMD_PAGE_PROGRAM_4B : SPI_NOR_CMD_PAGE_PROGRAM, Local_psLog[2].command);
+        TEST_ASSERT_EQUAL_HEX32(Local_u32Address, Local_psLog[2].address);
+        TEST_ASSERT_EQUAL_UINT32(Local_au16Chunks[Local_u8Chunk], Local_psLog[2].data);
+        TEST_ASSERT_EQUAL_HEX8(SPI_NOR_CMD_READ_STATUS, Local_psLog[3].command);
+
+        /*	busy status is polled within a single command	*/
+        TEST_ASSERT_TRUE(Local_psLog[3].data > 1);
+
+        Local_u32Address += Local_au16Chunks[Local_u8Chunk];
+    }
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(DATA, TEST_MEMORY(Local_u32Offset), Local_u16Len);
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(Local_u32Offset + Local_u16Len), SPI_NOR_PAGE_SIZE));
+
+    /*	03. read back	*/
+    SpiNorMock_vidResetStats();
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enRead(Local_u32Offset, READ, Local_u16Len));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(DATA, READ, Local_u16Len);
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->commands);
+    TEST_ASSERT_EQUAL_UINT32(Local_u16Len, Local_psStats->read_bytes);
+}
+
+/**
+ * 01. sector erase only erases its sector
+ * 02. block erase erases its 64 KB block
+ * 03. SpiNor_enErase: with SPI_NOR_BLOCK_ERASE, the sector's block is erased once, until one of its sectors
+ *     is programmed, sector erase otherwise
+ * */
+static void test_spi_nor_erase(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+
+    setup_memory(&SpiNorMock_sPresetW25q);
+    fill_buffer(DATA, SPI_NOR_PAGE_SIZE, 0x33);
+
+    /*	01. sector erase	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(0, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enEraseSector(1));
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(SPI_NOR_SECTOR_SIZE), SPI_NOR_SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(DATA, TEST_MEMORY(0), SPI_NOR_PAGE_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->sector_erases);
+
+    /*	02. block erase	*/
+#if (SPI_NOR_START_SECTOR % SPI_NOR_BLOCK_SECTORS) == 0
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_BLOCK_SIZE - SPI_NOR_PAGE_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enEraseBlock(0));
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(0), SPI_NOR_BLOCK_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->block_erases);
+#else
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_MEM_BOUNDARY, SpiNor_enEraseBlock(0));
+#endif	/*	SPI_NOR_START_SECTOR	*/
+
+    /*	03. erase for the region's user	*/
+    SpiNorMock_vidResetStats();
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(2 * SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enErase(1));
+
+#if SPI_NOR_BLOCK_ERASE == 1
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->block_erases);
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(0), SPI_NOR_BLOCK_SIZE));
+
+    /*	block is still erased, no command	*/
+    SpiNorMock_vidResetStats();
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enErase(2));
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->commands);
+
+    /*	one of its sectors was programmed, block is erased again	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(3 * SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enErase(2));
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->block_erases);
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(3 * SPI_NOR_SECTOR_SIZE), SPI_NOR_SECTOR_SIZE));
+#else
+    TEST_ASSERT_EQUAL_UINT32(1, Local_psStats->sector_erases);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->block_erases);
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(SPI_NOR_SECTOR_SIZE), SPI_NOR_SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(DATA, TEST_MEMORY(2 * SPI_NOR_SECTOR_SIZE), SPI_NOR_PAGE_SIZE);
+#endif	/*	SPI_NOR_BLOCK_ERASE	*/
+
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+}
+
+/**
+ * 01. write & erase of a write protected memory fail, no program or erase command is sent
+ * 02. fluffer handles report a corrupted block
+ * */
+static void test_spi_nor_write_protected(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    SpiNorMock_Config_t Local_sConfig = SpiNorMock_sPresetW25q;
+    Fluffer_Handles_t Local_sHandles;
+
+    Local_sConfig.write_protected = 1;
+    setup_memory(&Local_sConfig);
+    fill_buffer(DATA, SPI_NOR_PAGE_SIZE, 0x44);
+
+    /*	01. driver	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_WRITE_DISABLED, SpiNor_enWrite(0, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_WRITE_DISABLED, SpiNor_enEraseSector(0));
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(0), SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->programs);
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->sector_erases);
+
+    /*	02. handles	*/
+    SpiNor_vidSetHandles(&Local_sHandles);
+    TEST_ASSERT_NULL(Local_sHandles.map_handle);
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, Local_sHandles.write_handle(0, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(FH_ERR_CORRUPTED_BLOCK, Local_sHandles.erase_handle(0));
+    TEST_ASSERT_EQUAL_UINT32(0, SpiNorMock_psGetStats()->violations);
+}
+
+/**
+ * 01. fluffer instance on the driver's handles, 4 blocks of SPI_NOR_ERASE_UNIT_SECTORS sectors
+ * 02. write entries, marking all but the last TEST_KEPT_ENTRIES, through 3 clean ups
+ * 03. mount again, check kept entries are read back, and no command was rejected by the memory
+ * */
+static void test_spi_nor_fluffer(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    Fluffer_t Local_sFluffer;
+    Fluffer_Reader_t Local_sReader;
+    uint8_t Local_au8Entry[TEST_ELEMENT_SIZE];
+    uint32_t Local_u32Count;
+    uint32_t Local_u32Sequence;
+
+    /*	01. instance	*/
+    setup_memory(&SpiNorMock_sPresetW25q);
+    config_fluffer(&Local_sFluffer);
+    SpiNor_vidSetHandles(&Local_sFluffer.handles);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+
+    /*	02. write & mark	*/
+    Local_u32Count = (3UL * Local_sFluffer.context.size) + TEST_KEPT_ENTRIES;
+
+    for(Local_u32Sequence = 0; Local_u32Sequence < Local_u32Count; Local_u32Sequence++)
+    {
+        memset(Local_au8Entry, (uint8_t)Local_u32Sequence, sizeof(Local_au8Entry));
+        memcpy(Local_au8Entry, &Local_u32Sequence, sizeof(Local_u32Sequence));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&Local_sFluffer, Local_au8Entry));
+
+        if(Local_u32Sequence >= TEST_KEPT_ENTRIES)
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&Local_sFluffer));
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    /*	03. mount & read back	*/
+    memset(&Local_sFluffer.context, 0x00, sizeof(Local_sFluffer.context));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&Local_sFluffer, &Local_sReader));
+
+    for(Local_u32Sequence = Local_u32Count - TEST_KEPT_ENTRIES; Local_u32Sequence < Local_u32Count; Local_u32Sequence++)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry));
+        TEST_ASSERT_EQUAL_MEMORY(&Local_u32Sequence, Local_au8Entry, sizeof(Local_u32Sequence));
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry));
+
+    Debug("commands %lu, programs %lu, sector erases %lu, block erases %lu\n", (unsigned long)Local_psStats->commands,
+        (unsigned long)Local_psStats->programs, (unsigned long)Local_psStats->sector_erases, (unsigned long)Local_psStats->block_erases);
+    TEST_ASSERT_TRUE((Local_psStats->sector_erases + Local_psStats->block_erases) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+}
+
+/**
+ * 01. an asynchronous erase returns once it's started, it's busy until its erase time has passed
+ * 02. a read right after an asynchronous erase waits for it
+ * 03. fluffer instance on the asynchronous handles, write & mark entries through 3 clean ups with a service
+ *     call & 1 ms of application work per entry, mount again, check kept entries are read back, and no command
+ *     was rejected by the memory
+ * */
+static void test_spi_nor_async(void)
+{
+    Debug("\n\n------------- Begin: %s -------------\n", __FUNCTION__);
+    const SpiNorMock_Stats_t * Local_psStats = SpiNorMock_psGetStats();
+    Fluffer_t Local_sFluffer;
+    Fluffer_Reader_t Local_sReader;
+    uint8_t Local_au8Entry[TEST_ELEMENT_SIZE];
+    uint32_t Local_u32Count;
+    uint32_t Local_u32Sequence;
+    uint8_t Local_u8Busy = 1;
+
+    setup_memory(&SpiNorMock_sPresetW25q);
+    fill_buffer(DATA, SPI_NOR_PAGE_SIZE, 0x55);
+
+    /*	01. erase is started	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enIsBusy(&Local_u8Busy));
+    TEST_ASSERT_EQUAL_UINT8(0, Local_u8Busy);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->commands);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    SpiNorMock_vidResetStats();
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enStartErase(1));
+    TEST_ASSERT_TRUE(Local_psStats->time_ns < (SpiNorMock_sPresetW25q.sector_erase_ns / 10));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enIsBusy(&Local_u8Busy));
+    TEST_ASSERT_EQUAL_UINT8(1, Local_u8Busy);
+    SpiNorMock_vidAdvance(SpiNorMock_sPresetW25q.block_erase_ns);
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enIsBusy(&Local_u8Busy));
+    TEST_ASSERT_EQUAL_UINT8(0, Local_u8Busy);
+    TEST_ASSERT_TRUE(is_erased(TEST_MEMORY(SPI_NOR_SECTOR_SIZE), SPI_NOR_SECTOR_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NULLPTR, SpiNor_enIsBusy(NULL));
+
+    /*	02. read waits	*/
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(0, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enWrite(SPI_NOR_SECTOR_SIZE, DATA, SPI_NOR_PAGE_SIZE));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enStartErase(1));
+    TEST_ASSERT_EQUAL(SPI_NOR_ERROR_NONE, SpiNor_enRead(0, READ, SPI_NOR_PAGE_SIZE));
+#if SPI_NOR_BLOCK_ERASE == 1
+    TEST_ASSERT_TRUE(is_erased(READ, SPI_NOR_PAGE_SIZE));
+#else
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(DATA, READ, SPI_NOR_PAGE_SIZE);
+#endif	/*	SPI_NOR_BLOCK_ERASE	*/
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+
+    /*	03. fluffer instance	*/
+    setup_memory(&SpiNorMock_sPresetW25q);
+    config_fluffer(&Local_sFluffer);
+    SpiNor_vidSetAsyncHandles(&Local_sFluffer.handles);
+    TEST_ASSERT_NOT_NULL(Local_sFluffer.handles.poll_handle);
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+
+    Local_u32Count = (3UL * Local_sFluffer.context.size) + TEST_KEPT_ENTRIES;
+
+    for(Local_u32Sequence = 0; Local_u32Sequence < Local_u32Count; Local_u32Sequence++)
+    {
+        SpiNorMock_vidAdvance(1000000ULL);
+        (void)Fluffer_enService(&Local_sFluffer, 1);
+
+        memset(Local_au8Entry, (uint8_t)Local_u32Sequence, sizeof(Local_au8Entry));
+        memcpy(Local_au8Entry, &Local_u32Sequence, sizeof(Local_u32Sequence));
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enWriteEntry(&Local_sFluffer, Local_au8Entry));
+
+        if(Local_u32Sequence >= TEST_KEPT_ENTRIES)
+        {
+            TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enMarkEntry(&Local_sFluffer));
+        }
+        else
+        {
+            /*	do nothing	*/
+        }
+    }
+
+    memset(&Local_sFluffer.context, 0x00, sizeof(Local_sFluffer.context));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitialize(&Local_sFluffer));
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enInitReader(&Local_sFluffer, &Local_sReader));
+
+    for(Local_u32Sequence = Local_u32Count - TEST_KEPT_ENTRIES; Local_u32Sequence < Local_u32Count; Local_u32Sequence++)
+    {
+        TEST_ASSERT_EQUAL(FLUFFER_ERROR_NONE, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry));
+        TEST_ASSERT_EQUAL_MEMORY(&Local_u32Sequence, Local_au8Entry, sizeof(Local_u32Sequence));
+    }
+
+    TEST_ASSERT_EQUAL(FLUFFER_ERROR_EMPTY, Fluffer_enReadEntry(&Local_sFluffer, &Local_sReader, Local_au8Entry));
+    TEST_ASSERT_TRUE((Local_psStats->sector_erases + Local_psStats->block_erases) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, Local_psStats->violations);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_spi_nor(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spi_nor_initialize);
+    RUN_TEST(test_spi_nor_arguments);
+    RUN_TEST(test_spi_nor_write_split);
+    RUN_TEST(test_spi_nor_erase);
+    RUN_TEST(test_spi_nor_write_protected);
+    RUN_TEST(test_spi_nor_fluffer);
+    RUN_TEST(test_spi_nor_async);
+    UNITY_END();
+}
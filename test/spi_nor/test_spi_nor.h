@@ -0,0 +1,14 @@
+/******************************************************************************
+ * @file      test_spi_nor.h
+ * @brief
+ * @version   1.0
+ * @date      Oct 16, 2026
+ * @copyright
+ *****************************************************************************/
+#ifndef __SPI_NOR_TEST_SPI_NOR_H__
+#define __SPI_NOR_TEST_SPI_NOR_H__
+
+void test_spi_nor(void);
+void bench_spi_nor(void);
+
+#endif /* __SPI_NOR_TEST_SPI_NOR_H__ */